@@ -0,0 +1,13 @@
+#include "vp_mock_backend.h"
+
+namespace vp_bench {
+    vp_mock_config& mock_config() {
+        static vp_mock_config config;
+        return config;
+    }
+
+    vp_mock_counters& mock_counters() {
+        static vp_mock_counters counters;
+        return counters;
+    }
+}
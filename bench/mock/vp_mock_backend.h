@@ -0,0 +1,27 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace vp_bench {
+    // behaviour of mocked hardware (RGA, NPU) used by vp_bench, set before the pipeline is built.
+    // latencies are fixed per job, like a hardware unit which does not compete for CPU.
+    struct vp_mock_config {
+        // RGA job (colour conversion), 0 means as fast as the CPU emulation runs
+        int rga_latency_us = 0;
+        // one inference on a NPU context
+        int npu_latency_us = 8000;
+        // synthetic detections per frame
+        int detections = 8;
+    };
+
+    vp_mock_config& mock_config();
+
+    // jobs served by mocked RGA / NPU, reported by vp_bench
+    struct vp_mock_counters {
+        std::atomic<uint64_t> rga_jobs {0};
+        std::atomic<uint64_t> npu_jobs {0};
+    };
+
+    vp_mock_counters& mock_counters();
+}
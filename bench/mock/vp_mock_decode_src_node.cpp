@@ -0,0 +1,101 @@
+#include <cstring>
+
+#include "vp_mock_decode_src_node.h"
+#include "vp_utils/vp_frame_buffer_pool.h"
+
+namespace vp_bench {
+
+    vp_mock_decode_src_node::vp_mock_decode_src_node(std::string node_name,
+                                                     int channel_index,
+                                                     int width,
+                                                     int height,
+                                                     int fps,
+                                                     int frames):
+                                                     vp_src_node(node_name, channel_index),
+                                                     width(width & ~1),
+                                                     height(height & ~1),
+                                                     fps(fps),
+                                                     frames(frames) {
+        assert(this->width > 0 && this->height > 0 && fps >= 0 && frames >= 0);
+        original_fps = fps > 0 ? fps : 25;
+        original_width = this->width;
+        original_height = this->height;
+        this->initialized();
+    }
+
+    vp_mock_decode_src_node::~vp_mock_decode_src_node() {
+        deinitialized();
+    }
+
+    void vp_mock_decode_src_node::handle_run() {
+        // MPP aligns strides of decoded frames to 16
+        auto hor_stride = (width + 15) & ~15;
+        auto ver_stride = (height + 15) & ~15;
+        auto period = std::chrono::nanoseconds(fps > 0 ? 1000000000LL / fps : 0);
+        auto next_time = std::chrono::steady_clock::now();
+
+        vp_nodes::vp_stream_info stream_info {channel_index, original_fps, original_width, original_height, to_string()};
+        invoke_stream_info_hooker(node_name, stream_info);
+
+        while (alive) {
+            // check if need work
+            gate.knock();
+            if (!alive) {
+                break;
+            }
+            if (frames > 0 && emitted_frames.load() >= frames) {
+                // end of stream, wait for stop or destruction
+                gate.close();
+                continue;
+            }
+
+            auto buffer = vp_utils::vp_frame_buffer_pool::dma().alloc(ver_stride * 3 / 2, hor_stride, CV_8UC1);
+            if (buffer.empty()) {
+                VP_WARN(vp_utils::string_format("[%s] alloc frame buffer failed", node_name.c_str()));
+                continue;
+            }
+            std::memset(buffer.data, 16 + (frame_index + 1) % 220, static_cast<size_t>(hor_stride) * ver_stride);
+            std::memset(buffer.data + static_cast<size_t>(hor_stride) * ver_stride, 128, static_cast<size_t>(hor_stride) * ver_stride / 2);
+
+            // the buffer goes back to pool when the last meta holding it is destroyed
+            auto dma_frame = std::make_shared<vp_objects::vp_dma_image>(vp_utils::vp_frame_buffer_pool::get_fd(buffer),
+                                                                        buffer.data,
+                                                                        buffer.total(),
+                                                                        width,
+                                                                        height,
+                                                                        hor_stride,
+                                                                        ver_stride,
+                                                                        vp_objects::vp_dma_format::NV12,
+                                                                        [buffer]() {});
+            this->frame_index++;
+            auto out_meta = std::make_shared<vp_objects::vp_frame_meta>(dma_frame, this->frame_index, this->channel_index, width, height, original_fps);
+            this->out_queue.push(out_meta);
+            invoke_meta_handled_hooker(node_name, out_queue.size(), out_meta);
+            emitted_frames.fetch_add(1);
+
+            // pace like a live source
+            if (fps > 0) {
+                next_time += period;
+                auto now = std::chrono::steady_clock::now();
+                if (next_time > now) {
+                    std::this_thread::sleep_until(next_time);
+                }
+                else {
+                    // fell behind, do not burst to catch up
+                    next_time = now;
+                }
+            }
+        }
+
+        // send dead flag for dispatch_thread
+        this->out_queue.push(nullptr);
+    }
+
+    std::string vp_mock_decode_src_node::to_string() {
+        return vp_utils::string_format("mock://%dx%d@%d", width, height, fps);
+    }
+
+    int vp_mock_decode_src_node::emitted() const {
+        return emitted_frames.load();
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+
+#include "nodes/base/vp_src_node.h"
+
+namespace vp_bench {
+    // stands in for the MPP decoding src nodes (vp_mpp_sdl_src_node, vp_rk_rtsp_src_node) without MPP or a stream:
+    // it emits NV12 frames laid out like MppDecoder output (16 aligned strides, buffers from vp_frame_buffer_pool::dma()
+    // wrapped in vp_dma_image, zero-copy as vp_mpp_sdl_src_node does), so downstream nodes take the same paths as on a board.
+    // pixels are a flat colour changing every frame, decoding costs no CPU like the hardware decoder.
+    //
+    // fps > 0 paces frames like a live camera, fps == 0 replays as fast as the pipeline accepts them (back pressure of out_queue).
+    // after `frames` frames (0 means endless) it stops and emitted() stays there.
+    class vp_mock_decode_src_node: public vp_nodes::vp_src_node {
+    private:
+        int width;
+        int height;
+        int fps;
+        int frames;
+        std::atomic<int> emitted_frames {0};
+    protected:
+        virtual void handle_run() override;
+    public:
+        vp_mock_decode_src_node(std::string node_name,
+                                int channel_index,
+                                int width = 1920,
+                                int height = 1080,
+                                int fps = 25,
+                                int frames = 0);
+        ~vp_mock_decode_src_node();
+
+        virtual std::string to_string() override;
+
+        // frames emitted so far
+        int emitted() const;
+    };
+}
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "vp_mock_infer_node.h"
+#include "vp_mock_backend.h"
+
+namespace vp_bench {
+
+    vp_mock_infer_node::vp_mock_infer_node(std::string node_name, int contexts): vp_node(node_name) {
+        if (contexts > 1) {
+            infer_executor.reset(new vp_utils::vp_ordered_executor<std::shared_ptr<vp_objects::vp_meta>>(
+                contexts,
+                [this](std::shared_ptr<vp_objects::vp_meta>& meta) { pendding_meta(meta); }));
+            infer_executor->set_space_listener([this] { resume_handle(); });
+        }
+        this->frame_needs_bgr = false;
+        this->initialized();
+    }
+
+    vp_mock_infer_node::~vp_mock_infer_node() {
+        deinitialized();
+        infer_executor.reset();
+    }
+
+    void vp_mock_infer_node::infer_frame(const std::shared_ptr<vp_objects::vp_frame_meta>& frame_meta) {
+        vp_utils::vp_trace_scope trace(trace_name, "infer");
+        trace.bind_frame(frame_meta->channel_index, frame_meta->frame_index, infer_executor != nullptr);
+        auto start = std::chrono::steady_clock::now();
+
+        // objects bounce inside the frame with their own speed, the same object keeps its position across frames
+        auto width = frame_meta->original_width > 0 ? frame_meta->original_width : 1920;
+        auto height = frame_meta->original_height > 0 ? frame_meta->original_height : 1080;
+        auto count = vp_bench::mock_config().detections;
+        for (int i = 0; i < count; i++) {
+            auto box_w = width / 16 + (i % 4) * width / 64;
+            auto box_h = height / 8 + (i % 3) * height / 32;
+            auto range_x = std::max(1, width - box_w);
+            auto range_y = std::max(1, height - box_h);
+            auto step = static_cast<long>(frame_meta->frame_index) * (2 + i % 5);
+            auto x = static_cast<int>((i * 997L + step) % (2 * range_x));
+            auto y = static_cast<int>((i * 571L + step / 2) % (2 * range_y));
+            x = x < range_x ? x : 2 * range_x - x;
+            y = y < range_y ? y : 2 * range_y - y;
+            frame_meta->targets.push_back(std::make_shared<vp_objects::vp_frame_target>(x, y, box_w, box_h, i % 3, 0.5f + (i % 5) * 0.1f,
+                                                                                         frame_meta->frame_index, frame_meta->channel_index, "mock"));
+        }
+
+        vp_bench::mock_counters().npu_jobs.fetch_add(1, std::memory_order_relaxed);
+        std::this_thread::sleep_until(start + std::chrono::microseconds(vp_bench::mock_config().npu_latency_us));
+    }
+
+    std::shared_ptr<vp_objects::vp_meta> vp_mock_infer_node::handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
+        // no pipeline, infer in handle thread
+        if (infer_executor == nullptr) {
+            infer_frame(meta);
+            return meta;
+        }
+        // worker index is the NPU context, results are handed back in input order
+        infer_executor->submit([this, meta](int worker) {
+            infer_frame(meta);
+            return std::shared_ptr<vp_objects::vp_meta>(meta);
+        });
+        return nullptr;
+    }
+
+    std::shared_ptr<vp_objects::vp_meta> vp_mock_infer_node::handle_control_meta(std::shared_ptr<vp_objects::vp_control_meta> meta) {
+        if (infer_executor == nullptr) {
+            return meta;
+        }
+        infer_executor->submit_ready(meta);
+        return nullptr;
+    }
+
+    bool vp_mock_infer_node::handle_ready() {
+        return infer_executor == nullptr || infer_executor->in_flight() < infer_executor->capacity();
+    }
+}
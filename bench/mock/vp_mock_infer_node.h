@@ -0,0 +1,30 @@
+#pragma once
+
+#include <memory>
+
+#include "nodes/base/vp_node.h"
+#include "vp_utils/vp_ordered_executor.h"
+
+namespace vp_bench {
+    // stands in for the rk detectors (vp_rk_first_yolo / vp_rk_first_yolo26) without RKNN:
+    // every frame occupies one of `contexts` NPU contexts for mock_config().npu_latency_us and gets mock_config().detections
+    // synthetic targets moving along straight lines, so trackers and osd downstream have real work to do.
+    // with more than 1 context frames go through vp_utils::vp_ordered_executor and leave in input order, as the rk detectors do.
+    // it reads no pixels, like detectors fed by a preprocess node (frame_needs_bgr is false).
+    class vp_mock_infer_node: public vp_nodes::vp_node {
+    private:
+        // results are frame metas, or control metas passed on in order behind them
+        std::unique_ptr<vp_utils::vp_ordered_executor<std::shared_ptr<vp_objects::vp_meta>>> infer_executor;
+        // NPU job and decoding of one frame
+        void infer_frame(const std::shared_ptr<vp_objects::vp_frame_meta>& frame_meta);
+    protected:
+        virtual std::shared_ptr<vp_objects::vp_meta> handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) override;
+        // pass control meta on behind frames in flight, keep order without blocking
+        virtual std::shared_ptr<vp_objects::vp_meta> handle_control_meta(std::shared_ptr<vp_objects::vp_control_meta> meta) override;
+        // false when infer_executor is full, as the rk detectors do
+        virtual bool handle_ready() override;
+    public:
+        vp_mock_infer_node(std::string node_name, int contexts = 1);
+        ~vp_mock_infer_node();
+    };
+}
@@ -0,0 +1,76 @@
+// librga replacement for hardware-free builds, only the API used by vp_node is provided.
+// no buffer can be imported (importbuffer_fd returns 0), so callers go through virtual addresses.
+// NV12 -> BGR is done by OpenCV and takes at least rga_latency_us, other conversions and resizes are NOT_SUPPORTED
+// and callers fall back to their software path, as they do on a board whose RGA rejects the job.
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <opencv2/imgproc.hpp>
+
+#include "im2d.h"
+#include "RgaUtils.h"
+#include "vp_mock_backend.h"
+
+namespace {
+    rga_buffer_t wrap(void* vir_addr, rga_buffer_handle_t handle, int width, int height, int wstride, int hstride, int format) {
+        rga_buffer_t buffer;
+        std::memset(&buffer, 0, sizeof(buffer));
+        buffer.vir_addr = vir_addr;
+        buffer.fd = -1;
+        buffer.handle = handle;
+        buffer.width = width;
+        buffer.height = height;
+        buffer.wstride = wstride;
+        buffer.hstride = hstride;
+        buffer.format = format;
+        return buffer;
+    }
+}
+
+IM_API rga_buffer_handle_t importbuffer_fd(int fd, int size) {
+    return 0;
+}
+
+IM_EXPORT_API IM_STATUS releasebuffer_handle(rga_buffer_handle_t handle) {
+    return IM_STATUS_SUCCESS;
+}
+
+IM_C_API rga_buffer_t wrapbuffer_virtualaddr_t(void* vir_addr, int width, int height, int wstride, int hstride, int format) {
+    return wrap(vir_addr, 0, width, height, wstride, hstride, format);
+}
+
+IM_C_API rga_buffer_t wrapbuffer_handle_t(rga_buffer_handle_t handle, int width, int height, int wstride, int hstride, int format) {
+    return wrap(nullptr, handle, width, height, wstride, hstride, format);
+}
+
+IM_API rga_buffer_t wrapbuffer_handle(rga_buffer_handle_t handle, int width, int height, int format) {
+    return wrap(nullptr, handle, width, height, width, height, format);
+}
+
+IM_API rga_buffer_t wrapbuffer_handle(rga_buffer_handle_t handle, int width, int height, int format, int wstride, int hstride) {
+    return wrap(nullptr, handle, width, height, wstride, hstride, format);
+}
+
+IM_API IM_STATUS imcvtcolor(rga_buffer_t src, rga_buffer_t dst, int sfmt, int dfmt, int mode, int sync, int* release_fence_fd) {
+    if (src.vir_addr == nullptr || dst.vir_addr == nullptr) {
+        return IM_STATUS_INVALID_PARAM;
+    }
+    if (sfmt != RK_FORMAT_YCbCr_420_SP || dfmt != RK_FORMAT_BGR_888) {
+        return IM_STATUS_NOT_SUPPORTED;
+    }
+    auto start = std::chrono::steady_clock::now();
+    auto base = static_cast<uchar*>(src.vir_addr);
+    cv::Mat y(src.height, src.width, CV_8UC1, base, src.wstride);
+    cv::Mat uv(src.height / 2, src.width / 2, CV_8UC2, base + static_cast<size_t>(src.wstride) * src.hstride, src.wstride);
+    cv::Mat bgr(dst.height, dst.width, CV_8UC3, dst.vir_addr, static_cast<size_t>(dst.wstride) * 3);
+    cv::cvtColorTwoPlane(y, uv, bgr, cv::COLOR_YUV2BGR_NV12);
+
+    vp_bench::mock_counters().rga_jobs.fetch_add(1, std::memory_order_relaxed);
+    std::this_thread::sleep_until(start + std::chrono::microseconds(vp_bench::mock_config().rga_latency_us));
+    return IM_STATUS_SUCCESS;
+}
+
+IM_API IM_STATUS imresize(const rga_buffer_t src, rga_buffer_t dst, double fx, double fy, int interpolation, int sync, int* release_fence_fd) {
+    return IM_STATUS_NOT_SUPPORTED;
+}
@@ -0,0 +1,272 @@
+// hardware-free replay benchmark of the vp_node framework.
+// it runs a pipeline shaped like main.cc on a normal linux box:
+//   N x mock decode src -> mock infer (fixed NPU latency, synthetic detections) -> byte track -> osd -> split by channel -> N x fake des
+// and reports throughput, per-stage latency (vp_pipeline_metrics), heap allocations per frame and pool/backend counters.
+// MPP, RKNN are replaced by mock nodes and librga by bench/mock/vp_mock_rga.cpp, so regressions in queues, cloning,
+// osd, tracking and logging show up here without a board.
+//
+// usage: vp_bench [--channels 2] [--width 1920] [--height 1080] [--fps 0] [--frames 500] [--seconds 0]
+//                 [--npu-us 8000] [--rga-us 0] [--detections 8] [--contexts 1] [--pool 0] [--trace out.json] [--metrics out.prom]
+// --fps 0 replays as fast as the pipeline goes (default), --seconds > 0 runs endless sources for that long instead of --frames.
+// --pool N > 0 runs nodes behind the sources as tasks on one vp_work_stealing_pool of N workers (see vp_node_pool_scope),
+// --pool 1 --contexts 2 checks that the pipelined detector never holds the only worker.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nodes/track/vp_byte_track_node.h"
+#include "nodes/osd/vp_osd_node.h"
+#include "nodes/base/vp_split_node.h"
+#include "nodes/vp_fake_des_node.h"
+#include "vp_utils/logger/vp_logger.h"
+#include "vp_utils/metrics/vp_pipeline_metrics.h"
+#include "vp_utils/trace/vp_tracer.h"
+#include "vp_utils/vp_frame_buffer_pool.h"
+
+#include "vp_mock_backend.h"
+#include "vp_mock_decode_src_node.h"
+#include "vp_mock_infer_node.h"
+
+/* heap allocations of the whole process, counted by replacing global operator new */
+static std::atomic<uint64_t> g_allocations {0};
+static std::atomic<uint64_t> g_allocated_bytes {0};
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (auto p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+    struct bench_options {
+        int channels = 2;
+        int width = 1920;
+        int height = 1080;
+        int fps = 0;
+        int frames = 500;
+        int seconds = 0;
+        int contexts = 1;
+        int pool = 0;
+        std::string trace_path;
+        std::string metrics_path;
+    };
+
+    void usage(const char* program) {
+        std::cout << "usage: " << program << " [--channels N] [--width W] [--height H] [--fps F] [--frames N] [--seconds S]\n"
+                  << "       [--npu-us US] [--rga-us US] [--detections N] [--contexts N] [--pool N] [--trace FILE] [--metrics FILE]\n";
+    }
+
+    bool parse(int argc, char** argv, bench_options& options) {
+        auto& mock = vp_bench::mock_config();
+        for (int i = 1; i < argc; i++) {
+            std::string key = argv[i];
+            if (key == "-h" || key == "--help" || i + 1 >= argc) {
+                return false;
+            }
+            std::string value = argv[++i];
+            if (key == "--trace") {
+                options.trace_path = value;
+                continue;
+            }
+            if (key == "--metrics") {
+                options.metrics_path = value;
+                continue;
+            }
+            auto number = std::atoi(value.c_str());
+            if (number < 0) {
+                return false;
+            }
+            if (key == "--channels") options.channels = number;
+            else if (key == "--width") options.width = number;
+            else if (key == "--height") options.height = number;
+            else if (key == "--fps") options.fps = number;
+            else if (key == "--frames") options.frames = number;
+            else if (key == "--seconds") options.seconds = number;
+            else if (key == "--contexts") options.contexts = number;
+            else if (key == "--pool") options.pool = number;
+            else if (key == "--npu-us") mock.npu_latency_us = number;
+            else if (key == "--rga-us") mock.rga_latency_us = number;
+            else if (key == "--detections") mock.detections = number;
+            else return false;
+        }
+        return options.channels > 0 && options.width > 1 && options.height > 1 && (options.frames > 0 || options.seconds > 0);
+    }
+}
+
+int main(int argc, char** argv) {
+    bench_options options;
+    if (!parse(argc, argv, options)) {
+        usage(argv[0]);
+        return 1;
+    }
+    VP_SET_LOG_LEVEL(vp_utils::vp_log_level::WARN);
+    // warnings go to console only, runs leave nothing behind in the working directory
+    VP_SET_LOG_TO_FILE(false);
+    VP_LOGGER_INIT();
+    if (!options.trace_path.empty()) {
+        VP_TRACE_START(1 << 16);
+    }
+
+    auto frames = options.seconds > 0 ? 0 : options.frames;
+    std::vector<std::shared_ptr<vp_bench::vp_mock_decode_src_node>> src_nodes;
+    std::vector<std::shared_ptr<vp_nodes::vp_node>> src_nodes_in_pipe;
+    for (int i = 0; i < options.channels; i++) {
+        auto src = std::make_shared<vp_bench::vp_mock_decode_src_node>("src_" + std::to_string(i), i, options.width, options.height, options.fps, frames);
+        src_nodes.push_back(src);
+        src_nodes_in_pipe.push_back(src);
+    }
+
+    // nodes constructed while the scope is alive run on pool, it is destroyed after them (declared first)
+    std::shared_ptr<vp_utils::vp_work_stealing_pool> pool;
+    std::unique_ptr<vp_nodes::vp_node_pool_scope> pool_scope;
+    if (options.pool > 0) {
+        pool = std::make_shared<vp_utils::vp_work_stealing_pool>("bench", options.pool);
+        pool_scope.reset(new vp_nodes::vp_node_pool_scope(pool));
+    }
+    auto infer = std::make_shared<vp_bench::vp_mock_infer_node>("mock_infer", options.contexts);
+    auto track = std::make_shared<vp_nodes::vp_byte_track_node>("track");
+    auto osd = std::make_shared<vp_nodes::vp_osd_node>("osd", "", true);
+    auto split = std::make_shared<vp_nodes::vp_split_node>("split", true);
+    infer->attach_to(src_nodes_in_pipe);
+    track->attach_to({infer});
+    osd->attach_to({track});
+    split->attach_to({osd});
+
+    // frames reaching sinks
+    std::atomic<uint64_t> sink_frames {0};
+    std::vector<std::shared_ptr<vp_nodes::vp_fake_des_node>> des_nodes;
+    for (int i = 0; i < options.channels; i++) {
+        auto des = std::make_shared<vp_nodes::vp_fake_des_node>("des_" + std::to_string(i), i);
+        des->set_stream_status_hooker([&sink_frames](const std::string&, const vp_nodes::vp_stream_status&) {
+            sink_frames.fetch_add(1, std::memory_order_relaxed);
+        });
+        des->attach_to({split});
+        des_nodes.push_back(des);
+    }
+    pool_scope.reset();
+
+    std::unique_ptr<vp_utils::vp_pipeline_metrics> metrics(new vp_utils::vp_pipeline_metrics(src_nodes_in_pipe));
+    if (!options.metrics_path.empty()) {
+        metrics->dump_to(options.metrics_path);
+    }
+
+    auto allocations_start = g_allocations.load();
+    auto allocated_bytes_start = g_allocated_bytes.load();
+    auto start = std::chrono::steady_clock::now();
+    for (auto& src: src_nodes) {
+        src->start();
+    }
+
+    if (options.seconds > 0) {
+        std::this_thread::sleep_for(std::chrono::seconds(options.seconds));
+    }
+    else {
+        // all frames emitted, then wait until sinks stay still (frames dropped by queues never arrive)
+        auto total = static_cast<uint64_t>(options.frames) * options.channels;
+        uint64_t last = 0;
+        int still_rounds = 0;
+        while (still_rounds < 20) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            auto emitted = 0;
+            for (auto& src: src_nodes) {
+                emitted += src->emitted();
+            }
+            auto arrived = sink_frames.load();
+            if (arrived >= total) {
+                break;
+            }
+            still_rounds = (static_cast<uint64_t>(emitted) >= total && arrived == last) ? still_rounds + 1 : 0;
+            last = arrived;
+        }
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    auto allocations = g_allocations.load() - allocations_start;
+    auto allocated_bytes = g_allocated_bytes.load() - allocated_bytes_start;
+    auto arrived = sink_frames.load();
+
+    for (auto& src: src_nodes) {
+        src->stop();
+    }
+    if (!options.trace_path.empty()) {
+        VP_TRACE_STOP();
+    }
+
+    uint64_t emitted = 0;
+    for (auto& src: src_nodes) {
+        emitted += src->emitted();
+    }
+    auto per_frame = [arrived](uint64_t value) { return arrived > 0 ? static_cast<double>(value) / arrived : 0.0; };
+    std::printf("\n==== vp_bench: %d channel(s) %dx%d, fps %d, npu %dus x %d context(s), rga %dus, %d detections, %s ====\n",
+                options.channels, options.width, options.height, options.fps, vp_bench::mock_config().npu_latency_us, options.contexts,
+                vp_bench::mock_config().rga_latency_us, vp_bench::mock_config().detections,
+                options.pool > 0 ? ("pool of " + std::to_string(options.pool) + " worker(s)").c_str() : "thread per node");
+    std::printf("frames: %llu emitted, %llu reached sinks in %.2fs, throughput %.1f fps\n",
+                static_cast<unsigned long long>(emitted), static_cast<unsigned long long>(arrived), seconds, seconds > 0 ? arrived / seconds : 0.0);
+    std::printf("heap: %llu allocations (%.1f per frame), %.1f KB per frame\n",
+                static_cast<unsigned long long>(allocations), per_frame(allocations), per_frame(allocated_bytes) / 1024.0);
+    std::printf("frame buffer pool: dma %llu hits / %llu misses, host %llu hits / %llu misses\n",
+                static_cast<unsigned long long>(vp_utils::vp_frame_buffer_pool::dma().hits()),
+                static_cast<unsigned long long>(vp_utils::vp_frame_buffer_pool::dma().misses()),
+                static_cast<unsigned long long>(vp_utils::vp_frame_buffer_pool::host().hits()),
+                static_cast<unsigned long long>(vp_utils::vp_frame_buffer_pool::host().misses()));
+    std::printf("mock backends: %llu npu jobs, %llu rga jobs\n\n",
+                static_cast<unsigned long long>(vp_bench::mock_counters().npu_jobs.load()),
+                static_cast<unsigned long long>(vp_bench::mock_counters().rga_jobs.load()));
+    std::printf("%s\n", metrics->summary().c_str());
+
+    if (!options.trace_path.empty()) {
+        if (VP_TRACE_DUMP(options.trace_path)) {
+            std::printf("trace written to %s\n", options.trace_path.c_str());
+        }
+    }
+
+    metrics.reset();
+    for (auto& src: src_nodes) {
+        src->detach_recursively();
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+// order checks of vp_meta_queue under its drop policies, runs without RK hardware and without OpenCV.
+// exit code is the number of failed checks.
+//
+// usage: vp_meta_queue_test
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nodes/base/vp_meta_queue.h"
+
+namespace {
+    // meta carrying the order it was pushed in, frame or control
+    class test_meta: public vp_objects::vp_meta {
+    public:
+        test_meta(vp_objects::vp_meta_type meta_type, int channel_index, int sequence):
+                vp_meta(meta_type, channel_index), sequence(sequence) {}
+
+        int sequence;
+
+        std::shared_ptr<vp_objects::vp_meta> clone() override {
+            return std::make_shared<test_meta>(*this);
+        }
+    };
+
+    int failures = 0;
+
+    void check(bool ok, const std::string& what) {
+        if (!ok) {
+            failures++;
+            std::cout << "FAILED: " << what << std::endl;
+        }
+    }
+
+    std::shared_ptr<vp_objects::vp_meta> frame(int sequence, int channel = 0) {
+        return std::make_shared<test_meta>(vp_objects::vp_meta_type::FRAME, channel, sequence);
+    }
+
+    std::shared_ptr<vp_objects::vp_meta> control(int sequence, int channel = 0) {
+        return std::make_shared<test_meta>(vp_objects::vp_meta_type::CONTROL, channel, sequence);
+    }
+
+    // pop everything queued, controls as negative sequence, dead flag as 0
+    std::vector<int> drain(vp_nodes::vp_meta_queue& queue) {
+        std::vector<int> order;
+        std::shared_ptr<vp_objects::vp_meta> meta;
+        while (queue.try_pop(meta)) {
+            if (meta == nullptr) {
+                order.push_back(0);
+                continue;
+            }
+            auto sequence = std::static_pointer_cast<test_meta>(meta)->sequence;
+            order.push_back(meta->meta_type == vp_objects::vp_meta_type::FRAME ? sequence : -sequence);
+        }
+        return order;
+    }
+
+    std::string to_string(const std::vector<int>& order) {
+        std::string s;
+        for (auto v: order) {
+            s += (s.empty() ? "" : " ") + std::to_string(v);
+        }
+        return s;
+    }
+
+    void check_order(const std::vector<int>& order, const std::vector<int>& expected, const std::string& what) {
+        check(order == expected, what + ", expected [" + to_string(expected) + "] got [" + to_string(order) + "]");
+    }
+
+    // control metas in front of / between frames keep their position when the oldest frame is dropped.
+    // note control metas take slots too, they just are never refused or dropped.
+    void drop_oldest_keeps_control_position() {
+        vp_nodes::vp_meta_queue queue(4, vp_nodes::vp_queue_policy::DROP_OLDEST);
+        queue.push(control(1));
+        queue.push(frame(1));
+        queue.push(control(2));
+        queue.push(frame(2));
+        // full, frame 1 is dropped and both control metas stay in front of frame 2
+        check(!queue.push(frame(3)), "drop reported by push");
+        queue.push(nullptr);
+        check_order(drain(queue), {-1, -2, 2, 3, 0}, "DROP_OLDEST with control metas around frames");
+        check(queue.dropped() == 1, "1 frame dropped");
+        check(queue.size() == 0, "queue empty after drain");
+    }
+
+    // consumer pops between drops, tokens of dropped frames are skipped
+    void drop_oldest_interleaved_pops() {
+        vp_nodes::vp_meta_queue queue(3, vp_nodes::vp_queue_policy::DROP_OLDEST);
+        std::vector<int> order;
+        queue.push(frame(1));
+        queue.push(control(1));
+        queue.push(frame(2));
+        auto part = drain(queue);
+        order.insert(order.end(), part.begin(), part.end());
+        queue.push(frame(3));
+        queue.push(frame(4));
+        queue.push(control(2));
+        // frames 3 and 4 are dropped, control 2 comes out first
+        queue.push(frame(5));
+        queue.push(frame(6));
+        part = drain(queue);
+        order.insert(order.end(), part.begin(), part.end());
+        check_order(order, {1, -1, 2, -2, 5, 6}, "DROP_OLDEST with pops in between");
+        check(queue.size() == 0, "queue empty after drain");
+    }
+
+    // stale frames are skipped at pop time, control metas untouched
+    void keep_latest_per_channel() {
+        vp_nodes::vp_meta_queue queue(8, vp_nodes::vp_queue_policy::KEEP_LATEST_PER_CHANNEL);
+        queue.push(frame(1, 0));
+        queue.push(frame(2, 1));
+        queue.push(control(1));
+        queue.push(frame(3, 0));
+        check_order(drain(queue), {2, -1, 3}, "KEEP_LATEST_PER_CHANNEL");
+    }
+
+    // producers push frames and controls into a small queue drained by a slow consumer,
+    // every control meta must come out and metas of one producer must come out in push order.
+    void drop_oldest_concurrent() {
+        const int producers = 3;
+        const int metas_per_producer = 20000;
+        vp_nodes::vp_meta_queue queue(4, vp_nodes::vp_queue_policy::DROP_OLDEST);
+
+        std::atomic<int> running {producers};
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; p++) {
+            threads.emplace_back([&, p]() {
+                for (int i = 1; i <= metas_per_producer; i++) {
+                    queue.push(i % 10 == 0 ? control(i, p) : frame(i, p));
+                }
+                running--;
+            });
+        }
+
+        std::vector<int> last(producers, 0);
+        std::vector<int> controls(producers, 0);
+        auto in_order = true;
+        auto consume = [&](std::shared_ptr<vp_objects::vp_meta>& meta) {
+            auto sequence = std::static_pointer_cast<test_meta>(meta)->sequence;
+            in_order = in_order && sequence > last[meta->channel_index];
+            last[meta->channel_index] = sequence;
+            if (meta->meta_type == vp_objects::vp_meta_type::CONTROL) {
+                controls[meta->channel_index]++;
+            }
+        };
+        std::shared_ptr<vp_objects::vp_meta> meta;
+        auto popped = 0;
+        while (running.load() > 0) {
+            if (queue.try_pop(meta)) {
+                consume(meta);
+                if (++popped % 64 == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+        }
+        for (auto& t: threads) {
+            t.join();
+        }
+        while (queue.try_pop(meta)) {
+            consume(meta);
+        }
+
+        check(in_order, "metas of every producer in push order under concurrent DROP_OLDEST");
+        for (int p = 0; p < producers; p++) {
+            check(controls[p] == metas_per_producer / 10, "all control metas of producer " + std::to_string(p) + " delivered");
+        }
+        check(queue.size() == 0, "queue empty after concurrent drain");
+    }
+}
+
+int main() {
+    drop_oldest_keeps_control_position();
+    drop_oldest_interleaved_pops();
+    keep_latest_per_channel();
+    drop_oldest_concurrent();
+
+    std::cout << (failures == 0 ? "all checks passed" : std::to_string(failures) + " check(s) failed") << std::endl;
+    return failures;
+}
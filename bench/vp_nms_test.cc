@@ -0,0 +1,165 @@
+// checks of the shared NMS (models/nms.cpp) against plain greedy NMS on seeded random box sets, runs without RK
+// hardware. sets of 64 candidates or more go through the grid of nms(), smaller ones through its direct loop.
+// exit code is the number of failed checks.
+//
+// usage: vp_nms_test
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nms.h"
+
+namespace {
+    int failures = 0;
+
+    void check(bool ok, const std::string& what) {
+        if (!ok) {
+            failures++;
+            std::cout << "FAILED: " << what << std::endl;
+        }
+    }
+
+    // raw mt19937 output only, distributions of the standard library differ between implementations
+    float uniform(std::mt19937& rng, float lo, float hi) {
+        return lo + (hi - lo) * (rng() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // plain greedy NMS: candidates by score (then index), each one compared to every box kept before it
+    std::vector<int> greedy_nms(const std::vector<NmsBox>& boxes, const NmsOptions& options) {
+        std::vector<int> order(boxes.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return boxes[a].score > boxes[b].score; });
+        if (options.max_candidates > 0 && options.max_candidates < (int)order.size()) {
+            order.resize(options.max_candidates);
+        }
+
+        const float offset = options.pixel_inclusive ? 1.0f : 0.0f;
+        auto iou_over = [&](const NmsBox& a, const NmsBox& b) {
+            float ax2 = std::max(a.x1, a.x2) + offset, ay2 = std::max(a.y1, a.y2) + offset;
+            float bx2 = std::max(b.x1, b.x2) + offset, by2 = std::max(b.y1, b.y2) + offset;
+            float iw = std::min(ax2, bx2) - std::max(a.x1, b.x1);
+            float ih = std::min(ay2, by2) - std::max(a.y1, b.y1);
+            if (iw <= 0 || ih <= 0) {
+                return false;
+            }
+            float inter = iw * ih;
+            float uni = (ax2 - a.x1) * (ay2 - a.y1) + (bx2 - b.x1) * (by2 - b.y1) - inter;
+            return uni > 0 && inter > options.iou_threshold * uni;
+        };
+
+        std::vector<int> keep;
+        for (int i: order) {
+            if (options.max_detections > 0 && (int)keep.size() >= options.max_detections) {
+                break;
+            }
+            bool suppressed = false;
+            for (int k: keep) {
+                bool same_group = boxes[k].batch_id == boxes[i].batch_id
+                    && (options.mode == NmsMode::CLASS_AGNOSTIC || boxes[k].cls_id == boxes[i].cls_id);
+                if (same_group && iou_over(boxes[k], boxes[i])) {
+                    suppressed = true;
+                    break;
+                }
+            }
+            if (!suppressed) {
+                keep.push_back(i);
+            }
+        }
+        return keep;
+    }
+
+    // boxes around a few centers so that many overlap, spread over a frame up to 4096 wide so that the grid has
+    // many cells. scores on a 1/20 step to get ties, some boxes given as x2 < x1 or with zero size.
+    std::vector<NmsBox> random_boxes(std::mt19937& rng) {
+        int count = rng() % 4 == 0 ? rng() % 64 : 64 + rng() % 400;
+        float frame = rng() % 2 == 0 ? 640 : 4096;
+        int centers = 1 + rng() % 12;
+        std::vector<NmsBox> boxes(count);
+        for (auto& b: boxes) {
+            std::mt19937 center_rng(rng() % centers);
+            float cx = uniform(center_rng, 0, frame), cy = uniform(center_rng, 0, frame / 2);
+            float w = uniform(center_rng, 4, 200), h = uniform(center_rng, 4, 200);
+            cx += uniform(rng, -w / 3, w / 3);
+            cy += uniform(rng, -h / 3, h / 3);
+            w *= uniform(rng, 0.7f, 1.3f);
+            h *= uniform(rng, 0.7f, 1.3f);
+            // integer corners as from the decoders with pixel_inclusive
+            b.x1 = (float)(int)(cx - w / 2);
+            b.y1 = (float)(int)(cy - h / 2);
+            b.x2 = (float)(int)(cx + w / 2);
+            b.y2 = (float)(int)(cy + h / 2);
+            switch (rng() % 50) {
+            case 0: std::swap(b.x1, b.x2); break;
+            case 1: b.x2 = b.x1; break;
+            default: break;
+            }
+            b.score = (1 + rng() % 20) / 20.0f;
+            b.cls_id = rng() % 4;
+            b.batch_id = rng() % 8 == 0 ? 1 : 0;
+        }
+        return boxes;
+    }
+
+    void nms_matches_greedy() {
+        std::mt19937 rng(9);
+        const float thresholds[] = { 0.3f, 0.45f, 0.7f };
+        int grid_sets = 0;
+        for (int n = 0; n < 2000; n++) {
+            auto boxes = random_boxes(rng);
+            NmsOptions options;
+            options.iou_threshold = thresholds[rng() % 3];
+            options.mode = rng() % 2 == 0 ? NmsMode::CLASS_AWARE : NmsMode::CLASS_AGNOSTIC;
+            options.pixel_inclusive = rng() % 2 == 0;
+            options.max_candidates = rng() % 4 == 0 ? 1 + rng() % 300 : 0;
+            options.max_detections = rng() % 4 == 0 ? 1 + rng() % 100 : 0;
+
+            int candidates = options.max_candidates > 0 ? std::min(options.max_candidates, (int)boxes.size()) : (int)boxes.size();
+            grid_sets += candidates >= 64;
+
+            std::vector<int> keep;
+            nms(boxes, options, keep);
+            check(keep == greedy_nms(boxes, options), "set " + std::to_string(n) + " of " + std::to_string(boxes.size())
+                + " boxes, " + (options.mode == NmsMode::CLASS_AWARE ? "class aware" : "class agnostic")
+                + (options.pixel_inclusive ? ", pixel inclusive" : "") + ", max candidates " + std::to_string(options.max_candidates)
+                + ", max detections " + std::to_string(options.max_detections));
+        }
+        check(grid_sets > 1000, "only " + std::to_string(grid_sets) + " sets went through the grid");
+    }
+
+    // boxes of other classes or other batches never suppress each other, unless class agnostic
+    void groups() {
+        std::vector<NmsBox> boxes(4);
+        for (int i = 0; i < 4; i++) {
+            boxes[i].x1 = 10;
+            boxes[i].y1 = 10;
+            boxes[i].x2 = 50;
+            boxes[i].y2 = 50;
+            boxes[i].score = 0.9f - i * 0.1f;
+        }
+        boxes[1].cls_id = 1;
+        boxes[2].batch_id = 1;
+        boxes[3].cls_id = 1;
+        boxes[3].batch_id = 1;
+
+        NmsOptions options;
+        std::vector<int> keep;
+        nms(boxes, options, keep);
+        check(keep == std::vector<int>{ 0, 1, 2, 3 }, "class aware keeps one box per class and batch");
+        options.mode = NmsMode::CLASS_AGNOSTIC;
+        nms(boxes, options, keep);
+        check(keep == std::vector<int>{ 0, 2 }, "class agnostic keeps one box per batch");
+    }
+}
+
+int main() {
+    groups();
+    nms_matches_greedy();
+
+    std::cout << (failures == 0 ? "all checks passed" : std::to_string(failures) + " check(s) failed") << std::endl;
+    return failures;
+}
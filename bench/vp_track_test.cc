@@ -0,0 +1,509 @@
+// checks of ByteTrack association on seeded random scenes, runs without RK hardware.
+// track ids and boxes of every frame are compared to tables recorded from the tracker (the scenes without camera
+// motion give the same tables as the tracker before its tracks were stored as structure of arrays),
+// and the detection each output track reports (STrack::det_index) is checked.
+// the Hungarian solver of SORT is checked on random cost matrices, against the lowest cost found by trying all
+// assignments and against assignments recorded from the solver before it kept its working arrays.
+// exit code is the number of failed checks.
+//
+// usage: vp_track_test [--print]
+//   --print  write the results of the scenes and the tied assignments as tables in the form used below,
+//            instead of checking them
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BYTETracker.h"
+#include "Hungarian.h"
+
+namespace {
+    int failures = 0;
+
+    void check(bool ok, const std::string& what) {
+        if (!ok) {
+            failures++;
+            std::cout << "FAILED: " << what << std::endl;
+        }
+    }
+
+    // raw mt19937 output only, distributions of the standard library differ between implementations
+    float uniform(std::mt19937& rng, float lo, float hi) {
+        return lo + (hi - lo) * (rng() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // objects moving at constant speed, each seen for a part of the scene, with missed detections,
+    // low score detections and false positives. detections of a frame come in random order.
+    // pan moves the whole scene by (pan, pan / 2) per frame, the tracker is told by the warp.
+    struct scene {
+        unsigned seed;
+        int frames;
+        int objects;
+        float pan;
+    };
+
+    struct object {
+        float x, y, w, h, vx, vy;
+        int first, last;
+    };
+
+    std::vector<std::vector<DetectionResult>> make_scene(const scene& s) {
+        std::mt19937 rng(s.seed);
+        std::vector<object> objects(s.objects);
+        for (auto& o: objects) {
+            o.x = uniform(rng, 0, 600);
+            o.y = uniform(rng, 0, 300);
+            o.w = uniform(rng, 20, 80);
+            o.h = uniform(rng, 40, 120);
+            o.vx = uniform(rng, -6, 6);
+            o.vy = uniform(rng, -4, 4);
+            o.first = rng() % (s.frames / 2);
+            o.last = o.first + 10 + rng() % s.frames;
+        }
+
+        std::vector<std::vector<DetectionResult>> frames(s.frames);
+        for (int f = 0; f < s.frames; f++) {
+            auto& dets = frames[f];
+            auto add = [&](float x, float y, float w, float h, float score) {
+                DetectionResult det;
+                // same layout as vp_byte_track_node: top/left/bottom/right hold x/y/x2/y2
+                det.box = BOX{ (int)std::lround(x), (int)std::lround(y), (int)std::lround(x + w), (int)std::lround(y + h) };
+                det.score = score;
+                det.id = 0;
+                det.label = "face";
+                dets.push_back(det);
+            };
+            for (auto& o: objects) {
+                if (f < o.first || f > o.last || rng() % 10 == 0) {
+                    continue;
+                }
+                int t = f - o.first;
+                add(o.x + o.vx * t + s.pan * f + uniform(rng, -1.5f, 1.5f),
+                    o.y + o.vy * t + s.pan * f / 2 + uniform(rng, -1.5f, 1.5f),
+                    o.w + uniform(rng, -1.5f, 1.5f), o.h + uniform(rng, -1.5f, 1.5f),
+                    uniform(rng, 0.3f, 1.0f));
+            }
+            if (rng() % 10 == 0) {
+                add(uniform(rng, 0, 600), uniform(rng, 0, 300), uniform(rng, 20, 80), uniform(rng, 40, 120),
+                    uniform(rng, 0.1f, 0.7f));
+            }
+            for (int i = (int)dets.size() - 1; i > 0; i--) {
+                std::swap(dets[i], dets[rng() % (i + 1)]);
+            }
+        }
+        return frames;
+    }
+
+    // what vp_byte_track_node relies on to give detections their track ids: every output track was matched to a
+    // detection at this frame and no detection is claimed by two tracks
+    void check_det_index(const std::vector<DetectionResult>& dets, const std::vector<STrack>& tracks, const std::string& what) {
+        std::vector<int> claimed(dets.size(), 0);
+        for (auto& t: tracks) {
+            if (t.det_index < 0 || t.det_index >= (int)dets.size()) {
+                check(false, what + " track " + std::to_string(t.track_id) + " det_index " + std::to_string(t.det_index));
+                continue;
+            }
+            check(++claimed[t.det_index] == 1, what + " detection " + std::to_string(t.det_index) + " claimed twice");
+            // the matched detection overlaps the track
+            auto& box = dets[t.det_index].box;
+            bool overlaps = box.top < t.tlbr[2] && box.bottom > t.tlbr[0] && box.left < t.tlbr[3] && box.right > t.tlbr[1];
+            check(overlaps, what + " track " + std::to_string(t.track_id) + " far from detection " + std::to_string(t.det_index));
+        }
+    }
+
+    // results of a frame: track count, then id, x, y, w, h (rounded) of each track, in output order
+    typedef std::vector<int> frame_result;
+
+    std::vector<frame_result> run_scene(const scene& s) {
+        BYTETracker tracker(25, 30);
+        const float warp[6] = { 1, 0, s.pan, 0, 1, s.pan / 2 };
+        std::vector<frame_result> results;
+        for (auto& dets: make_scene(s)) {
+            const std::vector<STrack>& tracks = tracker.update(dets, s.pan != 0 ? warp : nullptr);
+            check_det_index(dets, tracks, "scene " + std::to_string(s.seed) + " frame " + std::to_string(results.size()));
+            frame_result r{ (int)tracks.size() };
+            for (auto& t: tracks) {
+                r.push_back(t.track_id);
+                for (int k = 0; k < 4; k++) {
+                    r.push_back((int)std::lround(t.tlwh[k]));
+                }
+            }
+            results.push_back(r);
+        }
+        return results;
+    }
+
+    // ids are taken from a counter shared by all trackers, so scenes must run in this order
+    const scene scenes[] = {
+        { 1, 40, 5, 0 },
+        { 2, 40, 8, 0 },
+        { 3, 40, 6, 4 },
+    };
+
+    // recorded with --print
+    const std::vector<std::vector<int>> expected[] = {
+        {
+            /* 0 */ { 0 },
+            /* 1 */ { 0 },
+            /* 2 */ { 0 },
+            /* 3 */ { 0 },
+            /* 4 */ { 0 },
+            /* 5 */ { 0 },
+            /* 6 */ { 0 },
+            /* 7 */ { 0 },
+            /* 8 */ { 0 },
+            /* 9 */ { 0 },
+            /* 10 */ { 1, 2, 236, 276, 51, 107 },
+            /* 11 */ { 1, 2, 234, 274, 51, 107 },
+            /* 12 */ { 1, 2, 232, 273, 51, 106 },
+            /* 13 */ { 0 },
+            /* 14 */ { 2, 3, 86, 70, 25, 72, 2, 229, 269, 51, 107 },
+            /* 15 */ { 3, 3, 82, 70, 25, 73, 4, 239, 146, 54, 76, 2, 229, 267, 51, 108 },
+            /* 16 */ { 2, 3, 77, 69, 25, 72, 2, 227, 279, 54, 111 },
+            /* 17 */ { 2, 3, 74, 67, 25, 72, 2, 220, 281, 55, 113 },
+            /* 18 */ { 2, 2, 214, 279, 57, 116, 4, 226, 156, 52, 73 },
+            /* 19 */ { 2, 2, 221, 267, 54, 111, 4, 220, 161, 54, 75 },
+            /* 20 */ { 1, 4, 215, 165, 53, 74 },
+            /* 21 */ { 2, 4, 210, 169, 53, 74, 3, 58, 64, 25, 71 },
+            /* 22 */ { 2, 3, 54, 62, 25, 72, 2, 191, 266, 57, 114 },
+            /* 23 */ { 1, 3, 50, 62, 25, 71 },
+            /* 24 */ { 4, 3, 47, 62, 25, 70, 6, 89, 135, 75, 59, 2, 178, 263, 57, 114, 4, 200, 180, 53, 73 },
+            /* 25 */ { 4, 3, 42, 60, 25, 71, 6, 83, 136, 76, 60, 2, 170, 259, 58, 115, 4, 194, 182, 54, 75 },
+            /* 26 */ { 2, 6, 77, 134, 74, 58, 2, 165, 257, 58, 114 },
+            /* 27 */ { 3, 2, 157, 254, 58, 114, 3, 34, 59, 25, 73, 4, 186, 189, 54, 75 },
+            /* 28 */ { 3, 2, 152, 249, 59, 115, 3, 32, 58, 25, 72, 4, 181, 193, 54, 75 },
+            /* 29 */ { 3, 2, 145, 245, 60, 116, 3, 27, 58, 25, 71, 4, 178, 197, 53, 74 },
+            /* 30 */ { 2, 2, 138, 244, 60, 115, 3, 24, 56, 25, 72 },
+            /* 31 */ { 3, 2, 132, 241, 61, 116, 3, 19, 54, 25, 72, 4, 169, 205, 54, 76 },
+            /* 32 */ { 4, 2, 127, 238, 61, 115, 3, 15, 54, 25, 72, 4, 165, 207, 54, 75, 6, 41, 137, 74, 59 },
+            /* 33 */ { 4, 2, 121, 235, 60, 114, 3, 12, 53, 25, 72, 4, 160, 210, 54, 75, 6, 37, 137, 73, 58 },
+            /* 34 */ { 3, 3, 9, 52, 25, 71, 4, 156, 213, 53, 74, 6, 31, 137, 72, 57 },
+            /* 35 */ { 3, 3, 5, 52, 25, 71, 4, 150, 218, 53, 74, 6, 27, 138, 73, 58 },
+            /* 36 */ { 4, 3, 2, 51, 25, 70, 4, 146, 222, 54, 75, 6, 21, 139, 74, 59, 2, 102, 226, 61, 116 },
+            /* 37 */ { 3, 3, -2, 51, 25, 71, 4, 143, 225, 53, 74, 2, 96, 223, 61, 115 },
+            /* 38 */ { 1, 3, -6, 49, 25, 72 },
+            /* 39 */ { 4, 3, -10, 48, 25, 72, 2, 84, 216, 61, 114, 4, 133, 231, 53, 74, 6, 3, 139, 73, 58 },
+        },
+        {
+            /* 0 */ { 0 },
+            /* 1 */ { 0 },
+            /* 2 */ { 0 },
+            /* 3 */ { 2, 7, 133, 172, 40, 54, 8, 263, 59, 22, 115 },
+            /* 4 */ { 1, 8, 263, 63, 22, 115 },
+            /* 5 */ { 1, 8, 266, 89, 14, 68 },
+            /* 6 */ { 2, 8, 262, 99, 12, 51, 7, 131, 169, 40, 54 },
+            /* 7 */ { 2, 10, 265, 73, 21, 115, 7, 132, 168, 40, 53 },
+            /* 8 */ { 2, 10, 265, 77, 21, 116, 7, 130, 168, 39, 53 },
+            /* 9 */ { 2, 10, 266, 80, 21, 115, 7, 130, 166, 39, 53 },
+            /* 10 */ { 2, 10, 266, 83, 21, 114, 7, 130, 166, 40, 54 },
+            /* 11 */ { 2, 10, 268, 87, 21, 115, 7, 129, 165, 40, 53 },
+            /* 12 */ { 2, 10, 267, 92, 21, 114, 7, 128, 163, 40, 53 },
+            /* 13 */ { 2, 10, 268, 94, 21, 115, 7, 129, 162, 40, 53 },
+            /* 14 */ { 3, 7, 127, 160, 40, 54, 13, 516, 161, 49, 74, 14, 180, 148, 37, 89 },
+            /* 15 */ { 3, 7, 127, 160, 40, 53, 14, 181, 151, 37, 91, 16, 218, 111, 40, 53 },
+            /* 16 */ { 6, 7, 126, 158, 40, 53, 14, 183, 153, 37, 90, 16, 214, 114, 39, 52, 17, 79, 151, 51, 87, 10, 271, 105, 21, 116, 13, 526, 157, 49, 73 },
+            /* 17 */ { 4, 7, 127, 156, 40, 53, 14, 185, 155, 37, 91, 17, 74, 152, 51, 88, 13, 531, 153, 48, 72 },
+            /* 18 */ { 6, 14, 187, 158, 37, 91, 17, 70, 154, 51, 87, 13, 535, 150, 48, 72, 18, 297, 68, 23, 64, 10, 272, 111, 21, 114, 16, 207, 118, 39, 52 },
+            /* 19 */ { 6, 14, 188, 160, 37, 91, 17, 66, 156, 50, 86, 13, 539, 148, 48, 72, 18, 298, 65, 23, 63, 10, 274, 115, 21, 114, 16, 202, 120, 39, 52 },
+            /* 20 */ { 8, 14, 190, 163, 37, 90, 17, 62, 158, 50, 86, 13, 544, 146, 49, 73, 18, 297, 62, 23, 64, 10, 272, 119, 21, 114, 16, 198, 120, 40, 53, 19, 69, 145, 57, 84, 7, 125, 153, 41, 55 },
+            /* 21 */ { 5, 17, 57, 160, 50, 87, 18, 296, 58, 23, 62, 10, 272, 123, 21, 115, 19, 66, 142, 58, 86, 7, 125, 152, 41, 54 },
+            /* 22 */ { 6, 17, 54, 161, 50, 87, 18, 295, 55, 23, 62, 19, 63, 139, 57, 85, 7, 125, 151, 41, 54, 14, 194, 168, 37, 92, 16, 193, 124, 40, 53 },
+            /* 23 */ { 6, 17, 51, 164, 51, 88, 18, 293, 52, 22, 62, 7, 125, 151, 40, 53, 14, 193, 170, 37, 91, 16, 190, 125, 40, 53, 10, 275, 130, 21, 116 },
+            /* 24 */ { 6, 17, 47, 166, 51, 87, 7, 125, 149, 41, 54, 14, 194, 174, 36, 90, 16, 185, 126, 40, 53, 10, 275, 135, 21, 115, 19, 56, 135, 57, 85 },
+            /* 25 */ { 6, 17, 44, 166, 51, 87, 7, 123, 149, 41, 54, 14, 197, 176, 36, 90, 16, 182, 127, 39, 52, 10, 276, 138, 21, 115, 19, 52, 132, 57, 85 },
+            /* 26 */ { 5, 17, 39, 169, 50, 86, 7, 123, 148, 40, 53, 16, 179, 130, 39, 51, 10, 276, 141, 22, 116, 19, 48, 131, 57, 85 },
+            /* 27 */ { 5, 17, 36, 170, 51, 87, 7, 123, 146, 41, 54, 10, 276, 146, 22, 116, 19, 46, 129, 57, 85, 14, 200, 182, 36, 91 },
+            /* 28 */ { 6, 17, 33, 171, 51, 88, 7, 123, 145, 41, 53, 10, 277, 148, 21, 115, 19, 43, 126, 57, 85, 14, 202, 183, 36, 90, 16, 172, 132, 39, 52 },
+            /* 29 */ { 5, 17, 29, 174, 51, 87, 10, 278, 153, 21, 114, 19, 40, 124, 57, 85, 14, 203, 186, 36, 89, 16, 168, 134, 40, 53 },
+            /* 30 */ { 5, 17, 24, 176, 50, 86, 10, 278, 156, 21, 113, 19, 37, 121, 57, 85, 14, 204, 189, 36, 90, 16, 164, 136, 39, 52 },
+            /* 31 */ { 6, 17, 20, 177, 50, 86, 10, 279, 159, 22, 114, 19, 34, 120, 58, 86, 14, 206, 191, 36, 90, 16, 160, 136, 39, 52, 7, 121, 141, 40, 52 },
+            /* 32 */ { 4, 10, 280, 163, 22, 114, 19, 30, 116, 57, 85, 16, 157, 139, 40, 53, 7, 121, 141, 40, 53 },
+            /* 33 */ { 5, 10, 280, 166, 22, 114, 19, 26, 115, 57, 86, 16, 154, 141, 39, 52, 7, 121, 139, 40, 52, 14, 209, 197, 36, 90 },
+            /* 34 */ { 3, 10, 282, 170, 22, 114, 19, 22, 114, 57, 86, 14, 210, 199, 36, 90 },
+            /* 35 */ { 4, 10, 282, 173, 22, 115, 19, 19, 111, 57, 86, 14, 211, 201, 36, 91, 7, 120, 138, 40, 53 },
+            /* 36 */ { 5, 10, 283, 178, 22, 116, 19, 17, 109, 57, 85, 14, 212, 205, 36, 90, 7, 119, 138, 41, 54, 16, 142, 147, 39, 51 },
+            /* 37 */ { 5, 10, 282, 180, 22, 115, 19, 14, 106, 56, 85, 14, 213, 207, 36, 91, 7, 119, 136, 41, 54, 16, 139, 147, 39, 52 },
+            /* 38 */ { 4, 10, 283, 184, 21, 114, 19, 10, 102, 56, 84, 14, 215, 210, 36, 90, 16, 135, 149, 40, 53 },
+            /* 39 */ { 2, 10, 284, 187, 22, 114, 19, 6, 102, 56, 85 },
+        },
+        {
+            /* 0 */ { 1, 20, 330, 21, 63, 108 },
+            /* 1 */ { 1, 20, 334, 20, 63, 108 },
+            /* 2 */ { 0 },
+            /* 3 */ { 1, 20, 337, 18, 63, 108 },
+            /* 4 */ { 1, 20, 337, 17, 63, 107 },
+            /* 5 */ { 2, 20, 338, 16, 62, 106, 22, 27, 237, 54, 117 },
+            /* 6 */ { 2, 20, 340, 16, 63, 107, 22, 27, 239, 54, 119 },
+            /* 7 */ { 1, 20, 340, 14, 62, 107 },
+            /* 8 */ { 2, 20, 343, 12, 62, 106, 22, 28, 240, 54, 118 },
+            /* 9 */ { 2, 20, 345, 12, 63, 107, 22, 30, 243, 54, 119 },
+            /* 10 */ { 2, 20, 346, 10, 62, 106, 22, 31, 244, 55, 120 },
+            /* 11 */ { 1, 22, 32, 246, 54, 119 },
+            /* 12 */ { 1, 22, 32, 246, 54, 119 },
+            /* 13 */ { 1, 20, 349, 7, 63, 108 },
+            /* 14 */ { 2, 25, 453, 92, 37, 67, 20, 351, 6, 63, 108 },
+            /* 15 */ { 2, 25, 458, 95, 38, 69, 20, 353, 5, 63, 107 },
+            /* 16 */ { 1, 25, 466, 98, 38, 69 },
+            /* 17 */ { 2, 25, 472, 99, 37, 68, 26, 237, 124, 63, 88 },
+            /* 18 */ { 2, 25, 478, 102, 37, 68, 26, 240, 125, 63, 87 },
+            /* 19 */ { 1, 26, 244, 125, 63, 87 },
+            /* 20 */ { 2, 26, 247, 125, 62, 87, 28, 553, 120, 75, 42 },
+            /* 21 */ { 3, 26, 251, 126, 62, 87, 28, 552, 119, 74, 41, 25, 498, 107, 38, 69 },
+            /* 22 */ { 2, 26, 252, 126, 62, 87, 28, 551, 116, 76, 43 },
+            /* 23 */ { 3, 26, 257, 126, 63, 88, 28, 550, 114, 77, 43, 25, 509, 109, 38, 69 },
+            /* 24 */ { 2, 28, 550, 112, 77, 43, 25, 514, 112, 37, 68 },
+            /* 25 */ { 3, 28, 552, 112, 74, 41, 25, 520, 114, 37, 69, 26, 263, 125, 62, 87 },
+            /* 26 */ { 3, 28, 548, 109, 76, 42, 25, 527, 115, 37, 68, 26, 267, 127, 63, 88 },
+            /* 27 */ { 3, 28, 549, 108, 75, 42, 25, 533, 118, 37, 68, 26, 270, 126, 62, 87 },
+            /* 28 */ { 3, 28, 549, 106, 75, 42, 25, 539, 119, 37, 69, 26, 275, 126, 62, 86 },
+            /* 29 */ { 3, 28, 548, 104, 73, 41, 25, 544, 122, 37, 68, 26, 278, 126, 62, 86 },
+            /* 30 */ { 2, 28, 549, 102, 72, 40, 25, 550, 123, 37, 69 },
+            /* 31 */ { 1, 28, 547, 100, 72, 40 },
+            /* 32 */ { 2, 28, 546, 100, 75, 42, 25, 563, 127, 37, 69 },
+            /* 33 */ { 2, 28, 547, 98, 74, 41, 25, 570, 128, 36, 68 },
+            /* 34 */ { 1, 28, 546, 97, 74, 42 },
+            /* 35 */ { 1, 28, 546, 94, 74, 41 },
+            /* 36 */ { 2, 28, 544, 93, 74, 42, 25, 588, 134, 36, 68 },
+            /* 37 */ { 2, 28, 545, 91, 74, 41, 25, 595, 137, 37, 69 },
+            /* 38 */ { 2, 28, 544, 88, 75, 42, 25, 601, 139, 37, 68 },
+            /* 39 */ { 2, 28, 542, 88, 75, 42, 25, 607, 140, 37, 68 },
+        },
+    };
+
+    void print_scenes() {
+        for (auto& s: scenes) {
+            std::cout << "scene " << s.seed << std::endl;
+            int f = 0;
+            for (auto& r: run_scene(s)) {
+                std::cout << "            /* " << f++ << " */ {";
+                for (size_t i = 0; i < r.size(); i++) {
+                    std::cout << (i == 0 ? " " : ", ") << r[i];
+                }
+                std::cout << " }," << std::endl;
+            }
+        }
+    }
+
+    // ids exact, boxes within a pixel, floating point contraction differs between compilers and targets
+    void scenes_match_recorded() {
+        for (size_t n = 0; n < sizeof(scenes) / sizeof(scenes[0]); n++) {
+            auto results = run_scene(scenes[n]);
+            auto& want = expected[n];
+            check(results.size() == want.size(), "scene " + std::to_string(scenes[n].seed) + " frame count");
+            for (size_t f = 0; f < std::min(results.size(), want.size()); f++) {
+                auto what = "scene " + std::to_string(scenes[n].seed) + " frame " + std::to_string(f);
+                auto& got = results[f];
+                auto& exp = want[f];
+                if (got.size() != exp.size() || got[0] != exp[0]) {
+                    check(false, what + " track count " + std::to_string(got[0]) + ", expected " + std::to_string(exp[0]));
+                    continue;
+                }
+                for (size_t i = 1; i < got.size(); i += 5) {
+                    check(got[i] == exp[i], what + " track id " + std::to_string(got[i]) + ", expected " + std::to_string(exp[i]));
+                    bool box_ok = true;
+                    for (int k = 1; k < 5; k++) {
+                        box_ok = box_ok && std::abs(got[i + k] - exp[i + k]) <= 1;
+                    }
+                    check(box_ok, what + " box of track " + std::to_string(got[i]));
+                }
+            }
+        }
+    }
+
+    // cost matrix n of the Hungarian checks, rows x cols with 0 to 6 of each, like 1 - IoU of SORT: values in [0, 1].
+    // tied costs (no overlap) when ties is set, which is where solvers may pick different assignments of equal cost.
+    std::vector<std::vector<double>> hungarian_matrix(unsigned n, bool ties) {
+        std::mt19937 rng(1000 + n);
+        int rows = rng() % 7;
+        int cols = rng() % 7;
+        std::vector<std::vector<double>> m(rows, std::vector<double>(cols));
+        for (auto& row: m) {
+            for (auto& v: row) {
+                v = ties ? (rng() % 2 == 0 ? 1.0 : (rng() % 4) * 0.25) : uniform(rng, 0, 1);
+            }
+        }
+        return m;
+    }
+
+    // lowest cost of assigning min(rows, cols) pairs, trying all of them
+    double brute_force_cost(const std::vector<std::vector<double>>& m, size_t row, int left, std::vector<uint8_t>& used) {
+        if (left == 0) {
+            return 0;
+        }
+        if (m.size() - row < (size_t)left) {
+            return 1e30;
+        }
+        double best = brute_force_cost(m, row + 1, left, used);
+        for (size_t col = 0; col < used.size(); col++) {
+            if (!used[col]) {
+                used[col] = 1;
+                best = std::min(best, m[row][col] + brute_force_cost(m, row + 1, left - 1, used));
+                used[col] = 0;
+            }
+        }
+        return best;
+    }
+
+    // checks an assignment of m: one column per row at most, each column used once, min(rows, cols) pairs, lowest cost
+    void check_assignment(const std::vector<std::vector<double>>& m, const std::vector<int>& assignment, double cost,
+        const std::string& what) {
+        int rows = (int)m.size();
+        int cols = rows == 0 ? 0 : (int)m[0].size();
+        if ((int)assignment.size() != rows) {
+            check(false, what + " assignment size " + std::to_string(assignment.size()));
+            return;
+        }
+        std::vector<uint8_t> used(cols, 0);
+        int pairs = 0;
+        double sum = 0;
+        for (int i = 0; i < rows; i++) {
+            int col = assignment[i];
+            if (col < 0) {
+                continue;
+            }
+            if (col >= cols || used[col]) {
+                check(false, what + " row " + std::to_string(i) + " assigned to column " + std::to_string(col));
+                return;
+            }
+            used[col] = 1;
+            pairs++;
+            sum += m[i][col];
+        }
+        check(pairs == std::min(rows, cols), what + " assigned " + std::to_string(pairs) + " pairs");
+        std::vector<uint8_t> free_cols(cols, 0);
+        double best = brute_force_cost(m, 0, std::min(rows, cols), free_cols);
+        check(std::fabs(sum - best) < 1e-9 && std::fabs(cost - best) < 1e-9, what + " cost " + std::to_string(cost)
+            + ", lowest " + std::to_string(best));
+    }
+
+    // matrices 0 to k_tied_matrices - 1 have tied costs, the others random costs
+    constexpr unsigned k_tied_matrices = 40;
+
+    // assignments of the matrices with tied costs given by the solver before it kept its working arrays,
+    // rows of the matrix first, then the column of each row
+    const std::vector<int> tied_assignments[k_tied_matrices] = {
+        /* 0 */ { 6, -1, -1, -1, -1, -1, -1 },
+        /* 1 */ { 2, 2, 0 },
+        /* 2 */ { 5, 0, 3, -1, 1, 2 },
+        /* 3 */ { 5, -1, -1, -1, -1, -1 },
+        /* 4 */ { 6, 0, 1, -1, -1, -1, -1 },
+        /* 5 */ { 6, 1, 0, 2, -1, -1, -1 },
+        /* 6 */ { 4, 1, 2, 0, -1 },
+        /* 7 */ { 2, 0, 4 },
+        /* 8 */ { 5, 1, 0, 3, 4, 2 },
+        /* 9 */ { 3, -1, -1, -1 },
+        /* 10 */ { 2, 0, -1 },
+        /* 11 */ { 2, -1, -1 },
+        /* 12 */ { 0 },
+        /* 13 */ { 2, 3, 1 },
+        /* 14 */ { 4, -1, -1, -1, -1 },
+        /* 15 */ { 0 },
+        /* 16 */ { 4, 3, 1, 2, 0 },
+        /* 17 */ { 0 },
+        /* 18 */ { 6, 0, 2, 1, 3, -1, -1 },
+        /* 19 */ { 6, 2, 1, -1, 3, -1, 0 },
+        /* 20 */ { 0 },
+        /* 21 */ { 4, 0, 1, 2, -1 },
+        /* 22 */ { 0 },
+        /* 23 */ { 2, 0, -1 },
+        /* 24 */ { 4, 0, -1, -1, -1 },
+        /* 25 */ { 4, -1, -1, -1, -1 },
+        /* 26 */ { 0 },
+        /* 27 */ { 3, 0, 1, 4 },
+        /* 28 */ { 4, 0, -1, -1, -1 },
+        /* 29 */ { 5, -1, -1, 0, -1, 1 },
+        /* 30 */ { 4, 1, 0, 2, -1 },
+        /* 31 */ { 5, 0, 2, 3, 1, -1 },
+        /* 32 */ { 3, 0, -1, -1 },
+        /* 33 */ { 1, 2 },
+        /* 34 */ { 2, 0, 3 },
+        /* 35 */ { 0 },
+        /* 36 */ { 5, -1, -1, -1, -1, -1 },
+        /* 37 */ { 3, -1, -1, -1 },
+        /* 38 */ { 5, -1, 1, 0, -1, 2 },
+        /* 39 */ { 1, 0 },
+    };
+
+    void print_tied_assignments() {
+        HungarianAlgorithm hungarian;
+        std::vector<int> assignment;
+        for (unsigned n = 0; n < k_tied_matrices; n++) {
+            auto m = hungarian_matrix(n, true);
+            hungarian.Solve(m, assignment);
+            std::cout << "        /* " << n << " */ { " << m.size();
+            for (auto col: assignment) {
+                std::cout << ", " << col;
+            }
+            std::cout << " }," << std::endl;
+        }
+    }
+
+    // both entry points against each other and against the lowest cost, one solver for all sizes as in
+    // vp_sort_track_node, so working arrays left from a bigger matrix are reused for smaller ones
+    void hungarian_matches_previous() {
+        HungarianAlgorithm hungarian;
+        std::vector<int> by_rows, flat_assignment;
+        std::vector<double> flat;
+        for (unsigned n = 0; n < 400; n++) {
+            bool ties = n < k_tied_matrices;
+            auto m = hungarian_matrix(n, ties);
+            auto what = std::string(ties ? "tied" : "random") + " matrix " + std::to_string(n);
+            int rows = (int)m.size();
+            int cols = rows == 0 ? 0 : (int)m[0].size();
+            flat.resize(rows * cols);
+            for (int i = 0; i < rows; i++) {
+                for (int j = 0; j < cols; j++) {
+                    flat[i + rows * j] = m[i][j];
+                }
+            }
+
+            double cost = hungarian.Solve(m, by_rows);
+            double flat_cost = hungarian.Solve(flat.data(), rows, cols, flat_assignment);
+            check(by_rows == flat_assignment && cost == flat_cost, what + " differs between entry points");
+            check_assignment(m, by_rows, cost, what);
+            if (ties) {
+                std::vector<int> got{ rows };
+                got.insert(got.end(), by_rows.begin(), by_rows.end());
+                check(got == tied_assignments[n], what + " assignment differs from the previous solver");
+            }
+        }
+    }
+
+    // no tracks or no detections
+    void hungarian_empty() {
+        HungarianAlgorithm hungarian;
+        std::vector<int> assignment{ 7, 7 };
+        std::vector<std::vector<double>> no_rows;
+        check(hungarian.Solve(no_rows, assignment) == 0 && assignment.empty(), "no rows");
+
+        std::vector<std::vector<double>> no_cols(3);
+        check(hungarian.Solve(no_cols, assignment) == 0 && assignment == std::vector<int>(3, -1), "no columns");
+
+        // after a real matrix, so the working arrays are not empty
+        auto m = hungarian_matrix(0, false);
+        hungarian.Solve(m, assignment);
+        check(hungarian.Solve(nullptr, 0, 4, assignment) == 0 && assignment.empty(), "no rows after a matrix");
+        check(hungarian.Solve(nullptr, 2, 0, assignment) == 0 && assignment == std::vector<int>(2, -1),
+            "no columns after a matrix");
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--print") == 0) {
+        print_scenes();
+        print_tied_assignments();
+        return 0;
+    }
+    scenes_match_recorded();
+    hungarian_matches_previous();
+    hungarian_empty();
+
+    std::cout << (failures == 0 ? "all checks passed" : std::to_string(failures) + " check(s) failed") << std::endl;
+    return failures;
+}
@@ -16,88 +16,87 @@ BYTETracker::~BYTETracker()
 {
 }
 
-vector<STrack> BYTETracker::update(const vector<DetectionResult>& objects)
+const vector<STrack>& BYTETracker::update(const vector<DetectionResult>& objects, const float *warp)
 {
 
 	////////////////// Step 1: Get detections //////////////////
 	this->frame_id++;
-	vector<STrack> activated_stracks;
-	vector<STrack> refind_stracks;
-	vector<STrack> removed_stracks;
-	vector<STrack> lost_stracks;
-	vector<STrack> detections;
-	vector<STrack> detections_low;
-
-	vector<STrack> detections_cp;
-	vector<STrack> tracked_stracks_swap;
-	vector<STrack> resa, resb;
-	vector<STrack> output_stracks;
-
-	vector<STrack*> unconfirmed;
-	vector<STrack*> tracked_stracks;
-	vector<STrack*> strack_pool;
-	vector<STrack*> r_tracked_stracks;
-
-	if (objects.size() > 0)
-	{
-		for (int i = 0; i < objects.size(); i++)
+	activated_stracks.clear();
+	refind_stracks.clear();
+	lost_now.clear();
+	removed_now.clear();
+	detections.clear();
+	detections_low.clear();
+	detections_cp.clear();
+	tracked_stracks_swap.clear();
+	unconfirmed.clear();
+	strack_pool.clear();
+	r_tracked_stracks.clear();
+
+	// detections are referred by their index in objects
+	det_tlwh.resize(objects.size() * 4);
+	det_tlbr.resize(objects.size() * 4);
+	for (int i = 0; i < objects.size(); i++)
+	{
+		float *tlwh = &det_tlwh[i * 4];
+		float *tlbr = &det_tlbr[i * 4];
+		tlwh[0] = objects[i].box.top;
+		tlwh[1] = objects[i].box.left;
+		tlwh[2] = objects[i].box.bottom;
+		tlwh[3] = objects[i].box.right;
+		tlwh[2] -= tlwh[0];
+		tlwh[3] -= tlwh[1];
+
+		tlbr[0] = tlwh[0];
+		tlbr[1] = tlwh[1];
+		tlbr[2] = tlwh[2] + tlwh[0];
+		tlbr[3] = tlwh[3] + tlwh[1];
+
+		if (objects[i].score >= track_thresh)
+		{
+			detections.push_back(i);
+		}
+		else
 		{
-			vector<float> tlbr_;
-			tlbr_.resize(4);
-			tlbr_[0] = objects[i].box.top;
-			tlbr_[1] = objects[i].box.left;
-			tlbr_[2] = objects[i].box.bottom;
-			tlbr_[3] = objects[i].box.right;
-
-			float score = objects[i].score;
-			std::string label = objects[i].label;
-
-			STrack strack(STrack::tlbr_to_tlwh(tlbr_), score, label);
-			if (score >= track_thresh)
-			{
-				detections.push_back(strack);
-			}
-			else
-			{
-				detections_low.push_back(strack);
-			}
+			detections_low.push_back(i);
 		}
 	}
 
 	// Add newly detected tracklets to tracked_stracks
 	for (int i = 0; i < this->tracked_stracks.size(); i++)
 	{
-		if (!this->tracked_stracks[i].is_activated)
-			unconfirmed.push_back(&this->tracked_stracks[i]);
+		int slot = this->tracked_stracks[i];
+		if (!pool.is_activated[slot])
+			unconfirmed.push_back(slot);
 		else
-			tracked_stracks.push_back(&this->tracked_stracks[i]);
+			strack_pool.push_back(slot);
 	}
 
 	////////////////// Step 2: First association, with IoU //////////////////
-	strack_pool = joint_stracks(tracked_stracks, this->lost_stracks);
-	STrack::multi_predict(strack_pool, this->kalman_filter);
-
-	vector<vector<float>> dists;
-	int dist_size = 0, dist_size_size = 0;
-	dists = iou_distance(strack_pool, detections, dist_size, dist_size_size);
+	joint_stracks(strack_pool, this->lost_stracks);
+	pool.multi_predict(strack_pool, this->kalman_filter);
+	if (warp != nullptr)
+	{
+		pool.multi_gmc(strack_pool, warp);
+		pool.multi_gmc(unconfirmed, warp);
+	}
 
-	vector<vector<int>> matches;
-	vector<int> u_track, u_detection;
-	linear_assignment(dists, dist_size, dist_size_size, match_thresh, matches, u_track, u_detection);
+	iou_distance(pool.tlbr.data(), strack_pool, det_tlbr.data(), detections);
+	linear_assignment(strack_pool.size(), detections.size(), match_thresh, matches, u_track, u_detection);
 
 	for (int i = 0; i < matches.size(); i++)
 	{
-		STrack *track = strack_pool[matches[i][0]];
-		STrack *det = &detections[matches[i][1]];
-		if (track->state == TrackState::Tracked)
+		int track = strack_pool[matches[i].first];
+		int det = detections[matches[i].second];
+		if (pool.state[track] == TrackState::Tracked)
 		{
-			track->update(*det, this->frame_id);
-			activated_stracks.push_back(*track);
+			pool.update(track, det, &det_tlwh[det * 4], objects[det].score, objects[det].label, this->kalman_filter, this->frame_id);
+			activated_stracks.push_back(track);
 		}
 		else
 		{
-			track->re_activate(*det, this->frame_id, false);
-			refind_stracks.push_back(*track);
+			pool.re_activate(track, det, &det_tlwh[det * 4], objects[det].score, objects[det].label, this->kalman_filter, this->frame_id, false);
+			refind_stracks.push_back(track);
 		}
 	}
 
@@ -106,136 +105,145 @@ vector<STrack> BYTETracker::update(const vector<DetectionResult>& objects)
 	{
 		detections_cp.push_back(detections[u_detection[i]]);
 	}
-	detections.clear();
-	detections.assign(detections_low.begin(), detections_low.end());
-	
+
 	for (int i = 0; i < u_track.size(); i++)
 	{
-		if (strack_pool[u_track[i]]->state == TrackState::Tracked)
+		if (pool.state[strack_pool[u_track[i]]] == TrackState::Tracked)
 		{
 			r_tracked_stracks.push_back(strack_pool[u_track[i]]);
 		}
 	}
 
-	dists.clear();
-	dists = iou_distance(r_tracked_stracks, detections, dist_size, dist_size_size);
-
-	matches.clear();
-	u_track.clear();
-	u_detection.clear();
-	linear_assignment(dists, dist_size, dist_size_size, 0.5, matches, u_track, u_detection);
+	iou_distance(pool.tlbr.data(), r_tracked_stracks, det_tlbr.data(), detections_low);
+	linear_assignment(r_tracked_stracks.size(), detections_low.size(), 0.5, matches, u_track, u_detection);
 
 	for (int i = 0; i < matches.size(); i++)
 	{
-		STrack *track = r_tracked_stracks[matches[i][0]];
-		STrack *det = &detections[matches[i][1]];
-		if (track->state == TrackState::Tracked)
+		int track = r_tracked_stracks[matches[i].first];
+		int det = detections_low[matches[i].second];
+		if (pool.state[track] == TrackState::Tracked)
 		{
-			track->update(*det, this->frame_id);
-			activated_stracks.push_back(*track);
+			pool.update(track, det, &det_tlwh[det * 4], objects[det].score, objects[det].label, this->kalman_filter, this->frame_id);
+			activated_stracks.push_back(track);
 		}
 		else
 		{
-			track->re_activate(*det, this->frame_id, false);
-			refind_stracks.push_back(*track);
+			pool.re_activate(track, det, &det_tlwh[det * 4], objects[det].score, objects[det].label, this->kalman_filter, this->frame_id, false);
+			refind_stracks.push_back(track);
 		}
 	}
 
 	for (int i = 0; i < u_track.size(); i++)
 	{
-		STrack *track = r_tracked_stracks[u_track[i]];
-		if (track->state != TrackState::Lost)
+		int track = r_tracked_stracks[u_track[i]];
+		if (pool.state[track] != TrackState::Lost)
 		{
-			track->mark_lost();
-			lost_stracks.push_back(*track);
+			pool.mark_lost(track);
+			lost_now.push_back(track);
 		}
 	}
 
 	// Deal with unconfirmed tracks, usually tracks with only one beginning frame
-	detections.clear();
-	detections.assign(detections_cp.begin(), detections_cp.end());
-
-	dists.clear();
-	dists = iou_distance(unconfirmed, detections, dist_size, dist_size_size);
-
-	matches.clear();
-	vector<int> u_unconfirmed;
-	u_detection.clear();
-	linear_assignment(dists, dist_size, dist_size_size, 0.7, matches, u_unconfirmed, u_detection);
+	iou_distance(pool.tlbr.data(), unconfirmed, det_tlbr.data(), detections_cp);
+	linear_assignment(unconfirmed.size(), detections_cp.size(), 0.7, matches, u_unconfirmed, u_detection);
 
 	for (int i = 0; i < matches.size(); i++)
 	{
-		unconfirmed[matches[i][0]]->update(detections[matches[i][1]], this->frame_id);
-		activated_stracks.push_back(*unconfirmed[matches[i][0]]);
+		int track = unconfirmed[matches[i].first];
+		int det = detections_cp[matches[i].second];
+		pool.update(track, det, &det_tlwh[det * 4], objects[det].score, objects[det].label, this->kalman_filter, this->frame_id);
+		activated_stracks.push_back(track);
 	}
 
 	for (int i = 0; i < u_unconfirmed.size(); i++)
 	{
-		STrack *track = unconfirmed[u_unconfirmed[i]];
-		track->mark_removed();
-		removed_stracks.push_back(*track);
+		int track = unconfirmed[u_unconfirmed[i]];
+		pool.mark_removed(track);
+		removed_now.push_back(track);
 	}
 
 	////////////////// Step 4: Init new stracks //////////////////
 	for (int i = 0; i < u_detection.size(); i++)
 	{
-		STrack *track = &detections[u_detection[i]];
-		if (track->score < this->high_thresh)
+		int det = detections_cp[u_detection[i]];
+		if (objects[det].score < this->high_thresh)
 			continue;
-		track->activate(this->kalman_filter, this->frame_id);
-		activated_stracks.push_back(*track);
+		int track = pool.acquire(det, &det_tlwh[det * 4], objects[det].score, objects[det].label);
+		pool.activate(track, this->kalman_filter, this->frame_id);
+		activated_stracks.push_back(track);
 	}
 
 	////////////////// Step 5: Update state //////////////////
 	for (int i = 0; i < this->lost_stracks.size(); i++)
 	{
-		if (this->frame_id - this->lost_stracks[i].end_frame() > this->max_time_lost)
+		int track = this->lost_stracks[i];
+		if (this->frame_id - pool.frame_id[track] > this->max_time_lost)
 		{
-			this->lost_stracks[i].mark_removed();
-			removed_stracks.push_back(this->lost_stracks[i]);
+			pool.mark_removed(track);
+			removed_now.push_back(track);
 		}
 	}
-	
+
 	for (int i = 0; i < this->tracked_stracks.size(); i++)
 	{
-		if (this->tracked_stracks[i].state == TrackState::Tracked)
+		if (pool.state[this->tracked_stracks[i]] == TrackState::Tracked)
 		{
 			tracked_stracks_swap.push_back(this->tracked_stracks[i]);
 		}
 	}
-	this->tracked_stracks.clear();
-	this->tracked_stracks.assign(tracked_stracks_swap.begin(), tracked_stracks_swap.end());
+	this->tracked_stracks.swap(tracked_stracks_swap);
 
-	this->tracked_stracks = joint_stracks(this->tracked_stracks, activated_stracks);
-	this->tracked_stracks = joint_stracks(this->tracked_stracks, refind_stracks);
+	joint_stracks(this->tracked_stracks, activated_stracks);
+	joint_stracks(this->tracked_stracks, refind_stracks);
 
-	//std::cout << activated_stracks.size() << std::endl;
+	sub_stracks(this->lost_stracks, this->tracked_stracks);
+	this->lost_stracks.insert(this->lost_stracks.end(), lost_now.begin(), lost_now.end());
 
-	this->lost_stracks = sub_stracks(this->lost_stracks, this->tracked_stracks);
-	for (int i = 0; i < lost_stracks.size(); i++)
+	// tracks removed at earlier frames leave lost list, the ones removed at this frame stay for one more frame
+	int kept = 0;
+	for (int i = 0; i < this->lost_stracks.size(); i++)
 	{
-		this->lost_stracks.push_back(lost_stracks[i]);
+		int track = this->lost_stracks[i];
+		if (pool.removed_frame[track] < 0)
+		{
+			this->lost_stracks[kept++] = track;
+		}
+	}
+	this->lost_stracks.resize(kept);
+	sort_by_track_id(this->lost_stracks);
+	for (int i = 0; i < removed_now.size(); i++)
+	{
+		if (pool.removed_frame[removed_now[i]] < 0)
+		{
+			pool.removed_frame[removed_now[i]] = this->frame_id;
+		}
 	}
 
-	this->lost_stracks = sub_stracks(this->lost_stracks, this->removed_stracks);
-	for (int i = 0; i < removed_stracks.size(); i++)
+	remove_duplicate_stracks(this->tracked_stracks, this->lost_stracks);
+
+	// tracks in neither list are gone
+	mark_slots(this->tracked_stracks);
+	for (int i = 0; i < this->lost_stracks.size(); i++)
 	{
-		this->removed_stracks.push_back(removed_stracks[i]);
+		slot_marks[this->lost_stracks[i]] = mark_stamp;
+	}
+	for (int slot = 0; slot < pool.capacity(); slot++)
+	{
+		if (pool.live[slot] && !is_marked(slot))
+		{
+			pool.release(slot);
+		}
 	}
-	
-	remove_duplicate_stracks(resa, resb, this->tracked_stracks, this->lost_stracks);
 
-	this->tracked_stracks.clear();
-	this->tracked_stracks.assign(resa.begin(), resa.end());
-	this->lost_stracks.clear();
-	this->lost_stracks.assign(resb.begin(), resb.end());
-	
+	output_stracks.resize(this->tracked_stracks.size());
+	int outputs = 0;
 	for (int i = 0; i < this->tracked_stracks.size(); i++)
 	{
-		if (this->tracked_stracks[i].is_activated)
+		if (pool.is_activated[this->tracked_stracks[i]])
 		{
-			output_stracks.push_back(this->tracked_stracks[i]);
+			pool.snapshot(this->tracked_stracks[i], this->frame_id, output_stracks[outputs++]);
 		}
 	}
+	output_stracks.resize(outputs);
 	return output_stracks;
-}
\ No newline at end of file
+}
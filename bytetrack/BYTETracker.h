@@ -1,5 +1,6 @@
 #pragma once  //避免头文件重复包含
 
+#include <utility>
 #include "STrack.h"
 #include "config.h"
 
@@ -9,24 +10,26 @@ public:
 	BYTETracker(int frame_rate = 30, int track_buffer = 30);
 	~BYTETracker();
 
-	vector<STrack> update(const vector<DetectionResult>& objects);
+	// activated tracks at this frame, the returned buffer is reused (valid until next update).
+	// STrack::det_index tells which of objects each track was matched to.
+	// warp is the camera motion from the previous frame (2x3 affine, row major), predicted tracks are moved by it
+	// before association. nullptr if the camera is still or the motion is unknown.
+	const vector<STrack>& update(const vector<DetectionResult>& objects, const float *warp = nullptr);
 	cv::Scalar get_color(int idx);
 
 private:
-	vector<STrack*> joint_stracks(vector<STrack*> &tlista, vector<STrack> &tlistb);
-	vector<STrack> joint_stracks(vector<STrack> &tlista, vector<STrack> &tlistb);
+	// association steps work on lists of slots (tracks) or of detection indexes, in place
+	void joint_stracks(vector<int> &tlista, const vector<int> &tlistb);
+	void sub_stracks(vector<int> &tlista, const vector<int> &tlistb);
+	void sort_by_track_id(vector<int> &tlist);
+	void remove_duplicate_stracks(vector<int> &stracksa, vector<int> &stracksb);
 
-	vector<STrack> sub_stracks(vector<STrack> &tlista, vector<STrack> &tlistb);
-	void remove_duplicate_stracks(vector<STrack> &resa, vector<STrack> &resb, vector<STrack> &stracksa, vector<STrack> &stracksb);
-
-	void linear_assignment(vector<vector<float> > &cost_matrix, int cost_matrix_size, int cost_matrix_size_size, float thresh,
-		vector<vector<int> > &matches, vector<int> &unmatched_a, vector<int> &unmatched_b);
-	vector<vector<float> > iou_distance(vector<STrack*> &atracks, vector<STrack> &btracks, int &dist_size, int &dist_size_size);
-	vector<vector<float> > iou_distance(vector<STrack> &atracks, vector<STrack> &btracks);
-	vector<vector<float> > ious(vector<vector<float> > &atlbrs, vector<vector<float> > &btlbrs);
-
-	double lapjv(const vector<vector<float> > &cost, vector<int> &rowsol, vector<int> &colsol, 
-		bool extend_cost = false, float cost_limit = LONG_MAX, bool return_cost = true);
+	void linear_assignment(int rows, int cols, float thresh,
+		vector<pair<int, int> > &matches, vector<int> &unmatched_a, vector<int> &unmatched_b);
+	// 1 - IoU of boxes a[i] and b[j] (tlbr, 4 floats per index) into dists, rows of a, cols of b
+	void iou_distance(const float *atlbrs, const vector<int> &a, const float *btlbrs, const vector<int> &b);
+	// solve dists (rows x cols) extended with cost_limit / 2, result in rowsol / colsol
+	void lapjv(int rows, int cols, float cost_limit);
 
 private:
 
@@ -36,8 +39,48 @@ private:
 	int frame_id;
 	int max_time_lost;
 
-	vector<STrack> tracked_stracks;
-	vector<STrack> lost_stracks;
-	vector<STrack> removed_stracks;
+	STrackPool pool;
+	// slots of tracks
+	vector<int> tracked_stracks;
+	vector<int> lost_stracks;
 	byte_kalman::KalmanFilter kalman_filter;
-};
\ No newline at end of file
+
+	/* per update scratch, kept to reuse memory */
+	// detections, 4 floats per index of input
+	vector<float> det_tlwh;
+	vector<float> det_tlbr;
+	vector<int> detections;
+	vector<int> detections_low;
+	vector<int> detections_cp;
+
+	vector<int> activated_stracks;
+	vector<int> refind_stracks;
+	vector<int> lost_now;
+	vector<int> removed_now;
+	vector<int> unconfirmed;
+	vector<int> strack_pool;
+	vector<int> r_tracked_stracks;
+	vector<int> tracked_stracks_swap;
+
+	vector<pair<int, int> > matches;
+	vector<int> u_track, u_detection, u_unconfirmed;
+
+	// flat cost matrix, row major
+	vector<float> dists;
+	// lapjv
+	vector<double> lap_cost;
+	vector<double*> lap_cost_rows;
+	vector<int> lap_x, lap_y;
+	vector<double> lap_workspace;
+	vector<int> rowsol, colsol;
+
+	// per slot mark for set operations on lists, a slot is in the set if its mark equals mark_stamp
+	vector<unsigned> slot_marks;
+	unsigned mark_stamp = 0;
+	vector<uint8_t> dup_marks;
+
+	vector<STrack> output_stracks;
+
+	void mark_slots(const vector<int> &slots);
+	bool is_marked(int slot) const { return slot_marks[slot] == mark_stamp; }
+};
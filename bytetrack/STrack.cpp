@@ -1,199 +1,221 @@
 #include "STrack.h"
 #include "dataType.h"
+#include <cmath>
 
-STrack::STrack(vector<float> tlwh_, float score, std::string label)
+int STrackPool::acquire(int det_index, const float *det_tlwh, float score, const std::string &label)
 {
-	_tlwh.resize(4);
-	_tlwh.assign(tlwh_.begin(), tlwh_.end());
-
-	is_activated = false;
-	track_id = 0;
-	state = TrackState::New;
-	
-	tlwh.resize(4);
-	tlbr.resize(4);
-
-	static_tlwh();
-	static_tlbr();
-	frame_id = 0;
-	tracklet_len = 0;
-	this->score = score;
-	this->label = label;
-	start_frame = 0;
+	int slot;
+	if (!free_slots.empty())
+	{
+		slot = free_slots.back();
+		free_slots.pop_back();
+	}
+	else
+	{
+		slot = capacity();
+		track_id.push_back(0);
+		state.push_back(TrackState::New);
+		is_activated.push_back(0);
+		frame_id.push_back(0);
+		tracklet_len.push_back(0);
+		start_frame.push_back(0);
+		this->det_index.push_back(-1);
+		this->score.push_back(0);
+		this->label.emplace_back();
+		tlwh.resize(tlwh.size() + 4);
+		tlbr.resize(tlbr.size() + 4);
+		mean.emplace_back();
+		covariance.emplace_back();
+		removed_frame.push_back(-1);
+		live.push_back(0);
+	}
+
+	track_id[slot] = 0;
+	state[slot] = TrackState::New;
+	is_activated[slot] = 0;
+	frame_id[slot] = 0;
+	tracklet_len[slot] = 0;
+	start_frame[slot] = 0;
+	this->det_index[slot] = det_index;
+	this->score[slot] = score;
+	this->label[slot] = label;
+	removed_frame[slot] = -1;
+	live[slot] = 1;
+	for (int k = 0; k < 4; k++)
+	{
+		tlwh[slot * 4 + k] = det_tlwh[k];
+	}
+	refresh_box(slot);
+	return slot;
 }
 
-STrack::~STrack()
+void STrackPool::release(int slot)
 {
+	live[slot] = 0;
+	free_slots.push_back(slot);
 }
 
-void STrack::activate(byte_kalman::KalmanFilter &kalman_filter, int frame_id)
+void STrackPool::activate(int slot, byte_kalman::KalmanFilter &kalman_filter, int frame_id)
 {
-	this->kalman_filter = kalman_filter;
-	this->track_id = this->next_id();
-
-	vector<float> _tlwh_tmp(4);
-	_tlwh_tmp[0] = this->_tlwh[0];
-	_tlwh_tmp[1] = this->_tlwh[1];
-	_tlwh_tmp[2] = this->_tlwh[2];
-	_tlwh_tmp[3] = this->_tlwh[3];
-	vector<float> xyah = tlwh_to_xyah(_tlwh_tmp);
+	this->track_id[slot] = next_id();
+
 	DETECTBOX xyah_box;
-	xyah_box[0] = xyah[0];
-	xyah_box[1] = xyah[1];
-	xyah_box[2] = xyah[2];
-	xyah_box[3] = xyah[3];
-	auto mc = this->kalman_filter.initiate(xyah_box);
-	this->mean = mc.first;
-	this->covariance = mc.second;
-
-	static_tlwh();
-	static_tlbr();
-
-	this->tracklet_len = 0;
-	this->state = TrackState::Tracked;
+	tlwh_to_xyah(&tlwh[slot * 4], xyah_box);
+	auto mc = kalman_filter.initiate(xyah_box);
+	mean[slot] = mc.first;
+	covariance[slot] = mc.second;
+
+	// still New here, the box stays the detection
+	refresh_box(slot);
+
+	tracklet_len[slot] = 0;
+	state[slot] = TrackState::Tracked;
 	if (frame_id == 1)
 	{
-		this->is_activated = true;
+		is_activated[slot] = 1;
 	}
-	//this->is_activated = true;
-	this->frame_id = frame_id;
-	this->start_frame = frame_id;
+	this->frame_id[slot] = frame_id;
+	start_frame[slot] = frame_id;
 }
 
-void STrack::re_activate(STrack &new_track, int frame_id, bool new_id)
+void STrackPool::re_activate(int slot, int det_index, const float *det_tlwh, float score, const std::string &label,
+	byte_kalman::KalmanFilter &kalman_filter, int frame_id, bool new_id)
 {
-	vector<float> xyah = tlwh_to_xyah(new_track.tlwh);
 	DETECTBOX xyah_box;
-	xyah_box[0] = xyah[0];
-	xyah_box[1] = xyah[1];
-	xyah_box[2] = xyah[2];
-	xyah_box[3] = xyah[3];
-	auto mc = this->kalman_filter.update(this->mean, this->covariance, xyah_box);
-	this->mean = mc.first;
-	this->covariance = mc.second;
-
-	static_tlwh();
-	static_tlbr();
-
-	this->tracklet_len = 0;
-	this->state = TrackState::Tracked;
-	this->is_activated = true;
-	this->frame_id = frame_id;
-	this->score = new_track.score;
-	this->label = new_track.label;
+	tlwh_to_xyah(det_tlwh, xyah_box);
+	auto mc = kalman_filter.update(mean[slot], covariance[slot], xyah_box);
+	mean[slot] = mc.first;
+	covariance[slot] = mc.second;
+
+	refresh_box(slot);
+
+	tracklet_len[slot] = 0;
+	state[slot] = TrackState::Tracked;
+	is_activated[slot] = 1;
+	this->frame_id[slot] = frame_id;
+	this->det_index[slot] = det_index;
+	this->score[slot] = score;
+	this->label[slot] = label;
 	if (new_id)
-		this->track_id = next_id();
+		track_id[slot] = next_id();
 }
 
-void STrack::update(STrack &new_track, int frame_id)
+void STrackPool::update(int slot, int det_index, const float *det_tlwh, float score, const std::string &label,
+	byte_kalman::KalmanFilter &kalman_filter, int frame_id)
 {
-	this->frame_id = frame_id;
-	this->tracklet_len++;
+	this->frame_id[slot] = frame_id;
+	this->det_index[slot] = det_index;
+	tracklet_len[slot]++;
 
-	vector<float> xyah = tlwh_to_xyah(new_track.tlwh);
 	DETECTBOX xyah_box;
-	xyah_box[0] = xyah[0];
-	xyah_box[1] = xyah[1];
-	xyah_box[2] = xyah[2];
-	xyah_box[3] = xyah[3];
+	tlwh_to_xyah(det_tlwh, xyah_box);
+	auto mc = kalman_filter.update(mean[slot], covariance[slot], xyah_box);
+	mean[slot] = mc.first;
+	covariance[slot] = mc.second;
 
-	auto mc = this->kalman_filter.update(this->mean, this->covariance, xyah_box);
-	this->mean = mc.first;
-	this->covariance = mc.second;
+	refresh_box(slot);
 
-	static_tlwh();
-	static_tlbr();
-
-	this->state = TrackState::Tracked;
-	this->is_activated = true;
-
-	this->score = new_track.score;
-	this->label = new_track.label;
+	state[slot] = TrackState::Tracked;
+	is_activated[slot] = 1;
 
+	this->score[slot] = score;
+	this->label[slot] = label;
 }
 
-void STrack::static_tlwh()
+void STrackPool::multi_predict(const vector<int> &slots, byte_kalman::KalmanFilter &kalman_filter)
 {
-	if (this->state == TrackState::New)
+	for (int i = 0; i < slots.size(); i++)
 	{
-		tlwh[0] = _tlwh[0];
-		tlwh[1] = _tlwh[1];
-		tlwh[2] = _tlwh[2];
-		tlwh[3] = _tlwh[3];
-		return;
+		int slot = slots[i];
+		if (state[slot] != TrackState::Tracked)
+		{
+			mean[slot][7] = 0;
+		}
+		kalman_filter.predict(mean[slot], covariance[slot]);
+		refresh_box(slot);
 	}
-
-	tlwh[0] = mean[0];
-	tlwh[1] = mean[1];
-	tlwh[2] = mean[2];
-	tlwh[3] = mean[3];
-
-	tlwh[2] *= tlwh[3];
-	tlwh[0] -= tlwh[2] / 2;
-	tlwh[1] -= tlwh[3] / 2;
 }
 
-void STrack::static_tlbr()
+void STrackPool::multi_gmc(const vector<int> &slots, const float *warp)
 {
-	tlbr.clear();
-	tlbr.assign(tlwh.begin(), tlwh.end());
-	tlbr[2] += tlbr[0];
-	tlbr[3] += tlbr[1];
-}
+	// the state is (x, y, a, h) and velocities: center and its velocity follow the linear part (plus translation
+	// for the center), height and its velocity scale with it, aspect ratio stays
+	float scale = std::sqrt(std::abs(warp[0] * warp[4] - warp[1] * warp[3]));
+	KAL_COVA J = KAL_COVA::Zero();
+	for (int k = 0; k <= 4; k += 4)
+	{
+		J(k, k) = warp[0];
+		J(k, k + 1) = warp[1];
+		J(k + 1, k) = warp[3];
+		J(k + 1, k + 1) = warp[4];
+		J(k + 2, k + 2) = 1;
+		J(k + 3, k + 3) = scale;
+	}
 
-vector<float> STrack::tlwh_to_xyah(vector<float> tlwh_tmp)
-{
-	vector<float> tlwh_output = tlwh_tmp;
-	tlwh_output[0] += tlwh_output[2] / 2;
-	tlwh_output[1] += tlwh_output[3] / 2;
-	tlwh_output[2] /= tlwh_output[3];
-	return tlwh_output;
+	for (int i = 0; i < slots.size(); i++)
+	{
+		int slot = slots[i];
+		mean[slot] = mean[slot] * J.transpose();
+		mean[slot][0] += warp[2];
+		mean[slot][1] += warp[5];
+		covariance[slot] = J * covariance[slot] * J.transpose();
+		refresh_box(slot);
+	}
 }
 
-vector<float> STrack::to_xyah()
+void STrackPool::snapshot(int slot, int frame_id, STrack &out) const
 {
-	return tlwh_to_xyah(tlwh);
+	out.track_id = track_id[slot];
+	out.state = state[slot];
+	out.is_activated = is_activated[slot] != 0;
+	for (int k = 0; k < 4; k++)
+	{
+		out.tlwh[k] = tlwh[slot * 4 + k];
+		out.tlbr[k] = tlbr[slot * 4 + k];
+	}
+	out.score = score[slot];
+	// reuses capacity of out.label
+	out.label = label[slot];
+	out.frame_id = this->frame_id[slot];
+	out.tracklet_len = tracklet_len[slot];
+	out.start_frame = start_frame[slot];
+	out.det_index = this->frame_id[slot] == frame_id ? det_index[slot] : -1;
 }
 
-vector<float> STrack::tlbr_to_tlwh(vector<float> &tlbr)
+void STrackPool::refresh_box(int slot)
 {
-	tlbr[2] -= tlbr[0];
-	tlbr[3] -= tlbr[1];
-	return tlbr;
-}
+	float *box = &tlwh[slot * 4];
+	if (state[slot] != TrackState::New)
+	{
+		const KAL_MEAN &m = mean[slot];
+		box[0] = m[0];
+		box[1] = m[1];
+		box[2] = m[2];
+		box[3] = m[3];
+
+		box[2] *= box[3];
+		box[0] -= box[2] / 2;
+		box[1] -= box[3] / 2;
+	}
 
-void STrack::mark_lost()
-{
-	state = TrackState::Lost;
+	float *corners = &tlbr[slot * 4];
+	corners[0] = box[0];
+	corners[1] = box[1];
+	corners[2] = box[2] + box[0];
+	corners[3] = box[3] + box[1];
 }
 
-void STrack::mark_removed()
+void STrackPool::tlwh_to_xyah(const float *tlwh, DETECTBOX &xyah)
 {
-	state = TrackState::Removed;
+	xyah[0] = tlwh[0] + tlwh[2] / 2;
+	xyah[1] = tlwh[1] + tlwh[3] / 2;
+	xyah[2] = tlwh[2] / tlwh[3];
+	xyah[3] = tlwh[3];
 }
 
-int STrack::next_id()
+int STrackPool::next_id()
 {
 	static int _count = 0;
 	_count++;
 	return _count;
 }
-
-int STrack::end_frame()
-{
-	return this->frame_id;
-}
-
-void STrack::multi_predict(vector<STrack*> &stracks, byte_kalman::KalmanFilter &kalman_filter)
-{
-	for (int i = 0; i < stracks.size(); i++)
-	{
-		if (stracks[i]->state != TrackState::Tracked)
-		{
-			stracks[i]->mean[7] = 0;
-		}
-		kalman_filter.predict(stracks[i]->mean, stracks[i]->covariance);
-		stracks[i]->static_tlwh();
-		stracks[i]->static_tlbr();
-	}
-}
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
 #include <opencv2/opencv.hpp>
 #include "kalmanFilter.h"
 
@@ -8,44 +12,88 @@ using namespace std;
 
 enum TrackState { New = 0, Tracked, Lost, Removed };
 
+// Track reported by BYTETracker::update, a copy of the track state at that frame.
 class STrack
 {
 public:
-	STrack(vector<float> tlwh_, float score, std::string label);
-	~STrack();
-
-	vector<float> static tlbr_to_tlwh(vector<float> &tlbr);
-	void static multi_predict(vector<STrack*> &stracks, byte_kalman::KalmanFilter &kalman_filter);
-	void static_tlwh();
-	void static_tlbr();
-	vector<float> tlwh_to_xyah(vector<float> tlwh_tmp);
-	vector<float> to_xyah();
-	void mark_lost();
-	void mark_removed();
-	int next_id();
-	int end_frame();
-	
-	void activate(byte_kalman::KalmanFilter &kalman_filter, int frame_id);
-	void re_activate(STrack &new_track, int frame_id, bool new_id = false);
-	void update(STrack &new_track, int frame_id);
+	int track_id = 0;
+	int state = TrackState::New;
+	bool is_activated = false;
 
+	// top-left x, y, width, height
+	std::array<float, 4> tlwh{};
+	// top-left x, y, bottom-right x, y
+	std::array<float, 4> tlbr{};
+	float score = 0;
+	std::string label;
+
+	int frame_id = 0;
+	int tracklet_len = 0;
+	int start_frame = 0;
+
+	// index (in input of BYTETracker::update) of the detection matched to the track at this frame, -1 if none
+	int det_index = -1;
+
+	int end_frame() const { return frame_id; }
+};
+
+// All tracks of a BYTETracker, stored as structure of arrays.
+// A track is addressed by its slot, which stays the same for the whole life of the track, so association works on
+// slot indices and never copies track state. Slots of dead tracks are recycled and the arrays only grow:
+// a tracker in steady state does not allocate.
+class STrackPool
+{
 public:
-	bool is_activated;
-	int track_id;
-	int state;
+	// take a slot for a track starting from detection det_index (tlwh, 4 floats), state is New
+	int acquire(int det_index, const float *det_tlwh, float score, const std::string &label);
+	// give the slot back, the track is gone
+	void release(int slot);
+	// slots ever used, live or free
+	int capacity() const { return (int)track_id.size(); }
+
+	void activate(int slot, byte_kalman::KalmanFilter &kalman_filter, int frame_id);
+	void re_activate(int slot, int det_index, const float *det_tlwh, float score, const std::string &label,
+		byte_kalman::KalmanFilter &kalman_filter, int frame_id, bool new_id = false);
+	void update(int slot, int det_index, const float *det_tlwh, float score, const std::string &label,
+		byte_kalman::KalmanFilter &kalman_filter, int frame_id);
+	void multi_predict(const vector<int> &slots, byte_kalman::KalmanFilter &kalman_filter);
+	// move tracks by camera motion (2x3 affine, row major)
+	void multi_gmc(const vector<int> &slots, const float *warp);
+	void mark_lost(int slot) { state[slot] = TrackState::Lost; }
+	void mark_removed(int slot) { state[slot] = TrackState::Removed; }
 
-	vector<float> _tlwh;
+	// copy of the track in slot at frame_id
+	void snapshot(int slot, int frame_id, STrack &out) const;
+
+	const float *tlbr_of(int slot) const { return &tlbr[slot * 4]; }
+
+	static void tlwh_to_xyah(const float *tlwh, DETECTBOX &xyah);
+	static int next_id();
+
+	// arrays indexed by slot
+	vector<int> track_id;
+	vector<int> state;
+	vector<uint8_t> is_activated;
+	vector<int> frame_id;
+	vector<int> tracklet_len;
+	vector<int> start_frame;
+	// detection which updated the track last, at frame_id
+	vector<int> det_index;
+	vector<float> score;
+	vector<std::string> label;
+	// 4 floats per slot
 	vector<float> tlwh;
 	vector<float> tlbr;
-	int frame_id;
-	int tracklet_len;
-	int start_frame;
-
-	KAL_MEAN mean;
-	KAL_COVA covariance;
-	float score;
-	std::string label;
+	vector<KAL_MEAN> mean;
+	vector<KAL_COVA> covariance;
+	// frame when the track was first removed, -1 if never
+	vector<int> removed_frame;
+	// slot holds a track (not in free list)
+	vector<uint8_t> live;
 
 private:
-	byte_kalman::KalmanFilter kalman_filter;
-};
\ No newline at end of file
+	vector<int> free_slots;
+
+	// box from kalman mean (from the detection while the track is New)
+	void refresh_box(int slot);
+};
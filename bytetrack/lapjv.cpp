@@ -7,10 +7,9 @@
 /** Column-reduction and reduction transfer for a dense cost matrix.
  */
 int_t _ccrrt_dense(const uint_t n, cost_t *cost[],
-	int_t *free_rows, int_t *x, int_t *y, cost_t *v)
+	int_t *free_rows, int_t *x, int_t *y, cost_t *v, boolean *unique)
 {
 	int_t n_free_rows;
-	boolean *unique;
 
 	for (uint_t i = 0; i < n; i++) {
 		x[i] = -1;
@@ -29,7 +28,6 @@ int_t _ccrrt_dense(const uint_t n, cost_t *cost[],
 	}
 	PRINT_COST_ARRAY(v, n);
 	PRINT_INDEX_ARRAY(y, n);
-	NEW(unique, boolean, n);
 	memset(unique, TRUE, n);
 	{
 		int_t j = n;
@@ -66,7 +64,6 @@ int_t _ccrrt_dense(const uint_t n, cost_t *cost[],
 			v[j] -= min;
 		}
 	}
-	FREE(unique);
 	return n_free_rows;
 }
 
@@ -219,16 +216,11 @@ int_t find_path_dense(
 	const uint_t n, cost_t *cost[],
 	const int_t start_i,
 	int_t *y, cost_t *v,
-	int_t *pred)
+	int_t *pred, int_t *cols, cost_t *d)
 {
 	uint_t lo = 0, hi = 0;
 	int_t final_j = -1;
 	uint_t n_ready = 0;
-	int_t *cols;
-	cost_t *d;
-
-	NEW(cols, int_t, n);
-	NEW(d, cost_t, n);
 
 	for (uint_t i = 0; i < n; i++) {
 		cols[i] = i;
@@ -271,9 +263,6 @@ int_t find_path_dense(
 		}
 	}
 
-	FREE(cols);
-	FREE(d);
-
 	return final_j;
 }
 
@@ -283,18 +272,15 @@ int_t find_path_dense(
 int_t _ca_dense(
 	const uint_t n, cost_t *cost[],
 	const uint_t n_free_rows,
-	int_t *free_rows, int_t *x, int_t *y, cost_t *v)
+	int_t *free_rows, int_t *x, int_t *y, cost_t *v,
+	int_t *pred, int_t *cols, cost_t *d)
 {
-	int_t *pred;
-
-	NEW(pred, int_t, n);
-
 	for (int_t *pfree_i = free_rows; pfree_i < free_rows + n_free_rows; pfree_i++) {
 		int_t i = -1, j;
 		uint_t k = 0;
 
 		PRINTF("looking at free_i=%d\n", *pfree_i);
-		j = find_path_dense(n, cost, *pfree_i, y, v, pred);
+		j = find_path_dense(n, cost, *pfree_i, y, v, pred, cols, d);
 		ASSERT(j >= 0);
 		ASSERT(j < n);
 		while (i != *pfree_i) {
@@ -311,33 +297,55 @@ int_t _ca_dense(
 			}
 		}
 	}
-	FREE(pred);
 	return 0;
 }
 
 
-/** Solve dense sparse LAP.
+size_t lapjv_workspace_size(const uint_t n)
+{
+	return n * (2 * sizeof(cost_t) + 3 * sizeof(int_t) + sizeof(boolean));
+}
+
+
+/** Solve dense sparse LAP with caller provided scratch memory, nothing is allocated.
  */
-int lapjv_internal(
+int lapjv_internal_ws(
 	const uint_t n, cost_t *cost[],
-	int_t *x, int_t *y)
+	int_t *x, int_t *y, void *workspace)
 {
 	int ret;
-	int_t *free_rows;
-	cost_t *v;
+	// cost_t arrays first, so every array is aligned for its type
+	cost_t *v = (cost_t *)workspace;
+	cost_t *d = v + n;
+	int_t *free_rows = (int_t *)(d + n);
+	int_t *pred = free_rows + n;
+	int_t *cols = pred + n;
+	boolean *unique = (boolean *)(cols + n);
 
-	NEW(free_rows, int_t, n);
-	NEW(v, cost_t, n);
-	ret = _ccrrt_dense(n, cost, free_rows, x, y, v);
+	ret = _ccrrt_dense(n, cost, free_rows, x, y, v, unique);
 	int i = 0;
 	while (ret > 0 && i < 2) {
 		ret = _carr_dense(n, cost, ret, free_rows, x, y, v);
 		i++;
 	}
 	if (ret > 0) {
-		ret = _ca_dense(n, cost, ret, free_rows, x, y, v);
+		ret = _ca_dense(n, cost, ret, free_rows, x, y, v, pred, cols, d);
 	}
-	FREE(v);
-	FREE(free_rows);
 	return ret;
-}
\ No newline at end of file
+}
+
+
+/** Solve dense sparse LAP.
+ */
+int lapjv_internal(
+	const uint_t n, cost_t *cost[],
+	int_t *x, int_t *y)
+{
+	int ret;
+	char *workspace;
+
+	NEW(workspace, char, lapjv_workspace_size(n));
+	ret = lapjv_internal_ws(n, cost, x, y, workspace);
+	FREE(workspace);
+	return ret;
+}
@@ -1,6 +1,8 @@
 #ifndef LAPJV_H
 #define LAPJV_H
 
+#include <stddef.h>
+
 #define LARGE 1000000
 
 #if !defined TRUE
@@ -60,4 +62,12 @@ extern int_t lapjv_internal(
 	const uint_t n, cost_t *cost[],
 	int_t *x, int_t *y);
 
+/* Scratch bytes needed by lapjv_internal_ws for a n x n problem, aligned like cost_t. */
+extern size_t lapjv_workspace_size(const uint_t n);
+
+/* Same as lapjv_internal but works in caller provided scratch memory, so a reused workspace makes it allocation free. */
+extern int_t lapjv_internal_ws(
+	const uint_t n, cost_t *cost[],
+	int_t *x, int_t *y, void *workspace);
+
 #endif // LAPJV_H
\ No newline at end of file
@@ -1,149 +1,136 @@
 #include "BYTETracker.h"
 #include "lapjv.h"
-#include <map>
+#include <algorithm>
 #include <iostream>
 using namespace std;
 
 
-vector<STrack*> BYTETracker::joint_stracks(vector<STrack*> &tlista, vector<STrack> &tlistb)
+void BYTETracker::mark_slots(const vector<int> &slots)
 {
-	map<int, int> exists;
-	vector<STrack*> res;
-	for (int i = 0; i < tlista.size(); i++)
+	if (slot_marks.size() < pool.capacity())
 	{
-		exists.insert(pair<int, int>(tlista[i]->track_id, 1));
-		res.push_back(tlista[i]);
+		slot_marks.resize(pool.capacity(), 0);
 	}
-	for (int i = 0; i < tlistb.size(); i++)
+	if (++mark_stamp == 0)
 	{
-		int tid = tlistb[i].track_id;
-		if (!exists[tid] || exists.count(tid) == 0)
-		{
-			exists[tid] = 1;
-			res.push_back(&tlistb[i]);
-		}
+		std::fill(slot_marks.begin(), slot_marks.end(), 0);
+		mark_stamp = 1;
+	}
+	for (int i = 0; i < slots.size(); i++)
+	{
+		slot_marks[slots[i]] = mark_stamp;
 	}
-	return res;
 }
 
-vector<STrack> BYTETracker::joint_stracks(vector<STrack> &tlista, vector<STrack> &tlistb)
+// tlista + tracks of tlistb not in tlista
+void BYTETracker::joint_stracks(vector<int> &tlista, const vector<int> &tlistb)
 {
-	map<int, int> exists;
-	vector<STrack> res;
-	for (int i = 0; i < tlista.size(); i++)
-	{
-		exists.insert(pair<int, int>(tlista[i].track_id, 1));
-		res.push_back(tlista[i]);
-	}
+	mark_slots(tlista);
 	for (int i = 0; i < tlistb.size(); i++)
 	{
-		int tid = tlistb[i].track_id;
-		if (!exists[tid] || exists.count(tid) == 0)
+		int slot = tlistb[i];
+		if (!is_marked(slot))
 		{
-			exists[tid] = 1;
-			res.push_back(tlistb[i]);
+			slot_marks[slot] = mark_stamp;
+			tlista.push_back(slot);
 		}
 	}
-	return res;
 }
 
-vector<STrack> BYTETracker::sub_stracks(vector<STrack> &tlista, vector<STrack> &tlistb)
+void BYTETracker::sort_by_track_id(vector<int> &tlist)
 {
-	map<int, STrack> stracks;
+	std::sort(tlist.begin(), tlist.end(), [this](int a, int b) { return pool.track_id[a] < pool.track_id[b]; });
+}
+
+// tlista - tlistb, ordered by track id
+void BYTETracker::sub_stracks(vector<int> &tlista, const vector<int> &tlistb)
+{
+	mark_slots(tlistb);
+	int kept = 0;
 	for (int i = 0; i < tlista.size(); i++)
 	{
-		stracks.insert(pair<int, STrack>(tlista[i].track_id, tlista[i]));
-	}
-	for (int i = 0; i < tlistb.size(); i++)
-	{
-		int tid = tlistb[i].track_id;
-		if (stracks.count(tid) != 0)
+		if (!is_marked(tlista[i]))
 		{
-			stracks.erase(tid);
+			tlista[kept++] = tlista[i];
 		}
 	}
-
-	vector<STrack> res;
-	map<int, STrack>::iterator  it;
-	for (it = stracks.begin(); it != stracks.end(); ++it)
-	{
-		res.push_back(it->second);
-	}
-
-	return res;
+	tlista.resize(kept);
+	sort_by_track_id(tlista);
 }
 
-void BYTETracker::remove_duplicate_stracks(vector<STrack> &resa, vector<STrack> &resb, vector<STrack> &stracksa, vector<STrack> &stracksb)
+// of tracks overlapping each other in both lists, keep the one tracked longer
+void BYTETracker::remove_duplicate_stracks(vector<int> &stracksa, vector<int> &stracksb)
 {
-	vector<vector<float> > pdist = iou_distance(stracksa, stracksb);
-	vector<pair<int, int> > pairs;
-	for (int i = 0; i < pdist.size(); i++)
+	int rows = stracksa.size();
+	int cols = stracksb.size();
+	iou_distance(pool.tlbr.data(), stracksa, pool.tlbr.data(), stracksb);
+
+	// marks of dupa at [0, rows), of dupb at [rows, rows + cols)
+	dup_marks.assign(rows + cols, 0);
+	for (int i = 0; i < rows; i++)
 	{
-		for (int j = 0; j < pdist[i].size(); j++)
+		for (int j = 0; j < cols; j++)
 		{
-			if (pdist[i][j] < 0.15)
+			if (dists[i * cols + j] < 0.15)
 			{
-				pairs.push_back(pair<int, int>(i, j));
+				int a = stracksa[i];
+				int b = stracksb[j];
+				int timep = pool.frame_id[a] - pool.start_frame[a];
+				int timeq = pool.frame_id[b] - pool.start_frame[b];
+				if (timep > timeq)
+					dup_marks[rows + j] = 1;
+				else
+					dup_marks[i] = 1;
 			}
 		}
 	}
 
-	vector<int> dupa, dupb;
-	for (int i = 0; i < pairs.size(); i++)
-	{
-		int timep = stracksa[pairs[i].first].frame_id - stracksa[pairs[i].first].start_frame;
-		int timeq = stracksb[pairs[i].second].frame_id - stracksb[pairs[i].second].start_frame;
-		if (timep > timeq)
-			dupb.push_back(pairs[i].second);
-		else
-			dupa.push_back(pairs[i].first);
-	}
-
-	for (int i = 0; i < stracksa.size(); i++)
+	int kept = 0;
+	for (int i = 0; i < rows; i++)
 	{
-		vector<int>::iterator iter = find(dupa.begin(), dupa.end(), i);
-		if (iter == dupa.end())
+		if (!dup_marks[i])
 		{
-			resa.push_back(stracksa[i]);
+			stracksa[kept++] = stracksa[i];
 		}
 	}
+	stracksa.resize(kept);
 
-	for (int i = 0; i < stracksb.size(); i++)
+	kept = 0;
+	for (int j = 0; j < cols; j++)
 	{
-		vector<int>::iterator iter = find(dupb.begin(), dupb.end(), i);
-		if (iter == dupb.end())
+		if (!dup_marks[rows + j])
 		{
-			resb.push_back(stracksb[i]);
+			stracksb[kept++] = stracksb[j];
 		}
 	}
+	stracksb.resize(kept);
 }
 
-void BYTETracker::linear_assignment(vector<vector<float> > &cost_matrix, int cost_matrix_size, int cost_matrix_size_size, float thresh,
-	vector<vector<int> > &matches, vector<int> &unmatched_a, vector<int> &unmatched_b)
+void BYTETracker::linear_assignment(int rows, int cols, float thresh,
+	vector<pair<int, int> > &matches, vector<int> &unmatched_a, vector<int> &unmatched_b)
 {
-	if (cost_matrix.size() == 0)
+	matches.clear();
+	unmatched_a.clear();
+	unmatched_b.clear();
+	if (rows * cols == 0)
 	{
-		for (int i = 0; i < cost_matrix_size; i++)
+		for (int i = 0; i < rows; i++)
 		{
 			unmatched_a.push_back(i);
 		}
-		for (int i = 0; i < cost_matrix_size_size; i++)
+		for (int i = 0; i < cols; i++)
 		{
 			unmatched_b.push_back(i);
 		}
 		return;
 	}
 
-	vector<int> rowsol; vector<int> colsol;
-	float c = lapjv(cost_matrix, rowsol, colsol, true, thresh);
-	for (int i = 0; i < rowsol.size(); i++)
+	lapjv(rows, cols, thresh);
+	for (int i = 0; i < rows; i++)
 	{
 		if (rowsol[i] >= 0)
 		{
-			vector<int> match;
-			match.push_back(i);
-			match.push_back(rowsol[i]);
-			matches.push_back(match);
+			matches.emplace_back(i, rowsol[i]);
 		}
 		else
 		{
@@ -151,7 +138,7 @@ void BYTETracker::linear_assignment(vector<vector<float> > &cost_matrix, int cos
 		}
 	}
 
-	for (int i = 0; i < colsol.size(); i++)
+	for (int i = 0; i < cols; i++)
 	{
 		if (colsol[i] < 0)
 		{
@@ -160,274 +147,86 @@ void BYTETracker::linear_assignment(vector<vector<float> > &cost_matrix, int cos
 	}
 }
 
-vector<vector<float> > BYTETracker::ious(vector<vector<float> > &atlbrs, vector<vector<float> > &btlbrs)
+void BYTETracker::iou_distance(const float *atlbrs, const vector<int> &a, const float *btlbrs, const vector<int> &b)
 {
-	vector<vector<float> > ious;
-	if (atlbrs.size()*btlbrs.size() == 0)
-		return ious;
-
-	ious.resize(atlbrs.size());
-	for (int i = 0; i < ious.size(); i++)
-	{
-		ious[i].resize(btlbrs.size());
-	}
+	int rows = a.size();
+	int cols = b.size();
+	dists.resize(rows * cols);
 
 	//bbox_ious
-	for (int k = 0; k < btlbrs.size(); k++)
+	for (int n = 0; n < rows; n++)
 	{
-		vector<float> ious_tmp;
-		float box_area = (btlbrs[k][2] - btlbrs[k][0] + 1)*(btlbrs[k][3] - btlbrs[k][1] + 1);
-		for (int n = 0; n < atlbrs.size(); n++)
+		const float *abox = atlbrs + a[n] * 4;
+		float *row = dists.data() + n * cols;
+		for (int k = 0; k < cols; k++)
 		{
-			float iw = min(atlbrs[n][2], btlbrs[k][2]) - max(atlbrs[n][0], btlbrs[k][0]) + 1;
+			const float *bbox = btlbrs + b[k] * 4;
+			float iou = 0.0;
+			float iw = min(abox[2], bbox[2]) - max(abox[0], bbox[0]) + 1;
 			if (iw > 0)
 			{
-				float ih = min(atlbrs[n][3], btlbrs[k][3]) - max(atlbrs[n][1], btlbrs[k][1]) + 1;
-				if(ih > 0)
-				{
-					float ua = (atlbrs[n][2] - atlbrs[n][0] + 1)*(atlbrs[n][3] - atlbrs[n][1] + 1) + box_area - iw * ih;
-					ious[n][k] = iw * ih / ua;
-				}
-				else
+				float ih = min(abox[3], bbox[3]) - max(abox[1], bbox[1]) + 1;
+				if (ih > 0)
 				{
-					ious[n][k] = 0.0;
+					float box_area = (bbox[2] - bbox[0] + 1)*(bbox[3] - bbox[1] + 1);
+					float ua = (abox[2] - abox[0] + 1)*(abox[3] - abox[1] + 1) + box_area - iw * ih;
+					iou = iw * ih / ua;
 				}
 			}
-			else
-			{
-				ious[n][k] = 0.0;
-			}
-		}
-	}
-
-	return ious;
-}
-
-vector<vector<float> > BYTETracker::iou_distance(vector<STrack*> &atracks, vector<STrack> &btracks, int &dist_size, int &dist_size_size)
-{
-	vector<vector<float> > cost_matrix;
-	if (atracks.size() * btracks.size() == 0)
-	{
-		dist_size = atracks.size();
-		dist_size_size = btracks.size();
-		return cost_matrix;
-	}
-	vector<vector<float> > atlbrs, btlbrs;
-	for (int i = 0; i < atracks.size(); i++)
-	{
-		atlbrs.push_back(atracks[i]->tlbr);
-	}
-	for (int i = 0; i < btracks.size(); i++)
-	{
-		btlbrs.push_back(btracks[i].tlbr);
-	}
-
-	dist_size = atracks.size();
-	dist_size_size = btracks.size();
-
-	vector<vector<float> > _ious = ious(atlbrs, btlbrs);
-	
-	for (int i = 0; i < _ious.size();i++)
-	{
-		vector<float> _iou;
-		for (int j = 0; j < _ious[i].size(); j++)
-		{
-			_iou.push_back(1 - _ious[i][j]);
-		}
-		cost_matrix.push_back(_iou);
-	}
-
-	return cost_matrix;
-}
-
-vector<vector<float> > BYTETracker::iou_distance(vector<STrack> &atracks, vector<STrack> &btracks)
-{
-	vector<vector<float> > atlbrs, btlbrs;
-	for (int i = 0; i < atracks.size(); i++)
-	{
-		atlbrs.push_back(atracks[i].tlbr);
-	}
-	for (int i = 0; i < btracks.size(); i++)
-	{
-		btlbrs.push_back(btracks[i].tlbr);
-	}
-
-	vector<vector<float> > _ious = ious(atlbrs, btlbrs);
-	vector<vector<float> > cost_matrix;
-	for (int i = 0; i < _ious.size(); i++)
-	{
-		vector<float> _iou;
-		for (int j = 0; j < _ious[i].size(); j++)
-		{
-			_iou.push_back(1 - _ious[i][j]);
+			row[k] = 1 - iou;
 		}
-		cost_matrix.push_back(_iou);
 	}
-
-	return cost_matrix;
 }
 
-double BYTETracker::lapjv(const vector<vector<float> > &cost, vector<int> &rowsol, vector<int> &colsol,
-	bool extend_cost, float cost_limit, bool return_cost)
+void BYTETracker::lapjv(int rows, int cols, float cost_limit)
 {
-	vector<vector<float> > cost_c;
-	cost_c.assign(cost.begin(), cost.end());
-
-	vector<vector<float> > cost_c_extended;
-
-	int n_rows = cost.size();
-	int n_cols = cost[0].size();
-	rowsol.resize(n_rows);
-	colsol.resize(n_cols);
-
-	int n = 0;
-	if (n_rows == n_cols)
-	{
-		n = n_rows;
-	}
-	else
-	{
-		if (!extend_cost)
-		{
-			cout << "set extend_cost=True" << endl;
-			system("pause");
-			exit(0);
-		}
-	}
-		
-	if (extend_cost || cost_limit < LONG_MAX)
-	{
-		n = n_rows + n_cols;
-		cost_c_extended.resize(n);
-		for (int i = 0; i < cost_c_extended.size(); i++)
-			cost_c_extended[i].resize(n);
-
-		if (cost_limit < LONG_MAX)
-		{
-			for (int i = 0; i < cost_c_extended.size(); i++)
-			{
-				for (int j = 0; j < cost_c_extended[i].size(); j++)
-				{
-					cost_c_extended[i][j] = cost_limit / 2.0;
-				}
-			}
-		}
-		else
-		{
-			float cost_max = -1;
-			for (int i = 0; i < cost_c.size(); i++)
-			{
-				for (int j = 0; j < cost_c[i].size(); j++)
-				{
-					if (cost_c[i][j] > cost_max)
-						cost_max = cost_c[i][j];
-				}
-			}
-			for (int i = 0; i < cost_c_extended.size(); i++)
-			{
-				for (int j = 0; j < cost_c_extended[i].size(); j++)
-				{
-					cost_c_extended[i][j] = cost_max + 1;
-				}
-			}
-		}
-
-		for (int i = n_rows; i < cost_c_extended.size(); i++)
-		{
-			for (int j = n_cols; j < cost_c_extended[i].size(); j++)
-			{
-				cost_c_extended[i][j] = 0;
-			}
-		}
-		for (int i = 0; i < n_rows; i++)
-		{
-			for (int j = 0; j < n_cols; j++)
-			{
-				cost_c_extended[i][j] = cost_c[i][j];
-			}
-		}
-
-		cost_c.clear();
-		cost_c.assign(cost_c_extended.begin(), cost_c_extended.end());
-	}
-
-	double **cost_ptr;
-	cost_ptr = new double *[sizeof(double *) * n];
-	for (int i = 0; i < n; i++)
-		cost_ptr[i] = new double[sizeof(double) * n];
-
+	// square problem of rows + cols, unmatched rows / cols pair with dummies at cost_limit / 2
+	int n = rows + cols;
+	float dummy_cost = cost_limit / 2.0;
+	lap_cost.resize(n * n);
+	lap_cost_rows.resize(n);
 	for (int i = 0; i < n; i++)
 	{
+		double *row = &lap_cost[i * n];
+		lap_cost_rows[i] = row;
 		for (int j = 0; j < n; j++)
 		{
-			cost_ptr[i][j] = cost_c[i][j];
+			if (i < rows && j < cols)
+				row[j] = dists[i * cols + j];
+			else if (i >= rows && j >= cols)
+				row[j] = 0;
+			else
+				row[j] = dummy_cost;
 		}
 	}
 
-	int* x_c = new int[sizeof(int) * n];
-	int *y_c = new int[sizeof(int) * n];
+	lap_x.resize(n);
+	lap_y.resize(n);
+	lap_workspace.resize(lapjv_workspace_size(n) / sizeof(double) + 1);
+	rowsol.resize(rows);
+	colsol.resize(cols);
 
-	int ret = lapjv_internal(n, cost_ptr, x_c, y_c);
+	int ret = lapjv_internal_ws(n, lap_cost_rows.data(), lap_x.data(), lap_y.data(), lap_workspace.data());
 	if (ret != 0)
 	{
 		cout << "Calculate Wrong!" << endl;
-		system("pause");
-		exit(0);
+		std::fill(rowsol.begin(), rowsol.end(), -1);
+		std::fill(colsol.begin(), colsol.end(), -1);
+		return;
 	}
 
-	double opt = 0.0;
-
-	if (n != n_rows)
-	{
-		for (int i = 0; i < n; i++)
-		{
-			if (x_c[i] >= n_cols)
-				x_c[i] = -1;
-			if (y_c[i] >= n_rows)
-				y_c[i] = -1;
-		}
-		for (int i = 0; i < n_rows; i++)
-		{
-			rowsol[i] = x_c[i];
-		}
-		for (int i = 0; i < n_cols; i++)
-		{
-			colsol[i] = y_c[i];
-		}
-
-		if (return_cost)
-		{
-			for (int i = 0; i < rowsol.size(); i++)
-			{
-				if (rowsol[i] != -1)
-				{
-					//cout << i << "\t" << rowsol[i] << "\t" << cost_ptr[i][rowsol[i]] << endl;
-					opt += cost_ptr[i][rowsol[i]];
-				}
-			}
-		}
-	}
-	else if (return_cost)
+	for (int i = 0; i < rows; i++)
 	{
-		for (int i = 0; i < rowsol.size(); i++)
-		{
-			opt += cost_ptr[i][rowsol[i]];
-		}
+		rowsol[i] = lap_x[i] >= cols ? -1 : lap_x[i];
 	}
-
-	for (int i = 0; i < n; i++)
+	for (int i = 0; i < cols; i++)
 	{
-		delete[]cost_ptr[i];
+		colsol[i] = lap_y[i] >= rows ? -1 : lap_y[i];
 	}
-	delete[]cost_ptr;
-	delete[]x_c;
-	delete[]y_c;
-
-	return opt;
 }
 
 cv::Scalar BYTETracker::get_color(int idx)
 {
 	idx += 3;
 	return cv::Scalar(37 * idx % 255, 17 * idx % 255, 29 * idx % 255);
-}
\ No newline at end of file
+}
@@ -213,9 +213,9 @@ int main(int argc, char** argv) {
     auto yolo26_pre_0 = std::make_shared<vp_nodes::vp_yolo26_preprocess_node>("yolo26_pre_0", yolo26_config_path);
     // YOLO26 检测节点。
     auto yolo26_0 = std::make_shared<vp_nodes::vp_rk_first_yolo26>("yolo26_0", yolo26_config_path);
-    // OSD 绘制节点。
-    auto osd_0 = std::make_shared<vp_nodes::vp_osd_node>("osd_0");
-    // BGR 转 NV12 适配节点（把 OSD 结果转为 NV12 供 SDL 显示）。
+    // OSD 绘制节点（直接绘制在 NV12 上，整条显示链路不再生成 BGR）。
+    auto osd_0 = std::make_shared<vp_nodes::vp_osd_node>("osd_0", "", true);
+    // BGR 转 NV12 适配节点（OSD 结果已是 NV12 时直接透传，BGR 输入时才转换）。
     auto bgr_to_nv12_0 = std::make_shared<vp_nodes::vp_bgr_to_nv12_node>("bgr_to_nv12_0");
     // NV12 SDL 直显终端节点（显示解码原始画面）。
     auto nv12_des_0 = std::make_shared<vp_nodes::vp_nv12_sdl_des_node>(
@@ -9,12 +9,19 @@ struct Config{
     std::vector<std::string> labels;
     std::vector<std::string> alarm_labels;
     int core_mask = 0;
+    // one rknn_context per entry pinned to the given rknn_core_mask (1: core 0, 2: core 1, 4: core 2, 3: core 0_1, 7: core 0_1_2),
+    // contexts share weights and frames are dispatched across them. empty means a single context with core_mask.
+    std::vector<int> core_masks;
 };
 
 struct YOLOConfig: public Config{
     ModelType type = ModelType::YOLOv5;
     float conf_threshold = 0.25;
     float nms_threshold = 0.45;
+    int max_detections = 100;  // 0 means no limit
+    // boxes of any class suppress each other, as the per-class nms of the old postprocessor did in effect.
+    // false suppresses only boxes of the same class.
+    bool class_agnostic_nms = true;
 };
 
 struct YOLO26Config: public Config{
@@ -23,6 +30,7 @@ struct YOLO26Config: public Config{
     float nms_threshold = 0.45;
     int input_width = 640;
     int input_height = 352;
+    bool int8_postprocess = true;  // decode int8 outputs directly when the model has quantized outputs
 };
 
 struct ClsConfig: public Config{
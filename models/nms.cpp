@@ -0,0 +1,164 @@
+#include "nms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+constexpr int k_grid_min_boxes = 64;  // 候选少于该数量时直接遍历保留框，网格收益不足。
+constexpr int k_grid_max_cells = 64;  // 网格每个方向的最大格数。
+
+/**
+ * @brief 候选框的预计算信息。
+ */
+struct Candidate {
+    float x1 = 0.0f;  // 左上角 x。
+    float y1 = 0.0f;  // 左上角 y。
+    float x2 = 0.0f;  // 右下角 x（pixel_inclusive 时已加 1）。
+    float y2 = 0.0f;  // 右下角 y（pixel_inclusive 时已加 1）。
+    float area = 0.0f;  // 面积。
+    int64_t group = 0;  // 抑制分组键，只有同组的框互相抑制。
+};
+
+/**
+ * @brief 判断 a、b 的 IoU 是否超过阈值（以乘法代替除法）。
+ */
+inline bool iou_over(const Candidate& a, const Candidate& b, float iou_threshold) {
+    const float iw = std::min(a.x2, b.x2) - std::max(a.x1, b.x1);  // 相交宽度。
+    if (iw <= 0.0f) {
+        return false;
+    }
+    const float ih = std::min(a.y2, b.y2) - std::max(a.y1, b.y1);  // 相交高度。
+    if (ih <= 0.0f) {
+        return false;
+    }
+    const float inter = iw * ih;  // 相交面积。
+    const float uni = a.area + b.area - inter;  // 并集面积。
+    return uni > 0.0f && inter > iou_threshold * uni;
+}
+}  // namespace
+
+void nms(const std::vector<NmsBox>& boxes, const NmsOptions& options, std::vector<int>& keep) {
+    keep.clear();
+    const int total = static_cast<int>(boxes.size());  // 候选总数。
+    if (total == 0) {
+        return;
+    }
+
+    // 分数从高到低排序一次，只需要前 k 个时做部分排序。
+    std::vector<int> order(total);  // 候选下标。
+    std::iota(order.begin(), order.end(), 0);
+    auto by_score = [&boxes](int a, int b) {
+        return boxes[a].score > boxes[b].score || (boxes[a].score == boxes[b].score && a < b);
+    };
+    int count = total;  // 参与 NMS 的候选数。
+    if (options.max_candidates > 0 && options.max_candidates < total) {
+        count = options.max_candidates;
+        std::partial_sort(order.begin(), order.begin() + count, order.end(), by_score);
+        order.resize(count);
+    } else {
+        std::sort(order.begin(), order.end(), by_score);
+    }
+
+    const float offset = options.pixel_inclusive ? 1.0f : 0.0f;  // 闭区间宽高补偿。
+    std::vector<Candidate> cands(count);  // 按排序后顺序存放的候选。
+    float min_x = 0.0f, min_y = 0.0f, max_x = 0.0f, max_y = 0.0f;  // 候选覆盖范围。
+    double sum_w = 0.0, sum_h = 0.0;  // 宽高之和，用于估计网格大小。
+    for (int i = 0; i < count; ++i) {
+        const auto& box = boxes[order[i]];  // 原始候选。
+        auto& c = cands[i];  // 预计算候选。
+        c.x1 = box.x1;
+        c.y1 = box.y1;
+        c.x2 = std::max(box.x1, box.x2) + offset;
+        c.y2 = std::max(box.y1, box.y2) + offset;
+        c.area = (c.x2 - c.x1) * (c.y2 - c.y1);
+        c.group = options.mode == NmsMode::CLASS_AWARE
+                      ? (static_cast<int64_t>(box.batch_id) << 32) | static_cast<uint32_t>(box.cls_id)
+                      : static_cast<int64_t>(box.batch_id);
+        if (i == 0) {
+            min_x = c.x1;
+            min_y = c.y1;
+            max_x = c.x2;
+            max_y = c.y2;
+        } else {
+            min_x = std::min(min_x, c.x1);
+            min_y = std::min(min_y, c.y1);
+            max_x = std::max(max_x, c.x2);
+            max_y = std::max(max_y, c.y2);
+        }
+        sum_w += c.x2 - c.x1;
+        sum_h += c.y2 - c.y1;
+    }
+
+    const int max_keep = options.max_detections > 0 ? options.max_detections : count;  // 保留上限。
+    keep.reserve(std::min(max_keep, count));
+    std::vector<int> kept;  // 已保留候选在 cands 中的下标。
+    kept.reserve(std::min(max_keep, count));
+
+    // 候选较少时直接与全部保留框比较。
+    if (count < k_grid_min_boxes) {
+        for (int i = 0; i < count && static_cast<int>(kept.size()) < max_keep; ++i) {
+            bool suppressed = false;  // 是否被抑制。
+            for (int k : kept) {
+                if (cands[k].group == cands[i].group && iou_over(cands[k], cands[i], options.iou_threshold)) {
+                    suppressed = true;
+                    break;
+                }
+            }
+            if (!suppressed) {
+                kept.push_back(i);
+                keep.push_back(order[i]);
+            }
+        }
+        return;
+    }
+
+    // 网格边长取平均框尺寸，相交的两个框必然覆盖至少一个共同格子。
+    const float cell = std::max(1.0f, static_cast<float>(std::max(sum_w, sum_h) / count));  // 网格边长。
+    const int cols = std::max(1, std::min(k_grid_max_cells, static_cast<int>(std::ceil((max_x - min_x) / cell))));  // 网格列数。
+    const int rows = std::max(1, std::min(k_grid_max_cells, static_cast<int>(std::ceil((max_y - min_y) / cell))));  // 网格行数。
+    const float cell_w = std::max(1e-6f, (max_x - min_x) / cols);  // 实际格宽。
+    const float cell_h = std::max(1e-6f, (max_y - min_y) / rows);  // 实际格高。
+    std::vector<std::vector<int>> grid(static_cast<size_t>(cols) * rows);  // 每格中的保留框。
+    std::vector<int> checked(count, -1);  // 记录保留框最近一次被哪个候选检查过，避免跨格重复计算。
+
+    auto cell_range = [&](const Candidate& c, int& gx1, int& gy1, int& gx2, int& gy2) {
+        gx1 = std::min(cols - 1, std::max(0, static_cast<int>((c.x1 - min_x) / cell_w)));
+        gy1 = std::min(rows - 1, std::max(0, static_cast<int>((c.y1 - min_y) / cell_h)));
+        gx2 = std::min(cols - 1, std::max(0, static_cast<int>((c.x2 - min_x) / cell_w)));
+        gy2 = std::min(rows - 1, std::max(0, static_cast<int>((c.y2 - min_y) / cell_h)));
+    };
+
+    for (int i = 0; i < count && static_cast<int>(kept.size()) < max_keep; ++i) {
+        const auto& c = cands[i];  // 当前候选。
+        int gx1 = 0, gy1 = 0, gx2 = 0, gy2 = 0;  // 覆盖的网格范围。
+        cell_range(c, gx1, gy1, gx2, gy2);
+
+        bool suppressed = false;  // 是否被抑制。
+        for (int gy = gy1; gy <= gy2 && !suppressed; ++gy) {
+            for (int gx = gx1; gx <= gx2 && !suppressed; ++gx) {
+                for (int k : grid[static_cast<size_t>(gy) * cols + gx]) {
+                    if (checked[k] == i) {
+                        continue;
+                    }
+                    checked[k] = i;
+                    if (cands[k].group == c.group && iou_over(cands[k], c, options.iou_threshold)) {
+                        suppressed = true;
+                        break;
+                    }
+                }
+            }
+        }
+        if (suppressed) {
+            continue;
+        }
+
+        kept.push_back(i);
+        keep.push_back(order[i]);
+        for (int gy = gy1; gy <= gy2; ++gy) {
+            for (int gx = gx1; gx <= gx2; ++gx) {
+                grid[static_cast<size_t>(gy) * cols + gx].push_back(i);
+            }
+        }
+    }
+}
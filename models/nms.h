@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief NMS 候选框（输入坐标系，左上/右下角点）。
+ */
+struct NmsBox {
+    float x1 = 0.0f;  // 左上角 x。
+    float y1 = 0.0f;  // 左上角 y。
+    float x2 = 0.0f;  // 右下角 x。
+    float y2 = 0.0f;  // 右下角 y。
+    float score = 0.0f;  // 置信度。
+    int cls_id = 0;  // 类别 ID。
+    int batch_id = 0;  // 批次（图像）序号，不同批次的框互不抑制。
+};
+
+/**
+ * @brief NMS 抑制范围。
+ */
+enum class NmsMode {
+    CLASS_AWARE,  // 只抑制同类别的框。
+    CLASS_AGNOSTIC  // 不区分类别。
+};
+
+/**
+ * @brief NMS 参数。
+ */
+struct NmsOptions {
+    float iou_threshold = 0.45f;  // IoU 大于该值的低分框被抑制。
+    NmsMode mode = NmsMode::CLASS_AWARE;  // 抑制范围。
+    int max_candidates = 0;  // 只取分数最高的前 k 个候选参与 NMS，0 表示不限制。
+    int max_detections = 0;  // 最多保留的框数，0 表示不限制。
+    bool pixel_inclusive = false;  // 宽高按像素闭区间计算（x2 - x1 + 1），兼容旧版 YOLO 后处理。
+};
+
+/**
+ * @brief 快速 NMS，所有检测器共用。
+ *
+ * 候选只排序一次（设置 max_candidates 时只做部分排序），按分数从高到低依次检查；
+ * 保留框按空间网格分桶，每个候选只与覆盖相同网格的保留框计算 IoU，遇到第一个抑制即提前结束。
+ * 批量模式即 batch_id：多张图的候选可以一次传入，不同 batch_id 的框互不影响。
+ * @param boxes 候选框。
+ * @param options NMS 参数。
+ * @param keep 输出保留框在 boxes 中的下标，按分数从高到低排列。
+ */
+void nms(const std::vector<NmsBox>& boxes, const NmsOptions& options, std::vector<int>& keep);
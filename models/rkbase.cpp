@@ -17,26 +17,40 @@ static void dump_tensor_attr(rknn_tensor_attr *attr)
             get_qnt_type_string(attr->qnt_type), attr->zp, attr->scale);
 }
 
-RKBASE::RKBASE(const std::string& model_path)
+RKBASE::RKBASE(const std::string& model_path, int core_mask, const RKBASE* share_from)
 {
     /* Create the neural network */
     spdlog::set_pattern("[%Y-%m-%d %H:%M:%S] [%^%l%$] [thread %t] %v");
-    spdlog::info("Loading model..");
-    int model_data_size = 0;
-    model_data = load_model(model_path.c_str(), &model_data_size);
-    ret = rknn_init(&ctx, model_data, model_data_size, 0, NULL);
+    ret = -1;
+    if (share_from)
+    {
+        // share weights with an existing context, no need to load model again
+        rknn_context src_ctx = share_from->ctx;
+        ret = rknn_dup_context(&src_ctx, &ctx);
+        if (ret < 0)
+        {
+            spdlog::warn("rknn_dup_context error ret={}, load model again", ret);
+        }
+    }
     if (ret < 0)
     {
-        printf("rknn_init error ret=%d\n", ret);
-        exit(-1);
+        spdlog::info("Loading model..");
+        int model_data_size = 0;
+        model_data = load_model(model_path.c_str(), &model_data_size);
+        ret = rknn_init(&ctx, model_data, model_data_size, 0, NULL);
+        if (ret < 0)
+        {
+            printf("rknn_init error ret=%d\n", ret);
+            exit(-1);
+        }
     }
 
     // set core mask
-    rknn_core_mask core_mask = RKNN_NPU_CORE_AUTO;
-    ret = rknn_set_core_mask(ctx, core_mask);
+    this->core_mask = core_mask;
+    ret = rknn_set_core_mask(ctx, static_cast<rknn_core_mask>(core_mask));
     if (ret < 0)
     {
-        spdlog::error("rknn_init core error ret={}", ret);
+        spdlog::error("rknn_init core error ret={} core_mask={}", ret, core_mask);
         exit(-1);
     }
 
@@ -129,10 +143,13 @@ int RKBASE::set_coremask(int n)
     switch(n % 3){
         case 0:
             core_mask = RKNN_NPU_CORE_0;
+            break;
         case 1:
             core_mask = RKNN_NPU_CORE_1;
-        case 2:
+            break;
+        default:
             core_mask = RKNN_NPU_CORE_2;
+            break;
     }
     ret = rknn_set_core_mask(ctx, core_mask);
     if (ret < 0)
@@ -140,6 +157,7 @@ int RKBASE::set_coremask(int n)
         spdlog::error("rknn_init core error ret={}", ret);
         exit(-1);
     }
+    this->core_mask = core_mask;
     return ret;
 }
 
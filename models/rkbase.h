@@ -13,9 +13,14 @@ using json = nlohmann::json;
 class RKBASE
 {
 public:
-    RKBASE(const std::string& model_path);
+    // core_mask: rknn_core_mask value, such as RKNN_NPU_CORE_0 or RKNN_NPU_CORE_0_1 (RKNN_NPU_CORE_AUTO by default).
+    // share_from: if not null, the new context is created by rknn_dup_context from it and shares its weights,
+    //             the model file is not loaded again. it must outlive this instance.
+    RKBASE(const std::string& model_path, int core_mask = RKNN_NPU_CORE_AUTO, const RKBASE* share_from = nullptr);
     ~RKBASE();
+    // pin context to single NPU core, n % 3 selects core 0/1/2.
     int set_coremask(int n);
+    int get_coremask() const { return core_mask; }
 
 protected:
     int model_channel = 3;
@@ -23,6 +28,7 @@ protected:
     int model_height = 384;
 
     rknn_context ctx;
+    int core_mask = RKNN_NPU_CORE_AUTO;
     unsigned char* model_data = nullptr;
     rknn_sdk_version version;
     rknn_input_output_num io_num;
@@ -9,12 +9,26 @@ int YOLO::load_config(const std::string &json_path, YOLOConfig& conf)
     conf.model_path = j_conf["model_path"].template get<std::string>();
     conf.conf_threshold = j_conf["conf_threshold"].template get<float>();
     conf.nms_threshold = j_conf["nms_threshold"].template get<float>();
+    if (j_conf.contains("max_detections")){
+        conf.max_detections = j_conf["max_detections"].template get<int>();
+    }
+    if (j_conf.contains("class_agnostic_nms")){
+        conf.class_agnostic_nms = j_conf["class_agnostic_nms"].template get<bool>();
+    }
     for (auto& it : j_conf["labels"]){
         conf.labels.push_back(it.template get<std::string>());
     }
     for (auto& it : j_conf["alarm_labels"]){
         conf.alarm_labels.push_back(it.template get<std::string>());
     }
+    if (j_conf.contains("core_mask")){
+        conf.core_mask = j_conf["core_mask"].template get<int>();
+    }
+    if (j_conf.contains("core_masks")){
+        for (auto& it : j_conf["core_masks"]){
+            conf.core_masks.push_back(it.template get<int>());
+        }
+    }
     std::string model_type = j_conf["model_type"].template get<std::string>();
     if (model_type == "YOLOv5"){
         conf.type = ModelType::YOLOv5;
@@ -57,11 +71,20 @@ void YOLO::run(const cv::Mat &src, std::vector<DetectionResult> &res)
 //         }
 //     }
 //     if (resize_buf) free(resize_buf);
-    LETTER_BOX lb;
+    YoloRawOutput out;
+    res.clear();
+    if (infer(src, out)) {
+        decode(out, res);
+    }
+}
+
+bool YOLO::infer(const cv::Mat &src, YoloRawOutput& out)
+{
+    LETTER_BOX& lb = out.lb;
     init_letterbox(lb);
     if (src.cols == model_width && src.rows == model_height)
     {
-        run_model(src.data, lb, res);
+        return run_model(src.data, out);
     }
     else{
         set_letterbox(src.cols, src.rows, lb);
@@ -69,10 +92,24 @@ void YOLO::run(const cv::Mat &src, std::vector<DetectionResult> &res)
         cv::Mat lb_img;
         opencv_letter_box_resize(src, lb_img, lb);
         cv::cvtColor(lb_img, lb_img, cv::COLOR_BGR2RGB);
-        run_model(lb_img.data, lb, res);
+        return run_model(lb_img.data, out);
     }
 }
 
+void YOLO::decode(YoloRawOutput& out, std::vector<DetectionResult> &res)
+{
+    if (out.bufs.size() != io_num.n_output) return;
+    rknn_output outputs[io_num.n_output];
+    memset(outputs, 0, sizeof(outputs));
+    for (int i = 0; i < io_num.n_output; i++) {
+        outputs[i].index = i;
+        outputs[i].want_float = 0;
+        outputs[i].buf = out.bufs[i].data();
+        outputs[i].size = out.bufs[i].size();
+    }
+    post->run(output_attrs, outputs, res, out.lb);
+}
+
 void YOLO::run(std::vector<cv::Mat> &img_datas, std::vector<std::vector<DetectionResult>> &res_datas){
     res_datas.clear();
     // scan 1 by 1
@@ -83,7 +120,7 @@ void YOLO::run(std::vector<cv::Mat> &img_datas, std::vector<std::vector<Detectio
     }
 }
 
-void YOLO::run_model(void* buf, LETTER_BOX &lb, std::vector<DetectionResult> &res)
+bool YOLO::run_model(void* buf, YoloRawOutput& out)
 {
     inputs[0].buf = buf;
     rknn_inputs_set(ctx, io_num.n_input, inputs);
@@ -95,8 +132,15 @@ void YOLO::run_model(void* buf, LETTER_BOX &lb, std::vector<DetectionResult> &re
     }
     ret = rknn_run(ctx, NULL);
     ret = rknn_outputs_get(ctx,  io_num.n_output, outputs, NULL);
-    post->run(output_attrs, outputs, res, lb);
+    if (ret < 0) return false;
+    // copy out and release, so the context is free for next frame while this one is decoded
+    out.bufs.resize(io_num.n_output);
+    for (int i = 0; i < io_num.n_output; i++) {
+        auto data = static_cast<int8_t*>(outputs[i].buf);
+        out.bufs[i].assign(data, data + outputs[i].size);
+    }
     rknn_outputs_release(ctx, io_num.n_output, outputs);
+    return true;
 }
 
 void YOLO::set_letterbox(int in_w, int in_h, LETTER_BOX& lb)
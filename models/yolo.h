@@ -2,10 +2,18 @@
 #include "rkbase.h"
 #include "yolo_post.h"
 
+// raw (quantized) outputs of one frame, filled by YOLO::infer(...) and consumed by YOLO::decode(...).
+// the two steps can run in different threads, so NPU runs next frame while CPU decodes this one.
+struct YoloRawOutput {
+    std::vector<std::vector<int8_t>> bufs;
+    LETTER_BOX lb;
+};
+
 // Object detection Task, support: yolov5 to yolov8.
 class YOLO:public RKBASE{
 public:
-    explicit YOLO(YOLOConfig& config):RKBASE(config.model_path){
+    // share_from: share weights with another instance (one context per NPU core), see RKBASE.
+    explicit YOLO(YOLOConfig& config, const YOLO* share_from = nullptr):RKBASE(config.model_path, config.core_mask, share_from){
         switch(config.type){
         case ModelType::YOLOv5:
             post = new YOLOv5v7_Post(config);
@@ -30,9 +38,13 @@ public:
     }
     void run(const cv::Mat& src, std::vector<DetectionResult> &res);
     void run(std::vector<cv::Mat> &img_datas, std::vector<std::vector<DetectionResult>> &res_datas);
+    // pipeline step 1: letterbox, set input, run on NPU and fetch outputs, no postprocess.
+    bool infer(const cv::Mat& src, YoloRawOutput& out);
+    // pipeline step 2: decode and nms, does not touch rknn context.
+    void decode(YoloRawOutput& out, std::vector<DetectionResult> &res);
     // void run(image_buffer_t& src, std::vector<DetectionResult> &res);
 private:
-    void run_model(void* buf, LETTER_BOX &lb, std::vector<DetectionResult> &res);
+    bool run_model(void* buf, YoloRawOutput& out);
     void set_letterbox(int in_w, int in_h, LETTER_BOX &lb);
     void init_letterbox(LETTER_BOX &lb);
     PostProcessorBase *post = nullptr;
@@ -6,14 +6,68 @@
 #include <map>
 #include <utility>
 
-YOLO26::YOLO26(const YOLO26Config& config) : RKBASE(config.model_path), config(config) {
+#include <sys/stat.h>
+
+#include "allocator/dma/dma_alloc.h"
+
+namespace {
+constexpr size_t k_max_input_mems = 32;  // 输入内存缓存上限，超过时清空重建。
+}
+
+YOLO26::YOLO26(const YOLO26Config& config, const YOLO26* share_from)
+    : RKBASE(config.model_path, config.core_mask, share_from), config(config) {
     // 使用模型真实输入尺寸，避免配置尺寸与模型不一致导致越界访问。
     this->config.input_width = model_width;
     this->config.input_height = model_height;
     this->postprocessor = std::make_unique<Yolo26PostProcessor>(this->config);
+    this->output_pool = std::make_shared<OutputPool>();
+    init_output_layouts();
+}
+
+YOLO26::~YOLO26() {
+    release_input_mems();
+    if (cpu_input_mem != nullptr) {
+        rknn_destroy_mem(ctx, cpu_input_mem);
+        cpu_input_mem = nullptr;
+    }
 }
 
-YOLO26::~YOLO26() = default;
+rknn_tensor_mem* YOLO26::get_input_mem(int fd, void* vir_addr, size_t size) {
+    // 缓冲池释放超出上限的块后，新分配的块可能复用相同的 fd、地址和大小，
+    // 因此以 DMA-buf 的 inode 区分缓冲，避免命中已释放缓冲的导入内存。
+    struct stat st;  // DMA-buf 文件信息。
+    if (fstat(fd, &st) != 0) {
+        return nullptr;
+    }
+    for (const auto& item : input_mems) {
+        if (item.dev == st.st_dev && item.ino == st.st_ino && item.vir_addr == vir_addr && item.size == size) {
+            return item.mem;
+        }
+    }
+    if (input_mems.size() >= k_max_input_mems) {
+        release_input_mems();
+    }
+
+    rknn_tensor_mem* mem = rknn_create_mem_from_fd(ctx, fd, vir_addr, static_cast<uint32_t>(size), 0);  // 导入的输入内存。
+    if (mem == nullptr) {
+        return nullptr;
+    }
+    InputMem item;  // 新缓存项。
+    item.dev = st.st_dev;
+    item.ino = st.st_ino;
+    item.vir_addr = vir_addr;
+    item.size = size;
+    item.mem = mem;
+    input_mems.push_back(item);
+    return mem;
+}
+
+void YOLO26::release_input_mems() {
+    for (auto& item : input_mems) {
+        rknn_destroy_mem(ctx, item.mem);
+    }
+    input_mems.clear();
+}
 
 int YOLO26::load_config(const std::string& json_path, YOLO26Config& conf) {
     std::ifstream stream(json_path);  // 配置文件输入流。
@@ -30,6 +84,13 @@ int YOLO26::load_config(const std::string& json_path, YOLO26Config& conf) {
     conf.input_width = j_conf.value("input_width", 640);
     conf.input_height = j_conf.value("input_height", 352);
     conf.core_mask = j_conf.value("core_mask", 0);
+    conf.int8_postprocess = j_conf.value("int8_postprocess", true);
+    conf.core_masks.clear();
+    if (j_conf.contains("core_masks") && j_conf["core_masks"].is_array()) {
+        for (const auto& item : j_conf["core_masks"]) {
+            conf.core_masks.push_back(item.template get<int>());
+        }
+    }
     conf.type = ModelType::YOLO26;
 
     conf.labels.clear();
@@ -58,131 +119,237 @@ int YOLO26::load_config(const std::string& json_path, YOLO26Config& conf) {
     return 0;
 }
 
-bool YOLO26::output_to_chw(const rknn_output& output, const rknn_tensor_attr& attr, Yolo26HeadTensor& tensor) {
-    if (output.buf == nullptr) {
+bool YOLO26::parse_output_layout(const rknn_tensor_attr& attr, OutputLayout& layout) {
+    if (attr.n_dims == 4) {
+        if (attr.fmt == RKNN_TENSOR_NHWC) {
+            layout.feat_h = attr.dims[1];
+            layout.feat_w = attr.dims[2];
+            layout.channels = attr.dims[3];
+            layout.c_stride = 1;
+            layout.p_stride = layout.channels;
+        } else {
+            layout.channels = attr.dims[1];
+            layout.feat_h = attr.dims[2];
+            layout.feat_w = attr.dims[3];
+            layout.c_stride = layout.feat_h * layout.feat_w;
+            layout.p_stride = 1;
+        }
+    } else if (attr.n_dims == 3) {
+        layout.channels = attr.dims[0];
+        layout.feat_h = attr.dims[1];
+        layout.feat_w = attr.dims[2];
+        layout.c_stride = layout.feat_h * layout.feat_w;
+        layout.p_stride = 1;
+    } else {
         return false;
     }
-    const float* src = reinterpret_cast<const float*>(output.buf);  // 输出浮点缓冲区。
-    if (src == nullptr) {
-        return false;
+    layout.elems = static_cast<size_t>(layout.channels) * layout.feat_h * layout.feat_w;
+    return layout.channels > 0 && layout.feat_h > 0 && layout.feat_w > 0;
+}
+
+void YOLO26::init_output_layouts() {
+    output_layouts.assign(io_num.n_output, OutputLayout());
+    std::map<std::pair<int, int>, HeadLayout> head_map;  // 以 (H,W) 聚合分支输出。
+    for (uint32_t i = 0; i < io_num.n_output; ++i) {
+        auto& layout = output_layouts[i];  // 当前输出布局。
+        if (!parse_output_layout(output_attrs[i], layout)) {
+            continue;
+        }
+        auto& head = head_map[std::make_pair(layout.feat_h, layout.feat_w)];  // 当前尺度 head。
+        if (layout.channels == 4) {
+            head.reg_index = static_cast<int>(i);
+        } else {
+            head.cls_index = static_cast<int>(i);
+        }
     }
 
-    if (attr.n_dims == 4) {
-        if (attr.fmt == RKNN_TENSOR_NCHW) {
-            tensor.num_cls = attr.dims[1];
-            tensor.feat_h = attr.dims[2];
-            tensor.feat_w = attr.dims[3];
-            const size_t total = static_cast<size_t>(tensor.num_cls) * tensor.feat_h * tensor.feat_w;  // 总元素数。
-            tensor.cls.assign(src, src + total);
-            return true;
-        }
-
-        tensor.feat_h = attr.dims[1];
-        tensor.feat_w = attr.dims[2];
-        tensor.num_cls = attr.dims[3];
-        const size_t total = static_cast<size_t>(tensor.num_cls) * tensor.feat_h * tensor.feat_w;  // 总元素数。
-        tensor.cls.resize(total);
-        for (int y = 0; y < tensor.feat_h; ++y) {
-            for (int x = 0; x < tensor.feat_w; ++x) {
-                for (int c = 0; c < tensor.num_cls; ++c) {
-                    const size_t nhwci = static_cast<size_t>(y) * tensor.feat_w * tensor.num_cls + static_cast<size_t>(x) * tensor.num_cls + c;  // NHWC 索引。
-                    const size_t chwi = static_cast<size_t>(c) * tensor.feat_h * tensor.feat_w + static_cast<size_t>(y) * tensor.feat_w + x;  // CHW 索引。
-                    tensor.cls[chwi] = src[nhwci];
-                }
-            }
+    head_layouts.clear();
+    for (const auto& pair : head_map) {
+        if (pair.second.reg_index >= 0 && pair.second.cls_index >= 0) {
+            head_layouts.push_back(pair.second);
+        }
+    }
+    std::sort(head_layouts.begin(), head_layouts.end(), [this](const HeadLayout& a, const HeadLayout& b) {
+        return output_layouts[a.reg_index].feat_h > output_layouts[b.reg_index].feat_h;
+    });
+
+    // 全部输出为 int8 仿射量化时直接取量化值，由后处理在量化域比较阈值，省去运行时逐元素反量化。
+    int8_outputs = config.int8_postprocess;
+    for (uint32_t i = 0; i < io_num.n_output; ++i) {
+        if (output_attrs[i].type != RKNN_TENSOR_INT8 || output_attrs[i].qnt_type != RKNN_TENSOR_QNT_AFFINE_ASYMMETRIC) {
+            int8_outputs = false;
         }
-        return true;
     }
+    spdlog::info("YOLO26 postprocess on {} outputs", int8_outputs ? "int8" : "float");
+}
 
-    if (attr.n_dims == 3) {
-        tensor.num_cls = attr.dims[0];
-        tensor.feat_h = attr.dims[1];
-        tensor.feat_w = attr.dims[2];
-        const size_t total = static_cast<size_t>(tensor.num_cls) * tensor.feat_h * tensor.feat_w;  // 总元素数。
-        tensor.cls.assign(src, src + total);
-        return true;
+std::shared_ptr<Yolo26OutputBuffers> YOLO26::acquire_output_buffers() {
+    std::unique_ptr<Yolo26OutputBuffers> buffers;  // 借出的缓冲组。
+    {
+        std::lock_guard<std::mutex> guard(output_pool->lock);
+        if (!output_pool->idle.empty()) {
+            buffers = std::move(output_pool->idle.back());
+            output_pool->idle.pop_back();
+        }
+    }
+    if (buffers == nullptr) {
+        buffers.reset(new Yolo26OutputBuffers(io_num.n_output));
+        for (uint32_t i = 0; i < io_num.n_output; ++i) {
+            (*buffers)[i].resize(static_cast<size_t>(output_attrs[i].n_elems) * (int8_outputs ? sizeof(int8_t) : sizeof(float)));
+        }
     }
 
-    return false;
+    std::shared_ptr<OutputPool> pool = output_pool;  // 缓冲归还目标。
+    return std::shared_ptr<Yolo26OutputBuffers>(buffers.release(), [pool](Yolo26OutputBuffers* ptr) {
+        std::lock_guard<std::mutex> guard(pool->lock);
+        pool->idle.emplace_back(ptr);
+    });
 }
 
 void YOLO26::run(const uint8_t* model_input_rgb, int orig_w, int orig_h, std::vector<DetectionResult>& res) {
     res.clear();
+    Yolo26RawOutput out;  // 原始输出。
+    if (infer(model_input_rgb, orig_w, orig_h, out)) {
+        decode(out, res);
+    }
+}
+
+void YOLO26::run(int input_fd, void* input_vir_addr, size_t input_size, int orig_w, int orig_h, std::vector<DetectionResult>& res) {
+    res.clear();
+    Yolo26RawOutput out;  // 原始输出。
+    if (infer(input_fd, input_vir_addr, input_size, orig_w, orig_h, out)) {
+        decode(out, res);
+    }
+}
+
+bool YOLO26::infer(const uint8_t* model_input_rgb, int orig_w, int orig_h, Yolo26RawOutput& out) {
     if (model_input_rgb == nullptr || orig_w <= 0 || orig_h <= 0) {
-        return;
+        return false;
     }
 
-    const float ratio_w = static_cast<float>(config.input_width) / static_cast<float>(orig_w);  // 宽方向缩放比。
-    const float ratio_h = static_cast<float>(config.input_height) / static_cast<float>(orig_h);  // 高方向缩放比。
+    if (input_mem_bound) {
+        // 已绑定过 DMA 输入，继续走 io_mem 路径，避免与 rknn_inputs_set 混用。
+        if (cpu_input_mem == nullptr) {
+            cpu_input_mem = rknn_create_mem(ctx, input_attrs[0].size_with_stride);
+            if (cpu_input_mem == nullptr) {
+                return false;
+            }
+        }
+        std::memcpy(cpu_input_mem->virt_addr, model_input_rgb, inputs[0].size);
+        ret = rknn_set_io_mem(ctx, cpu_input_mem, &input_attrs[0]);
+        if (ret < 0) {
+            return false;
+        }
+    } else {
+        inputs[0].buf = const_cast<uint8_t*>(model_input_rgb);
+        ret = rknn_inputs_set(ctx, io_num.n_input, inputs);
+        if (ret < 0) {
+            return false;
+        }
+    }
 
-    inputs[0].buf = const_cast<uint8_t*>(model_input_rgb);
-    ret = rknn_inputs_set(ctx, io_num.n_input, inputs);
+    return run_and_fetch(orig_w, orig_h, out);
+}
+
+bool YOLO26::infer(int input_fd, void* input_vir_addr, size_t input_size, int orig_w, int orig_h, Yolo26RawOutput& out) {
+    if (input_fd < 0 || orig_w <= 0 || orig_h <= 0 || input_size < inputs[0].size) {
+        return false;
+    }
+
+    // 模型要求输入行 stride 对齐且与宽度不一致时，紧凑缓冲无法直接作为输入内存。
+    const bool stride_match = input_attrs[0].w_stride == 0 || static_cast<int>(input_attrs[0].w_stride) == model_width;  // 行 stride 是否匹配。
+    rknn_tensor_mem* mem = stride_match ? get_input_mem(input_fd, input_vir_addr, input_size) : nullptr;  // 输入内存。
+    if (mem == nullptr) {
+        if (input_vir_addr != nullptr) {
+            // 回退为 CPU 读取，先使 CPU 缓存失效，读到 RGA 等设备写入的最新数据。
+            dma_sync_device_to_cpu(input_fd);
+            return infer(static_cast<const uint8_t*>(input_vir_addr), orig_w, orig_h, out);
+        }
+        return false;
+    }
+
+    if (!input_mem_bound) {
+        input_attrs[0].type = RKNN_TENSOR_UINT8;
+        input_attrs[0].fmt = RKNN_TENSOR_NHWC;
+        input_mem_bound = true;
+    }
+    ret = rknn_set_io_mem(ctx, mem, &input_attrs[0]);
     if (ret < 0) {
-        return;
+        return false;
     }
 
+    return run_and_fetch(orig_w, orig_h, out);
+}
+
+bool YOLO26::run_and_fetch(int orig_w, int orig_h, Yolo26RawOutput& out) {
+    out.heads.clear();
+    out.buffers.reset();
+    out.orig_w = orig_w;
+    out.orig_h = orig_h;
+
+    // 输出写入预分配缓冲（is_prealloc），运行时不再逐帧分配。
+    auto buffers = acquire_output_buffers();  // 本帧输出缓冲。
     std::vector<rknn_output> outputs(io_num.n_output);  // RKNN 输出容器。
     for (uint32_t i = 0; i < io_num.n_output; ++i) {
         outputs[i].index = i;
-        outputs[i].want_float = 1;
-        outputs[i].is_prealloc = 0;
+        outputs[i].want_float = int8_outputs ? 0 : 1;
+        outputs[i].is_prealloc = 1;
+        outputs[i].buf = (*buffers)[i].data();
+        outputs[i].size = static_cast<uint32_t>((*buffers)[i].size());
     }
 
     ret = rknn_run(ctx, nullptr);
     if (ret < 0) {
-        return;
+        return false;
     }
     ret = rknn_outputs_get(ctx, io_num.n_output, outputs.data(), nullptr);
     if (ret < 0) {
-        return;
+        return false;
     }
+    rknn_outputs_release(ctx, io_num.n_output, outputs.data());
 
-    struct PartialHead {
-        int feat_h = 0;  // 特征图高度。
-        int feat_w = 0;  // 特征图宽度。
-        int cls_c = 0;  // 分类通道数。
-        std::vector<float> reg;  // 回归数据。
-        std::vector<float> cls;  // 分类数据。
-    };
-
-    std::map<std::pair<int, int>, PartialHead> head_map;  // 以 (H,W) 聚合分支输出。
-    for (uint32_t i = 0; i < io_num.n_output; ++i) {
-        Yolo26HeadTensor tensor;  // 临时张量。
-        if (!output_to_chw(outputs[i], output_attrs[i], tensor)) {
+    // head 直接指向输出缓冲，按原始布局的步长访问。
+    out.heads.reserve(head_layouts.size());
+    for (const auto& head_layout : head_layouts) {
+        const auto& reg = output_layouts[head_layout.reg_index];  // 回归分支布局。
+        const auto& cls = output_layouts[head_layout.cls_index];  // 分类分支布局。
+        const size_t elem_size = int8_outputs ? sizeof(int8_t) : sizeof(float);  // 元素字节数。
+        const auto& reg_buf = (*buffers)[head_layout.reg_index];  // 回归分支缓冲。
+        const auto& cls_buf = (*buffers)[head_layout.cls_index];  // 分类分支缓冲。
+        if (reg_buf.size() < reg.elems * elem_size || cls_buf.size() < cls.elems * elem_size) {
             continue;
         }
-
-        auto key = std::make_pair(tensor.feat_h, tensor.feat_w);  // 当前 head 键。
-        auto& partial = head_map[key];
-        partial.feat_h = tensor.feat_h;
-        partial.feat_w = tensor.feat_w;
-        if (tensor.num_cls == 4) {
-            partial.reg = std::move(tensor.cls);
+        Yolo26HeadTensor head;  // 待解码 head。
+        head.feat_h = reg.feat_h;
+        head.feat_w = reg.feat_w;
+        head.num_cls = cls.channels;
+        if (int8_outputs) {
+            head.reg_i8 = reinterpret_cast<const int8_t*>(reg_buf.data());
+            head.reg_zp = out_zps[head_layout.reg_index];
+            head.reg_scale = out_scales[head_layout.reg_index];
+            head.cls_i8 = reinterpret_cast<const int8_t*>(cls_buf.data());
+            head.cls_zp = out_zps[head_layout.cls_index];
+            head.cls_scale = out_scales[head_layout.cls_index];
         } else {
-            partial.cls = std::move(tensor.cls);
-            partial.cls_c = tensor.num_cls;
+            head.reg = reinterpret_cast<const float*>(reg_buf.data());
+            head.cls = reinterpret_cast<const float*>(cls_buf.data());
         }
+        head.reg_c_stride = reg.c_stride;
+        head.reg_p_stride = reg.p_stride;
+        head.cls_c_stride = cls.c_stride;
+        head.cls_p_stride = cls.p_stride;
+        out.heads.push_back(head);
     }
+    out.buffers = std::move(buffers);
+    return true;
+}
 
-    std::vector<Yolo26HeadTensor> heads;  // 最终 head 集合。
-    heads.reserve(head_map.size());
-    for (auto& pair : head_map) {
-        auto& partial = pair.second;
-        if (partial.reg.empty() || partial.cls.empty() || partial.cls_c <= 0) {
-            continue;
-        }
-        Yolo26HeadTensor head;  // 待解码 head。
-        head.feat_h = partial.feat_h;
-        head.feat_w = partial.feat_w;
-        head.num_cls = partial.cls_c;
-        head.reg = std::move(partial.reg);
-        head.cls = std::move(partial.cls);
-        heads.push_back(std::move(head));
-    }
-    std::sort(heads.begin(), heads.end(), [](const Yolo26HeadTensor& a, const Yolo26HeadTensor& b) {
-        return a.feat_h > b.feat_h;
-    });
-
-    postprocessor->run(heads, orig_w, orig_h, ratio_w, ratio_h, res);
-    rknn_outputs_release(ctx, io_num.n_output, outputs.data());
+void YOLO26::decode(const Yolo26RawOutput& out, std::vector<DetectionResult>& res) const {
+    res.clear();
+    if (out.orig_w <= 0 || out.orig_h <= 0) {
+        return;
+    }
+    const float ratio_w = static_cast<float>(config.input_width) / static_cast<float>(out.orig_w);  // 宽方向缩放比。
+    const float ratio_h = static_cast<float>(config.input_height) / static_cast<float>(out.orig_h);  // 高方向缩放比。
+    postprocessor->run(out.heads, out.orig_w, out.orig_h, ratio_w, ratio_h, res);
 }
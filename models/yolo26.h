@@ -2,12 +2,34 @@
 
 #include <memory>
 #include <cstdint>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include <sys/types.h>
+
 #include "rkbase.h"
 #include "yolo26_post.h"
 
+/**
+ * @brief 一组 RKNN 输出缓冲（每个输出一块，float 或 int8 数据），由模型预分配并循环复用。
+ */
+using Yolo26OutputBuffers = std::vector<std::vector<uint8_t>>;
+
+/**
+ * @brief 已完成 NPU 推理、等待后处理的一帧输出。
+ *
+ * 由 YOLO26::infer 填充，交给 YOLO26::decode 解码；两步可以在不同线程执行，
+ * 使 NPU 推理下一帧的同时 CPU 对上一帧做后处理。
+ * heads 直接指向 buffers，最后一个持有者释放后 buffers 归还模型的输出缓冲池。
+ */
+struct Yolo26RawOutput {
+    std::shared_ptr<const Yolo26OutputBuffers> buffers;  // 预分配的输出缓冲。
+    std::vector<Yolo26HeadTensor> heads;  // 按特征图从大到小排列的 head 视图。
+    int orig_w = 0;  // 原始图宽度。
+    int orig_h = 0;  // 原始图高度。
+};
+
 /**
  * @brief YOLO26 RKNN 推理模型封装。
  */
@@ -15,9 +37,10 @@ class YOLO26 : public RKBASE {
 public:
     /**
      * @brief 构造 YOLO26 模型。
-     * @param config YOLO26 配置。
+     * @param config YOLO26 配置，config.core_mask 为该上下文绑定的 NPU 核。
+     * @param share_from 非空时通过 rknn_dup_context 与其共享权重（多核多上下文），须比本对象存活更久。
      */
-    explicit YOLO26(const YOLO26Config& config);
+    explicit YOLO26(const YOLO26Config& config, const YOLO26* share_from = nullptr);
 
     /**
      * @brief 释放模型资源。
@@ -41,17 +64,140 @@ public:
      */
     void run(const uint8_t* model_input_rgb, int orig_w, int orig_h, std::vector<DetectionResult>& res);
 
+    /**
+     * @brief 单帧推理，输入为 DMA-buf（零拷贝）。
+     *
+     * 按 fd 导入为 RKNN 输入内存并缓存，同一缓冲再次输入时不再导入；
+     * 模型输入要求行 stride 与宽度不一致时退回按虚拟地址拷贝输入（拷贝前同步 CPU 缓存，调用方无需同步）。
+     * @param input_fd 输入 RGB 缓冲 DMA-buf fd（NHWC uint8）。
+     * @param input_vir_addr 输入缓冲虚拟地址。
+     * @param input_size 输入缓冲字节数。
+     * @param orig_w 原始图宽度。
+     * @param orig_h 原始图高度。
+     * @param res 输出检测结果。
+     */
+    void run(int input_fd, void* input_vir_addr, size_t input_size, int orig_w, int orig_h, std::vector<DetectionResult>& res);
+
+    /**
+     * @brief 流水线第一步：设置输入、执行 NPU 推理并取回输出，不做后处理。
+     * @param model_input_rgb 输入预处理后的 RGB 字节缓冲（NHWC uint8）。
+     * @param orig_w 原始图宽度。
+     * @param orig_h 原始图高度。
+     * @param out 输出的原始 head 数据。
+     * @return true 成功；false 输入无效或推理失败。
+     */
+    bool infer(const uint8_t* model_input_rgb, int orig_w, int orig_h, Yolo26RawOutput& out);
+
+    /**
+     * @brief 流水线第一步（DMA-buf 输入），规则同 run 的 DMA-buf 版本。
+     * @param input_fd 输入 RGB 缓冲 DMA-buf fd（NHWC uint8）。
+     * @param input_vir_addr 输入缓冲虚拟地址。
+     * @param input_size 输入缓冲字节数。
+     * @param orig_w 原始图宽度。
+     * @param orig_h 原始图高度。
+     * @param out 输出的原始 head 数据。
+     * @return true 成功；false 输入无效或推理失败。
+     */
+    bool infer(int input_fd, void* input_vir_addr, size_t input_size, int orig_w, int orig_h, Yolo26RawOutput& out);
+
+    /**
+     * @brief 流水线第二步：解码与 NMS，不访问 RKNN 上下文，可与 infer 并发执行。
+     * @param out infer 输出的原始 head 数据。
+     * @param res 输出检测结果。
+     */
+    void decode(const Yolo26RawOutput& out, std::vector<DetectionResult>& res) const;
+
 private:
     /**
-     * @brief 把 RKNN 输出张量转换为 CHW 格式。
-     * @param output RKNN 输出。
+     * @brief 执行推理并取回输出（输入已设置）。
+     * @param orig_w 原始图宽度。
+     * @param orig_h 原始图高度。
+     * @param out 输出的原始 head 数据。
+     * @return true 成功；false 推理失败。
+     */
+    bool run_and_fetch(int orig_w, int orig_h, Yolo26RawOutput& out);
+
+    /**
+     * @brief 查找或创建 DMA-buf 对应的 RKNN 输入内存。
+     * @param fd DMA-buf fd。
+     * @param vir_addr 虚拟地址。
+     * @param size 缓冲字节数。
+     * @return rknn_tensor_mem* 输入内存，失败返回空。
+     */
+    rknn_tensor_mem* get_input_mem(int fd, void* vir_addr, size_t size);
+
+    /**
+     * @brief 释放全部缓存的输入内存。
+     */
+    void release_input_mems();
+
+    /**
+     * @brief 单个输出张量的布局（按 RKNN 返回的原始布局访问，不做转置）。
+     */
+    struct OutputLayout {
+        int feat_h = 0;  // 特征图高度。
+        int feat_w = 0;  // 特征图宽度。
+        int channels = 0;  // 通道数。
+        int c_stride = 0;  // 通道步长（元素）。
+        int p_stride = 0;  // 像素步长（元素）。
+        size_t elems = 0;  // 元素总数。
+    };
+
+    /**
+     * @brief 由同一尺度回归、分类两个输出组成的 head。
+     */
+    struct HeadLayout {
+        int reg_index = -1;  // 回归分支输出序号。
+        int cls_index = -1;  // 分类分支输出序号。
+    };
+
+    /**
+     * @brief 输出缓冲池，由模型与借出的缓冲共同持有，保证缓冲晚于模型释放时仍可安全归还。
+     */
+    struct OutputPool {
+        std::mutex lock;  // 保护 idle。
+        std::vector<std::unique_ptr<Yolo26OutputBuffers>> idle;  // 空闲缓冲组。
+    };
+
+    /**
+     * @brief 解析输出张量布局。
      * @param attr 张量属性。
-     * @param tensor 输出 head 张量。
-     * @return true 转换成功；false 转换失败。
+     * @param layout 输出布局。
+     * @return true 支持该布局；false 不支持。
+     */
+    static bool parse_output_layout(const rknn_tensor_attr& attr, OutputLayout& layout);
+
+    /**
+     * @brief 根据输出属性一次性建立 head 布局，并决定是否走 int8 输出。
      */
-    static bool output_to_chw(const rknn_output& output, const rknn_tensor_attr& attr, Yolo26HeadTensor& tensor);
+    void init_output_layouts();
+
+    /**
+     * @brief 从缓冲池借出一组输出缓冲，不足时新分配。
+     * @return std::shared_ptr<Yolo26OutputBuffers> 输出缓冲，释放时自动归还。
+     */
+    std::shared_ptr<Yolo26OutputBuffers> acquire_output_buffers();
 
 private:
     YOLO26Config config;  // YOLO26 运行配置。
     std::unique_ptr<Yolo26PostProcessor> postprocessor;  // 后处理对象。
+
+    /**
+     * @brief 已导入的 DMA-buf 输入内存。
+     */
+    struct InputMem {
+        dev_t dev = 0;  // DMA-buf 所在设备号。
+        ino_t ino = 0;  // DMA-buf inode，每个缓冲唯一，fd 被复用时仍能区分。
+        void* vir_addr = nullptr;  // 虚拟地址。
+        size_t size = 0;  // 缓冲字节数。
+        rknn_tensor_mem* mem = nullptr;  // RKNN 输入内存。
+    };
+    std::vector<InputMem> input_mems;  // 已导入的输入内存缓存。
+    rknn_tensor_mem* cpu_input_mem = nullptr;  // 绑定过 DMA 输入后 CPU 输入使用的内部内存。
+    bool input_mem_bound = false;  // 是否已通过 rknn_set_io_mem 绑定输入。
+
+    std::vector<OutputLayout> output_layouts;  // 各输出张量布局。
+    std::vector<HeadLayout> head_layouts;  // 按特征图从大到小排列的 head 布局。
+    std::shared_ptr<OutputPool> output_pool;  // 预分配输出缓冲池（流水线中同时在途的帧各占一组）。
+    bool int8_outputs = false;  // 是否直接取 int8 量化输出（want_float=0）交给后处理。
 };
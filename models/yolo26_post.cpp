@@ -2,62 +2,100 @@
 
 #include <algorithm>
 #include <cmath>
-
-Yolo26PostProcessor::Yolo26PostProcessor(const YOLO26Config& config) : config(config) {}
+#include <limits>
+
+Yolo26PostProcessor::Yolo26PostProcessor(const YOLO26Config& config) : config(config) {
+    if (config.conf_threshold <= 0.0f) {
+        conf_logit = -std::numeric_limits<float>::infinity();
+    } else if (config.conf_threshold >= 1.0f) {
+        conf_logit = std::numeric_limits<float>::infinity();
+    } else {
+        conf_logit = std::log(config.conf_threshold / (1.0f - config.conf_threshold));
+    }
+}
 
 float Yolo26PostProcessor::sigmoid(float x) {
     return 1.0f / (1.0f + std::exp(-x));
 }
 
-float Yolo26PostProcessor::box_iou(const Detection& a, const Detection& b) {
-    const float xx1 = std::max(a.x1, b.x1);  // 相交区域左上角 x。
-    const float yy1 = std::max(a.y1, b.y1);  // 相交区域左上角 y。
-    const float xx2 = std::min(a.x2, b.x2);  // 相交区域右下角 x。
-    const float yy2 = std::min(a.y2, b.y2);  // 相交区域右下角 y。
-
-    const float iw = std::max(0.0f, xx2 - xx1);  // 相交宽度。
-    const float ih = std::max(0.0f, yy2 - yy1);  // 相交高度。
-    const float inter = iw * ih;  // 相交面积。
+void Yolo26PostProcessor::decode_head_f32(const Yolo26HeadTensor& head, float stride, std::vector<Detection>& boxes) const {
+    for (int h = 0; h < head.feat_h; ++h) {
+        for (int w = 0; w < head.feat_w; ++w) {
+            const int base_idx = h * head.feat_w + w;  // 当前栅格线性索引。
+            const float* cls_ptr = head.cls + static_cast<size_t>(base_idx) * head.cls_p_stride;  // 当前栅格分类数据。
+            int best_cls = 0;  // 最佳类别 ID。
+            float best_logit = cls_ptr[0];  // 最佳类别 logit。
+            for (int c = 1; c < head.num_cls; ++c) {
+                const float logit = cls_ptr[static_cast<size_t>(c) * head.cls_c_stride];  // 当前类别 logit。
+                if (logit > best_logit) {
+                    best_logit = logit;
+                    best_cls = c;
+                }
+            }
+            // sigmoid 单调，阈值比较放在 logit 域。
+            if (best_logit < conf_logit) {
+                continue;
+            }
 
-    const float area_a = std::max(0.0f, a.x2 - a.x1) * std::max(0.0f, a.y2 - a.y1);  // A 面积。
-    const float area_b = std::max(0.0f, b.x2 - b.x1) * std::max(0.0f, b.y2 - b.y1);  // B 面积。
-    const float uni = area_a + area_b - inter;  // 并集面积。
-    if (uni <= 0.0f) {
-        return 0.0f;
+            const float* reg_ptr = head.reg + static_cast<size_t>(base_idx) * head.reg_p_stride;  // 当前栅格回归数据。
+            const float grid_x = static_cast<float>(w) + 0.5f;  // 栅格中心 x。
+            const float grid_y = static_cast<float>(h) + 0.5f;  // 栅格中心 y。
+            boxes.push_back({(grid_x - reg_ptr[0]) * stride,
+                             (grid_y - reg_ptr[head.reg_c_stride]) * stride,
+                             (grid_x + reg_ptr[2 * head.reg_c_stride]) * stride,
+                             (grid_y + reg_ptr[3 * head.reg_c_stride]) * stride,
+                             sigmoid(best_logit),
+                             best_cls});
+        }
     }
-    return inter / uni;
 }
 
-std::vector<Yolo26PostProcessor::Detection> Yolo26PostProcessor::nms_per_class(const std::vector<Detection>& boxes, float nms_thres) {
-    std::map<int, std::vector<Detection>> cls_buckets;  // 按类别分桶。
-    for (const auto& box : boxes) {
-        cls_buckets[box.cls_id].push_back(box);
+void Yolo26PostProcessor::decode_head_i8(const Yolo26HeadTensor& head, float stride, std::vector<Detection>& boxes) const {
+    // 量化阈值：(q - zp) * scale >= conf_logit 等价于 q >= ceil(zp + conf_logit / scale)。
+    int32_t thres_q = 0;  // 量化域阈值。
+    if (std::isinf(conf_logit)) {
+        thres_q = conf_logit < 0.0f ? std::numeric_limits<int8_t>::min() : std::numeric_limits<int8_t>::max() + 1;
+    } else {
+        const float thres = std::ceil(static_cast<float>(head.cls_zp) + conf_logit / head.cls_scale);  // 浮点量化阈值。
+        thres_q = static_cast<int32_t>(std::max(-129.0f, std::min(128.0f, thres)));
+    }
+    if (thres_q > std::numeric_limits<int8_t>::max()) {
+        return;
     }
 
-    std::vector<Detection> kept;  // 保留结果。
-    for (auto& pair : cls_buckets) {
-        auto& cls_boxes = pair.second;  // 当前类别检测框。
-        std::sort(cls_boxes.begin(), cls_boxes.end(), [](const Detection& a, const Detection& b) {
-            return a.score > b.score;
-        });
-
-        while (!cls_boxes.empty()) {
-            const Detection best = cls_boxes.front();  // 当前最高分框。
-            kept.push_back(best);
-            cls_boxes.erase(cls_boxes.begin());
-
-            std::vector<Detection> remain;  // NMS 后剩余框。
-            remain.reserve(cls_boxes.size());
-            for (const auto& box : cls_boxes) {
-                if (box_iou(best, box) < nms_thres) {
-                    remain.push_back(box);
+    for (int h = 0; h < head.feat_h; ++h) {
+        for (int w = 0; w < head.feat_w; ++w) {
+            const int base_idx = h * head.feat_w + w;  // 当前栅格线性索引。
+            const int8_t* cls_ptr = head.cls_i8 + static_cast<size_t>(base_idx) * head.cls_p_stride;  // 当前栅格分类数据。
+            int best_cls = 0;  // 最佳类别 ID。
+            int32_t best_q = cls_ptr[0];  // 最佳类别量化 logit。
+            for (int c = 1; c < head.num_cls; ++c) {
+                const int32_t q = cls_ptr[static_cast<size_t>(c) * head.cls_c_stride];  // 当前类别量化 logit。
+                if (q > best_q) {
+                    best_q = q;
+                    best_cls = c;
                 }
             }
-            cls_boxes.swap(remain);
+            if (best_q < thres_q) {
+                continue;
+            }
+
+            // 仅对通过阈值的栅格反量化。
+            const int8_t* reg_ptr = head.reg_i8 + static_cast<size_t>(base_idx) * head.reg_p_stride;  // 当前栅格回归数据。
+            const float l = (static_cast<float>(reg_ptr[0]) - head.reg_zp) * head.reg_scale;  // 左距离。
+            const float t = (static_cast<float>(reg_ptr[head.reg_c_stride]) - head.reg_zp) * head.reg_scale;  // 上距离。
+            const float r = (static_cast<float>(reg_ptr[2 * head.reg_c_stride]) - head.reg_zp) * head.reg_scale;  // 右距离。
+            const float b = (static_cast<float>(reg_ptr[3 * head.reg_c_stride]) - head.reg_zp) * head.reg_scale;  // 下距离。
+            const float grid_x = static_cast<float>(w) + 0.5f;  // 栅格中心 x。
+            const float grid_y = static_cast<float>(h) + 0.5f;  // 栅格中心 y。
+            boxes.push_back({(grid_x - l) * stride,
+                             (grid_y - t) * stride,
+                             (grid_x + r) * stride,
+                             (grid_y + b) * stride,
+                             sigmoid((static_cast<float>(best_q) - head.cls_zp) * head.cls_scale),
+                             best_cls});
         }
     }
-
-    return kept;
 }
 
 int Yolo26PostProcessor::run(const std::vector<Yolo26HeadTensor>& heads,
@@ -71,8 +109,8 @@ int Yolo26PostProcessor::run(const std::vector<Yolo26HeadTensor>& heads,
         if (head.feat_h <= 0 || head.feat_w <= 0 || head.num_cls <= 0) {
             continue;
         }
-        const int hw = head.feat_h * head.feat_w;  // 特征图像素总数。
-        if (head.reg.size() != static_cast<size_t>(4 * hw) || head.cls.size() != static_cast<size_t>(head.num_cls * hw)) {
+        const bool quantized = head.reg_i8 != nullptr && head.cls_i8 != nullptr;  // 是否为量化输出。
+        if (!quantized && (head.reg == nullptr || head.cls == nullptr)) {
             continue;
         }
 
@@ -83,48 +121,31 @@ int Yolo26PostProcessor::run(const std::vector<Yolo26HeadTensor>& heads,
         }
         const float stride = stride_h;  // 当前分支 stride。
 
-        for (int h = 0; h < head.feat_h; ++h) {
-            for (int w = 0; w < head.feat_w; ++w) {
-                const int base_idx = h * head.feat_w + w;  // 当前栅格线性索引。
-                int best_cls = -1;  // 最佳类别 ID。
-                float best_score = -1.0f;  // 最佳类别分数。
-                for (int c = 0; c < head.num_cls; ++c) {
-                    const float score = sigmoid(head.cls[c * hw + base_idx]);
-                    if (score > best_score) {
-                        best_score = score;
-                        best_cls = c;
-                    }
-                }
-
-                if (best_cls < 0 || best_score < config.conf_threshold) {
-                    continue;
-                }
-
-                const float grid_x = static_cast<float>(w) + 0.5f;  // 栅格中心 x。
-                const float grid_y = static_cast<float>(h) + 0.5f;  // 栅格中心 y。
-                float x1 = (grid_x - head.reg[0 * hw + base_idx]) * stride;  // 输入尺度 x1。
-                float y1 = (grid_y - head.reg[1 * hw + base_idx]) * stride;  // 输入尺度 y1。
-                float x2 = (grid_x + head.reg[2 * hw + base_idx]) * stride;  // 输入尺度 x2。
-                float y2 = (grid_y + head.reg[3 * hw + base_idx]) * stride;  // 输入尺度 y2。
-
-                x1 /= ratio_w;
-                y1 /= ratio_h;
-                x2 /= ratio_w;
-                y2 /= ratio_h;
-
-                x1 = std::max(0.0f, std::min(static_cast<float>(orig_w), x1));
-                y1 = std::max(0.0f, std::min(static_cast<float>(orig_h), y1));
-                x2 = std::max(0.0f, std::min(static_cast<float>(orig_w), x2));
-                y2 = std::max(0.0f, std::min(static_cast<float>(orig_h), y2));
-                boxes.push_back({x1, y1, x2, y2, best_score, best_cls});
-            }
+        if (quantized) {
+            decode_head_i8(head, stride, boxes);
+        } else {
+            decode_head_f32(head, stride, boxes);
         }
     }
 
-    const std::vector<Detection> kept = nms_per_class(boxes, config.nms_threshold);  // NMS 后保留框。
+    // 输入尺度映射回原图并裁剪。
+    const float max_x = static_cast<float>(orig_w);  // x 上限。
+    const float max_y = static_cast<float>(orig_h);  // y 上限。
+    for (auto& box : boxes) {
+        box.x1 = std::max(0.0f, std::min(max_x, box.x1 / ratio_w));
+        box.y1 = std::max(0.0f, std::min(max_y, box.y1 / ratio_h));
+        box.x2 = std::max(0.0f, std::min(max_x, box.x2 / ratio_w));
+        box.y2 = std::max(0.0f, std::min(max_y, box.y2 / ratio_h));
+    }
+
+    NmsOptions nms_options;  // NMS 参数。
+    nms_options.iou_threshold = config.nms_threshold;
+    std::vector<int> keep;  // NMS 后保留框下标。
+    nms(boxes, nms_options, keep);
     results.clear();
-    results.reserve(kept.size());
-    for (const auto& det : kept) {
+    results.reserve(keep.size());
+    for (int index : keep) {
+        const auto& det = boxes[index];  // 保留框。
         DetectionResult result;  // 统一输出检测结构。
         result.id = det.cls_id;
         result.score = det.score;
@@ -1,21 +1,35 @@
 #pragma once
 
-#include <map>
+#include <cstdint>
 #include <string>
-#include <utility>
 #include <vector>
 
 #include "config.h"
+#include "nms.h"
 
 /**
- * @brief YOLO26 单尺度分支张量描述。
+ * @brief YOLO26 单尺度分支张量描述（不持有数据）。
+ *
+ * 直接指向 RKNN 输出缓冲，按步长访问，NCHW 与 NHWC 输出都无需转置：
+ * 元素 (通道 c, 像素 p = h * W + w) 位于 data[c * c_stride + p * p_stride]。
+ * 量化输出时 reg_i8/cls_i8 非空（float 指针为空），数据为 int8 仿射量化值 (q - zp) * scale。
  */
 struct Yolo26HeadTensor {
     int feat_h = 0;  // 特征图高度。
     int feat_w = 0;  // 特征图宽度。
     int num_cls = 0;  // 类别数。
-    std::vector<float> reg;  // 回归分支数据，布局为 [4, H, W]。
-    std::vector<float> cls;  // 分类分支数据，布局为 [C, H, W]。
+    const float* reg = nullptr;  // 回归分支数据（4 通道）。
+    int reg_c_stride = 0;  // 回归分支通道步长（元素）。
+    int reg_p_stride = 0;  // 回归分支像素步长（元素）。
+    const float* cls = nullptr;  // 分类分支数据（num_cls 通道）。
+    int cls_c_stride = 0;  // 分类分支通道步长（元素）。
+    int cls_p_stride = 0;  // 分类分支像素步长（元素）。
+    const int8_t* reg_i8 = nullptr;  // 量化回归分支数据。
+    int32_t reg_zp = 0;  // 回归分支零点。
+    float reg_scale = 1.0f;  // 回归分支缩放。
+    const int8_t* cls_i8 = nullptr;  // 量化分类分支数据。
+    int32_t cls_zp = 0;  // 分类分支零点。
+    float cls_scale = 1.0f;  // 分类分支缩放。
 };
 
 /**
@@ -48,40 +62,34 @@ public:
 
 private:
     /**
-     * @brief 内部检测框结构。
+     * @brief 内部检测框结构，与 NMS 共用。
      */
-    struct Detection {
-        float x1 = 0.0f;  // 左上角 x。
-        float y1 = 0.0f;  // 左上角 y。
-        float x2 = 0.0f;  // 右下角 x。
-        float y2 = 0.0f;  // 右下角 y。
-        float score = 0.0f;  // 置信度。
-        int cls_id = -1;  // 类别 ID。
-    };
+    using Detection = NmsBox;
 
     /**
-     * @brief 计算 Sigmoid。
-     * @param x 输入值。
-     * @return float 输出值。
+     * @brief 解码浮点 head，先在 logit 域比较阈值，只对通过的栅格计算 sigmoid。
+     * @param head head 数据。
+     * @param stride 当前分支 stride。
+     * @param boxes 输出候选框（输入尺度）。
      */
-    static float sigmoid(float x);
+    void decode_head_f32(const Yolo26HeadTensor& head, float stride, std::vector<Detection>& boxes) const;
 
     /**
-     * @brief 计算 IoU。
-     * @param a 检测框 A。
-     * @param b 检测框 B。
-     * @return float IoU 值。
+     * @brief 解码量化 head，阈值换算到量化 logit 域，绝大多数栅格只需一次整数比较。
+     * @param head head 数据。
+     * @param stride 当前分支 stride。
+     * @param boxes 输出候选框（输入尺度）。
      */
-    static float box_iou(const Detection& a, const Detection& b);
+    void decode_head_i8(const Yolo26HeadTensor& head, float stride, std::vector<Detection>& boxes) const;
 
     /**
-     * @brief 按类别执行 NMS。
-     * @param boxes 输入检测框。
-     * @param nms_thres NMS 阈值。
-     * @return std::vector<Detection> 保留检测框。
+     * @brief 计算 Sigmoid。
+     * @param x 输入值。
+     * @return float 输出值。
      */
-    static std::vector<Detection> nms_per_class(const std::vector<Detection>& boxes, float nms_thres);
+    static float sigmoid(float x);
 
     YOLO26Config config;  // 后处理配置。
+    float conf_logit = 0.0f;  // 置信度阈值对应的 logit，sigmoid(x) >= conf_threshold 等价于 x >= conf_logit。
 };
 
@@ -1,4 +1,5 @@
 #include "yolo_post.h"
+#include "nms.h"
 
 inline static int clamp(float val, int min, int max) { return val > min ? (val < max ? val : max) : min; }
 
@@ -17,76 +18,6 @@ static int8_t qnt_f32_to_affine(float f32, int32_t zp, float scale)
 
 static float deqnt_affine_to_f32(int8_t qnt, int32_t zp, float scale) { return ((float)qnt - (float)zp) * scale; }
 
-static float CalculateOverlap(float xmin0, float ymin0, float xmax0, float ymax0, float xmin1, float ymin1, float xmax1,
-                              float ymax1)
-{
-    float w = fmax(0.f, fmin(xmax0, xmax1) - fmax(xmin0, xmin1) + 1.0);
-    float h = fmax(0.f, fmin(ymax0, ymax1) - fmax(ymin0, ymin1) + 1.0);
-    float i = w * h;
-    float u = (xmax0 - xmin0 + 1.0) * (ymax0 - ymin0 + 1.0) + (xmax1 - xmin1 + 1.0) * (ymax1 - ymin1 + 1.0) - i;
-    return u <= 0.f ? 0.f : (i / u);
-}
-
-static int nms(int validCount, std::vector<float>& outputLocations, std::vector<int> classIds, std::vector<int>& order,
-               int filterId, float threshold)
-{
-    for (int i = 0; i < validCount; ++i) {
-        if (order[i] == -1 || classIds[i] != filterId) continue;
-        int n = order[i];
-        for (int j = i + 1; j < validCount; ++j) {
-            int m = order[j];
-            if (m == -1 || classIds[i] != filterId) continue;
-            float xmin0 = outputLocations[n * 4 + 0];
-            float ymin0 = outputLocations[n * 4 + 1];
-            float xmax0 = outputLocations[n * 4 + 0] + outputLocations[n * 4 + 2];
-            float ymax0 = outputLocations[n * 4 + 1] + outputLocations[n * 4 + 3];
-
-            float xmin1 = outputLocations[m * 4 + 0];
-            float ymin1 = outputLocations[m * 4 + 1];
-            float xmax1 = outputLocations[m * 4 + 0] + outputLocations[m * 4 + 2];
-            float ymax1 = outputLocations[m * 4 + 1] + outputLocations[m * 4 + 3];
-
-            float iou = CalculateOverlap(xmin0, ymin0, xmax0, ymax0, xmin1, ymin1, xmax1, ymax1);
-
-            if (iou > threshold) order[j] = -1;
-        }
-    }
-    return 0;
-}
-
-static int quick_sort_indice_inverse(std::vector<float> &input, int left, int right, std::vector<int> &indices)
-{
-    float key;
-    int key_index;
-    int low = left;
-    int high = right;
-    if (left < right)
-    {
-        key_index = indices[left];
-        key = input[left];
-        while (low < high)
-        {
-            while (low < high && input[high] <= key)
-            {
-                high--;
-            }
-            input[low] = input[high];
-            indices[low] = indices[high];
-            while (low < high && input[low] >= key)
-            {
-                low++;
-            }
-            input[high] = input[low];
-            indices[high] = indices[low];
-        }
-        input[low] = key;
-        indices[low] = key_index;
-        quick_sort_indice_inverse(input, left, low - 1, indices);
-        quick_sort_indice_inverse(input, low + 1, right, indices);
-    }
-    return low;
-}
-
 void compute_dfl(float* tensor, int dfl_len, float* box){
     for (int b = 0; b < 4; b++){
         float exp_t[dfl_len];
@@ -118,25 +49,33 @@ int PostProcessorBase::run(rknn_tensor_attr *output_attrs, rknn_output * outputs
     // no object detect
     if (validCount <= 0) return 0;
 
-    std::vector<int> indexArray;
-    for (int i = 0; i < validCount; ++i) indexArray.push_back(i);
-
-    // sort;
-    quick_sort_indice_inverse(objProbs, 0, validCount - 1, indexArray);
+    // filterBoxes is (x, y, w, h) in model input
+    std::vector<NmsBox> nms_boxes(validCount);
+    for (int i = 0; i < validCount; ++i) {
+        auto& b = nms_boxes[i];
+        b.x1 = filterBoxes[i * 4 + 0];
+        b.y1 = filterBoxes[i * 4 + 1];
+        b.x2 = filterBoxes[i * 4 + 0] + filterBoxes[i * 4 + 2];
+        b.y2 = filterBoxes[i * 4 + 1] + filterBoxes[i * 4 + 3];
+        b.score = objProbs[i];
+        b.cls_id = classId[i];
+    }
 
     //nms
-    std::set<int> class_set(std::begin(classId), std::end(classId));
-    for (auto c : class_set) nms(validCount, filterBoxes, classId, indexArray, c, config.nms_threshold);
+    NmsOptions nms_options;
+    nms_options.iou_threshold = config.nms_threshold;
+    nms_options.max_detections = config.max_detections;
+    nms_options.mode = config.class_agnostic_nms ? NmsMode::CLASS_AGNOSTIC : NmsMode::CLASS_AWARE;
+    nms_options.pixel_inclusive = true;
+    std::vector<int> keep;
+    nms(nms_boxes, nms_options, keep);
 
-    int last_count = 0;
     /* box valid detect target */
-    for (int i = 0; i < validCount; ++i) {
-        if (indexArray[i] == -1 || last_count >= 8) continue;
-        int n = indexArray[i];
+    for (int n : keep) {
         struct DetectionResult obj;
 
         obj.id    = classId[n];
-        obj.score = objProbs[i];
+        obj.score = objProbs[n];
         obj.label = config.labels.at(classId[n]);
 
         obj.box.top    = w_reverse(filterBoxes[n * 4 + 0], lb);
@@ -145,9 +84,8 @@ int PostProcessorBase::run(rknn_tensor_attr *output_attrs, rknn_output * outputs
         obj.box.right  = h_reverse(filterBoxes[n * 4 + 1] + filterBoxes[n * 4 + 3], lb);
 
         results.push_back(obj);
-        last_count++;
     }
-    return last_count;
+    return static_cast<int>(keep.size());
 }
 
 int YOLOv5v7_Post::process_i8(int8_t *input, int *anchor, int grid_h, int grid_w, int stride,
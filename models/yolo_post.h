@@ -1,7 +1,6 @@
 #pragma once
 #include <iostream>
 #include <sstream>
-#include <set>
 
 #include <vector>
 #include <stdint.h>
@@ -36,7 +35,7 @@ public:
             lss << config.labels[i];
             if (i != config.labels.size() - 1) lss << ", ";
         }
-        spdlog::info("Post processor type is {}, labels: [{}], conf thresh: {}, nms thresh: {}.", type_name, lss.str(), config.conf_threshold, config.nms_threshold);
+        spdlog::info("Post processor type is {}, labels: [{}], conf thresh: {}, nms thresh: {}, class agnostic nms: {}.", type_name, lss.str(), config.conf_threshold, config.nms_threshold, config.class_agnostic_nms);
     }
 
     virtual int process_func(rknn_tensor_attr* output_attrs, rknn_output* outputs, int model_in_w, int model_in_h,
@@ -56,7 +56,7 @@ int main(int argc, char** argv)
         std::vector<DetectionResult> det_res;
         yolo->run(img, det_res);
 
-        std::vector<STrack> output_stracks = tracker.update(det_res);
+        const std::vector<STrack>& output_stracks = tracker.update(det_res);
 
         auto stop_time = std::chrono::steady_clock::now();
         duration = std::chrono::duration<double, std::milli>(stop_time - start_time).count();
@@ -66,7 +66,7 @@ int main(int argc, char** argv)
 
         for (int i = 0; i < output_stracks.size(); i++)
 		{
-			vector<float> tlwh = output_stracks[i].tlwh;
+			const auto& tlwh = output_stracks[i].tlwh;
             cv::Point obj_center(tlwh[0] + tlwh[1] / 2, tlwh[1] + tlwh[3] / 2);
             cv::Scalar s = tracker.get_color(output_stracks[i].track_id);
             putText(img, format("(%s: %d) %.2f", output_stracks[i].label.c_str(), output_stracks[i].track_id, output_stracks[i].score), Point(tlwh[0], tlwh[1] - 5),
@@ -1,36 +1,83 @@
 #include "Enmuxer.h"
+#include <cstring>
 // #include "utils/FileOperate.h"
 namespace FFmpeg {
 
 Enmuxer::Enmuxer(std::shared_ptr<Encoder> encoder, std::string out_url) {
     m_encoder = encoder;
     m_out_url = out_url;
-    if (out_url.find("mp4") != std::string::npos) {
+    init_format_name();
+}
+
+Enmuxer::Enmuxer(AVCodecID codec_id, int width, int height, int fps, std::vector<uint8_t> extradata,
+                 std::string out_url) {
+    m_codec_id  = codec_id;
+    m_width     = width;
+    m_height    = height;
+    m_time_base = {1, fps > 0 ? fps : 25};
+    m_extradata = std::move(extradata);
+    m_out_url   = out_url;
+    init_format_name();
+}
+
+void Enmuxer::init_format_name() {
+    auto ends_with = [this](const std::string &suffix) {
+        return m_out_url.size() >= suffix.size() &&
+               m_out_url.compare(m_out_url.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    if (m_out_url.find("mp4") != std::string::npos) {
         m_format_name = "mp4";
-    } else if (out_url.find("flv") != std::string::npos) {
+    } else if (m_out_url.find("flv") != std::string::npos) {
         m_format_name = "flv";
-    } else if (out_url.find("rtmp") != std::string::npos) {
+    } else if (m_out_url.find("rtmp") != std::string::npos) {
         m_format_name = "flv";
-    } else if (out_url.find("jpg") != std::string::npos) {
+    } else if (m_out_url.find("jpg") != std::string::npos) {
         m_format_name = "image2";
+    } else if (ends_with(".ts") || m_out_url.find("udp://") == 0 || m_out_url.find("srt://") == 0) {
+        m_format_name = "mpegts";
     } else {
         m_format_name = "mp4";
     }
 }
 
 Enmuxer::~Enmuxer() {
-    m_format_ctx = nullptr;
     close();
 }
 
 bool Enmuxer::open() {
     ASSERT_FFMPEG(avformat_alloc_output_context2(&m_format_ctx, nullptr, m_format_name.c_str(),
                                                  m_out_url.c_str()));
-    avformat_new_stream(m_format_ctx, m_encoder->get_codec_ctx()->codec);
-    ASSERT_FFMPEG(avcodec_parameters_from_context(get_video_stream()->codecpar,
-                                                  m_encoder->get_codec_ctx().get()));
-    ASSERT_FFMPEG(avio_open(&m_format_ctx->pb, m_out_url.c_str(), AVIO_FLAG_WRITE));
+    if (m_encoder) {
+        avformat_new_stream(m_format_ctx, m_encoder->get_codec_ctx()->codec);
+        ASSERT_FFMPEG(avcodec_parameters_from_context(get_video_stream()->codecpar,
+                                                      m_encoder->get_codec_ctx().get()));
+    } else {
+        AVStream *stream = avformat_new_stream(m_format_ctx, nullptr);
+        if (stream == nullptr) {
+            return false;
+        }
+        stream->time_base               = m_time_base;
+        stream->codecpar->codec_type    = AVMEDIA_TYPE_VIDEO;
+        stream->codecpar->codec_id      = m_codec_id;
+        stream->codecpar->width         = m_width;
+        stream->codecpar->height        = m_height;
+        stream->codecpar->format        = AV_PIX_FMT_NV12;
+        // Annex-B 头即可，mp4/flv 封装器会自行转换成 avcC/hvcC
+        if (!m_extradata.empty()) {
+            stream->codecpar->extradata = static_cast<uint8_t *>(
+                av_mallocz(m_extradata.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+            if (stream->codecpar->extradata == nullptr) {
+                return false;
+            }
+            memcpy(stream->codecpar->extradata, m_extradata.data(), m_extradata.size());
+            stream->codecpar->extradata_size = static_cast<int>(m_extradata.size());
+        }
+    }
+    if (!(m_format_ctx->oformat->flags & AVFMT_NOFILE)) {
+        ASSERT_FFMPEG(avio_open(&m_format_ctx->pb, m_out_url.c_str(), AVIO_FLAG_WRITE));
+    }
     ASSERT_FFMPEG(avformat_write_header(m_format_ctx, nullptr));
+    m_header_written = true;
     return true;
 }
 
@@ -39,10 +86,15 @@ bool Enmuxer::write_packet(av_packet &packet) {
     packet->dts      = packet->pts;
     packet->duration = 1;
 
-    packet->pts = av_rescale_q(packet->pts, m_encoder->get_time_base(), get_time_base());
-    packet->dts = av_rescale_q(packet->dts, m_encoder->get_time_base(), get_time_base());
-    packet->duration =
-        av_rescale_q(packet->duration, m_encoder->get_time_base(), get_time_base()) / 3;
+    if (m_encoder) {
+        packet->pts = av_rescale_q(packet->pts, m_encoder->get_time_base(), get_time_base());
+        packet->dts = av_rescale_q(packet->dts, m_encoder->get_time_base(), get_time_base());
+        packet->duration =
+            av_rescale_q(packet->duration, m_encoder->get_time_base(), get_time_base()) / 3;
+    } else {
+        av_packet_rescale_ts(packet.get(), m_time_base, get_time_base());
+    }
+    packet->stream_index = m_video_stream_index;
     packet->pos = -1;
 
     ASSERT_FFMPEG(av_interleaved_write_frame(m_format_ctx, packet.get()));
@@ -53,14 +105,19 @@ void Enmuxer::close() {
     std::unique_lock<std::mutex> lock(m_mutex);
     if (m_format_ctx) {
         write_trailer();
-        avio_close(m_format_ctx->pb);
+        if (!(m_format_ctx->oformat->flags & AVFMT_NOFILE)) {
+            avio_closep(&m_format_ctx->pb);
+        }
         avformat_free_context(m_format_ctx);
-        m_format_ctx = nullptr;
+        m_format_ctx     = nullptr;
+        m_header_written = false;
     }
 }
 
 void Enmuxer::write_trailer() {
-    if (m_format_name == "mp4" || m_format_name == "jpg")
+    if (!m_header_written)
+        return;
+    if (m_format_name == "mp4" || m_format_name == "jpg" || m_format_name == "mpegts")
         av_write_trailer(m_format_ctx);
 }
 
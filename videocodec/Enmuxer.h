@@ -3,12 +3,25 @@
 #include "Encoder.h"
 #include "SafeAVFormat.h"
 #include <mutex>
+#include <vector>
 
 namespace FFmpeg {
 class Enmuxer {
 public:
     Enmuxer(std::shared_ptr<Encoder> encoder, std::string out_url);
 
+    /*!
+     * @brief 封装外部编码器（如 MPP 硬编码）输出的 Annex-B 码流
+     * @param codec_id 编码类型 H264/HEVC
+     * @param width 视频宽度
+     * @param height 视频高度
+     * @param fps 帧率，packet 的 pts 以 1/fps 为单位
+     * @param extradata 码流头（SPS/PPS[/VPS]），MP4/FLV 需要
+     * @param out_url 输出文件路径或推流地址
+     */
+    Enmuxer(AVCodecID codec_id, int width, int height, int fps, std::vector<uint8_t> extradata,
+            std::string out_url);
+
     ~Enmuxer();
 
     bool open();
@@ -30,6 +43,22 @@ public:
         return std::make_shared<Enmuxer>(encoder, out_url);
     }
 
+    /*!
+     * @brief 创建一个封装外部编码码流的封装器
+     * @param codec_id 编码类型 H264/HEVC
+     * @param width 视频宽度
+     * @param height 视频高度
+     * @param fps 帧率
+     * @param extradata 码流头（SPS/PPS[/VPS]）
+     * @param out_url 输出文件路径或推流地址
+     * @return
+     */
+    static std::shared_ptr<Enmuxer> createShared(AVCodecID codec_id, int width, int height, int fps,
+                                                 std::vector<uint8_t> extradata,
+                                                 std::string          out_url) {
+        return std::make_shared<Enmuxer>(codec_id, width, height, fps, std::move(extradata), out_url);
+    }
+
     inline AVFormatContext *get_format_ctx() {
         return m_format_ctx;
     }
@@ -43,11 +72,21 @@ public:
     }
 
 private:
-    AVFormatContext         *m_format_ctx;
+    void init_format_name();
+
+    AVFormatContext         *m_format_ctx = nullptr;
     std::shared_ptr<Encoder> m_encoder;
     std::string              m_out_url;
     std::string              m_format_name;
     int                      m_video_stream_index = 0;
+    bool                     m_header_written     = false;
+
+    // 外部编码码流参数（m_encoder 为空时使用）
+    AVCodecID                m_codec_id = AV_CODEC_ID_NONE;
+    int                      m_width    = 0;
+    int                      m_height   = 0;
+    AVRational               m_time_base{1, 25};
+    std::vector<uint8_t>     m_extradata;
 
     std::mutex m_mutex;
 };
@@ -28,6 +28,14 @@ MppDecoder::MppDecoder(int type, int fps, void* usrdata, DecCallback callback)
 }
 
 MppDecoder::~MppDecoder() {
+    running = false;
+    if (frame_thread.joinable()) {
+        frame_thread.join();
+    }
+    if (packet) {
+        mpp_packet_deinit(&packet);
+        packet = NULL;
+    }
     if (loop_data.packet) {
         mpp_packet_deinit(&loop_data.packet);
         loop_data.packet = NULL;
@@ -66,13 +74,29 @@ int MppDecoder::Init(int v_type, int fps)
 
     MppDecCfg cfg       = NULL;
 
-    MppCtx mpp_ctx          = NULL;
     ret = mpp_create(&mpp_ctx, &mpp_mpi);
     if (MPP_OK != ret) {
         LOGD("mpp_create failed ");
         return 0;
     }
 
+    /*
+     * wait inside mpp instead of sleep polling: put_packet returns as soon as
+     * the input queue has room, get_frame as soon as a frame is decoded.
+     */
+    RK_S64 timeout = MPI_DEC_INPUT_TIMEOUT_MS;
+    ret = mpp_mpi->control(mpp_ctx, MPP_SET_INPUT_TIMEOUT, &timeout);
+    if (ret) {
+        LOGD("%p failed to set input timeout ret %d ", mpp_ctx, ret);
+        return -1;
+    }
+    timeout = MPI_DEC_OUTPUT_TIMEOUT_MS;
+    ret = mpp_mpi->control(mpp_ctx, MPP_SET_OUTPUT_TIMEOUT, &timeout);
+    if (ret) {
+        LOGD("%p failed to set output timeout ret %d ", mpp_ctx, ret);
+        return -1;
+    }
+
     ret = mpp_init(mpp_ctx, MPP_CTX_DEC, mpp_type);
     if (ret) {
         LOGD("%p mpp_init failed ", mpp_ctx);
@@ -112,6 +136,15 @@ int MppDecoder::Init(int v_type, int fps)
     loop_data.packet_size    = packet_size;
     loop_data.frame          = 0;
     loop_data.frame_count    = 0;
+
+    ret = mpp_packet_init(&packet, NULL, 0);
+    if (ret) {
+        LOGD("%p mpp_packet_init failed ret %d ", mpp_ctx, ret);
+        return -1;
+    }
+
+    running = true;
+    frame_thread = std::thread(&MppDecoder::FrameLoop, this);
     return 1;
 }
 
@@ -125,23 +158,17 @@ int MppDecoder::Reset() {
 int MppDecoder::Decode(uint8_t* pkt_data, int pkt_size, int pkt_eos)
 {
     MpiDecLoopData *data = &loop_data;
-    RK_U32 pkt_done = 0;
-    RK_U32 err_info = 0;
     MPP_RET ret = MPP_OK;
     MppCtx ctx  = data->ctx;
     MppApi *mpi = data->mpi;
 
-    size_t read_size = 0;
-    size_t packet_size = data->packet_size;
+    if (mpi == NULL || packet == NULL) {
+        return MPP_ERR_NULL_PTR;
+    }
 
     LOGD("receive packet size=%d ", pkt_size);
 
-    if (packet == NULL) {
-        ret = mpp_packet_init(&packet, NULL, 0);
-    }
-
-    ///////////////////////////////////////////////
-    // ret = mpp_packet_init(&packet, frame_data, frame_size);
+    // the whole packet at once, split_parse lets mpp find the frame boundaries
     mpp_packet_set_data(packet, pkt_data);
     mpp_packet_set_size(packet, pkt_size);
     mpp_packet_set_pos(packet, pkt_data);
@@ -149,187 +176,150 @@ int MppDecoder::Decode(uint8_t* pkt_data, int pkt_size, int pkt_eos)
     // setup eos flag
     if (pkt_eos)
         mpp_packet_set_eos(packet);
-    do {
-
-        RK_S32 times = 5;
-        // send the packet first if packet is not done
-        if (!pkt_done) {
-            ret = mpi->decode_put_packet(ctx, packet);
-            if (MPP_OK == ret)
-                pkt_done = 1;
-        }
-        // then get all available frame and release
-        do {
-            RK_S32 get_frm = 0;
-            RK_U32 frm_eos = 0;
-
-            try_again:
-            ret = mpi->decode_get_frame(ctx, &frame);
-            if (MPP_ERR_TIMEOUT == ret) {
-                if (times > 0) {
-                    times--;
-                    usleep(2000);
-                    goto try_again;
-                }
-                LOGD("decode_get_frame failed too much time ");
-            }
+    else
+        mpp_packet_clr_eos(packet);
 
-            if (MPP_OK != ret) {
-                LOGD("decode_get_frame failed ret %d ", ret);
-                break;
-            }
-
-            if (frame) {
-                RK_U32 hor_stride = mpp_frame_get_hor_stride(frame);
-                RK_U32 ver_stride = mpp_frame_get_ver_stride(frame);
-                RK_U32 hor_width = mpp_frame_get_width(frame);
-                RK_U32 ver_height = mpp_frame_get_height(frame);
-                RK_U32 buf_size = mpp_frame_get_buf_size(frame);
-                RK_S64 pts = mpp_frame_get_pts(frame);
-                RK_S64 dts = mpp_frame_get_dts(frame);
-
-                LOGD("decoder require buffer w:h [%d:%d] stride [%d:%d] buf_size %d pts=%lld dts=%lld ",
-                        hor_width, ver_height, hor_stride, ver_stride, buf_size, pts, dts);
-
-                if (mpp_frame_get_info_change(frame)) {
-
-                    LOGD("decode_get_frame get info changed found ");
-                    // ret = mpp_buffer_group_get_internal(&data->frm_grp, MPP_BUFFER_TYPE_DRM);
-                    // if (ret) {
-                    //     LOGD("get mpp buffer group  failed ret %d ", ret);
-                    //     break;
-                    // }
-                    // mpi->control(ctx, MPP_DEC_SET_EXT_BUF_GROUP, data->frm_grp);
-                    // mpi->control(ctx, MPP_DEC_SET_INFO_CHANGE_READY, NULL);
-                    if (NULL == data->frm_grp) {
-                        /* If buffer group is not set create one and limit it */
-                        ret = mpp_buffer_group_get_internal(&data->frm_grp, MPP_BUFFER_TYPE_DRM);
-                        if (ret) {
-                            LOGD("%p get mpp buffer group failed ret %d ", ctx, ret);
-                            break;
-                        }
-
-                        /* Set buffer to mpp decoder */
-                        ret = mpi->control(ctx, MPP_DEC_SET_EXT_BUF_GROUP, data->frm_grp);
-                        if (ret) {
-                            LOGD("%p set buffer group failed ret %d ", ctx, ret);
-                            break;
-                        }
-                    } else {
-                        /* If old buffer group exist clear it */
-                        ret = mpp_buffer_group_clear(data->frm_grp);
-                        if (ret) {
-                            LOGD("%p clear buffer group failed ret %d ", ctx, ret);
-                            break;
-                        }
-                    }
-
-                    /* Use limit config to limit buffer count to 24 with buf_size */
-                    ret = mpp_buffer_group_limit_config(data->frm_grp, buf_size, 24);
-                    if (ret) {
-                        LOGD("%p limit buffer group failed ret %d ", ctx, ret);
-                        break;
-                    }
-
-                    /*
-                     * All buffer group config done. Set info change ready to let
-                     * decoder continue decoding
-                     */
-                    ret = mpi->control(ctx, MPP_DEC_SET_INFO_CHANGE_READY, NULL);
-                    if (ret) {
-                        LOGD("%p info change ready failed ret %d ", ctx, ret);
-                        break;
-                    }
-
-                    this->last_frame_time_ms = GetCurrentTimeMS();
-                } else {
-                    err_info = mpp_frame_get_errinfo(frame) | mpp_frame_get_discard(frame);
-                    if (err_info) {
-                        LOGD("decoder_get_frame get err info:%d discard:%d. ",
-                                mpp_frame_get_errinfo(frame), mpp_frame_get_discard(frame));
-                    }
-                    data->frame_count++;
-                    struct timeval tv;
-                    gettimeofday(&tv, NULL);
-                    LOGD("get one frame %ld ",  (tv.tv_sec * 1000 + tv.tv_usec/1000));
-                    // mpp_frame_get_width(frame);
-                    // char *input_data =(char *) mpp_buffer_get_ptr(mpp_frame_get_buffer(frame));
-                    if (callback != nullptr) {
-                        MppFrameFormat format = mpp_frame_get_fmt(frame);
-                        char *data_vir =(char *) mpp_buffer_get_ptr(mpp_frame_get_buffer(frame));
-                        int fd = mpp_buffer_get_fd(mpp_frame_get_buffer(frame));
-                        callback(this->usrdata, hor_stride, ver_stride, hor_width, ver_height, format, fd, data_vir);
-                    }
-                    unsigned long cur_time_ms = GetCurrentTimeMS();
-                    long time_gap = 1000/this->fps - (cur_time_ms - this->last_frame_time_ms);
-                    LOGD("time_gap=%ld", time_gap);
-                    if (time_gap > 0) {
-                        usleep(time_gap * 1000);
-                    }
-                    this->last_frame_time_ms = GetCurrentTimeMS();
-                }
-                frm_eos = mpp_frame_get_eos(frame);
-
-                ret = mpp_frame_deinit(&frame);
-                frame = NULL;
-
-                // if(frame_pre!=NULL)
-                // {
-                //     mpp_frame_deinit(&frame_pre);
-                // }
-                // &frame_pre=&frame;
-
-                get_frm = 1;
-            }
-
-            // try get runtime frame memory usage
-            if (data->frm_grp) {
-                size_t usage = mpp_buffer_group_usage(data->frm_grp);
-                if (usage > data->max_usage)
-                    data->max_usage = usage;
-            }
+    /*
+     * put_packet blocks up to MPI_DEC_INPUT_TIMEOUT_MS while the input queue is
+     * full, the frame thread keeps draining output meanwhile so room appears as
+     * soon as the hardware consumes a packet.
+     */
+    for (int retry = 0; retry < MPI_DEC_PUT_RETRY && running; retry++) {
+        ret = mpi->decode_put_packet(ctx, packet);
+        if (MPP_OK == ret)
+            return ret;
+        LOGD("decode_put_packet ret %d, retry ", ret);
+    }
+    LOGD("decode_put_packet give up ret %d ", ret);
+    return ret;
+}
 
-            // if last packet is send but last frame is not found continue
-            if (pkt_eos && pkt_done && ! frm_eos) {
-                usleep(1*1000);
-                continue;
-            }
+void MppDecoder::FrameLoop()
+{
+    MpiDecLoopData *data = &loop_data;
+    MppCtx ctx  = data->ctx;
+    MppApi *mpi = data->mpi;
 
-            if (frm_eos) {
-                LOGD("found last frame ");
-                break;
-            }
+    while (running) {
+        // returns once a frame is ready or MPI_DEC_OUTPUT_TIMEOUT_MS passed
+        MPP_RET ret = mpi->decode_get_frame(ctx, &frame);
+        if (MPP_ERR_TIMEOUT == ret || (MPP_OK == ret && frame == NULL)) {
+            continue;
+        }
+        if (MPP_OK != ret) {
+            LOGD("decode_get_frame failed ret %d ", ret);
+            continue;
+        }
 
-            if (data->frame_num > 0 && data->frame_count >= data->frame_num) {
-                data->eos = 1;
-                break;
-            }
+        RK_U32 frm_eos = mpp_frame_get_eos(frame);
+        HandleFrame(frame);
+        mpp_frame_deinit(&frame);
+        frame = NULL;
 
-            if (get_frm)
-                continue;
-            break;
-        } while (1);
+        // try get runtime frame memory usage
+        if (data->frm_grp) {
+            size_t usage = mpp_buffer_group_usage(data->frm_grp);
+            if (usage > data->max_usage)
+                data->max_usage = usage;
+        }
 
+        if (frm_eos) {
+            LOGD("found last frame ");
+        }
         if (data->frame_num > 0 && data->frame_count >= data->frame_num) {
             data->eos = 1;
             LOGD("reach max frame number %d ", data->frame_count);
-            break;
+        }
+    }
+}
+
+void MppDecoder::HandleFrame(MppFrame frame)
+{
+    MpiDecLoopData *data = &loop_data;
+    MppCtx ctx  = data->ctx;
+    MppApi *mpi = data->mpi;
+    MPP_RET ret = MPP_OK;
+
+    RK_U32 hor_stride = mpp_frame_get_hor_stride(frame);
+    RK_U32 ver_stride = mpp_frame_get_ver_stride(frame);
+    RK_U32 hor_width = mpp_frame_get_width(frame);
+    RK_U32 ver_height = mpp_frame_get_height(frame);
+    RK_U32 buf_size = mpp_frame_get_buf_size(frame);
+    RK_S64 pts = mpp_frame_get_pts(frame);
+    RK_S64 dts = mpp_frame_get_dts(frame);
+
+    LOGD("decoder require buffer w:h [%d:%d] stride [%d:%d] buf_size %d pts=%lld dts=%lld ",
+            hor_width, ver_height, hor_stride, ver_stride, buf_size, pts, dts);
+
+    if (mpp_frame_get_info_change(frame)) {
+
+        LOGD("decode_get_frame get info changed found ");
+        if (NULL == data->frm_grp) {
+            /* If buffer group is not set create one and limit it */
+            ret = mpp_buffer_group_get_internal(&data->frm_grp, MPP_BUFFER_TYPE_DRM);
+            if (ret) {
+                LOGD("%p get mpp buffer group failed ret %d ", ctx, ret);
+                return;
+            }
+
+            /* Set buffer to mpp decoder */
+            ret = mpi->control(ctx, MPP_DEC_SET_EXT_BUF_GROUP, data->frm_grp);
+            if (ret) {
+                LOGD("%p set buffer group failed ret %d ", ctx, ret);
+                return;
+            }
+        } else {
+            /* If old buffer group exist clear it */
+            ret = mpp_buffer_group_clear(data->frm_grp);
+            if (ret) {
+                LOGD("%p clear buffer group failed ret %d ", ctx, ret);
+                return;
+            }
         }
 
-        if (pkt_done)
-            break;
+        /* Use limit config to limit buffer count to 24 with buf_size */
+        ret = mpp_buffer_group_limit_config(data->frm_grp, buf_size, 24);
+        if (ret) {
+            LOGD("%p limit buffer group failed ret %d ", ctx, ret);
+            return;
+        }
 
         /*
-         * why sleep here:
-         * mpi->decode_put_packet will failed when packet in internal queue is
-         * full, waiting the package is consumed .Usually hardware decode one
-         * frame which resolution is 1080p needs 2 ms,so here we sleep 3ms
-         * * is enough.
+         * All buffer group config done. Set info change ready to let
+         * decoder continue decoding
          */
-        usleep(3*1000);
-    } while (1);
-    mpp_packet_deinit(&packet);
-    return ret;
+        ret = mpi->control(ctx, MPP_DEC_SET_INFO_CHANGE_READY, NULL);
+        if (ret) {
+            LOGD("%p info change ready failed ret %d ", ctx, ret);
+            return;
+        }
+
+        this->last_frame_time_ms = GetCurrentTimeMS();
+        return;
+    }
+
+    RK_U32 err_info = mpp_frame_get_errinfo(frame) | mpp_frame_get_discard(frame);
+    if (err_info) {
+        LOGD("decoder_get_frame get err info:%d discard:%d. ",
+                mpp_frame_get_errinfo(frame), mpp_frame_get_discard(frame));
+    }
+    data->frame_count++;
+    LOGD("get one frame %ld ", GetCurrentTimeMS());
+    if (callback != nullptr) {
+        MppFrameFormat format = mpp_frame_get_fmt(frame);
+        char *data_vir =(char *) mpp_buffer_get_ptr(mpp_frame_get_buffer(frame));
+        int fd = mpp_buffer_get_fd(mpp_frame_get_buffer(frame));
+        callback(this->usrdata, hor_stride, ver_stride, hor_width, ver_height, format, fd, data_vir);
+    }
+    if (this->fps > 0) {
+        unsigned long cur_time_ms = GetCurrentTimeMS();
+        long time_gap = 1000/this->fps - (cur_time_ms - this->last_frame_time_ms);
+        LOGD("time_gap=%ld", time_gap);
+        if (time_gap > 0) {
+            usleep(time_gap * 1000);
+        }
+    }
+    this->last_frame_time_ms = GetCurrentTimeMS();
 }
 
 int MppDecoder::SetCallback(DecCallback callback) {
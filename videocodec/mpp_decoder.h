@@ -6,11 +6,19 @@
 #include "rockchip/mpp_frame.h"
 #include <string.h>
 #include <pthread.h>
+#include <atomic>
 #include <memory>
+#include <thread>
 
 #define MPI_DEC_STREAM_SIZE         (SZ_4K)
 #define MPI_DEC_LOOP_COUNT          4
 #define MAX_FILE_NAME_LENGTH        256
+// decode_put_packet waits up to this long for room in the decoder input queue
+#define MPI_DEC_INPUT_TIMEOUT_MS    100
+// decode_get_frame waits up to this long for a decoded frame, also how often the frame thread checks for stop
+#define MPI_DEC_OUTPUT_TIMEOUT_MS   100
+// input timeouts before a packet is given up (the decoder stalls while all output buffers are held)
+#define MPI_DEC_PUT_RETRY           50
 
 using DecCallback = void(*)(void* usrdata, int width_stride, int height_stride, int width, int height, int format, int fd, void* data);
 
@@ -42,6 +50,8 @@ public:
     ~MppDecoder();
     int Init(int v_type, int fps);
     int SetCallback(DecCallback callback);
+    // submit one whole packet, blocks while the decoder input queue is full.
+    // decoded frames are delivered to the callback from the decoder's frame thread.
     int Decode(uint8_t* pkt_data, int pkt_size, int pkt_eos);
     int Reset();
 
@@ -64,6 +74,12 @@ private:
     unsigned long last_frame_time_ms = 0;
 
     void* usrdata = NULL;
+
+    // frame thread pulls frames as soon as the decoder outputs them
+    std::thread frame_thread;
+    std::atomic<bool> running {false};
+    void FrameLoop();
+    void HandleFrame(MppFrame frame);
 };
 
 size_t mpp_frame_get_buf_size(const MppFrame s);
@@ -725,19 +725,30 @@ int MppEncoder::Reset() {
     return 0;
 }
 
+int MppEncoder::RequestIDR() {
+    if (mpp_mpi == NULL) {
+        return -1;
+    }
+    // next frame put to encoder is encoded as IDR
+    return mpp_mpi->control(mpp_ctx, MPP_ENC_SET_IDR_FRAME, NULL);
+}
+
 size_t MppEncoder::GetFrameSize() {
     return this->frame_size;
 }
 
 void* MppEncoder::ImportBuffer(int index, size_t size, int fd, int type) {
-    MppBuffer buf;
+    MppBuffer buf = NULL;
     MppBufferInfo info;
     memset(&info, 0, sizeof(MppBufferInfo));
     info.type = (MppBufferType)type; // MPP_BUFFER_TYPE_EXT_DMA
     info.fd =  fd;
     info.size = size;
     info.index = index;
-    mpp_buffer_import(&buf, &info);
+    if (mpp_buffer_import(&buf, &info)) {
+        LOGD("failed to import buffer fd %d size %zu\n", fd, size);
+        return NULL;
+    }
     return buf;
 }
 
@@ -69,6 +69,7 @@ class MppEncoder {
     int Encode(void* mpp_buf, char* enc_buf, int max_size);
     int GetHeader(char* enc_buf, int max_size);
     int Reset();
+    int RequestIDR();
     void* ImportBuffer(int index, size_t size, int fd, int type);
     size_t GetFrameSize();
     void* GetInputFrameBuffer();
@@ -24,8 +24,10 @@ namespace vp_nodes {
     std::shared_ptr<vp_objects::vp_meta> vp_des_node::handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
         // update cache of stream status
         stream_status.frame_index = meta->frame_index;
-        stream_status.width = meta->frame.size().width;
-        stream_status.height = meta->frame.size().height;
+        // BGR is absent for des nodes working on NV12 (or zero-copy metas which only carry dma_frame)
+        auto frame = meta->bgr_frame();
+        stream_status.width = frame.empty() ? meta->original_width : frame.size().width;
+        stream_status.height = frame.empty() ? meta->original_height : frame.size().height;
         stream_status.direction = to_string();
 
         // calculate the duration between now and the time when meta created, which is latency.
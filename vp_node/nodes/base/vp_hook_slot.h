@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace vp_nodes {
+    // holder of one hooker (callback) which is invoked on hot paths (per meta/frame) and replaced rarely.
+    // invoke() takes no lock: the installed callback is an immutable heap snapshot behind an atomic pointer,
+    // and when nothing is installed it costs a single relaxed load and a branch.
+    // set() swaps the snapshot and waits for invocations still running the old one before freeing it,
+    // so once set() returns the old callback will never be called again (owners may release what it captures).
+    // note: do not call set() from inside the callback of the same slot, it would wait for itself.
+    template<typename Signature>
+    class vp_hook_slot;
+
+    template<typename... Args>
+    class vp_hook_slot<void(Args...)> {
+    public:
+        using hooker = std::function<void(Args...)>;
+
+        vp_hook_slot() {}
+        ~vp_hook_slot() {
+            delete current.load();
+        }
+
+        vp_hook_slot(const vp_hook_slot&) = delete;
+        vp_hook_slot& operator=(const vp_hook_slot&) = delete;
+
+        // install hooker, empty one means uninstall
+        void set(hooker h) {
+            auto fresh = h ? new hooker(std::move(h)) : nullptr;
+            std::lock_guard<std::mutex> guard(set_lock);
+            auto old = current.exchange(fresh);
+            // pairs with invoke(), callers either see the new snapshot or are counted here
+            while (calls.load() > 0) {
+                std::this_thread::yield();
+            }
+            delete old;
+        }
+
+        bool installed() const {
+            return current.load(std::memory_order_relaxed) != nullptr;
+        }
+
+        template<typename... CallArgs>
+        void invoke(CallArgs&&... args) {
+            // fast path, nothing installed
+            if (current.load(std::memory_order_relaxed) == nullptr) {
+                return;
+            }
+            call_guard guard(calls);
+            auto h = current.load();
+            if (h != nullptr) {
+                (*h)(std::forward<CallArgs>(args)...);
+            }
+        }
+
+    private:
+        // keeps the invocation counted even if callback throws
+        struct call_guard {
+            std::atomic<int>& calls;
+            explicit call_guard(std::atomic<int>& calls): calls(calls) {
+                calls.fetch_add(1);
+            }
+            ~call_guard() {
+                calls.fetch_sub(1);
+            }
+        };
+
+        std::atomic<hooker*> current {nullptr};
+        // invocations which may be using the snapshot loaded before a set()
+        std::atomic<int> calls {0};
+        // serialize setters
+        std::mutex set_lock;
+    };
+}
@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <thread>
+
+#include "vp_meta_queue.h"
+
+namespace vp_nodes {
+
+    vp_meta_queue::vp_meta_queue(int capacity, vp_queue_policy policy):
+                                ring(max_capacity * 4),
+                                frames(max_capacity * 2),
+                                policy(policy),
+                                capacity(std::clamp(capacity, 1, max_capacity)) {
+        for (auto& c: channel_frames) {
+            c.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    vp_meta_queue::~vp_meta_queue() {
+
+    }
+
+    void vp_meta_queue::set_policy(vp_queue_policy policy, int capacity) {
+        this->policy.store(policy);
+        this->capacity.store(std::clamp(capacity, 1, max_capacity));
+        // capacity may grow or policy may leave BLOCK, let blocked producers re-check
+        notify_space();
+    }
+
+    vp_queue_policy vp_meta_queue::get_policy() const {
+        return policy.load();
+    }
+
+    int vp_meta_queue::get_capacity() const {
+        return capacity.load();
+    }
+
+    int vp_meta_queue::size() const {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    uint64_t vp_meta_queue::dropped() const {
+        return dropped_count.load(std::memory_order_relaxed);
+    }
+
+    bool vp_meta_queue::try_reserve() {
+        auto n = count.load(std::memory_order_relaxed);
+        while (n < capacity.load(std::memory_order_relaxed)) {
+            if (count.compare_exchange_weak(n, n + 1)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void vp_meta_queue::enqueue(entry& e) {
+        // ring has headroom of 3 x max_capacity cells beyond logical capacity, it is full only when control metas pile up.
+        while (!ring.try_push(e)) {
+            std::this_thread::yield();
+        }
+    }
+
+    bool vp_meta_queue::dequeue(std::shared_ptr<vp_objects::vp_meta>& meta) {
+        entry e;
+        // the signaled entry is there, but may still be written by its producer if another producer published behind it
+        while (!ring.try_pop(e)) {
+            std::this_thread::yield();
+        }
+        if (!e.frame) {
+            meta = std::move(e.meta);
+            return true;
+        }
+        if (take_frame(meta)) {
+            return true;
+        }
+        stale_tokens--;
+        return false;
+    }
+
+    bool vp_meta_queue::take_frame(std::shared_ptr<vp_objects::vp_meta>& meta) {
+        auto position = next_frame++;
+        if (early_frame != nullptr) {
+            if (early_frame_position != position) {
+                // frame of this token was dropped before early_frame
+                return false;
+            }
+            meta = std::move(early_frame);
+            early_frame = nullptr;
+            return true;
+        }
+
+        // frames in front of position have been taken already, by consumer or by producers dropping them
+        while (frames.popped() <= position) {
+            size_t popped_position;
+            if (frames.try_pop(meta, popped_position)) {
+                if (popped_position == position) {
+                    return true;
+                }
+                // a producer dropped the frame of this token between the check and the pop, keep the one taken for its own token
+                early_frame = std::move(meta);
+                early_frame_position = popped_position;
+                return false;
+            }
+            // frame is still being written by its producer
+            std::this_thread::yield();
+        }
+        return false;
+    }
+
+    int vp_meta_queue::release(const std::shared_ptr<vp_objects::vp_meta>& meta) {
+        auto was_full = count.fetch_sub(1) >= capacity.load(std::memory_order_relaxed);
+        auto left = 0;
+        if (meta != nullptr
+            && meta->meta_type == vp_objects::vp_meta_type::FRAME
+            && meta->channel_index >= 0
+            && meta->channel_index < max_tracked_channels) {
+            left = channel_frames[meta->channel_index].fetch_sub(1) - 1;
+        }
+        notify_space();
+        if (was_full) {
+            on_space.invoke();
+        }
+        return left;
+    }
+
+    void vp_meta_queue::notify_space() {
+        // fast path, nobody is waiting
+        if (blocked_producers.load() == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(space_lock);
+        space_cond.notify_all();
+    }
+
+    bool vp_meta_queue::drop_oldest_frame() {
+        // only the frame is taken away, its token stays in ring and consumer skips it later.
+        // control metas and dead flags are never dropped and keep their position.
+        if (stale_tokens.load() >= max_capacity) {
+            return false;
+        }
+        std::shared_ptr<vp_objects::vp_meta> oldest;
+        if (!frames.try_pop(oldest)) {
+            // no frame in queue (or the oldest one is being pushed right now)
+            return false;
+        }
+        stale_tokens++;
+        release(oldest);
+        dropped_count++;
+        return true;
+    }
+
+    void vp_meta_queue::wait_for_space() {
+        blocked_producers++;
+        {
+            std::unique_lock<std::mutex> lock(space_lock);
+            space_cond.wait(lock, [this] {
+                return closed.load()
+                    || policy.load() != vp_queue_policy::BLOCK
+                    || count.load() < capacity.load(); });
+        }
+        blocked_producers--;
+    }
+
+    bool vp_meta_queue::push(std::shared_ptr<vp_objects::vp_meta> meta) {
+        // dead flag and control metas bypass capacity and policy
+        if (meta == nullptr || meta->meta_type != vp_objects::vp_meta_type::FRAME) {
+            count.fetch_add(1);
+            entry e;
+            e.meta = std::move(meta);
+            enqueue(e);
+            items_semaphore.signal();
+            on_item.invoke();
+            return true;
+        }
+
+        auto no_drop = true;
+        auto attempts = 0;
+        while (!try_reserve()) {
+            if (closed.load()) {
+                dropped_count++;
+                return false;
+            }
+
+            auto p = policy.load();
+            if (p == vp_queue_policy::DROP_NEWEST) {
+                dropped_count++;
+                return false;
+            }
+            else if (p == vp_queue_policy::BLOCK) {
+                wait_for_space();
+            }
+            else {
+                // DROP_OLDEST / KEEP_LATEST_PER_CHANNEL
+                if (drop_oldest_frame()) {
+                    no_drop = false;
+                }
+                else if (stale_tokens.load() >= max_capacity) {
+                    // consumer stalls for long, tokens of dropped frames would fill up ring, drop the incoming frame instead
+                    dropped_count++;
+                    return false;
+                }
+                else if (++attempts > max_capacity) {
+                    // queue is full of control metas, admit anyway rather than spinning forever
+                    count.fetch_add(1);
+                    break;
+                }
+            }
+        }
+
+        if (meta->channel_index >= 0 && meta->channel_index < max_tracked_channels) {
+            channel_frames[meta->channel_index].fetch_add(1);
+        }
+        // frame goes first, so the frame of every token in ring has been pushed (or is being pushed)
+        while (!frames.try_push(meta)) {
+            std::this_thread::yield();
+        }
+        entry token;
+        token.frame = true;
+        enqueue(token);
+        items_semaphore.signal();
+        on_item.invoke();
+        return no_drop;
+    }
+
+    std::shared_ptr<vp_objects::vp_meta> vp_meta_queue::pop() {
+        while (true) {
+            items_semaphore.wait();
+            std::shared_ptr<vp_objects::vp_meta> meta;
+            if (!dequeue(meta)) {
+                // the frame has been dropped by producer, wait for the next one
+                continue;
+            }
+
+            auto left = release(meta);
+            // a newer frame of the same channel is waiting behind, skip the stale one
+            if (left > 0 && policy.load() == vp_queue_policy::KEEP_LATEST_PER_CHANNEL) {
+                dropped_count++;
+                continue;
+            }
+            return meta;
+        }
+    }
+
+    bool vp_meta_queue::try_pop(std::shared_ptr<vp_objects::vp_meta>& meta) {
+        while (items_semaphore.try_wait()) {
+            if (!dequeue(meta)) {
+                // the frame has been dropped by producer, check the next signal
+                continue;
+            }
+
+            auto left = release(meta);
+            // a newer frame of the same channel is waiting behind, skip the stale one
+            if (left > 0 && policy.load() == vp_queue_policy::KEEP_LATEST_PER_CHANNEL) {
+                dropped_count++;
+                continue;
+            }
+            return true;
+        }
+        return false;
+    }
+
+    bool vp_meta_queue::would_block(int incoming) const {
+        return policy.load() == vp_queue_policy::BLOCK
+            && !closed.load()
+            && count.load() + incoming > capacity.load();
+    }
+
+    void vp_meta_queue::set_listeners(std::function<void()> on_item, std::function<void()> on_space) {
+        this->on_item.set(std::move(on_item));
+        this->on_space.set(std::move(on_space));
+    }
+
+    void vp_meta_queue::close() {
+        closed.store(true);
+        std::lock_guard<std::mutex> guard(space_lock);
+        space_cond.notify_all();
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "vp_hook_slot.h"
+#include "vp_utils/vp_ring_queue.h"
+#include "vp_utils/vp_semaphore.h"
+#include "objects/vp_meta.h"
+
+namespace vp_nodes {
+    // what to do when a frame meta arrives at a full queue.
+    // control metas and dead flags (nullptr) are never dropped, they are always admitted even if the queue is full.
+    enum class vp_queue_policy {
+        BLOCK,                   // block producer until consumer frees a slot (backpressure to previous nodes)
+        DROP_OLDEST,             // drop the oldest frame meta in queue to make room for the new one
+        DROP_NEWEST,             // drop the incoming frame meta, queue content untouched
+        KEEP_LATEST_PER_CHANNEL  // like DROP_OLDEST, and stale frame metas are skipped at pop time if a newer frame of the same channel is queued
+    };
+
+    // bounded queue between nodes (in_queue) and between handle/dispatch threads inside node (out_queue).
+    // data lives in a lock-free ring (vp_utils::vp_ring_queue), consumers wait on vp_semaphore,
+    // producers only take a lock when they need to block under vp_queue_policy::BLOCK.
+    // multiple producers are allowed (several previous nodes push into the same in_queue), single consumer expected.
+    class vp_meta_queue {
+    private:
+        // entry in ring. frame metas live in frames, ring holds a token (frame == true) at their position instead,
+        // so DROP_OLDEST takes the oldest frame away without moving control metas or dead flags queued around it.
+        struct entry {
+            std::shared_ptr<vp_objects::vp_meta> meta;
+            bool frame = false;
+        };
+        // order of metas, including headroom for control metas, dead flags and stale tokens beyond logical capacity
+        vp_utils::vp_ring_queue<entry> ring;
+        // frame metas in push order, the n-th frame token in ring stands for the frame at position n of frames
+        vp_utils::vp_ring_queue<std::shared_ptr<vp_objects::vp_meta>> frames;
+        // notify consumer, signaled once for every entry in ring
+        vp_utils::vp_semaphore items_semaphore;
+        // tokens of dropped frames not yet skipped by consumer, bounded so they can not fill up ring
+        std::atomic<int> stale_tokens {0};
+
+        // consumer side, single consumer
+        // position in frames of the next frame token
+        size_t next_frame = 0;
+        // frame taken ahead of its token, frames in front of it have been dropped meanwhile
+        std::shared_ptr<vp_objects::vp_meta> early_frame;
+        size_t early_frame_position = 0;
+
+        std::atomic<vp_queue_policy> policy;
+        std::atomic<int> capacity;
+        // number of metas in queue
+        std::atomic<int> count {0};
+        // number of frame metas dropped since created
+        std::atomic<uint64_t> dropped_count {0};
+        // closed queue refuses frame metas and never blocks producers
+        std::atomic<bool> closed {false};
+
+        // queued frame metas per channel, used by KEEP_LATEST_PER_CHANNEL. channels beyond the array are not tracked.
+        static constexpr int max_tracked_channels = 64;
+        std::array<std::atomic<int>, max_tracked_channels> channel_frames;
+
+        // producers blocked under BLOCK policy
+        std::atomic<int> blocked_producers {0};
+        std::mutex space_lock;
+        std::condition_variable space_cond;
+
+        // optional callbacks for consumers/producers running as pool tasks, see set_listeners(...).
+        vp_hook_slot<void()> on_item;
+        vp_hook_slot<void()> on_space;
+
+        bool try_reserve();
+        void enqueue(entry& e);
+        // take the signaled entry out of ring, return false if it is the token of a dropped frame.
+        bool dequeue(std::shared_ptr<vp_objects::vp_meta>& meta);
+        // take the frame of the next frame token, return false if it has been dropped.
+        bool take_frame(std::shared_ptr<vp_objects::vp_meta>& meta);
+        // release slot occupied by meta which has been taken out of ring, return queued frames left in the same channel.
+        int release(const std::shared_ptr<vp_objects::vp_meta>& meta);
+        void notify_space();
+        // drop the oldest frame meta to make room, its token stays in ring. return false if nothing dropped.
+        bool drop_oldest_frame();
+        // wait until free slot appears or queue closed.
+        void wait_for_space();
+    public:
+        // max logical capacity for a single queue
+        static constexpr int max_capacity = 256;
+
+        vp_meta_queue(int capacity = 64, vp_queue_policy policy = vp_queue_policy::BLOCK);
+        ~vp_meta_queue();
+
+        vp_meta_queue(const vp_meta_queue&) = delete;
+        vp_meta_queue& operator=(const vp_meta_queue&) = delete;
+
+        // change policy and logical capacity (clamped to [1, max_capacity]), can be called at runtime.
+        void set_policy(vp_queue_policy policy, int capacity);
+        vp_queue_policy get_policy() const;
+        int get_capacity() const;
+
+        // push meta to the back of queue according to policy.
+        // return false if any frame meta (the incoming one or an old one) has been dropped.
+        bool push(std::shared_ptr<vp_objects::vp_meta> meta);
+        // pop meta from the front of queue, block until meta comes. nullptr is the dead flag.
+        std::shared_ptr<vp_objects::vp_meta> pop();
+        // non-blocking pop, return false if queue is empty.
+        bool try_pop(std::shared_ptr<vp_objects::vp_meta>& meta);
+
+        // push of a frame meta would block the producer now (BLOCK policy and incoming metas do not fit).
+        bool would_block(int incoming = 1) const;
+
+        // on_item is called after every push, on_space when a slot is freed in a queue which was full.
+        // they let pool tasks (see vp_node_pool_scope) wait for data/room without holding a thread, and must be cheap.
+        // they may be replaced while metas flow, the old ones are never called once set_listeners(...) returns.
+        void set_listeners(std::function<void()> on_item, std::function<void()> on_space);
+
+        // number of metas in queue
+        int size() const;
+        // number of frame metas dropped since created
+        uint64_t dropped() const;
+
+        // wake up blocked producers and refuse frame metas from now on, called when node is going to be destroyed.
+        void close();
+    };
+}
@@ -4,7 +4,9 @@
 namespace vp_nodes {
     
     vp_node::vp_node(std::string node_name): node_name(node_name) {
+        trace_name = vp_utils::vp_tracer::get_tracer().intern(node_name);
         node_fps_last_time = std::chrono::system_clock::now();
+        pre_nodes = std::make_shared<const std::vector<std::shared_ptr<vp_node>>>();
     }
     
     vp_node::~vp_node() {
@@ -22,122 +24,274 @@ namespace vp_nodes {
         }
     }
 
-    // there is only one thread poping data from the in_queue, we don't use lock here when poping.
-    // there is only one thread pushing data to the out_queue, we don't use lock here when pushing.
+    namespace {
+        thread_local std::shared_ptr<vp_utils::vp_work_stealing_pool> scope_pool;
+    }
+
+    vp_node_pool_scope::vp_node_pool_scope(std::shared_ptr<vp_utils::vp_work_stealing_pool> pool): previous(scope_pool) {
+        scope_pool = pool;
+    }
+
+    vp_node_pool_scope::~vp_node_pool_scope() {
+        scope_pool = previous;
+    }
+
+    std::shared_ptr<vp_utils::vp_work_stealing_pool> vp_node_pool_scope::current() {
+        return scope_pool;
+    }
+
+    // there is only one thread poping data from the in_queue.
+    // there is only one thread pushing data to the out_queue.
     void vp_node::handle_run() {
-        // cache for batch handling if need
-        std::vector<std::shared_ptr<vp_objects::vp_frame_meta>> frame_meta_batch_cache;
         while (alive) {
             // wait for producer, make sure in_queue is not empty.
-            this->in_queue_semaphore.wait();
-
+            auto in_meta = this->in_queue.pop();
             VP_DEBUG(vp_utils::string_format("[%s] before handling meta, in_queue.size()==>%d", node_name.c_str(), in_queue.size()));
-            auto in_meta = this->in_queue.front();
             
             // dead flag
             if (in_meta == nullptr) {
                 continue;
             }
-            
-            // handling hooker activated if need
-            invoke_meta_handling_hooker(node_name, in_queue.size(), in_meta);
+            handle_one(in_meta);
+        }
+        // send dead flag for dispatch_thread
+        this->out_queue.push(nullptr);
+    }
 
-            std::shared_ptr<vp_objects::vp_meta> out_meta;
-            auto batch_complete = false;
+    void vp_node::handle_one(std::shared_ptr<vp_objects::vp_meta> in_meta) {
+        vp_utils::vp_trace_scope trace(trace_name, "handle");
+        // handling hooker activated if need
+        invoke_meta_handling_hooker(node_name, in_queue.size(), in_meta);
+
+        std::shared_ptr<vp_objects::vp_meta> out_meta;
+        auto batch_complete = false;
 
-            // call handlers
-            if (in_meta->meta_type == vp_objects::vp_meta_type::CONTROL) {
-                auto meta_2_handle = std::dynamic_pointer_cast<vp_objects::vp_control_meta>(in_meta);
-                out_meta = this->handle_control_meta(meta_2_handle);
+        // call handlers
+        if (in_meta->meta_type == vp_objects::vp_meta_type::CONTROL) {
+            auto meta_2_handle = std::dynamic_pointer_cast<vp_objects::vp_control_meta>(in_meta);
+            out_meta = this->handle_control_meta(meta_2_handle);
+        }
+        else if (in_meta->meta_type == vp_objects::vp_meta_type::FRAME) {    
+            auto meta_2_handle = std::dynamic_pointer_cast<vp_objects::vp_frame_meta>(in_meta);
+            trace.bind_frame(meta_2_handle->channel_index, meta_2_handle->frame_index);
+            // produce BGR lazily, only for nodes asking for it
+            if (frame_needs_bgr && !meta_2_handle->ensure_bgr()) {
+                VP_WARN(vp_utils::string_format("[%s] convert frame to BGR failed, frame_index=%d", node_name.c_str(), meta_2_handle->frame_index));
             }
-            else if (in_meta->meta_type == vp_objects::vp_meta_type::FRAME) {    
-                auto meta_2_handle = std::dynamic_pointer_cast<vp_objects::vp_frame_meta>(in_meta);
-                // one by one
-                if (frame_meta_handle_batch == 1) {                    
-                    out_meta = this->handle_frame_meta(meta_2_handle);
+            // one by one
+            if (frame_meta_handle_batch == 1) {                    
+                out_meta = this->handle_frame_meta(meta_2_handle);
+            } 
+            else {
+                // batch by batch
+                frame_meta_batch_cache.push_back(meta_2_handle);
+                if (frame_meta_batch_cache.size() >= frame_meta_handle_batch) {
+                    // cache complete
+                    this->handle_frame_meta(frame_meta_batch_cache);
+                    batch_complete = true;
                 } 
                 else {
-                    // batch by batch
-                    frame_meta_batch_cache.push_back(meta_2_handle);
-                    if (frame_meta_batch_cache.size() >= frame_meta_handle_batch) {
-                        // cache complete
-                        this->handle_frame_meta(frame_meta_batch_cache);
-                        batch_complete = true;
-                    } 
-                    else {
-                        // cache not complete, do nothing
-                        VP_DEBUG(vp_utils::string_format("[%s] handle meta with batch, frame_meta_batch_cache.size()==>%d", node_name.c_str(), frame_meta_batch_cache.size()));
-                    }
+                    // cache not complete, do nothing
+                    VP_DEBUG(vp_utils::string_format("[%s] handle meta with batch, frame_meta_batch_cache.size()==>%d", node_name.c_str(), frame_meta_batch_cache.size()));
                 }
             }
-            else {
-                throw "invalid meta type!";
-            }
-            this->in_queue.pop();
-            VP_DEBUG(vp_utils::string_format("[%s] after handling meta, in_queue.size()==>%d", node_name.c_str(), in_queue.size()));
-            if (in_meta->meta_type == vp_objects::vp_meta_type::FRAME) {
-                log_node_fps_if_needed("handle");
-            }
+        }
+        else {
+            throw "invalid meta type!";
+        }
+        VP_DEBUG(vp_utils::string_format("[%s] after handling meta, in_queue.size()==>%d", node_name.c_str(), in_queue.size()));
+        if (in_meta->meta_type == vp_objects::vp_meta_type::FRAME) {
+            log_node_fps_if_needed("handle");
+        }
 
-            // one by one mode
-            // return nullptr means do not push it to next nodes(such as in des nodes).
-            if (out_meta != nullptr && node_type() != vp_node_type::DES) {
-                VP_DEBUG(vp_utils::string_format("[%s] before handling meta, out_queue.size()==>%d", node_name.c_str(), out_queue.size()));
-                this->out_queue.push(out_meta);
+        // one by one mode
+        // return nullptr means do not push it to next nodes(such as in des nodes).
+        if (out_meta != nullptr && node_type() != vp_node_type::DES) {
+            VP_DEBUG(vp_utils::string_format("[%s] before handling meta, out_queue.size()==>%d", node_name.c_str(), out_queue.size()));
+            // notify consumer of out_queue
+            this->out_queue.push(out_meta);
 
-                // handled hooker activated if need
-                invoke_meta_handled_hooker(node_name, out_queue.size(), out_meta);
+            // handled hooker activated if need
+            invoke_meta_handled_hooker(node_name, out_queue.size(), out_meta);
+            VP_DEBUG(vp_utils::string_format("[%s] after handling meta, out_queue.size()==>%d", node_name.c_str(), out_queue.size()));
+        }
 
+        // batch by batch mode
+        if (batch_complete && node_type() != vp_node_type::DES) {
+            // push to out_queue one by one
+            for (auto& i: frame_meta_batch_cache) {
+                VP_DEBUG(vp_utils::string_format("[%s] before handling meta, out_queue.size()==>%d", node_name.c_str(), out_queue.size()));
                 // notify consumer of out_queue
-                this->out_queue_semaphore.signal();
+                this->out_queue.push(i);
+
+                // handled hooker activated if need
+                invoke_meta_handled_hooker(node_name, out_queue.size(), i);
                 VP_DEBUG(vp_utils::string_format("[%s] after handling meta, out_queue.size()==>%d", node_name.c_str(), out_queue.size()));
             }
+            // clean cache for the next batch
+            frame_meta_batch_cache.clear();
+        }
 
-            // batch by batch mode
-            if (batch_complete && node_type() != vp_node_type::DES) {
-                // push to out_queue one by one
-                for (auto& i: frame_meta_batch_cache) {
-                    VP_DEBUG(vp_utils::string_format("[%s] before handling meta, out_queue.size()==>%d", node_name.c_str(), out_queue.size()));
-                    this->out_queue.push(i);
-
-                    // handled hooker activated if need
-                    invoke_meta_handled_hooker(node_name, out_queue.size(), i);
-
-                    // notify consumer of out_queue
-                    this->out_queue_semaphore.signal();
-                    VP_DEBUG(vp_utils::string_format("[%s] after handling meta, out_queue.size()==>%d", node_name.c_str(), out_queue.size()));
-                }
-                // clean cache for the next batch
-                frame_meta_batch_cache.clear();
-            }
+        // des nodes have no out_queue, report handled when handling returns so time spent in the last node is visible too
+        if (node_type() == vp_node_type::DES) {
+            invoke_meta_handled_hooker(node_name, 0, in_meta);
         }
-        // send dead flag for dispatch_thread
-        this->out_queue.push(nullptr);
-        this->out_queue_semaphore.signal();
     }
 
-    // there is only one thread poping from the out_queue, we don't use lock here when poping.
+    // there is only one thread poping from the out_queue.
     void vp_node::dispatch_run() {
         while (alive) {
             // wait for producer, make sure out_queue is not empty.
-            this->out_queue_semaphore.wait();
-
+            auto out_meta = this->out_queue.pop();
             VP_DEBUG(vp_utils::string_format("[%s] before dispatching meta, out_queue.size()==>%d", node_name.c_str(), out_queue.size()));
-            auto out_meta = this->out_queue.front();
             // dead flag
             if (out_meta == nullptr) {
                 continue;
             }
+            dispatch_one(out_meta);
+        }
+    }
+
+    void vp_node::dispatch_one(std::shared_ptr<vp_objects::vp_meta> out_meta) {
+        vp_utils::vp_trace_scope trace(trace_name, "dispatch");
+        if (trace.is_active() && out_meta->meta_type == vp_objects::vp_meta_type::FRAME) {
+            auto frame_meta = static_cast<vp_objects::vp_frame_meta*>(out_meta.get());
+            trace.bind_frame(frame_meta->channel_index, frame_meta->frame_index);
+        }
+        // leaving hooker activated if need
+        invoke_meta_leaving_hooker(node_name, out_queue.size(), out_meta);
+
+        // do something..
+        this->push_meta(out_meta);
+        VP_DEBUG(vp_utils::string_format("[%s] after dispatching meta, out_queue.size()==>%d", node_name.c_str(), out_queue.size()));
+        if (node_type() == vp_node_type::SRC && out_meta->meta_type == vp_objects::vp_meta_type::FRAME) {
+            log_node_fps_if_needed("dispatch");
+        }
+    }
 
-            // leaving hooker activated if need
-            invoke_meta_leaving_hooker(node_name, out_queue.size(), out_meta);
+    void vp_node::schedule_handle() {
+        if (handle_scheduled.exchange(true)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(tasks_lock);
+            // no more tasks for a node going to be destroyed
+            if (!alive) {
+                return;
+            }
+            running_tasks++;
+        }
+        pool->submit([this] { handle_task(); });
+    }
 
-            // do something..
-            this->push_meta(out_meta);
-            this->out_queue.pop();
-            VP_DEBUG(vp_utils::string_format("[%s] after dispatching meta, out_queue.size()==>%d", node_name.c_str(), out_queue.size()));
-            if (node_type() == vp_node_type::SRC && out_meta->meta_type == vp_objects::vp_meta_type::FRAME) {
-                log_node_fps_if_needed("dispatch");
+    void vp_node::schedule_dispatch() {
+        if (dispatch_scheduled.exchange(true)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(tasks_lock);
+            if (!alive) {
+                return;
+            }
+            running_tasks++;
+        }
+        pool->submit([this] { dispatch_task(); });
+    }
+
+    void vp_node::task_done() {
+        std::lock_guard<std::mutex> guard(tasks_lock);
+        if (--running_tasks == 0) {
+            tasks_cond.notify_all();
+        }
+    }
+
+    // pool mode counterpart of handle_run(), handle at most metas_per_task metas without waiting on any queue.
+    void vp_node::handle_task() {
+        auto has_out = node_type() != vp_node_type::DES;
+        for (int n = 0; n < metas_per_task && alive; n++) {
+            // keep room for a whole batch, a blocked push would hold the worker
+            if (has_out && out_queue.would_block(frame_meta_handle_batch)) {
+                handle_stalled.store(true);
+                break;
+            }
+            // node resumes us via resume_handle()
+            if (!handle_ready()) {
+                break;
+            }
+            std::shared_ptr<vp_objects::vp_meta> in_meta;
+            if (!in_queue.try_pop(in_meta)) {
+                break;
+            }
+            // dead flag
+            if (in_meta == nullptr) {
+                continue;
+            }
+            handle_one(in_meta);
+        }
+
+        handle_scheduled.store(false);
+        // metas (or room) may have come after the last check while handle_scheduled was still set, run again if so.
+        // it also continues a task which used up metas_per_task, behind tasks already queued on the worker.
+        if (alive && in_queue.size() > 0 && !(has_out && out_queue.would_block(frame_meta_handle_batch)) && handle_ready()) {
+            schedule_handle();
+        }
+        task_done();
+    }
+
+    bool vp_node::handle_ready() {
+        return true;
+    }
+
+    void vp_node::resume_handle() {
+        if (pool != nullptr && in_queue.size() > 0) {
+            schedule_handle();
+        }
+    }
+
+    // pool mode counterpart of dispatch_run().
+    void vp_node::dispatch_task() {
+        auto next = next_nodes();
+        for (int n = 0; n < metas_per_task && alive; n++) {
+            // next node resumes us via wake_pre_nodes() when it has room
+            if (!next_nodes_ready(next)) {
+                break;
+            }
+            std::shared_ptr<vp_objects::vp_meta> out_meta;
+            if (!out_queue.try_pop(out_meta)) {
+                break;
+            }
+            // room in out_queue now
+            if (handle_stalled.load() && handle_stalled.exchange(false)) {
+                schedule_handle();
+            }
+            // dead flag
+            if (out_meta == nullptr) {
+                continue;
+            }
+            dispatch_one(out_meta);
+        }
+
+        dispatch_scheduled.store(false);
+        if (alive && out_queue.size() > 0 && next_nodes_ready(next)) {
+            schedule_dispatch();
+        }
+        task_done();
+    }
+
+    bool vp_node::next_nodes_ready(const std::vector<std::shared_ptr<vp_node>>& next) {
+        for (auto& n: next) {
+            if (n != nullptr && n->in_queue.would_block()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void vp_node::wake_pre_nodes() {
+        auto snapshot = pre_nodes_snapshot();
+        for (auto& p: *snapshot) {
+            if (p->pool != nullptr && p->out_queue.size() > 0) {
+                p->schedule_dispatch();
             }
         }
     }
@@ -159,34 +313,101 @@ namespace vp_nodes {
             return;
         }
 
-        std::lock_guard<std::mutex> guard(this->in_queue_lock);
         VP_DEBUG(vp_utils::string_format("[%s] before meta flow, in_queue.size()==>%d", node_name.c_str(), in_queue.size()));
-        this->in_queue.push(meta);
+        // notify consumer of in_queue, may block or drop frame metas depending on policy of in_queue.
+        if (!this->in_queue.push(meta)) {
+            log_in_queue_drops_if_needed();
+            // the incoming meta itself may be dropped, do not report it as arriving.
+            if (this->in_queue.get_policy() == vp_queue_policy::DROP_NEWEST) {
+                return;
+            }
+        }
 
         // arriving hooker activated if need
         invoke_meta_arriving_hooker(node_name, in_queue.size(), meta);
-        
-        // notify consumer of in_queue
-        this->in_queue_semaphore.signal();
         VP_DEBUG(vp_utils::string_format("[%s] after meta flow, in_queue.size()==>%d", node_name.c_str(), in_queue.size()));
     }
 
+    void vp_node::log_in_queue_drops_if_needed() {
+        // print drop statistics once per second at most, avoid flooding logs.
+        std::lock_guard<std::mutex> guard(this->in_queue_drop_log_lock);
+        auto now_tp = std::chrono::steady_clock::now();
+        auto dropped = in_queue.dropped();
+        if (in_queue_drop_log_time.time_since_epoch().count() == 0) {
+            in_queue_drop_log_time = now_tp;
+            in_queue_dropped_last_log = dropped;
+            return;
+        }
+        auto delta_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now_tp - in_queue_drop_log_time).count();
+        if (delta_ms >= 1000) {
+            VP_WARN(vp_utils::string_format("[%s] drop_frame backlog=%d dropped=%llu(+%llu/s)",
+                                            node_name.c_str(),
+                                            in_queue.size(),
+                                            static_cast<unsigned long long>(dropped),
+                                            static_cast<unsigned long long>(dropped - in_queue_dropped_last_log)));
+            in_queue_drop_log_time = now_tp;
+            in_queue_dropped_last_log = dropped;
+        }
+    }
+
+    int vp_node::get_in_queue_size() const {
+        return in_queue.size();
+    }
+
+    int vp_node::get_out_queue_size() const {
+        return out_queue.size();
+    }
+
+    uint64_t vp_node::get_in_queue_dropped() const {
+        return in_queue.dropped();
+    }
+
+    uint64_t vp_node::get_out_queue_dropped() const {
+        return out_queue.dropped();
+    }
+
+    void vp_node::set_in_queue_policy(vp_queue_policy policy, int capacity) {
+        in_queue.set_policy(policy, capacity);
+    }
+
+    void vp_node::set_out_queue_policy(vp_queue_policy policy, int capacity) {
+        out_queue.set_policy(policy, capacity);
+    }
+
+    std::shared_ptr<const std::vector<std::shared_ptr<vp_node>>> vp_node::pre_nodes_snapshot() {
+        std::lock_guard<std::mutex> guard(pre_nodes_lock);
+        return pre_nodes;
+    }
+
     void vp_node::detach() {
-        for(auto i : this->pre_nodes) {
+        std::shared_ptr<const std::vector<std::shared_ptr<vp_node>>> detached;
+        {
+            std::lock_guard<std::mutex> guard(pre_nodes_lock);
+            detached = this->pre_nodes;
+            this->pre_nodes = std::make_shared<const std::vector<std::shared_ptr<vp_node>>>();
+        }
+        for(auto i : *detached) {
             i->remove_subscriber(shared_from_this());
         }
-        this->pre_nodes.clear();
     }
 
     void vp_node::detach_from(std::vector<std::string> pre_node_names) {
-        for (auto i = this->pre_nodes.begin(); i != this->pre_nodes.end();) {
-            if (std::find(pre_node_names.begin(), pre_node_names.end(), (*i)->node_name) != pre_node_names.end()) {
-                (*i)->remove_subscriber(shared_from_this());
-                i = this->pre_nodes.erase(i);
-            }
-            else {
-                i++;
+        std::vector<std::shared_ptr<vp_node>> detached;
+        {
+            std::lock_guard<std::mutex> guard(pre_nodes_lock);
+            auto left = std::make_shared<std::vector<std::shared_ptr<vp_node>>>();
+            for (auto& i: *this->pre_nodes) {
+                if (std::find(pre_node_names.begin(), pre_node_names.end(), i->node_name) != pre_node_names.end()) {
+                    detached.push_back(i);
+                }
+                else {
+                    left->push_back(i);
+                }
             }
+            this->pre_nodes = left;
+        }
+        for (auto& i: detached) {
+            i->remove_subscriber(shared_from_this());
         }
     }
 
@@ -208,24 +429,68 @@ namespace vp_nodes {
             if (i->node_type() == vp_node_type::DES) {
                 throw vp_excepts::vp_invalid_calling_error("DES nodes must not have any next nodes!");
             }
+            // a previous node in pool mode waits for room in my in_queue without blocking, tell it when room appears.
+            // pool mode nodes have the listener already (see initialized()), set it before metas can flow from the new node.
+            if (pool == nullptr && i->pool != nullptr) {
+                in_queue.set_listeners(nullptr, [this] { wake_pre_nodes(); });
+            }
+            {
+                std::lock_guard<std::mutex> guard(pre_nodes_lock);
+                auto attached = std::make_shared<std::vector<std::shared_ptr<vp_node>>>(*this->pre_nodes);
+                attached->push_back(i);
+                this->pre_nodes = attached;
+            }
             i->add_subscriber(shared_from_this());
-            this->pre_nodes.push_back(i);
         }
     }
 
     void vp_node::initialized() {
-        // start threads since all resources have been initialized
-        this->handle_thread = std::thread(&vp_node::handle_run, this);
-        this->dispatch_thread = std::thread(&vp_node::dispatch_run, this);
+        pool = vp_node_pool_scope::current();
+        if (pool == nullptr) {
+            // start threads since all resources have been initialized
+            this->handle_thread = std::thread([this] {
+                vp_utils::vp_tracer::set_thread_name(node_name + " handle");
+                handle_run();
+            });
+            this->dispatch_thread = std::thread([this] {
+                vp_utils::vp_tracer::set_thread_name(node_name + " dispatch");
+                dispatch_run();
+            });
+            return;
+        }
+
+        // src nodes produce metas in their own loop
+        if (node_type() == vp_node_type::SRC) {
+            this->handle_thread = std::thread([this] {
+                vp_utils::vp_tracer::set_thread_name(node_name + " handle");
+                handle_run();
+            });
+        }
+        else {
+            in_queue.set_listeners([this] { schedule_handle(); }, [this] { wake_pre_nodes(); });
+        }
+        if (node_type() != vp_node_type::DES) {
+            out_queue.set_listeners([this] { schedule_dispatch(); }, nullptr);
+        }
+        VP_INFO(vp_utils::string_format("[%s] run on pool [%s] with %d workers", node_name.c_str(), pool->name().c_str(), pool->workers()));
     }
 
     void vp_node::deinitialized() {
         // send dead flag
-        alive = false;
         {
-            std::lock_guard<std::mutex> guard(this->in_queue_lock);
-            this->in_queue.push(nullptr);
-            this->in_queue_semaphore.signal();
+            std::lock_guard<std::mutex> guard(tasks_lock);
+            alive = false;
+        }
+        // unblock producers waiting for free slots (previous nodes or my own handle thread)
+        this->in_queue.close();
+        this->out_queue.close();
+        this->in_queue.push(nullptr);
+        // dispatch thread of src nodes may wait forever if handle thread has exited already (such as end of file)
+        this->out_queue.push(nullptr);
+        // wait for tasks in pool mode, no new one is scheduled since alive is false
+        {
+            std::unique_lock<std::mutex> guard(tasks_lock);
+            tasks_cond.wait(guard, [this] { return running_tasks == 0; });
         }
         // wait for threads exits in vp_node
         if (handle_thread.joinable()) {
@@ -257,10 +522,9 @@ namespace vp_nodes {
     }
 
     void vp_node::pendding_meta(std::shared_ptr<vp_objects::vp_meta> meta) {
+        // notify consumer of out_queue
         this->out_queue.push(meta);
         // handled hooker activated if need
-        invoke_meta_handled_hooker(node_name, out_queue.size(), meta);        
-        // notify consumer of out_queue
-        this->out_queue_semaphore.signal();
+        invoke_meta_handled_hooker(node_name, out_queue.size(), meta);
     }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <thread>
 #include <queue>
 #include <mutex>
@@ -8,11 +9,13 @@
 #include <memory>
 #include <chrono>
 
-#include "vp_utils/vp_semaphore.h"
 #include "vp_utils/vp_utils.h"
 #include "vp_utils/logger/vp_logger.h"
+#include "vp_utils/vp_work_stealing_pool.h"
+#include "vp_utils/trace/vp_tracer.h"
 #include "vp_meta_publisher.h"
 #include "vp_meta_hookable.h"
+#include "vp_meta_queue.h"
 #include "objects/vp_control_meta.h"
 #include "objects/vp_frame_meta.h"
 #include "excepts/vp_invalid_calling_error.h"
@@ -25,20 +28,76 @@ namespace vp_nodes {
         MID   // middle node, can have input and output branchs
     };
 
+    // nodes constructed on current thread while the scope is alive run as tasks on pool, instead of 2 dedicated threads per node.
+    // one pool per cpu cluster lets heavy nodes stay on big cores and light ones on little cores, for example:
+    //   auto big = std::make_shared<vp_utils::vp_work_stealing_pool>("big", 0, vp_utils::vp_cpus_of(vp_utils::vp_cpu_cluster::BIG));
+    //   { vp_nodes::vp_node_pool_scope scope(big); infer_0 = std::make_shared<...>(...); }
+    // scopes can nest (the innermost wins), nodes constructed outside any scope keep thread mode. pool must outlive the nodes.
+    class vp_node_pool_scope {
+    private:
+        std::shared_ptr<vp_utils::vp_work_stealing_pool> previous;
+    public:
+        explicit vp_node_pool_scope(std::shared_ptr<vp_utils::vp_work_stealing_pool> pool);
+        ~vp_node_pool_scope();
+
+        vp_node_pool_scope(const vp_node_pool_scope&) = delete;
+        vp_node_pool_scope& operator=(const vp_node_pool_scope&) = delete;
+
+        // pool of the innermost scope alive on current thread, nullptr if none.
+        static std::shared_ptr<vp_utils::vp_work_stealing_pool> current();
+    };
+
     // base class for all nodes
     class vp_node: public vp_meta_publisher, 
                     public vp_meta_subscriber, 
                     public vp_meta_hookable, 
                     public std::enable_shared_from_this<vp_node> {
     private:
-        // previous nodes
-        std::vector<std::shared_ptr<vp_node>> pre_nodes;
+        // previous nodes, copy-on-write: attach/detach replace the whole list under pre_nodes_lock,
+        // readers on other threads (wake_pre_nodes() from a consumer of in_queue) take a snapshot and iterate it without lock.
+        std::shared_ptr<const std::vector<std::shared_ptr<vp_node>>> pre_nodes;
+        std::mutex pre_nodes_lock;
+        std::shared_ptr<const std::vector<std::shared_ptr<vp_node>>> pre_nodes_snapshot();
 
         // handle thread
         std::thread handle_thread;
         // dispatch thread
         std::thread dispatch_thread;
 
+        // pool mode (see vp_node_pool_scope), nullptr for thread mode.
+        // handle_run()/dispatch_run() loops are replaced by short tasks woken by queue listeners, which never wait on a queue:
+        // handle task stops when out_queue is full and dispatch task stops when any next node would block.
+        // src nodes keep a thread for their own handle_run() and des nodes have nothing to dispatch.
+        std::shared_ptr<vp_utils::vp_work_stealing_pool> pool;
+        // at most one handle task and one dispatch task of the node exist at any time
+        std::atomic<bool> handle_scheduled {false};
+        std::atomic<bool> dispatch_scheduled {false};
+        // handle task stopped on full out_queue, the dispatch task re-schedules it after taking metas away
+        std::atomic<bool> handle_stalled {false};
+        // tasks submitted and not finished yet, deinitialized() waits for them
+        int running_tasks = 0;
+        std::mutex tasks_lock;
+        std::condition_variable tasks_cond;
+        // metas handled by one task at most, then it yields to other nodes sharing the worker
+        static constexpr int metas_per_task = 8;
+
+        // cache for batch handling if need, kept across handle tasks in pool mode
+        std::vector<std::shared_ptr<vp_objects::vp_frame_meta>> frame_meta_batch_cache;
+
+        // handle one meta from in_queue / dispatch one meta from out_queue, shared by thread and pool modes
+        void handle_one(std::shared_ptr<vp_objects::vp_meta> in_meta);
+        void dispatch_one(std::shared_ptr<vp_objects::vp_meta> out_meta);
+        void schedule_handle();
+        void schedule_dispatch();
+        void handle_task();
+        void dispatch_task();
+        void task_done();
+        // none of next nodes would block on a new frame meta
+        bool next_nodes_ready(const std::vector<std::shared_ptr<vp_node>>& next);
+        // in_queue got room again, resume dispatch tasks of previous nodes stopped on it.
+        // installed as space listener of in_queue only if the node runs in pool mode or a previous node does.
+        void wake_pre_nodes();
+
     protected:
         // alive or not for node
         bool alive = true;
@@ -48,17 +107,26 @@ namespace vp_nodes {
         // note: control meta is not allowed like above, only one by one supported.
         int frame_meta_handle_batch = 1;
 
-        // cache input meta from previous nodes
-        std::queue<std::shared_ptr<vp_objects::vp_meta>> in_queue;
-        // 
-        std::mutex in_queue_lock;
-        // cache output meta to next nodes
-        std::queue<std::shared_ptr<vp_objects::vp_meta>> out_queue;
+        // whether handle_frame_meta(...) reads BGR image (meta->bgr_frame()), true by default since most nodes draw on or infer with BGR.
+        // frame metas carrying native NV12 (hardware decoded) are converted by vp_frame_meta::ensure_bgr() right before they are handled,
+        // the result is cached in meta (meta->frame keeps NV12) so the conversion happens at most once per frame in the whole pipeline.
+        // nodes working on NV12 or not touching pixels at all set it to false (before initialized()), so pipelines which only
+        // detect and publish metadata never pay for BGR.
+        bool frame_needs_bgr = true;
+
+        // cache input meta from previous nodes, bounded and drained by handle thread only.
+        // the edge policy (block/drop) is decided by the receiving node, see set_in_queue_policy(...).
+        vp_meta_queue in_queue;
+        // cache output meta to next nodes, bounded and drained by dispatch thread only.
+        vp_meta_queue out_queue;
+
+        // name of spans recorded by the node in timeline (see vp_utils::vp_tracer)
+        uint32_t trace_name = 0;
 
-        // synchronize for in_queue
-        vp_utils::vp_semaphore in_queue_semaphore;
-        // synchronize for out_queue
-        vp_utils::vp_semaphore out_queue_semaphore;
+        // rate-limited warning for frame metas dropped by in_queue
+        std::mutex in_queue_drop_log_lock;
+        uint64_t in_queue_dropped_last_log = 0;
+        std::chrono::steady_clock::time_point in_queue_drop_log_time;
 
         // 节点 FPS 统计周期（毫秒）。
         int node_fps_epoch_ms = 1000;
@@ -73,6 +141,8 @@ namespace vp_nodes {
          * @param stage 统计阶段标识（如 handle/dispatch）。
          */
         void log_node_fps_if_needed(const char* stage);
+        // print statistics of frame metas dropped by in_queue, once per second at most.
+        void log_in_queue_drops_if_needed();
 
         // get meta from in_queue, handle meta and put them into out_queue looply.
         // we need re-implement(define how to create meta and put it into out_queue) in src nodes since they have no previous nodes. 
@@ -98,9 +168,17 @@ namespace vp_nodes {
 
         // push meta to the back of out_queue, then it will be pushed to next nodes in order.
         // take care it's different from vp_node::push_meta(meta) which will push meta to next nodes directly.
-        // the method can be called ONLY in handle thread inside node.
+        // the method can be called ONLY in handle thread inside node, or in a single completion thread of the node
+        // which emits metas in the order handle thread received them (see vp_utils::vp_ordered_executor).
         void pendding_meta(std::shared_ptr<vp_objects::vp_meta> meta);
 
+        // pool mode only, asked before each meta is taken from in_queue: return false if handling one more meta would block
+        // (for example the node's own vp_utils::vp_ordered_executor is full). the handle task then stops instead of holding
+        // a worker, and the node calls resume_handle() when it can go on. true by default.
+        virtual bool handle_ready();
+        // resume handle task stopped by handle_ready(), can be called from any thread, does nothing in thread mode.
+        void resume_handle();
+
         // protected as it can't be instanstiated directly.
         vp_node(std::string node_name);
     public:
@@ -127,6 +205,18 @@ namespace vp_nodes {
         // get next nodes
         std::vector<std::shared_ptr<vp_node>> next_nodes();
 
+        // set policy and capacity for in_queue (the edge from previous nodes to me), can be called at runtime.
+        // BLOCK applies backpressure to previous nodes, others drop frame metas (control metas are never dropped).
+        void set_in_queue_policy(vp_queue_policy policy, int capacity);
+        // set policy and capacity for out_queue (between handle thread and dispatch thread inside me).
+        void set_out_queue_policy(vp_queue_policy policy, int capacity);
+
+        // statistics of queues, can be called from any thread (used by monitoring tools such as vp_utils::vp_pipeline_metrics).
+        int get_in_queue_size() const;
+        int get_out_queue_size() const;
+        uint64_t get_in_queue_dropped() const;
+        uint64_t get_out_queue_dropped() const;
+
         // get description of node
         virtual std::string to_string();
     };
@@ -4,6 +4,7 @@
 namespace vp_nodes {
         
     vp_placeholder_node::vp_placeholder_node(std::string node_name): vp_node(node_name) {
+        this->frame_needs_bgr = false;
         this->initialized();
     }
     
@@ -10,6 +10,8 @@ namespace vp_nodes {
                                 vp_node(node_name), 
                                 split_with_channel_index(split_with_channel_index),
                                 split_with_deep_copy(split_with_deep_copy) {
+        // pass through only, leave colour conversion to the branches which need it
+        this->frame_needs_bgr = false;
         this->initialized();
     }
     
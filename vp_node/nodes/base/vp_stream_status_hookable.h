@@ -1,10 +1,11 @@
 #pragma once
 
 #include <functional>
-#include <mutex>
 #include <string>
 #include <memory>
 
+#include "vp_hook_slot.h"
+
 namespace vp_nodes {
     // stream status created by des nodes.
     struct vp_stream_status {
@@ -19,31 +20,28 @@ namespace vp_nodes {
     };
 
     // callback when stream is going out of pipe, happens in des nodes. MUST not be blocked.
-    typedef std::function<void(std::string, vp_stream_status)> vp_stream_status_hooker;
+    // arguments are borrowed for the duration of the call.
+    typedef std::function<void(const std::string&, const vp_stream_status&)> vp_stream_status_hooker;
 
     // allow hookers attached to the pipe (des nodes specifically), hookers get notified when stream is going out of pipe.
     // this class is inherited by vp_des_node only.
+    // invoked for every frame, no lock taken (see vp_hook_slot).
     class vp_stream_status_hookable
     {
     private:
         /* data */
     protected:
-        std::mutex stream_status_hooker_lock;
-        vp_stream_status_hooker stream_status_hooker;
+        vp_hook_slot<void(const std::string&, const vp_stream_status&)> stream_status_hooker;
     public:
         vp_stream_status_hookable(/* args */) {}
         ~vp_stream_status_hookable() {}
         
         void set_stream_status_hooker(vp_stream_status_hooker stream_status_hooker) {
-            std::lock_guard<std::mutex> guard(stream_status_hooker_lock);
-            this->stream_status_hooker = stream_status_hooker;
+            this->stream_status_hooker.set(std::move(stream_status_hooker));
         }
 
-        void invoke_stream_status_hooker(std::string node_name, vp_stream_status stream_status) {
-            std::lock_guard<std::mutex> guard(stream_status_hooker_lock);
-            if (this->stream_status_hooker) {
-                this->stream_status_hooker(node_name, stream_status);
-            }
+        void invoke_stream_status_hooker(const std::string& node_name, const vp_stream_status& stream_status) {
+            this->stream_status_hooker.invoke(node_name, stream_status);
         }
     };
 }
\ No newline at end of file
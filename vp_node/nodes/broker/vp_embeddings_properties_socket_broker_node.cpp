@@ -83,11 +83,12 @@ namespace vp_nodes {
             cv::imwrite(name, cropped);
             msg_stream << name << std::endl;
         };
+        auto frame = meta->bgr_frame();
         if (broke_for == vp_broke_for::NORMAL) {
             for (int i = 0; i < meta->targets.size(); i++) {
                 auto& t = meta->targets[i];
                 // only broke for tracked targets and have enough frames
-                if ((only_for_tracked && t->track_id < 0) || (only_for_tracked && t->tracks.size() < min_tracked_frames)) {
+                if ((only_for_tracked && t->track_id < 0) || (only_for_tracked && t->tracks.tracked_frames() < min_tracked_frames)) {
                     continue;
                 }
                 
@@ -109,7 +110,7 @@ namespace vp_nodes {
                 // start flag
                 msg_stream << "<--" << std::endl;
                 // save small cropped image
-                save_cropped_image(meta->frame, cv::Rect(t->x, t->y, t->width, t->height), name);
+                save_cropped_image(frame, cv::Rect(t->x, t->y, t->width, t->height), name);
                 // format properties
                 format_properties(t->secondary_labels);
                 // format sub target (vehicle plate here), just using the first sub target's label is enough.
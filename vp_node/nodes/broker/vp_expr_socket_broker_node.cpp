@@ -78,7 +78,8 @@ namespace vp_nodes {
             format_basic_info(meta->channel_index, meta->frame_index);
             format_expr_info(meta->text_targets);
             auto screenshot_name = screenshot_dir + "/" + std::to_string(meta->channel_index) + "_" + std::to_string(meta->frame_index) + ".jpg";
-            format_screenshot(meta->osd_frame.empty() ? meta->frame : meta->osd_frame, screenshot_name);
+            auto screenshot = meta->osd_frame.empty() ? meta->bgr_frame() : meta->osd_frame;
+            format_screenshot(screenshot, screenshot_name);
             // end flag
             msg_stream << "-->" << std::endl;
         }
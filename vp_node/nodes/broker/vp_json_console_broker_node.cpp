@@ -25,8 +25,8 @@ namespace vp_nodes {
             // global values
             json_archive(cereal::make_nvp("channel_index", meta->channel_index),
             cereal::make_nvp("frame_index", meta->frame_index),
-            cereal::make_nvp("width", meta->frame.cols),
-            cereal::make_nvp("height", meta->frame.rows),
+            cereal::make_nvp("width", meta->bgr_frame().cols),
+            cereal::make_nvp("height", meta->bgr_frame().rows),
             cereal::make_nvp("fps", meta->fps),
             cereal::make_nvp("broke_for", broke_fors.at(broke_for)));
 
@@ -78,6 +78,7 @@ namespace vp_nodes {
             cv::imwrite(name, frame);
             msg_stream << name << std::endl;  // line4
         };
+        auto frame = meta->bgr_frame();
         auto format_plate = [&](const std::string& plate_color, const std::string& plate_text) {
             msg_stream << plate_color << std::endl;  // line5          
             msg_stream << plate_text << std::endl;   // line6
@@ -86,7 +87,7 @@ namespace vp_nodes {
             for (int i = 0; i < meta->targets.size(); i++) {
                 auto& t = meta->targets[i];
                 // only broke for tracked targets and have enough frames
-                if ((only_for_tracked && t->track_id < 0) || (only_for_tracked && t->tracks.size() < min_tracked_frames)) {
+                if ((only_for_tracked && t->track_id < 0) || (only_for_tracked && t->tracks.tracked_frames() < min_tracked_frames)) {
                     continue;
                 }
                 
@@ -134,9 +135,9 @@ namespace vp_nodes {
                 // basic info
                 format_basic_info(meta->channel_index, meta->frame_index);
                 // save small cropped image
-                save_cropped_image(meta->frame, cv::Rect(t->x, t->y, t->width, t->height), cropped_name);
+                save_cropped_image(frame, cv::Rect(t->x, t->y, t->width, t->height), cropped_name);
                 // save whole image
-                save_whole_image(meta->frame, whole_name);
+                save_whole_image(frame, whole_name);
                 // format color and text
                 format_plate(color, text);
                 // end flag
@@ -66,7 +66,7 @@ namespace vp_nodes {
     std::shared_ptr<vp_objects::vp_meta> vp_infer_node::handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
         std::vector<std::shared_ptr<vp_objects::vp_frame_meta>> frame_meta_with_batch {meta};
         run_infer_combinations(frame_meta_with_batch);    
-        return meta;
+        return defer_frame_output ? nullptr : meta;
     }
 
     // handle frame meta batch by batch
@@ -189,7 +189,10 @@ namespace vp_nodes {
         // start
         auto start_time = std::chrono::system_clock::now();
         // 1st step, prepare
-        prepare(frame_meta_with_batch, mats_to_infer);
+        {
+            vp_utils::vp_trace_scope trace(trace_name, "prepare");
+            prepare(frame_meta_with_batch, mats_to_infer);
+        }
         auto prepare_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start_time);
 
         // nothing to infer
@@ -199,17 +202,26 @@ namespace vp_nodes {
 
         start_time = std::chrono::system_clock::now();
         // 2nd step, preprocess
-        preprocess(mats_to_infer, blob_to_infer);
+        {
+            vp_utils::vp_trace_scope trace(trace_name, "preprocess");
+            preprocess(mats_to_infer, blob_to_infer);
+        }
         auto preprocess_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start_time);
 
         start_time = std::chrono::system_clock::now();
         // 3rd step, infer
-        infer(blob_to_infer, raw_outputs);
+        {
+            vp_utils::vp_trace_scope trace(trace_name, "infer");
+            infer(blob_to_infer, raw_outputs);
+        }
         auto infer_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start_time);
 
         start_time = std::chrono::system_clock::now();
         // 4th step, postprocess
-        postprocess(raw_outputs, frame_meta_with_batch);   
+        {
+            vp_utils::vp_trace_scope trace(trace_name, "postprocess");
+            postprocess(raw_outputs, frame_meta_with_batch);
+        }
         auto postprocess_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start_time);
 
         // end
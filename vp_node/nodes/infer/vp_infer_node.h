@@ -80,6 +80,10 @@ namespace vp_nodes {
         // opencv::dnn as backend 
         cv::dnn::Net net;
 
+        // set by derived classes which complete frames asynchronously (for example dispatching across several NPU cores),
+        // then handle_frame_meta(...) returns nullptr and the derived class pushes frames via pendding_meta(...) by itself, in order.
+        bool defer_frame_output = false;
+
         // re-implementation for one by one mode, marked as 'final' as we need not override any more in specific derived classes.
         virtual std::shared_ptr<vp_objects::vp_meta> handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) override final; 
         // re-implementation for batch by batch mode, marked as 'final' as we need not override any more in specific derived classes.
@@ -39,7 +39,7 @@ namespace vp_nodes {
     void vp_primary_infer_node::prepare(const std::vector<std::shared_ptr<vp_objects::vp_frame_meta>>& frame_meta_with_batch, std::vector<cv::Mat>& mats_to_infer) {
         // fetch the whole frame, can batch by batch
         for (auto& i: frame_meta_with_batch) {
-            mats_to_infer.push_back(i->frame);
+            mats_to_infer.push_back(i->bgr_frame());
         }
     }
 }
\ No newline at end of file
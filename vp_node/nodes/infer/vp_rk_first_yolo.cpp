@@ -1,3 +1,5 @@
+#include <fstream>
+
 #include "vp_rk_first_yolo.h"
 
 namespace vp_nodes {
@@ -6,18 +8,76 @@ namespace vp_nodes {
                                                     vp_primary_infer_node(node_name, "") {
         YOLOConfig conf;
         int ret = YOLO::load_config(json_path, conf);
-        rk_model = std::make_shared<YOLO>(conf);
+
+        auto dispatch_policy = vp_utils::vp_dispatch_policy::LEAST_LOADED;
+        auto async_infer = true;
+        std::ifstream f(json_path);
+        json j_conf;
+        f >> j_conf;
+        if (j_conf.contains("core_dispatch") && j_conf["core_dispatch"].template get<std::string>() == "round_robin") {
+            dispatch_policy = vp_utils::vp_dispatch_policy::ROUND_ROBIN;
+        }
+        if (j_conf.contains("async_infer")) {
+            async_infer = j_conf["async_infer"].template get<bool>();
+        }
+
+        // one context per core mask, the first one loads model and others share its weights
+        auto core_masks = conf.core_masks;
+        if (core_masks.empty()) {
+            core_masks.push_back(conf.core_mask);
+        }
+        for (int i = 0; i < core_masks.size(); i++) {
+            auto context_conf = conf;
+            context_conf.core_mask = core_masks[i];
+            rk_models.push_back(std::make_shared<YOLO>(context_conf, i == 0 ? nullptr : rk_models[0].get()));
+        }
+        if (async_infer || rk_models.size() > 1) {
+            infer_executor = std::make_unique<vp_utils::vp_ordered_executor<infer_result>>(static_cast<int>(rk_models.size()), 
+                                                                                            [this](infer_result& result) { apply_result(result); }, 
+                                                                                            dispatch_policy);
+            // pool mode never blocks on submit, handle task resumes when a result leaves
+            infer_executor->set_space_listener([this] { resume_handle(); });
+            this->defer_frame_output = true;
+            VP_INFO(vp_utils::string_format("[%s] yolo pipeline on %d rknn contexts", node_name.c_str(), static_cast<int>(rk_models.size())));
+        }
         this->initialized();
     }
     
     vp_rk_first_yolo::~vp_rk_first_yolo() {
         deinitialized();
-        // rk_model.reset();
+        // finish frames in flight, then release shared contexts before the one owning weights
+        infer_executor.reset();
+        while (!rk_models.empty()) {
+            rk_models.pop_back();
+        }
     }
 
     // please refer to vp_infer_node::run_infer_combinations
     void vp_rk_first_yolo::run_infer_combinations(const std::vector<std::shared_ptr<vp_objects::vp_frame_meta>>& frame_meta_with_batch) {
         assert(frame_meta_with_batch.size() == 1);
+        infer_result result;
+        result.frame_meta = frame_meta_with_batch[0];
+
+        // no pipeline, infer in handle thread
+        if (infer_executor == nullptr) {
+            infer_frame(0, result);
+            apply_result(result);
+            return;
+        }
+
+        // worker index is the index of context
+        infer_executor->submit([this, result](int worker) mutable {
+            infer_frame(worker, result);
+            return std::move(result);
+        });
+    }
+
+    void vp_rk_first_yolo::infer_frame(int model_index, infer_result& result) {
+        // on a worker of infer_executor the frame leaves handle thread, link it in timeline
+        vp_utils::vp_trace_scope trace(trace_name, "infer");
+        trace.bind_frame(result.frame_meta->channel_index, result.frame_meta->frame_index, infer_executor != nullptr);
+        result.model_index = model_index;
+        std::vector<std::shared_ptr<vp_objects::vp_frame_meta>> frame_meta_with_batch {result.frame_meta};
         std::vector<cv::Mat> mats_to_infer;
 
         // start
@@ -25,29 +85,60 @@ namespace vp_nodes {
 
         // prepare data, as same as base class
         vp_primary_infer_node::prepare(frame_meta_with_batch, mats_to_infer);
-        auto prepare_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start_time);
+        result.prepare_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start_time).count();
 
         start_time = std::chrono::system_clock::now();
-        std::vector<std::vector<DetectionResult>> res_datas;
-        rk_model->run(mats_to_infer, res_datas);
-
-        assert(res_datas.size() == 1);
-        auto& res = res_datas[0];
-        auto& frame_meta = frame_meta_with_batch[0];
+        assert(mats_to_infer.size() == 1);
+        result.valid = rk_models[model_index]->infer(mats_to_infer[0], result.raw);
+        result.infer_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start_time).count();
+    }
 
+    // called in order of frames, in handle thread (no pipeline) or in completion thread of infer_executor
+    void vp_rk_first_yolo::apply_result(infer_result& result) {
+        if (result.control_meta != nullptr) {
+            pendding_meta(result.control_meta);
+            return;
+        }
+        auto& frame_meta = result.frame_meta;
+        vp_utils::vp_trace_scope trace(trace_name, "postprocess");
+        trace.bind_frame(frame_meta->channel_index, frame_meta->frame_index, infer_executor != nullptr);
+        auto start_time = std::chrono::system_clock::now();
+        std::vector<DetectionResult> res;
+        if (result.valid) {
+            rk_models[result.model_index]->decode(result.raw, res);
+        }
         for (auto& obj : res){
             auto target = std::make_shared<vp_objects::vp_frame_target>(obj.box.top, obj.box.left, obj.box.bottom - obj.box.top, obj.box.right - obj.box.left, 
                                                                                     obj.id, obj.score, frame_meta->frame_index, frame_meta->channel_index, obj.label);            
             frame_meta->targets.push_back(target);
         }
 
-        auto infer_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start_time);
+        auto postprocess_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start_time);
+
+        // can not calculate preprocess time, set 0 by default.
+        vp_infer_node::infer_combinations_time_cost(1, result.prepare_time, 0, result.infer_time, postprocess_time.count());
+
+        if (defer_frame_output) {
+            pendding_meta(frame_meta);
+        }
+    }
+
+    std::shared_ptr<vp_objects::vp_meta> vp_rk_first_yolo::handle_control_meta(std::shared_ptr<vp_objects::vp_control_meta> meta) {
+        if (infer_executor == nullptr) {
+            return meta;
+        }
+        // emitted by completion thread after frames submitted before it
+        infer_result result;
+        result.control_meta = meta;
+        infer_executor->submit_ready(std::move(result));
+        return nullptr;
+    }
 
-        // can not calculate preprocess time and postprocess time, set 0 by default.
-        vp_infer_node::infer_combinations_time_cost(mats_to_infer.size(), prepare_time.count(), 0, infer_time.count(), 0);
+    bool vp_rk_first_yolo::handle_ready() {
+        return infer_executor == nullptr || infer_executor->in_flight() < infer_executor->capacity();
     }
 
     void vp_rk_first_yolo::postprocess(const std::vector<cv::Mat>& raw_outputs, const std::vector<std::shared_ptr<vp_objects::vp_frame_meta>>& frame_meta_with_batch) {
 
     }
-}
\ No newline at end of file
+}
@@ -1,22 +1,53 @@
 #pragma once
 
+#include <memory>
+
 #include "vp_primary_infer_node.h"
+#include "vp_utils/vp_ordered_executor.h"
 #include "yolo.h"
 
 namespace vp_nodes {
     // yolo detector based on rknn
+    // inference is pipelined by default (`async_infer`): handle thread submits frames, NPU runs them in worker threads and
+    // postprocess runs in a completion thread, so NPU works on frame N while CPU decodes frame N-1.
+    // set `core_masks` in config to load one rknn_context per NPU core (weights shared), frames are then dispatched
+    // across contexts (`core_dispatch`: least_loaded/round_robin). frames are pushed to next nodes in the original order.
     class vp_rk_first_yolo: public vp_primary_infer_node
     {
     private:
-        std::shared_ptr<YOLO> rk_model;
+        // result of one frame, handed back in order
+        struct infer_result {
+            std::shared_ptr<vp_objects::vp_frame_meta> frame_meta;
+            // not null means the result only passes the control meta on, in order
+            std::shared_ptr<vp_objects::vp_control_meta> control_meta;
+            bool valid = false;
+            int model_index = 0;
+            YoloRawOutput raw;
+            int prepare_time = 0;
+            int infer_time = 0;
+        };
+
+        // one model per rknn_context, [0] owns weights and others share them
+        std::vector<std::shared_ptr<YOLO>> rk_models;
+        // inference pipeline, null means infer synchronously in handle thread
+        std::unique_ptr<vp_utils::vp_ordered_executor<infer_result>> infer_executor;
+
+        // NPU stage, no postprocess
+        void infer_frame(int model_index, infer_result& result);
+        // postprocess stage, called in order of frames
+        void apply_result(infer_result& result);
     protected:
         // we need a totally new logic for the whole infer combinations
         // no separate step pre-defined needed in base class
         virtual void run_infer_combinations(const std::vector<std::shared_ptr<vp_objects::vp_frame_meta>>& frame_meta_with_batch) override;
         // override pure virtual method, for compile pass
         virtual void postprocess(const std::vector<cv::Mat>& raw_outputs, const std::vector<std::shared_ptr<vp_objects::vp_frame_meta>>& frame_meta_with_batch) override;
+        // pass control meta on behind frames in flight, keep order without blocking handle thread
+        virtual std::shared_ptr<vp_objects::vp_meta> handle_control_meta(std::shared_ptr<vp_objects::vp_control_meta> meta) override;
+        // false when infer_executor is full, in pool mode handle task leaves the worker and resumes once a result leaves
+        virtual bool handle_ready() override;
     public:
         vp_rk_first_yolo(std::string node_name, std::string json_path);
         ~vp_rk_first_yolo();
     };
-}
\ No newline at end of file
+}
@@ -4,6 +4,7 @@
 #include <chrono>
 #include <fstream>
 #include <stdexcept>
+#include <utility>
 
 #include "vp_utils/vp_utils.h"
 
@@ -19,60 +20,113 @@ vp_rk_first_yolo26::vp_rk_first_yolo26(std::string node_name, std::string json_p
                                                          ret));
     }
 
+    auto dispatch_policy = vp_utils::vp_dispatch_policy::LEAST_LOADED;  // 多上下文分发策略。
+    bool async_infer = true;  // 是否启用推理流水线。
     try {
         std::ifstream stream(json_path);  // 配置文件输入流。
         if (stream.is_open()) {
             json j_conf;  // JSON 配置对象。
             stream >> j_conf;
             infer_skip_frames = std::max(0, j_conf.value("infer_skip_frames", 0));
+            async_infer = j_conf.value("async_infer", true);
+            if (j_conf.value("core_dispatch", std::string("least_loaded")) == "round_robin") {
+                dispatch_policy = vp_utils::vp_dispatch_policy::ROUND_ROBIN;
+            }
         }
     } catch (const std::exception&) {
         infer_skip_frames = 0;
     }
     infer_period = infer_skip_frames + 1;
 
-    rk_model = std::make_shared<YOLO26>(conf);
+    // 每个 core_mask 一个上下文，第一个加载模型，其余通过 rknn_dup_context 共享权重。
+    std::vector<int> core_masks = conf.core_masks;  // 各上下文绑定的 NPU 核。
+    if (core_masks.empty()) {
+        core_masks.push_back(conf.core_mask);
+    }
+    for (size_t i = 0; i < core_masks.size(); ++i) {
+        YOLO26Config context_conf = conf;  // 当前上下文配置。
+        context_conf.core_mask = core_masks[i];
+        rk_models.push_back(std::make_shared<YOLO26>(context_conf, i == 0 ? nullptr : rk_models[0].get()));
+    }
+    if (async_infer || rk_models.size() > 1) {
+        // 流水线：处理线程只负责提交，NPU 推理在各上下文的工作线程执行，
+        // 后处理在分发器的完成线程按输入顺序执行并推给下游，NPU 推理第 N 帧时 CPU 可以后处理第 N-1 帧。
+        infer_executor = std::make_unique<vp_utils::vp_ordered_executor<infer_result>>(
+            static_cast<int>(rk_models.size()),
+            [this](infer_result& result) { apply_result(result); },
+            dispatch_policy);
+        // 线程池模式下处理任务不在提交处阻塞，结果交回腾出位置后再恢复。
+        infer_executor->set_space_listener([this] { resume_handle(); });
+        this->defer_frame_output = true;
+        VP_INFO(vp_utils::string_format("[%s] yolo26 pipeline on %zu rknn contexts, dispatch=%s",
+                                        node_name.c_str(),
+                                        rk_models.size(),
+                                        dispatch_policy == vp_utils::vp_dispatch_policy::ROUND_ROBIN ? "round_robin" : "least_loaded"));
+    }
+    // 模型输入由预处理节点提供，不读取 BGR 帧。
+    this->frame_needs_bgr = false;
     this->initialized();
 }
 
 vp_rk_first_yolo26::~vp_rk_first_yolo26() {
     deinitialized();
-    rk_model.reset();
+    // 先等待在途帧完成，再按创建的逆序释放上下文（共享权重的上下文先于权重持有者释放）。
+    infer_executor.reset();
+    while (!rk_models.empty()) {
+        rk_models.pop_back();
+    }
 }
 
 void vp_rk_first_yolo26::run_infer_combinations(
     const std::vector<std::shared_ptr<vp_objects::vp_frame_meta>>& frame_meta_with_batch) {
     assert(frame_meta_with_batch.size() == 1);
-    auto& frame_meta = frame_meta_with_batch[0];  // 当前帧元数据。
     const bool do_infer = (infer_frame_counter % static_cast<uint64_t>(infer_period) == 0);  // 本帧是否执行真实推理。
     ++infer_frame_counter;
 
-    if (!do_infer) {
-        for (const auto& cached_target : last_targets_cache) {
-            if (cached_target == nullptr) {
-                continue;
-            }
-            auto target = cached_target->clone();  // 克隆缓存目标，避免跨帧共享对象。
-            target->frame_index = frame_meta->frame_index;
-            target->channel_index = frame_meta->channel_index;
-            frame_meta->targets.push_back(target);
+    infer_result result;  // 当前帧推理结果。
+    result.frame_meta = frame_meta_with_batch[0];
+    result.inferred = do_infer;
+
+    if (infer_executor == nullptr) {
+        if (do_infer) {
+            infer_frame(0, result);
         }
-        vp_infer_node::infer_combinations_time_cost(static_cast<int>(frame_meta_with_batch.size()), 0, 0, 0, 0);
+        apply_result(result);
         return;
     }
 
+    // 跳帧也经过分发器排队，保证沿用的是前一次推理的结果且输出顺序不变。
+    if (!do_infer) {
+        infer_executor->submit_ready(std::move(result));
+        return;
+    }
+    infer_executor->submit([this, result](int worker) mutable {
+        infer_frame(worker, result);
+        return std::move(result);
+    });
+}
+
+void vp_rk_first_yolo26::infer_frame(int model_index, infer_result& result) {
+    auto& model = *rk_models[model_index];  // 当前上下文模型。
+    result.model_index = model_index;
+    const auto& frame_meta = result.frame_meta;  // 当前帧元数据。
+    // 在分发器工作线程上执行时帧离开了处理线程，时间线上用流箭头关联。
+    vp_utils::vp_trace_scope trace(trace_name, "infer");
+    trace.bind_frame(frame_meta->channel_index, frame_meta->frame_index, infer_executor != nullptr);
+    std::vector<std::shared_ptr<vp_objects::vp_frame_meta>> frame_meta_with_batch {frame_meta};  // 单帧批次。
     std::vector<cv::Mat> mats_to_infer;  // 待推理图像容器。
 
     auto start_time = std::chrono::system_clock::now();  // 开始时间戳。
     vp_primary_infer_node::prepare(frame_meta_with_batch, mats_to_infer);
-    const auto prepare_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now() - start_time);  // prepare 耗时。
+    result.prepare_time = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now() - start_time).count());
     if (mats_to_infer.empty()) {
         return;
     }
 
     start_time = std::chrono::system_clock::now();
-    if (!frame_meta->yolo26_input_ready || frame_meta->yolo26_input_rgb_data.empty()) {
+    const auto& input_dma = frame_meta->yolo26_input_dma;  // DMA-buf 模型输入（优先使用，零拷贝）。
+    if (!frame_meta->yolo26_input_ready || (input_dma == nullptr && frame_meta->yolo26_input_rgb_data.empty())) {
         VP_WARN(vp_utils::string_format("[%s] yolo26 input is not ready, drop frame=%d",
                                         node_name.c_str(),
                                         frame_meta->frame_index));
@@ -80,10 +134,11 @@ void vp_rk_first_yolo26::run_infer_combinations(
     }
     const size_t expected_input_bytes =
         static_cast<size_t>(frame_meta->yolo26_input_width) * static_cast<size_t>(frame_meta->yolo26_input_height) * 3U;  // 期望输入字节数。
-    if (frame_meta->yolo26_input_rgb_data.size() != expected_input_bytes) {
+    const size_t input_bytes = input_dma != nullptr ? input_dma->size : frame_meta->yolo26_input_rgb_data.size();  // 实际输入字节数。
+    if (input_bytes != expected_input_bytes) {
         VP_WARN(vp_utils::string_format("[%s] yolo26 input bytes mismatch, got=%zu expect=%zu frame=%d",
                                         node_name.c_str(),
-                                        frame_meta->yolo26_input_rgb_data.size(),
+                                        input_bytes,
                                         expected_input_bytes,
                                         frame_meta->frame_index));
         return;
@@ -91,37 +146,87 @@ void vp_rk_first_yolo26::run_infer_combinations(
 
     const int orig_w = frame_meta->original_width > 0 ? frame_meta->original_width : mats_to_infer[0].cols;  // 原始图像宽度。
     const int orig_h = frame_meta->original_height > 0 ? frame_meta->original_height : mats_to_infer[0].rows;  // 原始图像高度。
-    std::vector<DetectionResult> res;  // 检测结果。
-    rk_model->run(frame_meta->yolo26_input_rgb_data.data(), orig_w, orig_h, res);
-    auto infer_time = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::system_clock::now() - start_time);  // infer 耗时。
-
-    for (const auto& obj : res) {
-        auto target = std::make_shared<vp_objects::vp_frame_target>(obj.box.top,
-                                                                     obj.box.left,
-                                                                     obj.box.bottom - obj.box.top,
-                                                                     obj.box.right - obj.box.left,
-                                                                     obj.id,
-                                                                     obj.score,
-                                                                     frame_meta->frame_index,
-                                                                     frame_meta->channel_index,
-                                                                     obj.label);
-        frame_meta->targets.push_back(target);
-    }
-    last_targets_cache.clear();
-    last_targets_cache.reserve(frame_meta->targets.size());
-    for (const auto& target : frame_meta->targets) {
-        if (target == nullptr) {
-            continue;
+    if (input_dma != nullptr) {
+        result.valid = model.infer(input_dma->fd, input_dma->vir_addr, input_dma->size, orig_w, orig_h, result.raw);
+    } else {
+        result.valid = model.infer(frame_meta->yolo26_input_rgb_data.data(), orig_w, orig_h, result.raw);
+    }
+    result.infer_time = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now() - start_time).count());
+}
+
+void vp_rk_first_yolo26::apply_result(infer_result& result) {
+    if (result.control_meta != nullptr) {
+        this->pendding_meta(result.control_meta);
+        return;
+    }
+    auto& frame_meta = result.frame_meta;  // 当前帧元数据。
+    vp_utils::vp_trace_scope trace(trace_name, "postprocess");
+    trace.bind_frame(frame_meta->channel_index, frame_meta->frame_index, infer_executor != nullptr);
+    if (!result.inferred) {
+        for (const auto& cached_target : last_targets_cache) {
+            if (cached_target == nullptr) {
+                continue;
+            }
+            auto target = cached_target->clone();  // 克隆缓存目标，避免跨帧共享对象。
+            target->frame_index = frame_meta->frame_index;
+            target->channel_index = frame_meta->channel_index;
+            frame_meta->targets.push_back(target);
         }
-        last_targets_cache.push_back(target->clone());
+        vp_infer_node::infer_combinations_time_cost(1, 0, 0, 0, 0);
+    } else if (result.valid) {
+        const auto start_time = std::chrono::system_clock::now();  // 后处理开始时间戳。
+        std::vector<DetectionResult> res;  // 检测结果。
+        rk_models[result.model_index]->decode(result.raw, res);
+        result.raw = Yolo26RawOutput();  // 及早释放原始输出。
+        for (const auto& obj : res) {
+            auto target = std::make_shared<vp_objects::vp_frame_target>(obj.box.top,
+                                                                         obj.box.left,
+                                                                         obj.box.bottom - obj.box.top,
+                                                                         obj.box.right - obj.box.left,
+                                                                         obj.id,
+                                                                         obj.score,
+                                                                         frame_meta->frame_index,
+                                                                         frame_meta->channel_index,
+                                                                         obj.label);
+            frame_meta->targets.push_back(target);
+        }
+        last_targets_cache.clear();
+        last_targets_cache.reserve(frame_meta->targets.size());
+        for (const auto& target : frame_meta->targets) {
+            if (target == nullptr) {
+                continue;
+            }
+            last_targets_cache.push_back(target->clone());
+        }
+        const auto postprocess_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now() - start_time);  // 后处理耗时。
+        vp_infer_node::infer_combinations_time_cost(1,
+                                                    result.prepare_time,
+                                                    0,
+                                                    result.infer_time,
+                                                    static_cast<int>(postprocess_time.count()));
     }
 
-    vp_infer_node::infer_combinations_time_cost(static_cast<int>(mats_to_infer.size()),
-                                                static_cast<int>(prepare_time.count()),
-                                                0,
-                                                static_cast<int>(infer_time.count()),
-                                                0);
+    if (this->defer_frame_output) {
+        this->pendding_meta(frame_meta);
+    }
+}
+
+std::shared_ptr<vp_objects::vp_meta> vp_rk_first_yolo26::handle_control_meta(
+    std::shared_ptr<vp_objects::vp_control_meta> meta) {
+    if (infer_executor == nullptr) {
+        return meta;
+    }
+    // 排在在途帧之后由完成线程转发，不等待流水线排空。
+    infer_result result;  // 仅携带控制消息的结果。
+    result.control_meta = meta;
+    infer_executor->submit_ready(std::move(result));
+    return nullptr;
+}
+
+bool vp_rk_first_yolo26::handle_ready() {
+    return infer_executor == nullptr || infer_executor->in_flight() < infer_executor->capacity();
 }
 
 void vp_rk_first_yolo26::postprocess(
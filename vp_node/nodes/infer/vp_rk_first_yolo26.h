@@ -1,8 +1,10 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 
 #include "vp_primary_infer_node.h"
+#include "vp_utils/vp_ordered_executor.h"
 #include "yolo26.h"
 
 namespace vp_nodes {
@@ -11,11 +13,39 @@ namespace vp_nodes {
  */
 class vp_rk_first_yolo26 : public vp_primary_infer_node {
 private:
-    std::shared_ptr<YOLO26> rk_model;  // YOLO26 模型对象。
+    /**
+     * @brief 单帧推理结果，按输入顺序交回节点。
+     */
+    struct infer_result {
+        std::shared_ptr<vp_objects::vp_frame_meta> frame_meta;  // 帧元数据。
+        std::shared_ptr<vp_objects::vp_control_meta> control_meta;  // 控制消息，非空时该结果只负责按序转发它。
+        bool inferred = false;  // 是否执行了推理（false 表示跳帧，沿用缓存结果）。
+        bool valid = false;  // 推理是否成功（输入无效时为 false）。
+        int model_index = 0;  // 执行推理的模型（上下文）序号。
+        Yolo26RawOutput raw;  // NPU 原始输出，待后处理。
+        int prepare_time = 0;  // prepare 耗时（ms）。
+        int infer_time = 0;  // infer 耗时（ms）。
+    };
+
+    std::vector<std::shared_ptr<YOLO26>> rk_models;  // 每个 RKNN 上下文一个模型对象，[0] 加载权重，其余共享权重。
+    std::unique_ptr<vp_utils::vp_ordered_executor<infer_result>> infer_executor;  // 推理流水线，为空时在处理线程同步推理。
     int infer_skip_frames = 0;  // 跳帧推理配置，0 表示不跳帧。
     int infer_period = 1;  // 推理周期，等于 infer_skip_frames + 1。
     uint64_t infer_frame_counter = 0;  // 输入帧计数器，用于决定是否执行推理。
-    std::vector<std::shared_ptr<vp_objects::vp_frame_target>> last_targets_cache;  // 上一次推理结果缓存。
+    std::vector<std::shared_ptr<vp_objects::vp_frame_target>> last_targets_cache;  // 上一次推理结果缓存（仅在结果交回时访问）。
+
+    /**
+     * @brief 流水线 NPU 阶段：在指定模型上推理一帧，不做后处理。
+     * @param model_index 模型序号（同一模型同一时刻只被一个线程使用）。
+     * @param result 输入 frame_meta，输出 NPU 原始输出。
+     */
+    void infer_frame(int model_index, infer_result& result);
+
+    /**
+     * @brief 流水线后处理阶段：按输入顺序解码、写回检测目标并更新跳帧缓存，异步模式下同时把帧推给下游。
+     * @param result 推理结果。
+     */
+    void apply_result(infer_result& result);
 
 protected:
     /**
@@ -33,6 +63,18 @@ protected:
     virtual void postprocess(const std::vector<cv::Mat>& raw_outputs,
                              const std::vector<std::shared_ptr<vp_objects::vp_frame_meta>>& frame_meta_with_batch) override;
 
+    /**
+     * @brief 控制消息经流水线排在在途帧之后下发，保证顺序且不阻塞处理线程。
+     * @param meta 控制元数据。
+     * @return 流水线模式下返回 nullptr（由完成线程转发）。
+     */
+    virtual std::shared_ptr<vp_objects::vp_meta> handle_control_meta(std::shared_ptr<vp_objects::vp_control_meta> meta) override;
+
+    /**
+     * @brief 线程池模式下流水线已满时返回 false，处理任务让出工作线程，结果交回后由 resume_handle() 恢复。
+     */
+    virtual bool handle_ready() override;
+
 public:
     /**
      * @brief 构造 YOLO26 主检测节点。
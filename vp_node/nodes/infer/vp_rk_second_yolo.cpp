@@ -35,6 +35,7 @@ namespace vp_nodes {
         rk_model->run(mats_to_infer, res_datas);
 
         auto &frame_meta = frame_meta_with_batch[0];
+        auto frame = frame_meta->bgr_frame();
         auto index = 0;
 
         for (int i = 0; i < res_datas.size(); i++) {
@@ -44,8 +45,8 @@ namespace vp_nodes {
                 // check value range
                 auto x = std::max(0, res.box.top + frame_meta->targets[i]->x - 10);  // offset
                 auto y = std::max(0, res.box.left + frame_meta->targets[i]->y - 8);   // offset
-                auto w = std::min(res.box.bottom - res.box.top, frame_meta->frame.cols - x);
-                auto h = std::min(res.box.right - res.box.left, frame_meta->frame.rows - y);
+                auto w = std::min(res.box.bottom - res.box.top, frame.cols - x);
+                auto h = std::min(res.box.right - res.box.left, frame.rows - y);
                 if (w <= 0 || h <=0) {
                     continue;
                 }
@@ -47,6 +47,7 @@ namespace vp_nodes {
 
         // crop to get small images in frame 
         auto& frame_meta = frame_meta_with_batch[0];
+        auto frame = frame_meta->bgr_frame();
 
         // batch by batch inside single frame
         for (auto& i : frame_meta->targets) {
@@ -63,11 +64,11 @@ namespace vp_nodes {
                 box = cv::Rect(box.x - crop_padding, box.y - crop_padding, box.width + crop_padding * 2, box.height + crop_padding * 2);
                 box.x = std::max(box.x, 0);
                 box.y = std::max(box.y, 0);
-                box.width = std::min(box.width, frame_meta->frame.cols - box.x);
-                box.height = std::min(box.height, frame_meta->frame.rows - box.y);
+                box.width = std::min(box.width, frame.cols - box.x);
+                box.height = std::min(box.height, frame.rows - box.y);
             }
             
-            mats_to_infer.push_back(frame_meta->frame(box)); 
+            mats_to_infer.push_back(frame(box)); 
         }
     }
 
@@ -8,6 +8,7 @@
 #include "im2d.h"
 #include "im2d_common.h"
 #include "nlohmann/json.hpp"
+#include "vp_utils/vp_frame_buffer_pool.h"
 #include "vp_utils/vp_utils.h"
 
 namespace vp_nodes {
@@ -18,6 +19,8 @@ using json = nlohmann::json;
 vp_yolo26_preprocess_node::vp_yolo26_preprocess_node(std::string node_name, std::string json_path)
     : vp_node(std::move(node_name)) {
     load_preprocess_config(json_path);
+    // 直接读取 NV12（或已有的 BGR），BGR 由真正需要的下游节点按需转换。
+    this->frame_needs_bgr = false;
     this->initialized();
 }
 
@@ -47,102 +50,129 @@ void vp_yolo26_preprocess_node::load_preprocess_config(const std::string& json_p
     }
 }
 
-bool vp_yolo26_preprocess_node::ensure_rga_cache(int src_width, int src_height) {
-    if (src_width <= 1 || src_height <= 1 || input_width <= 1 || input_height <= 1) {
-        return false;
-    }
-
-    if (cache_src_width == src_width &&
-        cache_src_height == src_height &&
-        cache_dst_width == input_width &&
-        cache_dst_height == input_height &&
-        !cache_bgr_full_data.empty() &&
-        !cache_rgb_full_data.empty() &&
-        !cache_rgb_resize_data.empty()) {
-        return true;
-    }
-
-    const size_t src_rgb_bytes = static_cast<size_t>(src_width) * static_cast<size_t>(src_height) * 3U;  // 源尺寸 RGB/BGR 字节数。
-    const size_t dst_rgb_bytes = static_cast<size_t>(input_width) * static_cast<size_t>(input_height) * 3U;  // 目标尺寸 RGB 字节数。
-    cache_bgr_full_data.assign(src_rgb_bytes, 0U);
-    cache_rgb_full_data.assign(src_rgb_bytes, 0U);
-    cache_rgb_resize_data.assign(dst_rgb_bytes, 0U);
-    if (cache_bgr_full_data.empty() || cache_rgb_full_data.empty() || cache_rgb_resize_data.empty()) {
-        return false;
-    }
-
-    cache_src_width = src_width;
-    cache_src_height = src_height;
-    cache_dst_width = input_width;
-    cache_dst_height = input_height;
-    return true;
+uint8_t* vp_yolo26_preprocess_node::ensure_rgb_cache(std::vector<uint8_t>& cache, int width, int height) {
+    // resize 在容量足够时不会重新分配，尺寸不变的后续帧没有额外开销。
+    cache.resize(static_cast<size_t>(width) * static_cast<size_t>(height) * 3U);
+    return cache.data();
 }
 
-bool vp_yolo26_preprocess_node::preprocess_with_rga(const cv::Mat& src_nv12,
-                                                    std::vector<uint8_t>& dst_rgb_data,
-                                                    cv::Mat& dst_bgr_frame) {
-    if (src_nv12.empty() || src_nv12.type() != CV_8UC1) {
-        return false;
+std::shared_ptr<vp_objects::vp_dma_image> vp_yolo26_preprocess_node::acquire_rgb_input() {
+    // DMA 池中的模型输入缓冲，图像释放时随 Mat 归还池中。
+    cv::Mat rgb = vp_utils::vp_frame_buffer_pool::dma().alloc(input_height, input_width, CV_8UC3);
+    const int fd = vp_utils::vp_frame_buffer_pool::get_fd(rgb);  // DMA-buf fd。
+    if (fd < 0) {
+        // dma_heap 不可用，池退回主机内存。
+        return nullptr;
     }
+    return std::make_shared<vp_objects::vp_dma_image>(
+        fd,
+        rgb.data,
+        rgb.total() * rgb.elemSize(),
+        input_width,
+        input_height,
+        input_width,
+        input_height,
+        vp_objects::vp_dma_format::RGB888,
+        [rgb]() {
+            // 仅持有 Mat 引用，releaser 随图像析构时缓冲归还池中。
+        });
+}
 
-    const int src_width = src_nv12.cols;  // 输入图像宽度。
-    const int src_rows = src_nv12.rows;  // 输入总行数（Y+UV）。
-    const int src_height = src_rows * 2 / 3;  // 输入图像高度。
-    if (src_height <= 1 || src_rows != src_height * 3 / 2 || src_width <= 1) {
-        return false;
+bool vp_yolo26_preprocess_node::preprocess_with_rga(const std::shared_ptr<vp_objects::vp_frame_meta>& meta,
+                                                    std::shared_ptr<vp_objects::vp_dma_image>& dst_rgb_dma,
+                                                    std::vector<uint8_t>& dst_rgb_data) {
+    const auto& src_dma = meta->dma_frame;  // DMA-buf 输入（可为空）。
+    const bool use_src_dma = src_dma != nullptr && src_dma->format == vp_objects::vp_dma_format::NV12;  // 是否按 fd 导入输入。
+    const cv::Mat& src_frame = meta->frame;  // CPU 输入（原生 NV12 或 BGR，不会被其他节点原地转换）。
+    const bool src_is_bgr = !use_src_dma && src_frame.type() == CV_8UC3;  // CPU 输入是否为 BGR。
+    const int src_format = src_is_bgr ? RK_FORMAT_BGR_888 : RK_FORMAT_YCbCr_420_SP;  // RGA 输入格式。
+    int src_width = 0;  // 输入图像宽度。
+    int src_height = 0;  // 输入图像高度。
+    if (use_src_dma) {
+        src_width = src_dma->width;
+        src_height = src_dma->height;
+    } else if (src_is_bgr) {
+        src_width = src_frame.cols;
+        src_height = src_frame.rows;
+    } else {
+        if (src_frame.empty() || src_frame.type() != CV_8UC1) {
+            return false;
+        }
+        src_width = src_frame.cols;
+        src_height = src_frame.rows * 2 / 3;
+        if (src_frame.rows != src_height * 3 / 2) {
+            return false;
+        }
     }
-    const size_t src_nv12_bytes =
-        static_cast<size_t>(src_width) * static_cast<size_t>(src_height) * 3U / 2U;  // NV12 输入总字节数。
-    if (!ensure_rga_cache(src_width, src_height)) {
+    if (src_height <= 1 || src_width <= 1 || input_width <= 1 || input_height <= 1) {
         return false;
     }
 
     std::vector<uint8_t> src_contiguous_data;  // 连续内存输入缓冲。
-    const uint8_t* src_ptr = src_nv12.data;  // 输入缓冲地址。
-    if (!src_nv12.isContinuous()) {
-        src_contiguous_data.resize(src_nv12_bytes);
-        for (int row = 0; row < src_rows; ++row) {
-            const uint8_t* src_row_ptr = src_nv12.ptr<uint8_t>(row);  // 输入当前行起始地址。
-            uint8_t* dst_row_ptr =
-                src_contiguous_data.data() + static_cast<size_t>(row) * static_cast<size_t>(src_width);  // 连续缓冲当前行起始地址。
-            std::memcpy(dst_row_ptr, src_row_ptr, static_cast<size_t>(src_width));
+    rga_buffer_handle_t src_handle = 0;  // 输入 DMA-buf 的 RGA 句柄（每帧导入，MPP 缓冲会轮转复用）。
+    rga_buffer_handle_t dst_handle = 0;  // 模型输入 DMA-buf 的 RGA 句柄。
+    rga_buffer_t src_img;  // RGA 输入图描述。
+    if (use_src_dma) {
+        src_handle = importbuffer_fd(src_dma->fd, static_cast<int>(src_dma->size));
+        if (src_handle == 0) {
+            return false;
         }
-        src_ptr = src_contiguous_data.data();
+        src_img = wrapbuffer_handle(src_handle,
+                                    src_width,
+                                    src_height,
+                                    RK_FORMAT_YCbCr_420_SP,
+                                    src_dma->hor_stride,
+                                    src_dma->ver_stride);
+    } else {
+        const size_t row_bytes = src_frame.cols * src_frame.elemSize();  // 每行有效字节数。
+        const uint8_t* src_ptr = src_frame.data;  // 输入缓冲地址。
+        if (!src_frame.isContinuous()) {
+            src_contiguous_data.resize(row_bytes * static_cast<size_t>(src_frame.rows));
+            for (int row = 0; row < src_frame.rows; ++row) {
+                const uint8_t* src_row_ptr = src_frame.ptr<uint8_t>(row);  // 输入当前行起始地址。
+                uint8_t* dst_row_ptr = src_contiguous_data.data() + static_cast<size_t>(row) * row_bytes;  // 连续缓冲当前行起始地址。
+                std::memcpy(dst_row_ptr, src_row_ptr, row_bytes);
+            }
+            src_ptr = src_contiguous_data.data();
+        }
+        src_img = wrapbuffer_virtualaddr(const_cast<uint8_t*>(src_ptr),
+                                         src_width,
+                                         src_height,
+                                         src_format);
     }
 
-    rga_buffer_t src_img = wrapbuffer_virtualaddr(const_cast<uint8_t*>(src_ptr),
-                                                  src_width,
-                                                  src_height,
-                                                  RK_FORMAT_YCbCr_420_SP);  // RGA 输入图描述。
-    rga_buffer_t bgr_img = wrapbuffer_virtualaddr(cache_bgr_full_data.data(),
-                                                  src_width,
-                                                  src_height,
-                                                  RK_FORMAT_BGR_888);  // RGA BGR 全尺寸图描述。
-    rga_buffer_t rgb_full_img = wrapbuffer_virtualaddr(cache_rgb_full_data.data(),
-                                                       src_width,
-                                                       src_height,
-                                                       RK_FORMAT_RGB_888);  // RGA RGB 全尺寸图描述。
-    rga_buffer_t rgb_resize_img = wrapbuffer_virtualaddr(cache_rgb_resize_data.data(),
-                                                         input_width,
-                                                         input_height,
-                                                         RK_FORMAT_RGB_888);  // RGA RGB 缩放图描述。
-
-    IM_STATUS bgr_status =
-        imcvtcolor(src_img, bgr_img, RK_FORMAT_YCbCr_420_SP, RK_FORMAT_BGR_888);  // NV12->BGR 状态。
-    bool success = (bgr_status == IM_STATUS_SUCCESS);
+    dst_rgb_dma = acquire_rgb_input();
+    if (dst_rgb_dma) {
+        dst_handle = importbuffer_fd(dst_rgb_dma->fd, static_cast<int>(dst_rgb_dma->size));
+        if (dst_handle == 0) {
+            dst_rgb_dma.reset();
+        }
+    }
+    rga_buffer_t rgb_resize_img;  // RGA RGB 缩放图描述。
+    if (dst_rgb_dma) {
+        rgb_resize_img = wrapbuffer_handle(dst_handle,
+                                           input_width,
+                                           input_height,
+                                           RK_FORMAT_RGB_888);
+    } else {
+        rgb_resize_img = wrapbuffer_virtualaddr(ensure_rgb_cache(cache_rgb_resize_data, input_width, input_height),
+                                                input_width,
+                                                input_height,
+                                                RK_FORMAT_RGB_888);
+    }
 
     // 融合路径：直接 NV12 -> RGB(目标尺寸)，把颜色转换与缩放合并为一步。
-    if (success) {
-        IM_STATUS fused_status = improcess(src_img, rgb_resize_img, {}, {}, {}, {}, IM_SYNC);  // 融合处理状态。
-        success = (fused_status == IM_STATUS_SUCCESS);
-    }
+    IM_STATUS fused_status = improcess(src_img, rgb_resize_img, {}, {}, {}, {}, IM_SYNC);  // 融合处理状态。
+    bool success = (fused_status == IM_STATUS_SUCCESS);
 
     // RGA 兼容性回退：若融合路径失败，则退回两步 RGA（NV12->RGB，再 RGB resize）。
-    if (success) {
-        // do nothing
-    } else {
+    if (!success) {
+        rga_buffer_t rgb_full_img = wrapbuffer_virtualaddr(ensure_rgb_cache(cache_rgb_full_data, src_width, src_height),
+                                                           src_width,
+                                                           src_height,
+                                                           RK_FORMAT_RGB_888);  // RGA RGB 全尺寸图描述。
         IM_STATUS rgb_status =
-            imcvtcolor(src_img, rgb_full_img, RK_FORMAT_YCbCr_420_SP, RK_FORMAT_RGB_888);  // NV12->RGB 状态。
+            imcvtcolor(src_img, rgb_full_img, src_format, RK_FORMAT_RGB_888);  // 输入->RGB 状态。
         success = (rgb_status == IM_STATUS_SUCCESS);
         if (success) {
             IM_STATUS resize_status = imresize(rgb_full_img, rgb_resize_img);  // RGB 缩放状态。
@@ -150,36 +180,45 @@ bool vp_yolo26_preprocess_node::preprocess_with_rga(const cv::Mat& src_nv12,
         }
     }
 
-    if (success) {
-        dst_bgr_frame = cv::Mat(src_height, src_width, CV_8UC3, cache_bgr_full_data.data()).clone();
-        success = !dst_bgr_frame.empty();
+    if (src_handle != 0) {
+        releasebuffer_handle(src_handle);
     }
+    if (dst_handle != 0) {
+        releasebuffer_handle(dst_handle);
+    }
+
     if (!success) {
+        dst_rgb_dma.reset();
         dst_rgb_data.clear();
-        dst_bgr_frame.release();
         return false;
     }
 
-    dst_rgb_data = cache_rgb_resize_data;
+    if (dst_rgb_dma) {
+        // RKNN 按 fd 导入时不经过 CPU，CPU 缓存同步留给真正读取 vir_addr 的回退路径（见 YOLO26::infer）。
+        dst_rgb_data.clear();
+    } else {
+        dst_rgb_data = cache_rgb_resize_data;
+    }
     return true;
 }
 
 std::shared_ptr<vp_objects::vp_meta> vp_yolo26_preprocess_node::handle_frame_meta(
     std::shared_ptr<vp_objects::vp_frame_meta> meta) {
-    if (meta == nullptr || meta->frame.empty()) {
+    if (meta == nullptr || (meta->frame.empty() && meta->dma_frame == nullptr)) {
         return meta;
     }
 
+    std::shared_ptr<vp_objects::vp_dma_image> preprocessed_rgb_dma;  // 预处理输出 DMA 缓冲。
     std::vector<uint8_t> preprocessed_rgb_data;  // 预处理输出字节缓冲。
-    cv::Mat bgr_frame;  // 供后续 OSD 的 BGR 图像。
-    const bool ok = preprocess_with_rga(meta->frame, preprocessed_rgb_data, bgr_frame);  // 预处理执行结果。
+    const bool ok = preprocess_with_rga(meta, preprocessed_rgb_dma, preprocessed_rgb_data);  // 预处理执行结果。
     meta->yolo26_input_ready = ok;
     if (ok) {
+        meta->yolo26_input_dma = std::move(preprocessed_rgb_dma);
         meta->yolo26_input_rgb_data = std::move(preprocessed_rgb_data);
         meta->yolo26_input_width = input_width;
         meta->yolo26_input_height = input_height;
-        meta->frame = bgr_frame;
     } else {
+        meta->yolo26_input_dma.reset();
         meta->yolo26_input_rgb_data.clear();
         meta->yolo26_input_width = 0;
         meta->yolo26_input_height = 0;
@@ -190,10 +229,11 @@ std::shared_ptr<vp_objects::vp_meta> vp_yolo26_preprocess_node::handle_frame_met
 
     ++frame_counter;
     if (frame_counter % static_cast<uint64_t>(preprocess_debug_log_interval) == 0) {
-        VP_INFO(vp_utils::string_format("[%s] backend=rga size=%dx%d frame=%llu",
+        VP_INFO(vp_utils::string_format("[%s] backend=rga size=%dx%d dma_out=%d frame=%llu",
                                         node_name.c_str(),
                                         input_width,
                                         input_height,
+                                        meta->yolo26_input_dma != nullptr ? 1 : 0,
                                         static_cast<unsigned long long>(frame_counter)));
     }
     return meta;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -8,7 +9,9 @@
 
 namespace vp_nodes {
 /**
- * @brief YOLO26 预处理节点，直接处理 NV12 帧并输出 BGR/模型输入。
+ * @brief YOLO26 预处理节点，直接处理 NV12 帧并输出模型输入。
+ *
+ * 不生成全尺寸 BGR，frame 保持原生 NV12，需要 BGR 的下游节点通过 vp_frame_meta::ensure_bgr() 按需转换。
  */
 class vp_yolo26_preprocess_node : public vp_node {
 private:
@@ -20,19 +23,9 @@ private:
     int preprocess_debug_log_interval = 300;
     // 帧计数器。
     uint64_t frame_counter = 0;
-    // 当前缓存对应的源宽度。
-    int cache_src_width = 0;
-    // 当前缓存对应的源高度。
-    int cache_src_height = 0;
-    // 当前缓存对应的目标宽度。
-    int cache_dst_width = 0;
-    // 当前缓存对应的目标高度。
-    int cache_dst_height = 0;
-    // NV12->BGR 全尺寸缓存。
-    std::vector<uint8_t> cache_bgr_full_data;
-    // NV12->RGB 全尺寸缓存（融合失败时回退到两步 RGA 路径使用）。
+    // NV12->RGB 全尺寸缓存，仅在融合失败回退到两步 RGA 路径时按需分配。
     std::vector<uint8_t> cache_rgb_full_data;
-    // 模型输入 RGB 缩放缓存。
+    // 模型输入 RGB 缩放缓存，仅在 DMA 缓冲不可用时按需分配。
     std::vector<uint8_t> cache_rgb_resize_data;
 
 private:
@@ -44,25 +37,37 @@ private:
     void load_preprocess_config(const std::string& json_path);
 
     /**
-     * @brief 根据输入/输出尺寸确保 RGA 缓存可用。
+     * @brief 确保 RGB 缓存能容纳指定尺寸，已足够时不重新分配。
      *
-     * @param src_width 输入宽度。
-     * @param src_height 输入高度。
-     * @return true 缓存可用。
-     * @return false 缓存分配失败。
+     * @param cache RGB 缓存。
+     * @param width 图像宽度。
+     * @param height 图像高度。
+     * @return uint8_t* 缓存起始地址。
      */
-    bool ensure_rga_cache(int src_width, int src_height);
+    static uint8_t* ensure_rgb_cache(std::vector<uint8_t>& cache, int width, int height);
+
+    /**
+     * @brief 从 DMA 帧缓冲池取出一块模型输入缓冲。
+     *
+     * @return std::shared_ptr<vp_objects::vp_dma_image> RGB 图像，池耗尽或 DMA 不可用时返回空。
+     */
+    std::shared_ptr<vp_objects::vp_dma_image> acquire_rgb_input();
 
     /**
      * @brief 使用 librga 执行 NV12 预处理。
      *
-     * @param src_nv12 输入 NV12 图像（CV_8UC1，高度为 3/2H）。
-     * @param dst_rgb_data 输出 RGB 字节缓冲。
-     * @param dst_bgr_frame 输出 BGR 图像（供 OSD 节点使用）。
+     * 输入优先使用 meta 上的 DMA-buf（按 fd 导入，不经 CPU），否则使用 frame 的虚拟地址（NV12 或 BGR）；
+     * 模型输入优先写入 DMA 缓冲供 RKNN 直接导入，否则写入 dst_rgb_data。
+     *
+     * @param meta 输入帧元数据。
+     * @param dst_rgb_dma 输出 RGB DMA 图像（可为空）。
+     * @param dst_rgb_data 输出 RGB 字节缓冲（dst_rgb_dma 为空时有效）。
      * @return true 成功。
      * @return false 失败。
      */
-    bool preprocess_with_rga(const cv::Mat& src_nv12, std::vector<uint8_t>& dst_rgb_data, cv::Mat& dst_bgr_frame);
+    bool preprocess_with_rga(const std::shared_ptr<vp_objects::vp_frame_meta>& meta,
+                             std::shared_ptr<vp_objects::vp_dma_image>& dst_rgb_dma,
+                             std::vector<uint8_t>& dst_rgb_data);
 
 protected:
     /**
@@ -1,32 +1,181 @@
 
-
+#include <algorithm>
+#include <cstring>
 #include <opencv2/imgproc.hpp>
 #include "vp_osd_node.h"
+#include "vp_utils/vp_frame_buffer_pool.h"
 
 namespace vp_nodes {
-        
-    vp_osd_node::vp_osd_node(std::string node_name, std::string font):
-                            vp_node(node_name) {
+
+    namespace {
+        // Y plane and half resolution interleaved UV plane (CV_8UC2) of a compact NV12 image, both are views.
+        struct nv12_planes {
+            cv::Mat y;
+            cv::Mat uv;
+        };
+
+        nv12_planes split_nv12(cv::Mat& nv12) {
+            auto height = nv12.rows * 2 / 3;
+            nv12_planes planes;
+            planes.y = nv12.rowRange(0, height);
+            planes.uv = cv::Mat(height / 2, nv12.cols / 2, CV_8UC2, nv12.ptr<uchar>(height), nv12.step[0]);
+            return planes;
+        }
+
+        // BGR colour to (Y, U, V), BT.601 limited range as the decoder output.
+        cv::Scalar bgr_to_yuv(const cv::Scalar& bgr) {
+            auto b = bgr[0], g = bgr[1], r = bgr[2];
+            return cv::Scalar(16 + 0.257 * r + 0.504 * g + 0.098 * b,
+                              128 - 0.148 * r - 0.291 * g + 0.439 * b,
+                              128 + 0.439 * r - 0.368 * g - 0.071 * b);
+        }
+
+        cv::Rect half(const cv::Rect& rect) {
+            return cv::Rect(rect.x / 2, rect.y / 2, rect.width / 2, rect.height / 2);
+        }
+
+        // thickness < 0 means filled, as cv::rectangle.
+        void nv12_rectangle(nv12_planes& planes, const cv::Rect& rect, const cv::Scalar& bgr, int thickness) {
+            auto yuv = bgr_to_yuv(bgr);
+            cv::rectangle(planes.y, rect, cv::Scalar(yuv[0]), thickness);
+            cv::rectangle(planes.uv, half(rect), cv::Scalar(yuv[1], yuv[2]), thickness < 0 ? thickness : std::max(1, thickness / 2));
+        }
+
+        void nv12_line(nv12_planes& planes, cv::Point p1, cv::Point p2, const cv::Scalar& bgr, int thickness) {
+            auto yuv = bgr_to_yuv(bgr);
+            cv::line(planes.y, p1, p2, cv::Scalar(yuv[0]), thickness, cv::LINE_AA);
+            cv::line(planes.uv, cv::Point(p1.x / 2, p1.y / 2), cv::Point(p2.x / 2, p2.y / 2), cv::Scalar(yuv[1], yuv[2]), std::max(1, thickness / 2));
+        }
+
+        // compact NV12 copy of the frame (pooled), empty if frame is not NV12 or not CPU accessible.
+        cv::Mat nv12_canvas_of(const vp_objects::vp_frame_meta& meta) {
+            if (!meta.frame.empty()) {
+                return meta.frame.type() == CV_8UC1 ? vp_utils::vp_frame_buffer_pool::host().clone(meta.frame) : cv::Mat();
+            }
+            auto& dma = meta.dma_frame;
+            if (dma == nullptr || dma->format != vp_objects::vp_dma_format::NV12 || dma->vir_addr == nullptr) {
+                return cv::Mat();
+            }
+            // padded strides, copy visible rows of both planes
+            auto canvas = vp_utils::vp_frame_buffer_pool::host().alloc(dma->height * 3 / 2, dma->width, CV_8UC1);
+            auto base = static_cast<const uchar*>(dma->vir_addr);
+            auto step = static_cast<size_t>(dma->hor_stride);
+            auto uv_plane = base + step * static_cast<size_t>(dma->ver_stride);
+            for (int row = 0; row < dma->height; ++row) {
+                std::memcpy(canvas.ptr<uchar>(row), base + step * row, dma->width);
+            }
+            for (int row = 0; row < dma->height / 2; ++row) {
+                std::memcpy(canvas.ptr<uchar>(dma->height + row), uv_plane + step * row, dma->width);
+            }
+            return canvas;
+        }
+    }
+
+    vp_osd_node::vp_osd_node(std::string node_name, std::string font, bool draw_on_nv12):
+                            vp_node(node_name), draw_on_nv12(draw_on_nv12) {
         if (!font.empty()) {
             ft2 = cv::freetype::createFreeType2();
-            ft2->loadFontData(font, 0);   
-        }       
+            ft2->loadFontData(font, 0);
+        }
+        // NV12 frames are drawn as they are, BGR is produced only as fallback (see handle_frame_meta)
+        if (draw_on_nv12) {
+            this->frame_needs_bgr = false;
+        }
         this->initialized();
     }
-    
+
     vp_osd_node::~vp_osd_node() {
         deinitialized();
     }
-    
+
     std::shared_ptr<vp_objects::vp_meta> vp_osd_node::handle_control_meta(std::shared_ptr<vp_objects::vp_control_meta> meta) {
         return meta;
     }
 
     // display logic
     std::shared_ptr<vp_objects::vp_meta> vp_osd_node::handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
+        if (draw_on_nv12) {
+            // keep drawing on the same kind of canvas if previous osd node has created one
+            auto nv12 = meta->osd_frame.empty() ? meta->frame_is_nv12() : meta->osd_frame.type() == CV_8UC1;
+            if (nv12 && draw_nv12(meta)) {
+                return meta;
+            }
+            // not NV12 or not CPU accessible, fall back to BGR which the base class skipped for us
+            if (!meta->ensure_bgr()) {
+                VP_WARN(vp_utils::string_format("[%s] convert frame to BGR failed, frame_index=%d", node_name.c_str(), meta->frame_index));
+                return meta;
+            }
+        }
+        draw_bgr(meta);
+        return meta;
+    }
+
+    bool vp_osd_node::draw_nv12(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
         // operations on osd_frame
         if (meta->osd_frame.empty()) {
-            meta->osd_frame = meta->frame.clone();
+            meta->osd_frame = nv12_canvas_of(*meta);
+            if (meta->osd_frame.empty()) {
+                return false;
+            }
+        }
+
+        auto planes = split_nv12(meta->osd_frame);
+        // label text is drawn on Y only, so it takes the chroma of its background
+        auto text_luma = cv::Scalar(bgr_to_yuv(cv::Scalar())[0]);
+        // scan targets
+        for (auto& i : meta->targets) {
+            // track_id
+            auto id = std::to_string(i->track_id);
+            auto labels_to_display = i->primary_label;
+
+            // tracked
+            if (i->track_id != -1) {
+                labels_to_display = "#" + id + " " + labels_to_display;
+            }
+
+            for (auto& label : i->secondary_labels) {
+                labels_to_display += "|" + label;
+            }
+
+            // draw tracks if size>=2
+            if (i->tracks.size() >= 2) {
+                for (size_t n = 0; n + 1 < i->tracks.size(); n++) {
+                    auto p1 = i->tracks[n].track_point();
+                    auto p2 = i->tracks[n + 1].track_point();
+                    nv12_line(planes, cv::Point(p1.x, p1.y), cv::Point(p2.x, p2.y), cv::Scalar(0, 255, 255), 1);
+                }
+            }
+
+            nv12_rectangle(planes, cv::Rect(i->x, i->y, i->width, i->height), cv::Scalar(255, 255, 0), 2);
+            if (ft2 != nullptr) {
+                ft2->putText(planes.y, labels_to_display, cv::Point(i->x, i->y), 20, cv::Scalar(bgr_to_yuv(cv::Scalar(255, 0, 255))[0]), cv::FILLED, cv::LINE_AA, true);
+            }
+            else {
+                int baseline = 0;
+                auto size = cv::getTextSize(labels_to_display, 1, 1.5, 1, &baseline);
+                auto rect = cv::Rect(i->x, i->y - size.height, size.width, size.height);
+                nv12_rectangle(planes, rect, cv::Scalar(179, 52, 255), -1);
+                vp_utils::put_text_at_center_of_rect(planes.y, labels_to_display, rect, false, 1, 1, text_luma);
+            }
+
+            // scan sub targets
+            for (auto& sub_target: i->sub_targets) {
+                nv12_rectangle(planes, cv::Rect(sub_target->x, sub_target->y, sub_target->width, sub_target->height), cv::Scalar(255), 1);
+                if (ft2 != nullptr) {
+                    ft2->putText(planes.y, sub_target->label, cv::Point(sub_target->x, sub_target->y), 20, cv::Scalar(bgr_to_yuv(cv::Scalar(0, 0, 255))[0]), cv::FILLED, cv::LINE_AA, true);
+                }
+                else {
+                    cv::putText(planes.y, sub_target->label, cv::Point(sub_target->x, sub_target->y), 1, 1, cv::Scalar(bgr_to_yuv(cv::Scalar(0, 0, 255))[0]));
+                }
+            }
+        }
+        return true;
+    }
+
+    void vp_osd_node::draw_bgr(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
+        // operations on osd_frame
+        if (meta->osd_frame.empty()) {
+            meta->osd_frame = vp_utils::vp_frame_buffer_pool::host().clone(meta->bgr_frame());
         }
 
         auto& canvas = meta->osd_frame;
@@ -40,14 +189,14 @@ namespace vp_nodes {
             if (i->track_id != -1) {
                 labels_to_display = "#" + id + " " + labels_to_display;
             }
-            
+
             for (auto& label : i->secondary_labels) {
                 labels_to_display += "|" + label;
             }
-            
+
             // draw tracks if size>=2
             if (i->tracks.size() >= 2) {
-                for (int n = 0; n < (i->tracks.size() - 1); n++) {
+                for (size_t n = 0; n + 1 < i->tracks.size(); n++) {
                     auto p1 = i->tracks[n].track_point();
                     auto p2 = i->tracks[n + 1].track_point();
                     cv::line(canvas, cv::Point(p1.x, p1.y), cv::Point(p2.x, p2.y), cv::Scalar(0, 255, 255), 1, cv::LINE_AA);
@@ -58,7 +207,7 @@ namespace vp_nodes {
             if (ft2 != nullptr) {
                 ft2->putText(canvas, labels_to_display, cv::Point(i->x, i->y), 20, cv::Scalar(255, 0, 255), cv::FILLED, cv::LINE_AA, true);
             }
-            else {               
+            else {
                 //cv::putText(canvas, labels_to_display, cv::Point(i->x, i->y), 1, 1, cv::Scalar(255, 0, 255));
                 int baseline = 0;
                 auto size = cv::getTextSize(labels_to_display, 1, 1.5, 1, &baseline);
@@ -75,8 +224,7 @@ namespace vp_nodes {
                     cv::putText(canvas, sub_target->label, cv::Point(sub_target->x, sub_target->y), 1, 1, cv::Scalar(0, 0, 255));
                 }
             }
-            
+
         }
-        return meta;
     }
-}
\ No newline at end of file
+}
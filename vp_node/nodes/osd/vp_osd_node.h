@@ -23,15 +23,27 @@ namespace vp_nodes {
 
     // on screen display(short as osd) node.
     // mainly used to display vp_frame_target on frame.
+    //
+    // with draw_on_nv12 set, frames still carrying native NV12 (hardware decoded) are drawn in place on a NV12 copy:
+    // boxes and lines go to both Y and UV planes, labels are drawn on Y over a filled background, so osd_frame is NV12
+    // and no BGR image is produced for display pipelines (see vp_bgr_to_nv12_node, which then passes it through).
+    // BGR frames are drawn as usual in either mode.
     class vp_osd_node: public vp_node {
     private:
         // support chinese font
         cv::Ptr<cv::freetype::FreeType2> ft2;
+        // draw on NV12 planes directly if frame is NV12
+        bool draw_on_nv12 = false;
+
+        // draw targets on osd_frame (BGR)
+        void draw_bgr(std::shared_ptr<vp_objects::vp_frame_meta> meta);
+        // draw targets on osd_frame (NV12), return false if no CPU accessible NV12 image available
+        bool draw_nv12(std::shared_ptr<vp_objects::vp_frame_meta> meta);
     protected:
         virtual std::shared_ptr<vp_objects::vp_meta> handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) override;
         virtual std::shared_ptr<vp_objects::vp_meta> handle_control_meta(std::shared_ptr<vp_objects::vp_control_meta> meta) override;
     public:
-        vp_osd_node(std::string node_name, std::string font = "");
+        vp_osd_node(std::string node_name, std::string font = "", bool draw_on_nv12 = false);
         ~vp_osd_node();
     };
 
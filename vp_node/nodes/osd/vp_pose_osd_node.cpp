@@ -1,5 +1,6 @@
 
 #include "vp_pose_osd_node.h"
+#include "vp_utils/vp_frame_buffer_pool.h"
 
 namespace vp_nodes {
     
@@ -15,7 +16,7 @@ namespace vp_nodes {
     std::shared_ptr<vp_objects::vp_meta> vp_pose_osd_node::handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
         // operations on osd_frame
         if (meta->osd_frame.empty()) {
-            meta->osd_frame = meta->frame.clone();
+            meta->osd_frame = vp_utils::vp_frame_buffer_pool::host().clone(meta->bgr_frame());
         }
 
         // scan pose targets
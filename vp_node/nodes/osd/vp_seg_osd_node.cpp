@@ -37,20 +37,21 @@ namespace vp_nodes {
     }
 
     std::shared_ptr<vp_objects::vp_meta> vp_seg_osd_node::handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
+        auto frame = meta->bgr_frame();
         // operations on osd_frame
         if (meta->osd_frame.empty()) {
             // add a gap at the left of osd frame
-            meta->osd_frame = cv::Mat(meta->frame.rows, meta->frame.cols + gap, meta->frame.type(), cv::Scalar(255, 255, 255));
+            meta->osd_frame = cv::Mat(frame.rows, frame.cols + gap, frame.type(), cv::Scalar(255, 255, 255));
             
             // initialize by copying frame to osd frame
-            auto roi = meta->osd_frame(cv::Rect(gap, 0, meta->frame.cols, meta->frame.rows));
-            meta->frame.copyTo(roi);
+            auto roi = meta->osd_frame(cv::Rect(gap, 0, frame.cols, frame.rows));
+            frame.copyTo(roi);
         }
         
         // left for display color/class pairs
         auto canvas_left = meta->osd_frame(cv::Rect(0, 0, gap, meta->osd_frame.rows));
         // right for display result
-        auto canvas_right = meta->osd_frame(cv::Rect(gap, 0, meta->frame.cols, meta->osd_frame.rows)); 
+        auto canvas_right = meta->osd_frame(cv::Rect(gap, 0, frame.cols, meta->osd_frame.rows)); 
 
         if (!meta->mask.empty()) {
             cv::Mat segm;
@@ -14,14 +14,15 @@ namespace vp_nodes {
     }
 
     std::shared_ptr<vp_objects::vp_meta> vp_text_osd_node::handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
+        auto frame = meta->bgr_frame();
         // operations on osd_frame
         if (meta->osd_frame.empty()) {
             // double times higher than frame 
-            meta->osd_frame = cv::Mat(meta->frame.rows * 2, meta->frame.cols, meta->frame.type());
+            meta->osd_frame = cv::Mat(frame.rows * 2, frame.cols, frame.type());
         }
 
-        auto canvas1 = meta->frame.clone();
-        auto canvas2 = cv::Mat(meta->frame.rows, meta->frame.cols, meta->frame.type(), cv::Scalar(255, 255, 255));
+        auto canvas1 = frame.clone();
+        auto canvas2 = cv::Mat(frame.rows, frame.cols, frame.type(), cv::Scalar(255, 255, 255));
 
         for (int i = 0; i < meta->text_targets.size(); i++) {
             auto& text = meta->text_targets[i];
@@ -42,8 +43,8 @@ namespace vp_nodes {
         }
 
         // copy back to osd frame
-        auto roi1 = meta->osd_frame(cv::Rect(0, 0, meta->frame.cols, meta->frame.rows));
-        auto roi2 = meta->osd_frame(cv::Rect(0, meta->frame.rows, meta->frame.cols, meta->frame.rows));
+        auto roi1 = meta->osd_frame(cv::Rect(0, 0, frame.cols, frame.rows));
+        auto roi2 = meta->osd_frame(cv::Rect(0, frame.rows, frame.cols, frame.rows));
 
         canvas1.copyTo(roi1);
         canvas2.copyTo(roi2);
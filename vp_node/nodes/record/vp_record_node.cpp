@@ -29,47 +29,93 @@ namespace vp_nodes {
     }
 
     std::shared_ptr<vp_objects::vp_meta> vp_record_node::handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
-        // cache fps for current channel
-        if (all_fps.count(meta->channel_index) == 0) {
-            all_fps[meta->channel_index] = meta->fps;
-        }
-        auto& fps = all_fps[meta->channel_index];
-
-        // first time for current channel
-        if (all_pre_records.count(meta->channel_index) == 0) {
-            all_pre_records[meta->channel_index] = std::deque<std::shared_ptr<vp_objects::vp_frame_meta>>();
-        }
-        auto& pre_records = all_pre_records[meta->channel_index];
-        
-        // update pre_records for current channel
-        pre_records.push_back(meta);
-        auto frames_need_pre_record = fps * pre_record_video_duration;
-        // keep max frames
-        if (pre_records.size() > frames_need_pre_record) {
-            pre_records.pop_front();
-        }
-        
         // first time for current channel
         if (all_record_tasks.count(meta->channel_index) == 0) {
             all_record_tasks[meta->channel_index] = std::list<std::shared_ptr<vp_nodes::vp_record_task>>();
         }
         auto& record_tasks = all_record_tasks[meta->channel_index];
+        auto& pending_video_records = all_pending_video_records[meta->channel_index];
 
-        // then append data to all tasks of current channel
+        // remove tasks which are complete already
+        auto video_recording = !pending_video_records.empty();
         for (auto i = record_tasks.begin(); i != record_tasks.end();) {
             if ((*i)->status == vp_nodes::vp_record_task_status::COMPLETE) {
-                i = record_tasks.erase(i); // remove task which is complete already
+                i = record_tasks.erase(i);
             }
             else {
-                (*i)->append_async(meta);  // no block here
+                video_recording = video_recording || std::dynamic_pointer_cast<vp_video_record_task>(*i) != nullptr;
                 i++;
             }
-        }    
-        
+        }
+
+        // encode once for pre-record ring and all video tasks of current channel.
+        // without pre-record the encoder only runs while recording, see auto_new_record_task for the key frame it asks.
+        av_packet packet;
+        if (pre_record_video_duration > 0 || video_recording) {
+            auto& encoder = all_encoders[meta->channel_index];
+            if (encoder == nullptr) {
+                encoder = std::make_shared<vp_utils::vp_mpp_frame_encoder>(false, bitrate, false, node_name);
+            }
+            packet = encoder->encode(meta, osd);
+            if (encoder->failed() && !pending_video_records.empty()) {
+                VP_ERROR(vp_utils::string_format("[%s] [record] no encoder for channel %d, %d video record tasks dropped", node_name.c_str(), meta->channel_index, static_cast<int>(pending_video_records.size())));
+                pending_video_records.clear();
+            }
+        }
+        // encoder is ready now, start video tasks requested before.
+        // before the ring takes the packet, since new tasks copy the ring and get the packet again in the loop below.
+        if (packet != nullptr) {
+            while (!pending_video_records.empty()) {
+                auto control_meta = pending_video_records.front();
+                pending_video_records.pop_front();
+                auto_new_record_task(control_meta);
+            }
+        }
+        if (packet != nullptr && pre_record_video_duration > 0) {
+            update_pre_records(meta->channel_index, packet);
+        }
+
+        // then append data to all tasks of current channel
+        for (auto& task: record_tasks) {
+            auto video_record_task = std::dynamic_pointer_cast<vp_video_record_task>(task);
+            if (video_record_task != nullptr) {
+                // packets are shared with pre-record ring and other tasks, tasks never modify them
+                if (packet != nullptr) {
+                    video_record_task->append_packet_async(packet);  // no block here
+                }
+            }
+            else {
+                task->append_async(meta);  // no block here
+            }
+        }
+
         // done 
         return meta;
     }
 
+    void vp_record_node::update_pre_records(int channel_index, av_packet packet) {
+        auto& pre_records = all_pre_records[channel_index];
+        // ring must start with a key frame
+        if (pre_records.empty() && !(packet->flags & AV_PKT_FLAG_KEY)) {
+            return;
+        }
+        pre_records.push_back(packet);
+
+        // keep at least fps * pre_record_video_duration packets, drop the oldest GOP only if the rest is still enough.
+        // so the ring is at most one GOP longer than needed and always remuxable from its head.
+        auto frames_need_pre_record = static_cast<size_t>(all_encoders[channel_index]->fps() * pre_record_video_duration);
+        while (pre_records.size() > frames_need_pre_record) {
+            size_t next_key = 1;
+            while (next_key < pre_records.size() && !(pre_records[next_key]->flags & AV_PKT_FLAG_KEY)) {
+                next_key++;
+            }
+            if (next_key == pre_records.size() || pre_records.size() - next_key < frames_need_pre_record) {
+                break;
+            }
+            pre_records.erase(pre_records.begin(), pre_records.begin() + next_key);
+        }
+    }
+
     std::shared_ptr<vp_objects::vp_meta> vp_record_node::handle_control_meta(std::shared_ptr<vp_objects::vp_control_meta> meta) {
         
         if (meta->control_type == vp_objects::vp_control_type::IMAGE_RECORD ||
@@ -88,8 +134,6 @@ namespace vp_nodes {
 
     void vp_record_node::auto_new_record_task(std::shared_ptr<vp_objects::vp_control_meta>& meta) {
         auto& record_tasks = all_record_tasks[meta->channel_index];
-        auto& pre_records = all_pre_records[meta->channel_index];
-        auto& fps = all_fps[meta->channel_index];
 
         // image record
         if (meta->control_type == vp_objects::vp_control_type::IMAGE_RECORD) {
@@ -121,7 +165,23 @@ namespace vp_nodes {
             
             // create video record task
             auto file_name_without_ext = video_record_control_meta->video_file_name_without_ext;
-            auto _osd = video_record_control_meta->osd;
+            auto& encoder = all_encoders[meta->channel_index];
+            if (encoder == nullptr || !encoder->ready()) {
+                // size/fps/stream header are known after the first encoded frame, create the task then
+                all_pending_video_records[meta->channel_index].push_back(meta);
+                if (encoder != nullptr) {
+                    encoder->request_key_frame();
+                }
+                return;
+            }
+            auto& pre_records = all_pre_records[meta->channel_index];
+            if (pre_records.empty()) {
+                // no pre-record, do not wait for the next GOP to start
+                encoder->request_key_frame();
+            }
+            if (video_record_control_meta->osd != osd) {
+                VP_WARN(vp_utils::string_format("[%s] [record] osd of video is decided by node (osd=%d), requested osd=%d ignored", node_name.c_str(), osd, video_record_control_meta->osd));
+            }
             auto _record_video_duration = video_record_control_meta->record_video_duration;
             if (_record_video_duration == 0) {
                 // use default value
@@ -133,9 +193,9 @@ namespace vp_nodes {
                                                                                     file_name_without_ext, 
                                                                                     video_save_dir, 
                                                                                     auto_sub_dir, 
-                                                                                    _osd, 
-                                                                                    resolution_w_h, 
-                                                                                    bitrate, fps, pre_record_video_duration, _record_video_duration, node_name);
+                                                                                    osd, 
+                                                                                    encoder->codec_id(), encoder->width(), encoder->height(), encoder->header(),
+                                                                                    encoder->fps(), pre_record_video_duration, _record_video_duration, node_name);
             video_record_task->set_task_complete_hooker([this](int channel_index, vp_record_info record_info) {
                 // just notify hooker which has attached on the node
                 if (this->video_record_complete_hooker) {                
@@ -11,11 +11,16 @@
 #include "vp_image_record_task.h"
 #include "vp_video_record_task.h"
 #include "vp_record_status_hookable.h"
+#include "vp_utils/vp_mpp_frame_encoder.h"
 
 namespace vp_nodes {
     // video/image recording node, save it to local disk.
     // it is a middle node but works asynchronously, so recording would not block the pipeline.
     // note record node could work on multi channels at the same time.
+    //
+    // video is encoded once per channel by MPP (H.264), the pre-record ring holds encoded packets starting from a key frame
+    // and video tasks just remux the ring plus following packets into mp4, no re-encoding and no raw frames kept alive.
+    // so for video, osd is decided by the node (not by vp_video_record_control_meta) and resolution_w_h is ignored.
     class vp_record_node: public vp_node, public vp_record_status_hookable
     {
     private:
@@ -30,27 +35,31 @@ namespace vp_nodes {
         int record_video_duration;
         // auto create sub directory by date and channel or not, such as `./video_save_dir/2022-10-8/1/**.mp4`
         bool auto_sub_dir;
-        // width and height
+        // width and height (image only, video keeps the size of source)
         vp_objects::vp_size resolution_w_h = {};
         // bitrate for video record
         int bitrate = 1024;
         // record osd frame or not
         bool osd = false;
 
-        // fps for current video
-        // int fps = 0;
-        std::map<int, int> all_fps;
+        // encoder for each channel, created on demand and shared by pre-record ring and video tasks
+        std::map<int, std::shared_ptr<vp_utils::vp_mpp_frame_encoder>> all_encoders;
         
         /* record task list */
         // std::list<std::shared_ptr<vp_nodes::vp_record_task>> record_tasks;
         std::map<int, std::list<std::shared_ptr<vp_nodes::vp_record_task>>> all_record_tasks;
 
         /* pre-record for video */
-        // std::deque<std::shared_ptr<vp_objects::vp_frame_meta>> pre_records;
-        std::map<int, std::deque<std::shared_ptr<vp_objects::vp_frame_meta>>> all_pre_records;
+        // encoded packets, the first one is always a key frame
+        std::map<int, std::deque<av_packet>> all_pre_records;
+
+        // video record requests waiting for the encoder of channel (no frame encoded yet)
+        std::map<int, std::list<std::shared_ptr<vp_objects::vp_control_meta>>> all_pending_video_records;
 
         // new record task
         void auto_new_record_task(std::shared_ptr<vp_objects::vp_control_meta>& meta);
+        // push packet to pre-record ring and drop the oldest GOPs which are not needed
+        void update_pre_records(int channel_index, av_packet packet);
 
     protected:
         // re-implementation
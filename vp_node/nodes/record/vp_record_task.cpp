@@ -90,12 +90,12 @@ namespace vp_nodes {
     void vp_record_task::preprocess(std::shared_ptr<vp_objects::vp_frame_meta>& frame_to_record, cv::Mat& data) {
         cv::Mat resize_frame;
         if (this->resolution_w_h.width != 0 && this->resolution_w_h.height != 0) {                 
-            cv::resize((osd && !frame_to_record->osd_frame.empty()) ? frame_to_record->osd_frame : frame_to_record->frame, 
+            cv::resize((osd && !frame_to_record->osd_frame.empty()) ? frame_to_record->osd_frame : frame_to_record->bgr_frame(), 
                         resize_frame, 
                         cv::Size(resolution_w_h.width, resolution_w_h.height));
         }
         else {
-            resize_frame = (osd && !frame_to_record->osd_frame.empty()) ? frame_to_record->osd_frame : frame_to_record->frame;
+            resize_frame = (osd && !frame_to_record->osd_frame.empty()) ? frame_to_record->osd_frame : frame_to_record->bgr_frame();
         }
 
         resize_frame.copyTo(data);
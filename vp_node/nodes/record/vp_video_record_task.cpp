@@ -3,28 +3,34 @@
 
 namespace vp_nodes {
     vp_video_record_task::vp_video_record_task(int channel_index, 
-                                                std::deque<std::shared_ptr<vp_objects::vp_frame_meta>> pre_record_frames, 
+                                                std::deque<av_packet> pre_record_packets, 
                                                 std::string file_name_without_ext,
                                                 std::string save_dir,
                                                 bool auto_sub_dir,
                                                 bool osd,
-                                                vp_objects::vp_size resolution_w_h,
-                                                int bitrate,
+                                                AVCodecID codec_id,
+                                                int width,
+                                                int height,
+                                                std::vector<uint8_t> stream_header,
                                                 int fps,
                                                 int pre_record_video_duration,
                                                 int record_video_duration,
                                                 std::string host_node_name,
                                                 bool auto_start):
-                                                vp_record_task(channel_index, file_name_without_ext, save_dir, auto_sub_dir, resolution_w_h, osd, host_node_name),
-                                                bitrate(bitrate),
+                                                vp_record_task(channel_index, file_name_without_ext, save_dir, auto_sub_dir, {}, osd, host_node_name),
+                                                codec_id(codec_id),
+                                                width(width),
+                                                height(height),
+                                                stream_header(stream_header),
                                                 fps(fps),
                                                 pre_record_video_duration(pre_record_video_duration),
                                                 record_video_duration(record_video_duration) {
-        assert(bitrate > 0);
+        assert(fps > 0);
+        // the whole pre-record ring (may be up to one GOP longer than pre_record_video_duration) plus record duration
+        frames_need_record = static_cast<int>(pre_record_packets.size()) + record_video_duration * fps;
         // transfer to inner cache
-        for (auto i: pre_record_frames) {
-            frames_to_record.push_back(i);
-            cache_semaphore.signal();
+        for (auto& i: pre_record_packets) {
+            append_packet_async(i);
         }
 
         // start automatically when initializing
@@ -35,44 +41,73 @@ namespace vp_nodes {
 
     vp_video_record_task::~vp_video_record_task() {
         stop_task();
+        if (muxer != nullptr) {
+            muxer->close();
+        }
+    }
+
+    void vp_video_record_task::append_packet_async(av_packet packet) {
+        // can append data only if NOSTART or STARTED
+        if (status == vp_record_task_status::COMPLETE) {
+            return;
+        }
+
+        // just push data into queue, it is a producer
+        {
+            std::lock_guard<std::mutex> guard(packets_lock);
+            packets_to_record.push_back(packet);
+        }
+        cache_semaphore.signal();
     }
 
     void vp_video_record_task::record_task_run() {
         /* Below Code Run In A Separate Thread! */
         // get valid path
         auto full_record_path = get_full_record_path();
-        // format string used by gstreamer
-        auto gst = vp_utils::string_format(gst_template, bitrate, full_record_path.c_str());
-        
-        // get total frames to record
-        frames_need_record = (pre_record_video_duration + record_video_duration) * fps;
         frames_already_record = 0;
         // video duration at least 1 second
         assert(frames_need_record > fps * 1);
+        // pts of the first packet written, file starts from 0
+        int64_t first_pts = AV_NOPTS_VALUE;
 
         // pop data from cache and write into file
         while (status == vp_record_task_status::STARTED) {
             // it is a consumer
             cache_semaphore.wait();
 
-            auto frame_to_record = frames_to_record.front();
-            if (frame_to_record == nullptr) {
-                // dead flag
-                continue;
+            av_packet packet;
+            {
+                std::lock_guard<std::mutex> guard(packets_lock);
+                if (packets_to_record.empty()) {
+                    // dead flag
+                    continue;
+                }
+                packet = packets_to_record.front();
+                packets_to_record.pop_front();
             }
-            
-            cv::Mat frame_data;
-            // preprocess, vp_frame_meta -> cv::Mat
-            preprocess(frame_to_record, frame_data);
-            frames_to_record.pop_front();
 
-            // we open video writer in while loop, since we need width and height of frame when open a VideoWriter.
-            if (!video_writer.isOpened()) {
-                assert(video_writer.open(gst, cv::CAP_GSTREAMER, 0, fps, {frame_data.cols, frame_data.rows}));
+            // we open muxer at the first key frame, mp4 must start with it.
+            if (muxer == nullptr) {
+                if (!(packet->flags & AV_PKT_FLAG_KEY)) {
+                    continue;
+                }
+                muxer = FFmpeg::Enmuxer::createShared(codec_id, width, height, fps, stream_header, full_record_path);
+                if (!muxer->open()) {
+                    VP_ERROR(vp_utils::string_format("[%s] [record] open muxer failed for `%s`", host_node_name.c_str(), full_record_path.c_str()));
+                    muxer = nullptr;
+                    status = vp_record_task_status::COMPLETE;
+                    break;
+                }
+                first_pts = packet->pts;
             }
 
-            // write cv::Mat to file
-            video_writer.write(frame_data);
+            // muxer rescales timestamps and takes the payload, write a new reference instead of the shared packet
+            auto to_write = alloc_av_packet_with(packet.get());
+            to_write->pts -= first_pts;
+            to_write->dts = to_write->pts;
+            if (!muxer->write_packet(to_write)) {
+                VP_WARN(vp_utils::string_format("[%s] [record] write packet failed for `%s`", host_node_name.c_str(), full_record_path.c_str()));
+            }
             frames_already_record++;
             VP_DEBUG(vp_utils::string_format("[%s] [record] already written %d frames for `%s`", host_node_name.c_str(), frames_already_record, get_full_record_path().c_str()));
 
@@ -82,8 +117,9 @@ namespace vp_nodes {
 
             // check if complete
             if (frames_already_record >= frames_need_record) {
-                // here release writer at once mannually make sure the video file can be used by others.
-                video_writer.release();
+                // here close muxer at once mannually make sure the video file can be used by others.
+                muxer->close();
+                muxer = nullptr;
 
                 vp_record_info record_info;
                 record_info.record_type = vp_record_type::VIDEO;
@@ -100,4 +136,4 @@ namespace vp_nodes {
         // save as mp4
         return ".mp4";
     }  
-}
\ No newline at end of file
+}
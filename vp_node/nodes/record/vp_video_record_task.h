@@ -1,20 +1,32 @@
 #pragma once
 
+#include <mutex>
+#include <vector>
+
 #include "vp_record_task.h"
+#include "Enmuxer.h"
 
 namespace vp_nodes {
     // video record task, each task instance responsible for recording only 1 video file.
     // create multi instances if multi videos need to be record at the same time, and maintain these tasks in a list.
+    // it takes encoded packets (pre-record ring first) and remuxes them into mp4 without re-encoding,
+    // packets before the first key frame are skipped.
     class vp_video_record_task: public vp_record_task {
     private:
-        // video writer
-        cv::VideoWriter video_writer;
-        // gst template
-        std::string gst_template = "appsrc ! videoconvert ! x264enc bitrate=%d ! mp4mux ! filesink location=%s";
-        
+        // mp4 muxer, opened at the first key frame
+        std::shared_ptr<FFmpeg::Enmuxer> muxer;
+        // packets to be written, shared with the host node (read only), pushed by host node and popped by record thread
+        std::deque<av_packet> packets_to_record;
+        std::mutex packets_lock;
+
+        AVCodecID codec_id;
+        int width;
+        int height;
+        // SPS/PPS[/VPS], extradata of mp4
+        std::vector<uint8_t> stream_header;
+
         int frames_already_record = -1;
         int frames_need_record = 0;
-        int bitrate;
         int fps;
         int record_video_duration;
         int pre_record_video_duration;
@@ -26,18 +38,23 @@ namespace vp_nodes {
         virtual std::string get_file_ext() override;
     public:
         vp_video_record_task(int channel_index, 
-                        std::deque<std::shared_ptr<vp_objects::vp_frame_meta>> pre_record_frames, 
+                        std::deque<av_packet> pre_record_packets, 
                         std::string file_name_without_ext,
                         std::string save_dir,
                         bool auto_sub_dir,
                         bool osd,
-                        vp_objects::vp_size resolution_w_h,
-                        int bitrate,
+                        AVCodecID codec_id,
+                        int width,
+                        int height,
+                        std::vector<uint8_t> stream_header,
                         int fps,
                         int pre_record_video_duration,
                         int record_video_duration,
                         std::string host_node_name = "host_node_not_specified",
                         bool auto_start = true);
         ~vp_video_record_task();
+
+        // append encoded packet asynchronously (pts in 1/fps), just write it to cache
+        void append_packet_async(av_packet packet);
     };
-}
\ No newline at end of file
+}
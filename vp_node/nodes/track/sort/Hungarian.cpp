@@ -10,6 +10,7 @@
 // 
 
 #include "Hungarian.h"
+#include <algorithm>
 #include <cmath>
 #include <cfloat>
 HungarianAlgorithm::HungarianAlgorithm(){}
@@ -22,29 +23,36 @@ HungarianAlgorithm::~HungarianAlgorithm(){}
 double HungarianAlgorithm::Solve(vector<vector<double>>& DistMatrix, vector<int>& Assignment)
 {
 	unsigned int nRows = DistMatrix.size();
-	unsigned int nCols = DistMatrix[0].size();
-
-	double *distMatrixIn = new double[nRows * nCols];
-	int *assignment = new int[nRows];
-	double cost = 0.0;
+	unsigned int nCols = nRows == 0 ? 0 : DistMatrix[0].size();
 
 	// Fill in the distMatrixIn. Mind the index is "i + nRows * j".
 	// Here the cost matrix of size MxN is defined as a double precision array of N*M elements. 
 	// In the solving functions matrices are seen to be saved MATLAB-internally in row-order.
 	// (i.e. the matrix [1 2; 3 4] will be stored as a vector [1 3 2 4], NOT [1 2 3 4]).
+	distMatrixIn.resize(nRows * nCols);
 	for (unsigned int i = 0; i < nRows; i++)
 		for (unsigned int j = 0; j < nCols; j++)
 			distMatrixIn[i + nRows * j] = DistMatrix[i][j];
-	
-	// call solving function
-	assignmentoptimal(assignment, &cost, distMatrixIn, nRows, nCols);
 
-	Assignment.clear();
-	for (unsigned int r = 0; r < nRows; r++)
-		Assignment.push_back(assignment[r]);
+	return Solve(distMatrixIn.data(), nRows, nCols, Assignment);
+}
+
+
+double HungarianAlgorithm::Solve(const double *DistMatrix, int nRows, int nCols, vector<int>& Assignment)
+{
+	double cost = 0.0;
+	Assignment.resize(nRows);
 
-	delete[] distMatrixIn;
-	delete[] assignment;
+	if (nRows == 0)
+		return cost;
+	if (nCols == 0)
+	{
+		std::fill(Assignment.begin(), Assignment.end(), -1);
+		return cost;
+	}
+
+	// call solving function
+	assignmentoptimal(Assignment.data(), &cost, DistMatrix, nRows, nCols);
 	return cost;
 }
 
@@ -52,7 +60,7 @@ double HungarianAlgorithm::Solve(vector<vector<double>>& DistMatrix, vector<int>
 //********************************************************//
 // Solve optimal solution for assignment problem using Munkres algorithm, also known as Hungarian Algorithm.
 //********************************************************//
-void HungarianAlgorithm::assignmentoptimal(int *assignment, double *cost, double *distMatrixIn, int nOfRows, int nOfColumns)
+void HungarianAlgorithm::assignmentoptimal(int *assignment, double *cost, const double *distMatrixIn, int nOfRows, int nOfColumns)
 {
 	double *distMatrix, *distMatrixTemp, *distMatrixEnd, *columnEnd, value, minValue;
 	bool *coveredColumns, *coveredRows, *starMatrix, *newStarMatrix, *primeMatrix;
@@ -66,7 +74,8 @@ void HungarianAlgorithm::assignmentoptimal(int *assignment, double *cost, double
 	/* generate working copy of distance Matrix */
 	/* check if all matrix elements are positive */
 	nOfElements = nOfRows * nOfColumns;
-	distMatrix = (double *)malloc(nOfElements * sizeof(double));
+	distMatrixWork.resize(nOfElements);
+	distMatrix = distMatrixWork.data();
 	distMatrixEnd = distMatrix + nOfElements;
 
 	for (row = 0; row<nOfElements; row++)
@@ -78,12 +87,19 @@ void HungarianAlgorithm::assignmentoptimal(int *assignment, double *cost, double
 	}
 
 
-	/* memory allocation */
-	coveredColumns = (bool *)calloc(nOfColumns, sizeof(bool));
-	coveredRows = (bool *)calloc(nOfRows, sizeof(bool));
-	starMatrix = (bool *)calloc(nOfElements, sizeof(bool));
-	primeMatrix = (bool *)calloc(nOfElements, sizeof(bool));
-	newStarMatrix = (bool *)calloc(nOfElements, sizeof(bool)); /* used in step4 */
+	/* memory allocation, taken from the working arrays */
+	size_t nOfBools = nOfColumns + nOfRows + 3 * (size_t)nOfElements;
+	if (boolWorkSize < nOfBools)
+	{
+		boolWork.reset(new bool[nOfBools]);
+		boolWorkSize = nOfBools;
+	}
+	std::fill_n(boolWork.get(), nOfBools, false);
+	coveredColumns = boolWork.get();
+	coveredRows = coveredColumns + nOfColumns;
+	starMatrix = coveredRows + nOfRows;
+	primeMatrix = starMatrix + nOfElements;
+	newStarMatrix = primeMatrix + nOfElements; /* used in step4 */
 
 	/* preliminary steps */
 	if (nOfRows <= nOfColumns)
@@ -170,14 +186,6 @@ void HungarianAlgorithm::assignmentoptimal(int *assignment, double *cost, double
 	/* compute cost and remove invalid assignments */
 	computeassignmentcost(assignment, cost, distMatrixIn, nOfRows);
 
-	/* free allocated memory */
-	free(distMatrix);
-	free(coveredColumns);
-	free(coveredRows);
-	free(starMatrix);
-	free(primeMatrix);
-	free(newStarMatrix);
-
 	return;
 }
 
@@ -200,7 +208,7 @@ void HungarianAlgorithm::buildassignmentvector(int *assignment, bool *starMatrix
 }
 
 /********************************************************/
-void HungarianAlgorithm::computeassignmentcost(int *assignment, double *cost, double *distMatrix, int nOfRows)
+void HungarianAlgorithm::computeassignmentcost(int *assignment, double *cost, const double *distMatrix, int nOfRows)
 {
 	int row, col;
 
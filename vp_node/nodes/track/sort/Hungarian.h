@@ -9,7 +9,10 @@
 // by Cong Ma, 2016
 // 
 
+#pragma once
+
 #include <iostream>
+#include <memory>
 #include <vector>
 
 using namespace std;
@@ -21,11 +24,20 @@ public:
 	HungarianAlgorithm();
 	~HungarianAlgorithm();
 	double Solve(vector<vector<double>>& DistMatrix, vector<int>& Assignment);
+	// DistMatrix is nRows x nCols stored column by column, element (i, j) at i + nRows * j.
+	// working arrays are kept in the object, so solving with one object every frame does not allocate once warmed up.
+	double Solve(const double *DistMatrix, int nRows, int nCols, vector<int>& Assignment);
 
 private:
-	void assignmentoptimal(int *assignment, double *cost, double *distMatrix, int nOfRows, int nOfColumns);
+	// working arrays, grown on demand
+	vector<double> distMatrixIn;
+	vector<double> distMatrixWork;
+	unique_ptr<bool[]> boolWork;
+	size_t boolWorkSize = 0;
+
+	void assignmentoptimal(int *assignment, double *cost, const double *distMatrix, int nOfRows, int nOfColumns);
 	void buildassignmentvector(int *assignment, bool *starMatrix, int nOfRows, int nOfColumns);
-	void computeassignmentcost(int *assignment, double *cost, double *distMatrix, int nOfRows);
+	void computeassignmentcost(int *assignment, double *cost, const double *distMatrix, int nOfRows);
 	void step2a(int *assignment, double *distMatrix, bool *starMatrix, bool *newStarMatrix, bool *primeMatrix, bool *coveredColumns, bool *coveredRows, int nOfRows, int nOfColumns, int minDim);
 	void step2b(int *assignment, double *distMatrix, bool *starMatrix, bool *newStarMatrix, bool *primeMatrix, bool *coveredColumns, bool *coveredRows, int nOfRows, int nOfColumns, int minDim);
 	void step3(int *assignment, double *distMatrix, bool *starMatrix, bool *newStarMatrix, bool *primeMatrix, bool *coveredColumns, bool *coveredRows, int nOfRows, int nOfColumns, int minDim);
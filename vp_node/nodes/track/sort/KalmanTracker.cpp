@@ -42,10 +42,43 @@ StateType KalmanTracker::predict()
 		m_hit_streak = 0;
 	m_time_since_update += 1;
 
-	StateType predictBox = get_rect_xysr(p.at<float>(0, 0), p.at<float>(1, 0), p.at<float>(2, 0), p.at<float>(3, 0));
+	return get_rect_xysr(p.at<float>(0, 0), p.at<float>(1, 0), p.at<float>(2, 0), p.at<float>(3, 0));
+}
+
+
+// Warp the predicted state by camera motion, return the warped prediction.
+// center and its velocity follow the linear part (plus translation for the center), area and its velocity
+// scale with the determinant, aspect ratio stays. covariance is transformed the same way.
+StateType KalmanTracker::apply_motion(const cv::Matx23f& warp)
+{
+	float area_scale = std::abs(warp(0, 0) * warp(1, 1) - warp(0, 1) * warp(1, 0));
 
-	m_history.push_back(predictBox);
-	return m_history.back();
+	cv::Matx<float, 7, 7> J = cv::Matx<float, 7, 7>::zeros();
+	for (int k = 0; k <= 4; k += 4)
+	{
+		J(k, k) = warp(0, 0);
+		J(k, k + 1) = warp(0, 1);
+		J(k + 1, k) = warp(1, 0);
+		J(k + 1, k + 1) = warp(1, 1);
+	}
+	J(2, 2) = area_scale;
+	J(3, 3) = 1;
+	J(6, 6) = area_scale;
+
+	cv::Matx<float, 7, 1> x(kf.statePre.ptr<float>());
+	cv::Matx<float, 7, 7> P(kf.errorCovPre.ptr<float>());
+	x = J * x;
+	x(0) += warp(0, 2);
+	x(1) += warp(1, 2);
+	P = J * P * J.t();
+
+	// predict() leaves post equal to pre, keep it that way
+	cv::Mat(7, 1, CV_32F, x.val).copyTo(kf.statePre);
+	cv::Mat(7, 7, CV_32F, P.val).copyTo(kf.errorCovPre);
+	kf.statePre.copyTo(kf.statePost);
+	kf.errorCovPre.copyTo(kf.errorCovPost);
+
+	return get_rect_xysr(x(0), x(1), x(2), x(3));
 }
 
 
@@ -53,7 +86,6 @@ StateType KalmanTracker::predict()
 void KalmanTracker::update(StateType stateMat)
 {
 	m_time_since_update = 0;
-	m_history.clear();
 	m_hits += 1;
 	m_hit_streak += 1;
 
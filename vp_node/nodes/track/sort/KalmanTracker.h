@@ -38,12 +38,9 @@ public:
 		kf_count++;
 	}
 
-	~KalmanTracker()
-	{
-		m_history.clear();
-	}
-
 	StateType predict();
+	// warp the predicted state by camera motion (2x3 affine, previous frame -> this frame), call after predict().
+	StateType apply_motion(const cv::Matx23f& warp);
 	void update(StateType stateMat);
 	
 	StateType get_state();
@@ -62,8 +59,6 @@ private:
 
 	cv::KalmanFilter kf;
 	cv::Mat measurement;
-
-	std::vector<StateType> m_history;
 };
 
 
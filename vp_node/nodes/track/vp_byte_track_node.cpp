@@ -3,8 +3,8 @@
 namespace vp_nodes {
 
 	vp_byte_track_node::vp_byte_track_node(std::string node_name,
-		vp_track_for track_for) :
-		vp_track_node(node_name, track_for) {
+		vp_track_for track_for, vp_gmc_method gmc_method) :
+		vp_track_node(node_name, track_for, gmc_method) {
 		this->initialized();
 	}
 
@@ -12,15 +12,6 @@ namespace vp_nodes {
 		deinitialized();
 	}
 
-	double vp_byte_track_node::GetIOU(cv::Rect_<float> bb_test, cv::Rect_<float> bb_gt)
-	{
-		float in = (bb_test & bb_gt).area();
-		float un = bb_test.area() + bb_gt.area() - in;
-		if (un < DBL_EPSILON)
-			return 0;
-		return (double)(in / un);
-	}
-
 	std::shared_ptr<vp_objects::vp_meta> vp_byte_track_node::handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta)
 	{
 		// channel_index can be different each call
@@ -65,19 +56,14 @@ namespace vp_nodes {
 		}
 		auto& tracker = all_trackers[channel_index];
 
-		std::vector<STrack> output_stracks = tracker.update(det_res);
-		
-		// update
+		// warp predicted tracks by camera motion before association
+		estimate_camera_motion(meta, rects);
+		const std::vector<STrack>& output_stracks = tracker.update(det_res, has_camera_motion ? camera_motion.val : nullptr);
+
+		// every output track knows the detection it was matched to
 		for (auto& it : output_stracks) {
-			for (int i = 0; i < rects.size(); ++i) {
-				if (GetIOU(cv::Rect_<float>(rects[i].x, rects[i].y, rects[i].width, rects[i].height),
-					cv::Rect_<float>(it.tlwh[0], it.tlwh[1], it.tlwh[2], it.tlwh[3])) > 0.8) {
-					track_ids[i] = it.track_id;
-					//meta->targets[i]->x = it.tlwh[0];
-					//meta->targets[i]->y = it.tlwh[1];
-					//meta->targets[i]->width = it.tlwh[2];
-					//meta->targets[i]->height = it.tlwh[3];
-				}
+			if (it.det_index >= 0) {
+				track_ids[it.det_index] = it.track_id;
 			}
 		}
 		postprocess(meta, rects, std::vector<std::vector<float>>(), track_ids);
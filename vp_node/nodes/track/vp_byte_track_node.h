@@ -13,7 +13,6 @@ namespace vp_nodes {
         // track for
         vp_track_for track_for = vp_track_for::NORMAL;
         std::map<int, BYTETracker> all_trackers;
-        double GetIOU(cv::Rect_<float> bb_test, cv::Rect_<float> bb_gt);
 
     protected:
         virtual std::shared_ptr<vp_objects::vp_meta> handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) override final;
@@ -21,7 +20,8 @@ namespace vp_nodes {
                            const std::vector<std::vector<float>>& target_embeddings, std::vector<int>& track_ids) override { return; };
 
     public:
-        vp_byte_track_node(std::string node_name, vp_track_for track_for=vp_track_for::NORMAL);
+        // gmc_method enables camera motion compensation (for moving cameras such as drone or PTZ).
+        vp_byte_track_node(std::string node_name, vp_track_for track_for=vp_track_for::NORMAL, vp_gmc_method gmc_method=vp_gmc_method::NONE);
         virtual ~vp_byte_track_node();
 
     };
@@ -0,0 +1,198 @@
+#include <cmath>
+#include <opencv2/calib3d.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>
+
+#include "vp_gmc.h"
+#include "vp_utils/vp_color_convert.h"
+
+namespace vp_nodes {
+
+    vp_gmc::vp_gmc(vp_gmc_method method, int downscale):
+                    method(method),
+                    downscale(std::max(1, downscale)) {
+        if (method == vp_gmc_method::ORB) {
+            detector = cv::FastFeatureDetector::create(20);
+            extractor = cv::ORB::create();
+            matcher = cv::BFMatcher::create(cv::NORM_HAMMING);
+        }
+    }
+
+    vp_gmc::~vp_gmc() {
+    }
+
+    void vp_gmc::reset() {
+        initialized_first_frame = false;
+        prev_points.clear();
+        prev_keypoints.clear();
+        prev_descriptors.release();
+    }
+
+    bool vp_gmc::apply(std::shared_ptr<vp_objects::vp_frame_meta> meta, const std::vector<vp_objects::vp_rect>& detections, cv::Matx23f& warp) {
+        if (method == vp_gmc_method::NONE) {
+            return false;
+        }
+        // prev_grey holds the previous frame after the swap
+        std::swap(grey, prev_grey);
+        if (!grey_of(meta)) {
+            reset();
+            return false;
+        }
+        // resolution changed, start over
+        if (initialized_first_frame && grey.size() != prev_grey.size()) {
+            reset();
+        }
+
+        if (method == vp_gmc_method::SPARSE_OPT_FLOW) {
+            return apply_sparse_opt_flow(warp);
+        }
+        return apply_features(detections, warp);
+    }
+
+    bool vp_gmc::grey_of(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
+        // the native NV12 image first, its Y plane is grey already and RGA can shrink it from the dma-buf
+        auto& dma = meta->dma_frame;
+        if (dma != nullptr && dma->format == vp_objects::vp_dma_format::NV12) {
+            return vp_utils::nv12_to_grey(dma->fd, dma->vir_addr, dma->size, dma->width, dma->height, dma->hor_stride, dma->ver_stride,
+                                        dma->width / downscale, dma->height / downscale, grey);
+        }
+
+        // native image, NV12 or BGR
+        auto& frame = meta->frame;
+        if (frame.empty()) {
+            return false;
+        }
+        auto width = frame.cols;
+        auto height = frame.type() == CV_8UC1 ? frame.rows * 2 / 3 : frame.rows;
+        return vp_utils::frame_to_grey(frame, width / downscale, height / downscale, grey);
+    }
+
+    bool vp_gmc::apply_sparse_opt_flow(cv::Matx23f& warp) {
+        // find the keypoints
+        cv::goodFeaturesToTrack(grey, points, 1000, 0.01, 1, cv::noArray(), 3, false, 0.04);
+
+        // handle first frame
+        if (!initialized_first_frame) {
+            prev_points.swap(points);
+            initialized_first_frame = true;
+            return false;
+        }
+
+        // find correspondences, leave good ones only
+        from.clear();
+        to.clear();
+        if (!prev_points.empty()) {
+            cv::calcOpticalFlowPyrLK(prev_grey, grey, prev_points, matched_points, status, err);
+            for (size_t i = 0; i < status.size(); i++) {
+                if (status[i]) {
+                    from.push_back(prev_points[i]);
+                    to.push_back(matched_points[i]);
+                }
+            }
+        }
+        prev_points.swap(points);
+
+        return estimate(warp);
+    }
+
+    bool vp_gmc::apply_features(const std::vector<vp_objects::vp_rect>& detections, cv::Matx23f& warp) {
+        auto width = grey.cols;
+        auto height = grey.rows;
+
+        // find the keypoints away from borders and targets, targets may move on their own
+        mask.create(grey.size(), CV_8UC1);
+        mask.setTo(0);
+        mask(cv::Rect(cv::Point(int(0.02 * width), int(0.02 * height)), cv::Point(int(0.98 * width), int(0.98 * height)))).setTo(255);
+        for (auto& det: detections) {
+            auto rect = cv::Rect(det.x / downscale, det.y / downscale, det.width / downscale, det.height / downscale) & cv::Rect(0, 0, width, height);
+            if (rect.area() > 0) {
+                mask(rect).setTo(0);
+            }
+        }
+        detector->detect(grey, keypoints, mask);
+
+        // compute the descriptors
+        extractor->compute(grey, keypoints, descriptors);
+
+        auto keep_for_next = [&]() {
+            prev_keypoints.swap(keypoints);
+            cv::swap(prev_descriptors, descriptors);
+        };
+
+        // handle first frame
+        if (!initialized_first_frame) {
+            keep_for_next();
+            initialized_first_frame = true;
+            return false;
+        }
+
+        // match descriptors
+        knn_matches.clear();
+        if (!prev_descriptors.empty() && !descriptors.empty()) {
+            matcher->knnMatch(prev_descriptors, descriptors, knn_matches, 2);
+        }
+
+        // filter matches based on smallest spatial distance
+        from.clear();
+        to.clear();
+        auto max_dx = 0.25f * width;
+        auto max_dy = 0.25f * height;
+        for (auto& m: knn_matches) {
+            if (m.size() < 2 || m[0].distance >= 0.9f * m[1].distance) {
+                continue;
+            }
+            auto& prev = prev_keypoints[m[0].queryIdx].pt;
+            auto& curr = keypoints[m[0].trainIdx].pt;
+            if (std::abs(prev.x - curr.x) < max_dx && std::abs(prev.y - curr.y) < max_dy) {
+                from.push_back(prev);
+                to.push_back(curr);
+            }
+        }
+
+        // drop matches moving unlike the others
+        if (!from.empty()) {
+            cv::Point2f mean(0, 0), sq(0, 0);
+            for (size_t i = 0; i < from.size(); i++) {
+                auto d = from[i] - to[i];
+                mean += d;
+                sq += cv::Point2f(d.x * d.x, d.y * d.y);
+            }
+            mean /= float(from.size());
+            auto std_x = std::sqrt(std::max(0.f, sq.x / from.size() - mean.x * mean.x));
+            auto std_y = std::sqrt(std::max(0.f, sq.y / from.size() - mean.y * mean.y));
+
+            size_t kept = 0;
+            for (size_t i = 0; i < from.size(); i++) {
+                auto d = from[i] - to[i];
+                if (std::abs(d.x - mean.x) < 2.5f * std_x && std::abs(d.y - mean.y) < 2.5f * std_y) {
+                    from[kept] = from[i];
+                    to[kept] = to[i];
+                    kept++;
+                }
+            }
+            from.resize(kept);
+            to.resize(kept);
+        }
+        keep_for_next();
+
+        return estimate(warp);
+    }
+
+    bool vp_gmc::estimate(cv::Matx23f& warp) {
+        // not enough matching points
+        if (from.size() <= 4) {
+            return false;
+        }
+        cv::Mat H = cv::estimateAffinePartial2D(from, to, cv::noArray(), cv::RANSAC);
+        if (H.empty()) {
+            return false;
+        }
+        H.convertTo(H, CV_32F);
+        warp = cv::Matx23f(H.ptr<float>());
+
+        // handle downscale
+        warp(0, 2) *= downscale;
+        warp(1, 2) *= downscale;
+        return true;
+    }
+}
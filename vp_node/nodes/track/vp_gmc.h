@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/features2d.hpp>
+
+#include "objects/vp_frame_meta.h"
+#include "objects/shapes/vp_rect.h"
+
+namespace vp_nodes {
+    // method used to estimate camera motion, same as python/trackers/utils/gmc.py
+    enum class vp_gmc_method {
+        NONE = 0,             // no compensation
+        SPARSE_OPT_FLOW = 1,  // good features to track + pyramidal LK optical flow
+        ORB = 2               // FAST keypoints + ORB descriptors, brute-force hamming matching (targets masked out)
+    };
+
+    // global motion compensation for one channel.
+    // estimates the affine transform (rotation + uniform scale + translation) between consecutive frames on a downscaled grey image,
+    // trackers warp their predicted states with it before association, so targets keep matching when the camera moves (drone, PTZ).
+    class vp_gmc {
+    private:
+        vp_gmc_method method;
+        int downscale;
+
+        // grey images of this / previous frame, swapped every frame to reuse memory
+        cv::Mat grey;
+        cv::Mat prev_grey;
+        bool initialized_first_frame = false;
+
+        // sparse optical flow
+        std::vector<cv::Point2f> points;
+        std::vector<cv::Point2f> prev_points;
+        std::vector<cv::Point2f> matched_points;
+        std::vector<uchar> status;
+        std::vector<float> err;
+
+        // orb
+        cv::Ptr<cv::FastFeatureDetector> detector;
+        cv::Ptr<cv::ORB> extractor;
+        cv::Ptr<cv::DescriptorMatcher> matcher;
+        cv::Mat mask;
+        std::vector<cv::KeyPoint> keypoints;
+        std::vector<cv::KeyPoint> prev_keypoints;
+        cv::Mat descriptors;
+        cv::Mat prev_descriptors;
+        std::vector<std::vector<cv::DMatch>> knn_matches;
+
+        // point pairs fed to estimateAffinePartial2D
+        std::vector<cv::Point2f> from;
+        std::vector<cv::Point2f> to;
+
+        // downscaled grey of frame in meta, RGA does the job for NV12 frames
+        bool grey_of(std::shared_ptr<vp_objects::vp_frame_meta> meta);
+        bool apply_sparse_opt_flow(cv::Matx23f& warp);
+        bool apply_features(const std::vector<vp_objects::vp_rect>& detections, cv::Matx23f& warp);
+        // fit from -> to, warp in full resolution
+        bool estimate(cv::Matx23f& warp);
+    public:
+        vp_gmc(vp_gmc_method method = vp_gmc_method::SPARSE_OPT_FLOW, int downscale = 2);
+        ~vp_gmc();
+
+        // estimate camera motion from the previous frame to frame of meta, detections (rects of targets) are ignored by feature matching.
+        // warp maps points of previous frame to this frame in original resolution: p' = warp * (x, y, 1).
+        // return false (warp untouched) for the first frame or if motion can not be estimated, trackers then work as usual.
+        bool apply(std::shared_ptr<vp_objects::vp_frame_meta> meta, const std::vector<vp_objects::vp_rect>& detections, cv::Matx23f& warp);
+
+        // forget the previous frame
+        void reset();
+    };
+}
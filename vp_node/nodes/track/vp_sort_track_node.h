@@ -1,7 +1,6 @@
 #pragma once
 
 #include <vector>
-#include <set>
 #include <map>
 #include "vp_track_node.h"
 #include "sort/Hungarian.h"
@@ -13,37 +12,33 @@ namespace vp_nodes {
     {
     private:
         /* config data for sort algo */
-        /* data */
-        typedef struct TrackingBox
-        {
-            //int frame;
-            int id;
-            Rect_<float> box;
-        }TrackingBox;
-
         int max_age = 1;
         int min_hits = 3;
         double iouThreshold = 0.5;
         // vector<KalmanTracker> trackers;
         std::map<int, std::vector<KalmanTracker>> all_trackers;
+
+        /* per frame scratch, kept to reuse memory */
+        HungarianAlgorithm hungarian;
+        std::vector<cv::Rect_<float>> detBoxes;
         std::vector<cv::Rect_<float>> predictedBoxes;
-        std::vector<vector<double>> iouMatrix;
+        // 1 - iou of (tracker i, detection j) at i + trkNum * j, the layout HungarianAlgorithm works on
+        std::vector<double> iouMatrix;
         std::vector<int> assignment;
-        std::set<int> unmatchedDetections;
-        std::set<int> unmatchedTrajectories;
-        std::set<int> allItems;
-        std::set<int> matchedItems;
         std::vector<cv::Point> matchedPairs;
-        std::vector<TrackingBox> frameTrackingResult;
+        std::vector<uint8_t> detMatched;
+        // detection each tracker is updated with (or created from) at this frame, -1 if none
+        std::vector<int> trackerDets;
     private:
-        double GetIOU(cv::Rect_<float> bb_test, cv::Rect_<float> bb_gt);
+        double GetIOU(const cv::Rect_<float>& bb_test, const cv::Rect_<float>& bb_gt);
     protected:
         // fill track_ids using sort algo
         virtual void track(int channel_index, const std::vector<vp_objects::vp_rect>& target_rects, 
                         const std::vector<std::vector<float>>& target_embeddings, 
                         std::vector<int>& track_ids) override;
     public:
-        vp_sort_track_node(std::string node_name, vp_track_for track_for = vp_track_for::NORMAL);
+        // gmc_method enables camera motion compensation (for moving cameras such as drone or PTZ).
+        vp_sort_track_node(std::string node_name, vp_track_for track_for = vp_track_for::NORMAL, vp_gmc_method gmc_method = vp_gmc_method::NONE);
         virtual ~vp_sort_track_node();
     };
 
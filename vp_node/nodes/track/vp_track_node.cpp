@@ -4,9 +4,13 @@
 namespace vp_nodes {
         
     vp_track_node::vp_track_node(std::string node_name, 
-                                vp_track_for track_for): 
+                                vp_track_for track_for,
+                                vp_gmc_method gmc_method): 
                                 vp_node(node_name), 
-                                track_for(track_for) {
+                                track_for(track_for),
+                                gmc_method(gmc_method) {
+        // trackers work on target boxes only
+        this->frame_needs_bgr = false;
     }
     
     vp_track_node::~vp_track_node() {
@@ -27,6 +31,7 @@ namespace vp_nodes {
 
         // step 1, collect data
         preprocess(meta, rects, embeddings);
+        estimate_camera_motion(meta, rects);
 
         // step 2, track by channel
         track(channel_index, rects, embeddings, track_ids);
@@ -37,6 +42,18 @@ namespace vp_nodes {
         return meta;
     }
 
+    void vp_track_node::estimate_camera_motion(std::shared_ptr<vp_objects::vp_frame_meta> meta, const std::vector<vp_objects::vp_rect>& target_rects) {
+        has_camera_motion = false;
+        if (gmc_method == vp_gmc_method::NONE) {
+            return;
+        }
+        auto it = all_gmcs.find(meta->channel_index);
+        if (it == all_gmcs.end()) {
+            it = all_gmcs.emplace(meta->channel_index, vp_gmc(gmc_method)).first;
+        }
+        has_camera_motion = it->second.apply(meta, target_rects, camera_motion);
+    }
+
     void vp_track_node::preprocess(std::shared_ptr<vp_objects::vp_frame_meta> frame_meta, 
                                 std::vector<vp_objects::vp_rect>& target_rects, 
                                 std::vector<std::vector<float>>& target_embeddings) {
@@ -72,7 +89,17 @@ namespace vp_nodes {
 
         // support multi channels
         auto& tracks_by_id = all_tracks_by_id[frame_meta->channel_index];
-        auto& last_tracked_frame_indexes = all_last_tracked_frame_indexes[frame_meta->channel_index];
+
+        // append rect to cache of track_id and return the latest rects
+        auto cache_track = [&](int track_id, const vp_objects::vp_rect& rect) {
+            auto it = tracks_by_id.find(track_id);
+            if (it == tracks_by_id.end()) {
+                it = tracks_by_id.emplace(track_id, vp_track_cache{vp_objects::vp_track_history_buffer(max_track_history), 0}).first;
+            }
+            it->second.history.push(rect);                                  // cache
+            it->second.last_tracked_frame_index = frame_meta->frame_index;   // update stamp
+            return it->second.history.view();
+        };
 
         if (track_for == vp_track_for::NORMAL) {
             //assert(target_rects.size() == frame_meta->targets.size());
@@ -83,11 +110,8 @@ namespace vp_nodes {
 
                 // -1 means no track result returned yet
                 if (track_id != -1) {
-                    tracks_by_id[track_id].push_back(rect);                           // cache
-                    last_tracked_frame_indexes[track_id] = frame_meta->frame_index;   // update stamp
-
                     target->track_id = track_id;               // write track_id back to target
-                    target->tracks = tracks_by_id[track_id];   // write tracks back to target
+                    target->tracks = cache_track(track_id, rect);   // write tracks back to target, shared not copied
                 }
             }
         }
@@ -101,23 +125,21 @@ namespace vp_nodes {
 
                 // -1 means no track result returned yet
                 if (track_id != -1) {
-                    tracks_by_id[track_id].push_back(rect);                           // cache
-                    last_tracked_frame_indexes[track_id] = frame_meta->frame_index;   // update stamp
-
                     face->track_id = track_id;                // write track_id back to face target
-                    face->tracks = tracks_by_id[track_id];    // write tracks back to face target
+                    face->tracks = cache_track(track_id, rect);     // write tracks back to face target, shared not copied
                 }
             }
         }
         /* ... extend for more track for... */
 
         // remove cache tracks if has been long time since last updated (maybe it disappeared already).
-        for (auto i = last_tracked_frame_indexes.begin(); i != last_tracked_frame_indexes.end();) {
-            if (frame_meta->frame_index - (i->second) > max_allowed_disappear_frames 
-                || frame_meta->frame_index < i->second) {
-                VP_DEBUG(vp_utils::string_format("[%s] [tracking] long time no update, so erase cache of tracks for track_id:`%d`, size of tracks is:`%d`", node_name.c_str(), i->first, tracks_by_id[i->first].size()));
-                tracks_by_id.erase(i->first);              // erase tracks first
-                i = last_tracked_frame_indexes.erase(i);   // erase stamp then
+        // targets still holding the tracks keep them alive, the cache only drops its reference.
+        for (auto i = tracks_by_id.begin(); i != tracks_by_id.end();) {
+            auto last_tracked_frame_index = i->second.last_tracked_frame_index;
+            if (frame_meta->frame_index - last_tracked_frame_index > max_allowed_disappear_frames 
+                || frame_meta->frame_index < last_tracked_frame_index) {
+                VP_DEBUG(vp_utils::string_format("[%s] [tracking] long time no update, so erase cache of tracks for track_id:`%d`, tracked frames:`%d`", node_name.c_str(), i->first, i->second.history.tracked_frames()));
+                i = tracks_by_id.erase(i);
             }
             else {
                 i++;
@@ -2,8 +2,11 @@
 #pragma once
 
 #include <map>
+#include <unordered_map>
 #include <assert.h>
 #include "nodes/base/vp_node.h"
+#include "objects/vp_track_history.h"
+#include "vp_gmc.h"
 
 namespace vp_nodes {
     // track node applied to which type of target (vp_frame_target, vp_frame_face_target or others)
@@ -20,17 +23,35 @@ namespace vp_nodes {
         // track for
         vp_track_for track_for = vp_track_for::NORMAL;
         
-        // cache tracks at previous frames
-        // std::map<int, std::vector<vp_objects::vp_rect>> tracks_by_id;
-        std::map<int, std::map<int, std::vector<vp_objects::vp_rect>>> all_tracks_by_id;
+        // cache of tracks at previous frames
+        struct vp_track_cache {
+            vp_objects::vp_track_history_buffer history;
+            // stamp
+            int last_tracked_frame_index;
+        };
 
-        // stamp
-        // std::map<int, int> last_tracked_frame_indexes;
-        std::map<int, std::map<int, int>> all_last_tracked_frame_indexes;
+        // track_id -> cache, one table per channel
+        std::map<int, std::unordered_map<int, vp_track_cache>> all_tracks_by_id;
 
         // remove cache tracks if it has been long time since last tracked.
         const int max_allowed_disappear_frames = 25;
+
+        // rects kept for each track, older ones are dropped.
+        const int max_track_history = 50;
+
+        // camera motion compensation, one estimator per channel
+        vp_gmc_method gmc_method = vp_gmc_method::NONE;
+        std::map<int, vp_gmc> all_gmcs;
     protected:
+        // camera motion (previous frame -> this frame, 2x3 affine in original resolution) of the frame being tracked,
+        // valid only if has_camera_motion is true. trackers warp their predicted states with it before association.
+        cv::Matx23f camera_motion;
+        bool has_camera_motion = false;
+
+        // estimate camera motion of the channel meta belongs to (no-op if gmc_method is NONE), fill camera_motion & has_camera_motion.
+        // called by handle_frame_meta before track(), target_rects are masked out for feature matching.
+        void estimate_camera_motion(std::shared_ptr<vp_objects::vp_frame_meta> meta, const std::vector<vp_objects::vp_rect>& target_rects);
+
         virtual std::shared_ptr<vp_objects::vp_meta> handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) override;
         virtual std::shared_ptr<vp_objects::vp_meta> handle_control_meta(std::shared_ptr<vp_objects::vp_control_meta> meta) override final;
 
@@ -54,7 +75,7 @@ namespace vp_nodes {
                         const std::vector<std::vector<float>>& target_embeddings, 
                         const std::vector<int>& track_ids);
     public:
-        vp_track_node(std::string node_name, vp_track_for track_for = vp_track_for::NORMAL);
+        vp_track_node(std::string node_name, vp_track_for track_for = vp_track_for::NORMAL, vp_gmc_method gmc_method = vp_gmc_method::NONE);
         virtual ~vp_track_node();
     };
 }
\ No newline at end of file
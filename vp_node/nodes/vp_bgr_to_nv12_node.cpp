@@ -1,12 +1,12 @@
 #include "vp_bgr_to_nv12_node.h"
 
-#include <cstring>
-
-#include <opencv2/imgproc.hpp>
+#include "vp_utils/vp_color_convert.h"
 
 namespace vp_nodes {
 
-vp_bgr_to_nv12_node::vp_bgr_to_nv12_node(std::string node_name) : vp_node(node_name) {
+vp_bgr_to_nv12_node::vp_bgr_to_nv12_node(std::string node_name, bool use_rga) : vp_node(node_name), use_rga(use_rga) {
+    // NV12 输入直接透传，BGR 输入自行转换，不需要基类预先转 BGR。
+    this->frame_needs_bgr = false;
     this->initialized();
 }
 
@@ -20,6 +20,22 @@ std::shared_ptr<vp_objects::vp_meta> vp_bgr_to_nv12_node::handle_frame_meta(
         return meta;
     }
 
+    // OSD 直接绘制在 NV12 上：叠加结果即输出图像。
+    if (!meta->osd_frame.empty() && meta->osd_frame.type() == CV_8UC1) {
+        // 同时丢弃按需转换缓存的 BGR，其内容不含 OSD。
+        meta->replace_frame(meta->osd_frame);
+        // 原解码缓冲不再代表当前图像（已叠加 OSD），释放以免下游误用。
+        meta->dma_frame.reset();
+        meta->original_width = meta->frame.cols;
+        meta->original_height = meta->frame.rows * 2 / 3;
+        return meta;
+    }
+
+    // 没有 OSD 且帧本身仍是 NV12：无需转换。
+    if (meta->osd_frame.empty() && meta->frame_is_nv12()) {
+        return meta;
+    }
+
     // 输入图像（优先使用 OSD 结果）。
     const cv::Mat& input_bgr = meta->osd_frame.empty() ? meta->frame : meta->osd_frame;
     if (input_bgr.empty()) {
@@ -43,7 +59,7 @@ std::shared_ptr<vp_objects::vp_meta> vp_bgr_to_nv12_node::handle_frame_meta(
         return meta;
     }
 
-    // NV12 要求偶数宽高，这里做向下对齐裁剪。
+    // NV12 要求偶数宽高，转换时做向下对齐裁剪（按原 stride 读取，不拷贝）。
     const int even_width = input_width & ~1;
     const int even_height = input_height & ~1;
     if (even_width <= 1 || even_height <= 1) {
@@ -54,52 +70,16 @@ std::shared_ptr<vp_objects::vp_meta> vp_bgr_to_nv12_node::handle_frame_meta(
         return meta;
     }
 
-    // 偶数尺寸 BGR 输入。
-    cv::Mat bgr_even = input_bgr;
-    if (even_width != input_width || even_height != input_height) {
-        bgr_even = input_bgr(cv::Rect(0, 0, even_width, even_height)).clone();
-    }
-
-    // I420 图像缓存。
-    cv::Mat i420_frame;
-    cv::cvtColor(bgr_even, i420_frame, cv::COLOR_BGR2YUV_I420);
-    if (i420_frame.empty()) {
-        VP_WARN(vp_utils::string_format("[%s] cvtColor BGR->I420 failed", node_name.c_str()));
-        return meta;
-    }
-
-    // NV12 输出图像缓存。
-    cv::Mat nv12_frame(even_height * 3 / 2, even_width, CV_8UC1);
-    if (nv12_frame.empty()) {
+    // NV12 输出图像缓存（池化，随 meta 释放回收）。
+    cv::Mat nv12_frame;
+    if (!vp_utils::bgr_to_nv12(input_bgr, nv12_frame, use_rga)) {
+        VP_WARN(vp_utils::string_format("[%s] convert BGR->NV12 failed", node_name.c_str()));
         return meta;
     }
 
-    // Y 平面字节数。
-    const size_t y_size = static_cast<size_t>(even_width) * static_cast<size_t>(even_height);
-    // U/V 平面字节数。
-    const size_t uv_size = y_size / 4;
-    // I420 基地址。
-    const uint8_t* i420_ptr = i420_frame.ptr<uint8_t>(0);
-    // NV12 基地址。
-    uint8_t* nv12_ptr = nv12_frame.ptr<uint8_t>(0);
-    // I420 的 Y 平面。
-    const uint8_t* src_y = i420_ptr;
-    // I420 的 U 平面。
-    const uint8_t* src_u = i420_ptr + y_size;
-    // I420 的 V 平面。
-    const uint8_t* src_v = i420_ptr + y_size + uv_size;
-    // NV12 的 Y 平面。
-    uint8_t* dst_y = nv12_ptr;
-    // NV12 的 UV 平面。
-    uint8_t* dst_uv = nv12_ptr + y_size;
-
-    std::memcpy(dst_y, src_y, y_size);
-    for (size_t i = 0; i < uv_size; ++i) {
-        dst_uv[2 * i] = src_u[i];
-        dst_uv[2 * i + 1] = src_v[i];
-    }
-
-    meta->frame = nv12_frame;
+    meta->replace_frame(nv12_frame);
+    // 原解码缓冲不再代表当前图像（已叠加 OSD），释放以免下游误用。
+    meta->dma_frame.reset();
     meta->original_width = even_width;
     meta->original_height = even_height;
     return meta;
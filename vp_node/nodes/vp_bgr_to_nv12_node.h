@@ -9,8 +9,15 @@ namespace vp_nodes {
  *
  * 优先使用 `osd_frame`（若存在）作为输入，这样可以把检测框/文字叠加结果
  * 转换后交给 NV12 SDL 显示节点输出。
+ *
+ * 转换为单遍融合实现（ARM 上为 NEON），直接写出 Y 与交错 UV，不经过 I420 中间图；
+ * 也可选择优先使用 RGA。若 OSD 已直接绘制在 NV12 上（或帧本身就是 NV12），则直接透传，不做任何转换。
  */
 class vp_bgr_to_nv12_node : public vp_node {
+private:
+    // 是否优先使用 RGA 转换（失败时回退 CPU）。
+    bool use_rga = false;
+
 protected:
     /**
      * @brief 处理视频帧元数据并执行 BGR->NV12 转换。
@@ -35,8 +42,9 @@ public:
      * @brief 构造 BGR->NV12 适配节点。
      *
      * @param node_name 节点名称。
+     * @param use_rga 是否优先使用 RGA 转换，默认使用 CPU（NEON）。
      */
-    explicit vp_bgr_to_nv12_node(std::string node_name);
+    explicit vp_bgr_to_nv12_node(std::string node_name, bool use_rga = false);
 
     /**
      * @brief 析构节点并释放资源。
@@ -5,6 +5,7 @@ namespace vp_nodes {
         
     vp_fake_des_node::vp_fake_des_node(std::string node_name, 
                         int channel_index): vp_des_node(node_name, channel_index) {
+        this->frame_needs_bgr = false;
         this->initialized();
     }
     
@@ -4,6 +4,7 @@
 
 #include "vp_ffmpeg_src_node.h"
 #include "vp_utils/vp_utils.h"
+#include "vp_utils/vp_frame_buffer_pool.h"
 
 #include "im2d.h"
 #include "RgaUtils.h"
@@ -25,6 +26,8 @@ namespace vp_nodes {
             VP_INFO(vp_utils::string_format("[%s] Init Demuxer or Decoder failed!", node_name.c_str()));
             exit(0);
         }
+        // live stream can not wait for slow nodes, drop the oldest frame instead of blocking the receiving thread.
+        this->set_out_queue_policy(vp_queue_policy::DROP_OLDEST, 16);
         this->initialized();
     }
     
@@ -65,17 +68,19 @@ namespace vp_nodes {
                 }
                 skip = 0;
 
-                cv::Mat image(frame->height, frame->width, CV_8UC3);
+                // recycled buffer from pool, the meta owns it directly so no clone needed.
+                cv::Mat image = vp_utils::vp_frame_buffer_pool::host().alloc(frame->height, frame->width, CV_8UC3);
                 if (!m_scaler->scale<av_frame, cv::Mat>(frame, image)) {
                     VP_ERROR(vp_utils::string_format("[%s] Run Scaler Failed!", node_name.c_str()));
                     continue;
                 }
                 cv::Mat resize_frame;
                 if (this->resize_ratio != 1.0f) {                 
-                    cv::resize(image, resize_frame, cv::Size(), resize_ratio, resize_ratio);
+                    resize_frame = vp_utils::vp_frame_buffer_pool::host().alloc(cvRound(image.rows * resize_ratio), cvRound(image.cols * resize_ratio), CV_8UC3);
+                    cv::resize(image, resize_frame, resize_frame.size());
                 }
                 else {
-                    resize_frame = image.clone(); // clone!;
+                    resize_frame = image;
                 }
 
                 // set true size because resize
@@ -90,12 +95,7 @@ namespace vp_nodes {
                     this->out_queue.push(out_meta);
                     
                     // handled hooker activated if need
-                    if (this->meta_handled_hooker) {
-                        meta_handled_hooker(node_name, out_queue.size(), out_meta);
-                    }
-
-                    // important! notify consumer of out_queue in case it is waiting.
-                    this->out_queue_semaphore.signal();
+                    invoke_meta_handled_hooker(node_name, out_queue.size(), out_meta);
                     VP_DEBUG(vp_utils::string_format("[%s] after handling meta, out_queue.size()==>%d", node_name.c_str(), out_queue.size()));
                 } 
             } else if (re == AVERROR_EOF) {
@@ -113,7 +113,6 @@ namespace vp_nodes {
         }
         // send dead flag for dispatch_thread
         this->out_queue.push(nullptr);
-        this->out_queue_semaphore.signal();    
     }
 
     // return stream url
@@ -115,12 +115,7 @@ namespace vp_nodes {
                 this->out_queue.push(out_meta);
 
                 // handled hooker activated if need
-                if (this->meta_handled_hooker) {
-                    meta_handled_hooker(node_name, out_queue.size(), out_meta);
-                }
-
-                // important! notify consumer of out_queue in case it is waiting.
-                this->out_queue_semaphore.signal();
+                invoke_meta_handled_hooker(node_name, out_queue.size(), out_meta);
                 VP_DEBUG(vp_utils::string_format("[%s] after handling meta, out_queue.size()==>%d", node_name.c_str(), out_queue.size()));
             }
 
@@ -134,7 +129,6 @@ namespace vp_nodes {
 
         // send dead flag for dispatch_thread
         this->out_queue.push(nullptr);
-        this->out_queue_semaphore.signal();        
     }
 
     // return stream path
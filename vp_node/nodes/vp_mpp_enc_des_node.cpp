@@ -0,0 +1,87 @@
+#include "vp_mpp_enc_des_node.h"
+
+#include "vp_utils/logger/vp_logger.h"
+#include "vp_utils/vp_utils.h"
+
+namespace vp_nodes {
+
+vp_mpp_enc_des_node::vp_mpp_enc_des_node(std::string node_name,
+                                         int channel_index,
+                                         std::string out_url,
+                                         int bitrate,
+                                         bool h265,
+                                         bool osd,
+                                         bool use_rga)
+    : vp_des_node(node_name, channel_index),
+      out_url(std::move(out_url)),
+      osd(osd),
+      encoder(h265, bitrate, use_rga, node_name) {
+    // NV12 直接编码，BGR 输入由本节点自行转换。
+    this->frame_needs_bgr = false;
+    VP_INFO(vp_utils::string_format("[%s] url=%s codec=%s bitrate=%dkbps osd=%d",
+                                    this->node_name.c_str(),
+                                    this->out_url.c_str(),
+                                    h265 ? "h265" : "h264",
+                                    bitrate,
+                                    this->osd ? 1 : 0));
+    this->initialized();
+}
+
+vp_mpp_enc_des_node::~vp_mpp_enc_des_node() {
+    deinitialized();
+    if (muxer) {
+        muxer->close();
+        muxer.reset();
+    }
+}
+
+void vp_mpp_enc_des_node::mux_encoded(av_packet packet) {
+    if (!muxer) {
+        // 封装必须从关键帧开始。
+        if (!(packet->flags & AV_PKT_FLAG_KEY)) {
+            return;
+        }
+        muxer = FFmpeg::Enmuxer::createShared(encoder.codec_id(),
+                                              encoder.width(),
+                                              encoder.height(),
+                                              encoder.fps(),
+                                              encoder.header(),
+                                              out_url);
+        if (!muxer->open()) {
+            VP_ERROR(vp_utils::string_format("[%s] open muxer failed: %s", node_name.c_str(), out_url.c_str()));
+            muxer.reset();
+            return;
+        }
+        VP_INFO(vp_utils::string_format("[%s] muxer opened: %s", node_name.c_str(), out_url.c_str()));
+    }
+
+    if (!muxer->write_packet(packet)) {
+        // 推流断开等：关闭后请求 IDR，在下一帧关键帧重新打开。
+        VP_WARN(vp_utils::string_format("[%s] write packet failed, reopen at next key frame", node_name.c_str()));
+        muxer->close();
+        muxer.reset();
+        encoder.request_key_frame();
+    }
+}
+
+std::shared_ptr<vp_objects::vp_meta>
+vp_mpp_enc_des_node::handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
+    // 编码输出，无可用图像、尺寸不符或编码失败时为空。
+    auto packet = encoder.encode(meta, osd);
+    if (packet) {
+        mux_encoded(std::move(packet));
+    }
+
+    return vp_des_node::handle_frame_meta(meta);
+}
+
+std::shared_ptr<vp_objects::vp_meta>
+vp_mpp_enc_des_node::handle_control_meta(std::shared_ptr<vp_objects::vp_control_meta> meta) {
+    return vp_des_node::handle_control_meta(meta);
+}
+
+std::string vp_mpp_enc_des_node::to_string() {
+    return out_url;
+}
+
+} // namespace vp_nodes
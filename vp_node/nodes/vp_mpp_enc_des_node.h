@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "base/vp_des_node.h"
+#include "vp_utils/vp_mpp_frame_encoder.h"
+
+#include "Enmuxer.h"
+
+namespace vp_nodes {
+/**
+ * @brief 基于 MPP 硬件编码的输出终端节点。
+ *
+ * 直接把 NV12 帧（解码 DMA-buf 零拷贝导入，或紧凑 NV12/BGR 拷入编码输入缓冲）编码为 H.264/H.265，
+ * 再用 FFmpeg 封装为 MP4/FLV/MPEG-TS 写文件或推流，不经过 GStreamer 与 cv::VideoWriter。
+ * 编码分辨率由首帧决定，之后尺寸不一致的帧会被丢弃。
+ */
+class vp_mpp_enc_des_node : public vp_des_node {
+private:
+    // 输出地址：本地文件（.mp4/.flv/.ts）或推流地址（rtmp://、udp://、srt://）。
+    std::string out_url;
+    // 是否优先编码 OSD 叠加结果。
+    bool osd = true;
+
+    // MPP 编码器（输入选择、零拷贝导入、关键帧标记均在其中），首帧确定分辨率。
+    vp_utils::vp_mpp_frame_encoder encoder;
+    // 封装器，收到首个关键帧时打开。
+    std::shared_ptr<FFmpeg::Enmuxer> muxer;
+
+private:
+    /**
+     * @brief 把一帧编码输出写入封装器，必要时先打开封装器。
+     * @param packet 编码输出（pts 以 1/帧率 为单位）。
+     */
+    void mux_encoded(av_packet packet);
+
+protected:
+    /**
+     * @brief 编码并封装一帧。
+     * @param meta 输入帧元数据。
+     * @return std::shared_ptr<vp_objects::vp_meta> 始终返回 nullptr。
+     */
+    virtual std::shared_ptr<vp_objects::vp_meta> handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) override;
+
+    /**
+     * @brief 处理控制元数据。
+     * @param meta 控制元数据。
+     * @return std::shared_ptr<vp_objects::vp_meta> 始终返回 nullptr。
+     */
+    virtual std::shared_ptr<vp_objects::vp_meta> handle_control_meta(std::shared_ptr<vp_objects::vp_control_meta> meta) override;
+
+public:
+    /**
+     * @brief 构造 MPP 硬件编码输出节点。
+     * @param node_name 节点名称。
+     * @param channel_index 通道索引。
+     * @param out_url 输出文件路径或推流地址，封装格式按后缀/协议选择（默认 MP4）。
+     * @param bitrate 目标码率(kbps)。
+     * @param h265 是否编码为 H.265。
+     * @param osd 是否优先编码 OSD 叠加结果。
+     * @param use_rga BGR 输入转 NV12 时是否尝试 RGA。
+     */
+    vp_mpp_enc_des_node(std::string node_name,
+                        int channel_index,
+                        std::string out_url,
+                        int bitrate = 4096,
+                        bool h265 = false,
+                        bool osd = true,
+                        bool use_rga = false);
+
+    /**
+     * @brief 析构，写入封装尾并释放编码器。
+     */
+    ~vp_mpp_enc_des_node();
+
+    /**
+     * @brief 返回节点描述字符串。
+     * @return std::string 输出地址。
+     */
+    virtual std::string to_string() override;
+};
+
+} // namespace vp_nodes
@@ -6,13 +6,20 @@
 #include <unistd.h>
 
 #include "vp_utils/logger/vp_logger.h"
+#include "vp_utils/vp_frame_buffer_pool.h"
 #include "vp_utils/vp_utils.h"
 
 namespace vp_nodes {
 
 namespace {
-// MPP 输入分片大小，避免超大包一次性提交造成阻塞。
-constexpr size_t k_input_chunk_size = 4096;
+// decode_put_packet 等待解码器输入队列空位的超时(ms)。
+constexpr RK_S64 k_input_timeout_ms = 100;
+// decode_get_frame 等待解码帧的超时(ms)，也是取帧侧检查退出与送流状态的周期。
+constexpr RK_S64 k_output_timeout_ms = 100;
+// 输入全部提交后等待 EOS 帧的最长时间(us)。
+constexpr uint64_t k_eos_wait_us = 3000000;
+// 输入连续等待多少次超时打印一次阻塞告警（下游长期持有全部解码缓冲时）。
+constexpr int k_input_stall_log_interval = 50;
 
 /**
  * @brief 将 FFmpeg 错误码转换为可读字符串。
@@ -51,16 +58,19 @@ vp_mpp_sdl_src_node::vp_mpp_sdl_src_node(std::string node_name,
                                          int channel_index,
                                          std::string file_path,
                                          bool cycle,
-                                         bool pace_by_src_fps)
+                                         bool pace_by_src_fps,
+                                         bool zero_copy)
     : vp_src_node(node_name, channel_index, 1.0f),
       file_path(std::move(file_path)),
       cycle(cycle),
-      pace_by_src_fps(pace_by_src_fps) {
-    VP_INFO(vp_utils::string_format("[%s] file=%s cycle=%d pace=%d decode_only=1 nv12_output=1",
+      pace_by_src_fps(pace_by_src_fps),
+      zero_copy(zero_copy) {
+    VP_INFO(vp_utils::string_format("[%s] file=%s cycle=%d pace=%d zero_copy=%d decode_only=1 nv12_output=1",
                                     this->node_name.c_str(),
                                     this->file_path.c_str(),
                                     this->cycle ? 1 : 0,
-                                    this->pace_by_src_fps ? 1 : 0));
+                                    this->pace_by_src_fps ? 1 : 0,
+                                    this->zero_copy ? 1 : 0));
     this->initialized();
 }
 
@@ -167,6 +177,20 @@ bool vp_mpp_sdl_src_node::init_decoder() {
         return false;
     }
 
+    // 在 MPP 内部等待代替 usleep 轮询：输入队列一有空位、解码帧一就绪即返回。
+    RK_S64 timeout = k_input_timeout_ms;
+    ret = dec_mpi->control(dec_ctx, MPP_SET_INPUT_TIMEOUT, &timeout);
+    if (ret) {
+        VP_ERROR(vp_utils::string_format("[%s] MPP_SET_INPUT_TIMEOUT failed: %d", node_name.c_str(), ret));
+        return false;
+    }
+    timeout = k_output_timeout_ms;
+    ret = dec_mpi->control(dec_ctx, MPP_SET_OUTPUT_TIMEOUT, &timeout);
+    if (ret) {
+        VP_ERROR(vp_utils::string_format("[%s] MPP_SET_OUTPUT_TIMEOUT failed: %d", node_name.c_str(), ret));
+        return false;
+    }
+
     ret = mpp_init(dec_ctx, MPP_CTX_DEC, coding);
     if (ret) {
         VP_ERROR(vp_utils::string_format("[%s] mpp_init failed: %d", node_name.c_str(), ret));
@@ -260,8 +284,8 @@ bool vp_mpp_sdl_src_node::setup_info_change(MppFrame frame) {
     stride_v = static_cast<int>(mpp_frame_get_ver_stride(frame));
 
     if (!dec_frm_grp) {
-        // 创建内部 buffer group 返回值。
-        const MPP_RET group_ret = mpp_buffer_group_get_internal(&dec_frm_grp, MPP_BUFFER_TYPE_ION);
+        // 创建内部 buffer group 返回值（DRM 缓冲可直接导出 DMA-buf fd 给 RGA/RKNN）。
+        const MPP_RET group_ret = mpp_buffer_group_get_internal(&dec_frm_grp, MPP_BUFFER_TYPE_DRM);
         if (group_ret) {
             VP_ERROR(vp_utils::string_format("[%s] mpp_buffer_group_get_internal failed: %d", node_name.c_str(), group_ret));
             return false;
@@ -286,6 +310,36 @@ bool vp_mpp_sdl_src_node::setup_info_change(MppFrame frame) {
     return true;
 }
 
+std::shared_ptr<vp_objects::vp_dma_image> vp_mpp_sdl_src_node::wrap_dma_frame(MppFrame frame) {
+    // MPP buffer。
+    MppBuffer buffer = mpp_frame_get_buffer(frame);
+    if (!buffer) {
+        return nullptr;
+    }
+    // DMA-buf fd。
+    const int fd = mpp_buffer_get_fd(buffer);
+    // CPU 虚拟地址。
+    void* vir_addr = mpp_buffer_get_ptr(buffer);
+    if (fd < 0 || !vir_addr) {
+        return nullptr;
+    }
+
+    // 持有缓冲直到下游全部释放，mpp_frame_deinit 不会立即归还。
+    if (mpp_buffer_inc_ref(buffer)) {
+        return nullptr;
+    }
+    return std::make_shared<vp_objects::vp_dma_image>(
+        fd,
+        vir_addr,
+        mpp_buffer_get_size(buffer),
+        static_cast<int>(mpp_frame_get_width(frame)),
+        static_cast<int>(mpp_frame_get_height(frame)),
+        static_cast<int>(mpp_frame_get_hor_stride(frame)),
+        static_cast<int>(mpp_frame_get_ver_stride(frame)),
+        vp_objects::vp_dma_format::NV12,
+        [buffer]() { mpp_buffer_put(buffer); });
+}
+
 void vp_mpp_sdl_src_node::publish_nv12_frame_meta(MppFrame frame) {
     // MPP buffer。
     MppBuffer buffer = mpp_frame_get_buffer(frame);
@@ -312,8 +366,29 @@ void vp_mpp_sdl_src_node::publish_nv12_frame_meta(MppFrame frame) {
         return;
     }
 
-    // NV12 输出帧（按有效宽高组织，不带 stride padding）。
-    cv::Mat output_nv12(frame_height * 3 / 2, frame_width, CV_8UC1);
+    if (zero_copy) {
+        // 零拷贝 NV12 图像。
+        auto dma_frame = wrap_dma_frame(frame);
+        if (dma_frame) {
+            this->frame_index++;
+            // 下游输出 meta。
+            auto out_meta = std::make_shared<vp_objects::vp_frame_meta>(
+                dma_frame,
+                this->frame_index,
+                this->channel_index,
+                frame_width,
+                frame_height,
+                this->original_fps);
+
+            this->out_queue.push(out_meta);
+            invoke_meta_handled_hooker(node_name, out_queue.size(), out_meta);
+            return;
+        }
+        // 无法导出 fd 时退回拷贝路径。
+    }
+
+    // NV12 输出帧（按有效宽高组织，不带 stride padding），从帧缓冲池取得，下游释放后回收。
+    cv::Mat output_nv12 = vp_utils::vp_frame_buffer_pool::host().alloc(frame_height * 3 / 2, frame_width, CV_8UC1);
     if (output_nv12.empty()) {
         return;
     }
@@ -348,10 +423,7 @@ void vp_mpp_sdl_src_node::publish_nv12_frame_meta(MppFrame frame) {
         this->original_fps);
 
     this->out_queue.push(out_meta);
-    if (this->meta_handled_hooker) {
-        meta_handled_hooker(node_name, out_queue.size(), out_meta);
-    }
-    this->out_queue_semaphore.signal();
+    invoke_meta_handled_hooker(node_name, out_queue.size(), out_meta);
 }
 
 bool vp_mpp_sdl_src_node::process_decoded_frame(MppFrame frame, bool& got_eos) {
@@ -396,187 +468,121 @@ bool vp_mpp_sdl_src_node::process_decoded_frame(MppFrame frame, bool& got_eos) {
     return true;
 }
 
-bool vp_mpp_sdl_src_node::poll_decoder_frames(bool& got_eos) {
-    // 超时重试计数。
-    int timeout_retry = 20;
+bool vp_mpp_sdl_src_node::drain_decoder(bool& got_eos) {
+    // 送流结束后首次取帧超时的时间(us)，用于限制等待 EOS 帧的时长。
+    uint64_t eos_wait_start_us = 0;
     while (alive) {
         // 取出的解码帧。
         MppFrame frame = nullptr;
-        // MPP 返回值。
+        // MPP 返回值（阻塞至有帧或输出超时）。
         const MPP_RET ret = dec_mpi->decode_get_frame(dec_ctx, &frame);
-
-        if (ret == MPP_ERR_TIMEOUT) {
-            if (timeout_retry-- > 0) {
-                usleep(1000);
-                continue;
-            }
-            return true;
-        }
-        if (ret != MPP_OK) {
+        if (ret != MPP_OK && ret != MPP_ERR_TIMEOUT) {
             VP_ERROR(vp_utils::string_format("[%s] decode_get_frame failed: %d", node_name.c_str(), ret));
             return false;
         }
-        if (!frame) {
-            return true;
+
+        if (frame) {
+            // 当前帧处理结果。
+            const bool ok = process_decoded_frame(frame, got_eos);
+            mpp_frame_deinit(&frame);
+            if (!ok) {
+                return false;
+            }
+            if (got_eos) {
+                return true;
+            }
+            continue;
         }
 
-        // 当前帧处理结果。
-        const bool ok = process_decoded_frame(frame, got_eos);
-        mpp_frame_deinit(&frame);
-        if (!ok) {
+        // 超时无帧：检查送流线程状态。
+        if (feed_failed) {
             return false;
         }
+        if (feed_done) {
+            // 当前时间。
+            const uint64_t now = now_us();
+            if (eos_wait_start_us == 0) {
+                eos_wait_start_us = now;
+            } else if (now - eos_wait_start_us > k_eos_wait_us) {
+                VP_WARN(vp_utils::string_format("[%s] no eos frame from decoder, end of stream anyway", node_name.c_str()));
+                return true;
+            }
+        }
     }
 
     return true;
 }
 
-bool vp_mpp_sdl_src_node::put_dec_packet_retry(bool& got_eos) {
-    // 提交重试次数。
-    int retry = 2000;
-    while (retry-- > 0 && alive) {
-        // 提交 packet 返回值。
+bool vp_mpp_sdl_src_node::send_to_decoder(const AVPacket* packet, bool eos) {
+    // 整包提交，split_parse 由 MPP 自行切分帧边界。
+    mpp_packet_set_data(dec_pkt, packet ? packet->data : nullptr);
+    mpp_packet_set_pos(dec_pkt, packet ? packet->data : nullptr);
+    mpp_packet_set_size(dec_pkt, packet ? static_cast<size_t>(packet->size) : 0);
+    mpp_packet_set_length(dec_pkt, packet ? static_cast<size_t>(packet->size) : 0);
+    if (eos) {
+        mpp_packet_set_eos(dec_pkt);
+    } else {
+        mpp_packet_clr_eos(dec_pkt);
+    }
+
+    // 连续未被接收次数。
+    int stalls = 0;
+    while (alive && !feed_stop) {
+        // 提交 packet 返回值（输入队列满时在 MPP 内部等待至多 k_input_timeout_ms）。
         const MPP_RET ret = dec_mpi->decode_put_packet(dec_ctx, dec_pkt);
         if (ret == MPP_OK) {
             return true;
         }
-        if (!poll_decoder_frames(got_eos)) {
-            return false;
+        // 解码器在下游持有全部输出缓冲时会暂停，取帧侧释放后自然恢复，这里只需继续等待。
+        if (++stalls % k_input_stall_log_interval == 0) {
+            VP_WARN(vp_utils::string_format("[%s] decoder input stalled for %d timeouts, last ret=%d",
+                                            node_name.c_str(), stalls, ret));
         }
-        usleep(1000);
     }
-
-    // 主动退出时不视为错误，避免 Ctrl+C 产生误导性 timeout 日志。
-    if (!alive) {
-        return false;
-    }
-    VP_ERROR(vp_utils::string_format("[%s] decode_put_packet timeout", node_name.c_str()));
     return false;
 }
 
-bool vp_mpp_sdl_src_node::send_to_decoder(const AVPacket* packet, bool eos, bool& got_eos) {
-    // 输入数据首地址。
-    RK_U8* data = packet ? packet->data : nullptr;
-    // 输入总长度。
-    size_t total_size = packet ? static_cast<size_t>(packet->size) : 0;
-    // 当前偏移。
-    size_t offset = 0;
-
-    if (total_size == 0) {
-        mpp_packet_set_data(dec_pkt, nullptr);
-        mpp_packet_set_pos(dec_pkt, nullptr);
-        mpp_packet_set_size(dec_pkt, 0);
-        mpp_packet_set_length(dec_pkt, 0);
-        if (eos) {
-            mpp_packet_set_eos(dec_pkt);
-        } else {
-            mpp_packet_clr_eos(dec_pkt);
-        }
-        return put_dec_packet_retry(got_eos);
-    }
-
-    while (offset < total_size && alive) {
-        // 本次提交分片长度。
-        size_t chunk = total_size - offset;
-        if (chunk > k_input_chunk_size) {
-            chunk = k_input_chunk_size;
-        }
-
-        mpp_packet_set_data(dec_pkt, data + offset);
-        mpp_packet_set_pos(dec_pkt, data + offset);
-        mpp_packet_set_size(dec_pkt, chunk);
-        mpp_packet_set_length(dec_pkt, chunk);
-        if (eos && offset + chunk == total_size) {
-            mpp_packet_set_eos(dec_pkt);
-        } else {
-            mpp_packet_clr_eos(dec_pkt);
-        }
-
-        while (mpp_packet_get_length(dec_pkt) > 0 && alive) {
-            if (!put_dec_packet_retry(got_eos)) {
-                return false;
-            }
-        }
-
-        offset += chunk;
-    }
-
-    return true;
-}
-
-bool vp_mpp_sdl_src_node::run_pipeline_once() {
+void vp_mpp_sdl_src_node::feed_loop() {
     // 输入 packet。
     AVPacket* input_packet = av_packet_alloc();
     // 过滤后 packet。
     AVPacket* filtered_packet = av_packet_alloc();
-    // 是否拿到 eos。
-    bool got_eos = false;
-
-    if (!input_packet || !filtered_packet) {
-        if (input_packet) {
-            av_packet_free(&input_packet);
-        }
-        if (filtered_packet) {
-            av_packet_free(&filtered_packet);
-        }
+    // 送流结果。
+    bool ok = input_packet && filtered_packet;
+    if (!ok) {
         VP_ERROR(vp_utils::string_format("[%s] av_packet_alloc failed", node_name.c_str()));
-        return false;
     }
 
-    while (alive && av_read_frame(ifmt, input_packet) >= 0) {
+    while (ok && alive && !feed_stop && av_read_frame(ifmt, input_packet) >= 0) {
         if (input_packet->stream_index == video_index) {
             // bsf 输入返回值。
-            int ret = av_bsf_send_packet(ibsfc, input_packet);
+            const int ret = av_bsf_send_packet(ibsfc, input_packet);
             if (ret < 0) {
                 VP_ERROR(vp_utils::string_format("[%s] av_bsf_send_packet failed: %s",
                                                  node_name.c_str(), ff_err_to_string(ret).c_str()));
-                av_packet_unref(input_packet);
-                av_packet_free(&input_packet);
-                av_packet_free(&filtered_packet);
-                return false;
+                ok = false;
             }
 
             // bsf 输出返回值（初始化为 EAGAIN，避免短路时误判）。
             int receive_ret = AVERROR(EAGAIN);
-            while (alive && (receive_ret = av_bsf_receive_packet(ibsfc, filtered_packet)) >= 0) {
-                if (!send_to_decoder(filtered_packet, false, got_eos)) {
-                    av_packet_unref(filtered_packet);
-                    av_packet_unref(input_packet);
-                    av_packet_free(&input_packet);
-                    av_packet_free(&filtered_packet);
-                    return false;
-                }
-                if (!poll_decoder_frames(got_eos)) {
-                    av_packet_unref(filtered_packet);
-                    av_packet_unref(input_packet);
-                    av_packet_free(&input_packet);
-                    av_packet_free(&filtered_packet);
-                    return false;
-                }
+            while (ok && (receive_ret = av_bsf_receive_packet(ibsfc, filtered_packet)) >= 0) {
+                ok = send_to_decoder(filtered_packet, false);
                 av_packet_unref(filtered_packet);
             }
 
-            if (alive && receive_ret != AVERROR(EAGAIN) && receive_ret != AVERROR_EOF) {
+            if (ok && receive_ret != AVERROR(EAGAIN) && receive_ret != AVERROR_EOF) {
                 VP_ERROR(vp_utils::string_format("[%s] av_bsf_receive_packet failed: %s",
                                                  node_name.c_str(), ff_err_to_string(receive_ret).c_str()));
-                av_packet_unref(input_packet);
-                av_packet_free(&input_packet);
-                av_packet_free(&filtered_packet);
-                return false;
+                ok = false;
             }
         }
 
         av_packet_unref(input_packet);
     }
 
-    if (alive) {
-        if (av_bsf_send_packet(ibsfc, nullptr) < 0) {
-            av_packet_free(&input_packet);
-            av_packet_free(&filtered_packet);
-            return false;
-        }
-
-        while (alive) {
+    if (ok && alive && !feed_stop) {
+        ok = av_bsf_send_packet(ibsfc, nullptr) >= 0;
+        while (ok) {
             // bsf 输出返回值。
             const int ret = av_bsf_receive_packet(ibsfc, filtered_packet);
             if (ret == AVERROR_EOF || ret == AVERROR(EAGAIN)) {
@@ -585,38 +591,66 @@ bool vp_mpp_sdl_src_node::run_pipeline_once() {
             if (ret < 0) {
                 VP_ERROR(vp_utils::string_format("[%s] av_bsf_receive_packet(flush) failed: %s",
                                                  node_name.c_str(), ff_err_to_string(ret).c_str()));
-                av_packet_free(&input_packet);
-                av_packet_free(&filtered_packet);
-                return false;
-            }
-
-            if (!send_to_decoder(filtered_packet, false, got_eos) || !poll_decoder_frames(got_eos)) {
-                av_packet_unref(filtered_packet);
-                av_packet_free(&input_packet);
-                av_packet_free(&filtered_packet);
-                return false;
+                ok = false;
+                break;
             }
+            ok = send_to_decoder(filtered_packet, false);
             av_packet_unref(filtered_packet);
         }
 
-        if (!send_to_decoder(nullptr, true, got_eos)) {
-            av_packet_free(&input_packet);
-            av_packet_free(&filtered_packet);
-            return false;
-        }
-
-        for (int i = 0; i < 3000 && !got_eos && alive; ++i) {
-            if (!poll_decoder_frames(got_eos)) {
-                av_packet_free(&input_packet);
-                av_packet_free(&filtered_packet);
-                return false;
-            }
-            usleep(1000);
-        }
+        ok = ok && send_to_decoder(nullptr, true);
     }
 
     av_packet_free(&input_packet);
     av_packet_free(&filtered_packet);
+    // 主动退出时不视为错误。
+    feed_failed = !ok && alive && !feed_stop;
+    feed_done = true;
+}
+
+bool vp_mpp_sdl_src_node::run_pipeline_once() {
+    // 是否拿到 eos。
+    bool got_eos = false;
+
+    feed_done = false;
+    feed_failed = false;
+    feed_stop = false;
+    feed_thread = std::thread(&vp_mpp_sdl_src_node::feed_loop, this);
+
+    // 取帧结果。
+    const bool ok = drain_decoder(got_eos);
+
+    // 取帧侧提前结束时送流线程可能阻塞在输入等待里，最多一个输入超时后退出。
+    feed_stop = true;
+    feed_thread.join();
+    return ok && !feed_failed;
+}
+
+bool vp_mpp_sdl_src_node::rewind_stream() {
+    if (!ifmt || !ibsfc || !dec_ctx || !dec_mpi) {
+        return false;
+    }
+
+    // 视频流起始时间戳（未知时从 0 开始）。
+    const AVStream* video_stream = ifmt->streams[video_index];
+    const int64_t start_ts = video_stream->start_time != AV_NOPTS_VALUE ? video_stream->start_time : 0;
+    // seek 返回值（BACKWARD 保证落在起点之前最近的关键帧）。
+    const int ret = av_seek_frame(ifmt, video_index, start_ts, AVSEEK_FLAG_BACKWARD);
+    if (ret < 0) {
+        VP_WARN(vp_utils::string_format("[%s] av_seek_frame failed: %s",
+                                        node_name.c_str(), ff_err_to_string(ret).c_str()));
+        return false;
+    }
+    // 上一轮已送入 flush（nullptr），bsf 处于 EOF 状态，需清空后才能继续接收。
+    av_bsf_flush(ibsfc);
+
+    // 丢弃解码器内残留 packet/帧并清除 EOS，外部缓冲组保持绑定，下游仍持有的缓冲不受影响。
+    const MPP_RET mpp_ret = dec_mpi->reset(dec_ctx);
+    if (mpp_ret) {
+        VP_WARN(vp_utils::string_format("[%s] mpp reset failed: %d", node_name.c_str(), mpp_ret));
+        return false;
+    }
+    mpp_packet_clr_eos(dec_pkt);
     return true;
 }
 
@@ -651,47 +685,54 @@ void vp_mpp_sdl_src_node::cleanup() {
 }
 
 void vp_mpp_sdl_src_node::handle_run() {
+    // demux/解码资源是否已就绪（循环播放时跨轮复用）。
+    bool ready = false;
     while (alive) {
         gate.knock();
         if (!alive) {
             break;
         }
 
-        dec_frames = 0;
-        shown_frames = 0;
-        fps_start_us = 0;
-        fps_last_log_us = 0;
-        fps_last_log_frames = 0;
-        play_start_us = 0;
+        if (!ready) {
+            dec_frames = 0;
+            shown_frames = 0;
+            fps_start_us = 0;
+            fps_last_log_us = 0;
+            fps_last_log_frames = 0;
+            play_start_us = 0;
+
+            if (!init_demux() || !init_decoder()) {
+                cleanup();
+                VP_ERROR(vp_utils::string_format("[%s] init failed, retry in 1s", node_name.c_str()));
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+                continue;
+            }
+            ready = true;
 
-        if (!init_demux() || !init_decoder()) {
-            cleanup();
-            VP_ERROR(vp_utils::string_format("[%s] init failed, retry in 1s", node_name.c_str()));
-            std::this_thread::sleep_for(std::chrono::seconds(1));
-            continue;
+            vp_stream_info stream_info{channel_index, original_fps, original_width, original_height, to_string()};
+            invoke_stream_info_hooker(node_name, stream_info);
         }
 
-        vp_stream_info stream_info{channel_index, original_fps, original_width, original_height, to_string()};
-        invoke_stream_info_hooker(node_name, stream_info);
-
         const bool ok = run_pipeline_once();
+        loop_count++;
+        // 统计跨轮累计，节奏基准也不重置，回绕后按原帧间隔无缝衔接。
         const uint64_t elapsed_us = (fps_start_us && dec_frames > 0) ? (now_us() - fps_start_us) : 0;
         const double avg_fps = elapsed_us ? (static_cast<double>(dec_frames) * 1000000.0 / static_cast<double>(elapsed_us)) : 0.0;
-        VP_INFO(vp_utils::string_format("[%s] run done ok=%d frames=%u avg_fps=%.2f",
-                                        node_name.c_str(), ok ? 1 : 0, dec_frames, avg_fps));
-
-        cleanup();
+        VP_INFO(vp_utils::string_format("[%s] run done ok=%d loop=%u frames=%u avg_fps=%.2f",
+                                        node_name.c_str(), ok ? 1 : 0, loop_count, dec_frames, avg_fps));
 
-        if (!alive) {
+        if (!alive || !cycle) {
             break;
         }
-        if (!cycle) {
-            break;
+        // 正常到达文件尾时原地回绕；出错或回绕失败才整体重建。
+        if (!ok || !rewind_stream()) {
+            cleanup();
+            ready = false;
         }
     }
 
+    cleanup();
     this->out_queue.push(nullptr);
-    this->out_queue_semaphore.signal();
 }
 
 std::string vp_mpp_sdl_src_node::to_string() {
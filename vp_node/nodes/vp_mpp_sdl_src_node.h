@@ -1,10 +1,13 @@
 #pragma once
 
+#include <atomic>
 #include <string>
+#include <thread>
 
 #include <opencv2/core/core.hpp>
 
 #include "base/vp_src_node.h"
+#include "objects/vp_dma_image.h"
 
 extern "C" {
 #include <libavcodec/bsf.h>
@@ -30,6 +33,8 @@ private:
     bool cycle = true;
     // 是否按源视频 FPS 节奏显示。
     bool pace_by_src_fps = false;
+    // 是否零拷贝下发 MPP 输出缓冲（DMA-buf），否则拷贝为紧凑 NV12。
+    bool zero_copy = true;
 
     // FFmpeg demux 上下文。
     AVFormatContext* ifmt = nullptr;
@@ -73,6 +78,17 @@ private:
     uint64_t fps_last_log_us = 0;
     // 上次打印 FPS 时帧计数。
     uint32_t fps_last_log_frames = 0;
+    // 已完成的播放轮数（循环播放时每到文件尾加一）。
+    uint32_t loop_count = 0;
+
+    // 送流线程：demux + bsf 后整包提交给解码器，输入队列满时阻塞在 MPP 内部。
+    std::thread feed_thread;
+    // 送流线程已结束（含 EOS 已提交或出错）。
+    std::atomic<bool> feed_done{false};
+    // 送流线程因错误结束。
+    std::atomic<bool> feed_failed{false};
+    // 通知送流线程提前退出（取帧侧出错时）。
+    std::atomic<bool> feed_stop{false};
 
 private:
     /**
@@ -120,6 +136,15 @@ private:
      */
     void publish_nv12_frame_meta(MppFrame frame);
 
+    /**
+     * @brief 引用 MPP 输出缓冲构造 DMA-buf 图像，不拷贝像素。
+     *
+     * 缓冲引用计数加一，图像最后一个持有者释放时归还给解码器。
+     * @param frame MPP 输出帧。
+     * @return std::shared_ptr<vp_objects::vp_dma_image> DMA-buf 图像，失败返回空。
+     */
+    std::shared_ptr<vp_objects::vp_dma_image> wrap_dma_frame(MppFrame frame);
+
     /**
      * @brief 处理单帧 decode 输出。
      * @param frame MPP 输出帧。
@@ -129,34 +154,39 @@ private:
     bool process_decoded_frame(MppFrame frame, bool& got_eos);
 
     /**
-     * @brief 拉取并处理解码器输出帧。
+     * @brief 阻塞取帧直到 EOS：有解码帧即返回，无帧时按输出超时醒来检查送流状态。
      * @param got_eos 是否收到 EOS。
      * @return true 成功；false 失败。
      */
-    bool poll_decoder_frames(bool& got_eos);
+    bool drain_decoder(bool& got_eos);
 
     /**
-     * @brief 重试向解码器提交 packet。
-     * @param got_eos 是否收到 EOS。
-     * @return true 成功；false 失败。
+     * @brief 把整个码流 packet 提交到解码器，输入队列满时在 MPP 内部等待。
+     * @param packet 输入 packet，可为空表示 flush。
+     * @param eos 当前 packet 是否为 EOS。
+     * @return true 成功；false 失败或被要求退出。
      */
-    bool put_dec_packet_retry(bool& got_eos);
+    bool send_to_decoder(const AVPacket* packet, bool eos);
 
     /**
-     * @brief 把码流 packet 发送到解码器。
-     * @param packet 输入 packet，可为空表示 flush。
-     * @param eos 当前 packet 是否为 EOS。
-     * @param got_eos 是否收到 EOS。
-     * @return true 成功；false 失败。
+     * @brief 送流线程主体：读完整个文件并提交 EOS。
      */
-    bool send_to_decoder(const AVPacket* packet, bool eos, bool& got_eos);
+    void feed_loop();
 
     /**
-     * @brief 执行一次完整 demux+decode 流程。
+     * @brief 执行一次完整 demux+decode 流程（送流线程提交 packet，当前线程取帧）。
      * @return true 成功；false 失败。
      */
     bool run_pipeline_once();
 
+    /**
+     * @brief 文件播放结束后回到起点，保留 demux/bsf/MPP 上下文与输出缓冲组。
+     *
+     * demux seek 到首个关键帧，flush bsf，并 reset MPP 解码器清空 EOS 状态与残留帧。
+     * @return true 回绕成功；false 失败（调用方需重建全部资源）。
+     */
+    bool rewind_stream();
+
     /**
      * @brief 释放 FFmpeg/MPP 资源。
      */
@@ -176,12 +206,14 @@ public:
      * @param file_path 输入 MP4 路径。
      * @param cycle 是否循环播放。
      * @param pace_by_src_fps 是否按源 FPS 节奏播放。
+     * @param zero_copy 是否零拷贝下发 MPP 输出缓冲（下游持有帧期间占用解码缓冲）。
      */
     vp_mpp_sdl_src_node(std::string node_name,
                         int channel_index,
                         std::string file_path,
                         bool cycle = true,
-                        bool pace_by_src_fps = false);
+                        bool pace_by_src_fps = false,
+                        bool zero_copy = true);
 
     /**
      * @brief 析构并释放资源。
@@ -28,6 +28,10 @@ vp_nv12_sdl_des_node::vp_nv12_sdl_des_node(std::string node_name,
       sdl_video_driver(std::move(sdl_video_driver)),
       sdl_render_driver(std::move(sdl_render_driver)),
       fullscreen(fullscreen) {
+    // 显示节点输入队列上限为 4，超出后丢弃新帧，避免显示端背压拖慢上游。
+    this->set_in_queue_policy(vp_queue_policy::DROP_NEWEST, 4);
+    // 直接显示 NV12，不需要 BGR。
+    this->frame_needs_bgr = false;
     this->initialized();
 }
 
@@ -180,43 +184,6 @@ void vp_nv12_sdl_des_node::pump_sdl_events() {
     }
 }
 
-void vp_nv12_sdl_des_node::meta_flow(std::shared_ptr<vp_objects::vp_meta> meta) {
-    if (meta == nullptr) {
-        return;
-    }
-
-    std::lock_guard<std::mutex> guard(this->in_queue_lock);
-    const bool queue_full = this->in_queue.size() >= this->max_in_queue_size;
-    const bool is_frame_meta = meta->meta_type == vp_objects::vp_meta_type::FRAME;
-    if (queue_full && is_frame_meta) {
-        this->dropped_frames++;
-        // 每秒打印一次丢帧统计，避免日志刷屏。
-        const auto now_tp = std::chrono::steady_clock::now();
-        if (this->dropped_log_tp.time_since_epoch().count() == 0) {
-            this->dropped_log_tp = now_tp;
-            this->dropped_frames_last_log = this->dropped_frames;
-        } else {
-            const auto delta_ms =
-                std::chrono::duration_cast<std::chrono::milliseconds>(now_tp - this->dropped_log_tp).count();
-            if (delta_ms >= 1000) {
-                const uint64_t dropped_delta = this->dropped_frames - this->dropped_frames_last_log;
-                VP_WARN(vp_utils::string_format("[%s] drop_frame backlog=%zu dropped=%llu(+%llu/s)",
-                                                this->node_name.c_str(),
-                                                this->in_queue.size(),
-                                                static_cast<unsigned long long>(this->dropped_frames),
-                                                static_cast<unsigned long long>(dropped_delta)));
-                this->dropped_log_tp = now_tp;
-                this->dropped_frames_last_log = this->dropped_frames;
-            }
-        }
-        return;
-    }
-
-    this->in_queue.push(meta);
-    invoke_meta_arriving_hooker(this->node_name, this->in_queue.size(), meta);
-    this->in_queue_semaphore.signal();
-}
-
 void vp_nv12_sdl_des_node::release_sdl() {
     if (sdl_texture != nullptr) {
         SDL_DestroyTexture(sdl_texture);
@@ -238,23 +205,44 @@ void vp_nv12_sdl_des_node::release_sdl() {
 
 std::shared_ptr<vp_objects::vp_meta>
 vp_nv12_sdl_des_node::handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_meta> meta) {
-    // 输入 NV12 帧。
-    cv::Mat& frame = meta->frame;
+    // 输入 NV12 帧（其他分支按需转换的 BGR 另存于 meta，frame 不会被原地改写）。
+    const cv::Mat& frame = meta->frame;
+    // DMA-buf NV12 帧（来自硬解码零拷贝输出，可为空）。
+    const auto& dma_frame = meta->dma_frame;
 
     // NV12 宽度。
-    const int frame_width = frame.cols;
-    // NV12 总行数（Y + UV）。
-    const int frame_rows = frame.rows;
+    int frame_width = frame.cols;
     // NV12 高度。
-    const int frame_height = frame_rows * 2 / 3;
-
-    // 基础格式校验。
-    const bool valid_type = (frame.type() == CV_8UC1);
-    const bool valid_size = (frame_rows > 0 && frame_width > 0 && frame_rows == frame_height * 3 / 2);
-    if (!valid_type || !valid_size) {
-        VP_WARN(vp_utils::string_format("[%s] invalid nv12 frame: type=%d size=%dx%d",
-                                        node_name.c_str(), frame.type(), frame.cols, frame.rows));
-        return vp_des_node::handle_frame_meta(meta);
+    int frame_height = frame.rows * 2 / 3;
+    // NV12 的 Y 面起始地址。
+    const uint8_t* y_plane = nullptr;
+    // NV12 的 UV 面起始地址。
+    const uint8_t* uv_plane = nullptr;
+    // 行跨度（字节）。
+    int pitch = frame.cols;
+
+    if (dma_frame != nullptr && dma_frame->format == vp_objects::vp_dma_format::NV12 && dma_frame->vir_addr != nullptr) {
+        // 直接按 stride 从解码缓冲上传纹理，不经过紧凑拷贝。
+        frame_width = dma_frame->width;
+        frame_height = dma_frame->height;
+        pitch = dma_frame->hor_stride;
+        y_plane = static_cast<const uint8_t*>(dma_frame->vir_addr);
+        uv_plane = y_plane + static_cast<size_t>(dma_frame->hor_stride) * static_cast<size_t>(dma_frame->ver_stride);
+    } else {
+        // NV12 总行数（Y + UV）。
+        const int frame_rows = frame.rows;
+
+        // 基础格式校验。
+        const bool valid_type = (frame.type() == CV_8UC1);
+        const bool valid_size = (frame_rows > 0 && frame_width > 0 && frame_rows == frame_height * 3 / 2);
+        if (!valid_type || !valid_size) {
+            VP_WARN(vp_utils::string_format("[%s] invalid nv12 frame: type=%d size=%dx%d",
+                                            node_name.c_str(), frame.type(), frame.cols, frame.rows));
+            return vp_des_node::handle_frame_meta(meta);
+        }
+        pitch = static_cast<int>(frame.step[0]);
+        y_plane = frame.ptr<uint8_t>(0);
+        uv_plane = frame.ptr<uint8_t>(frame_height);
     }
 
     if (!sdl_inited) {
@@ -274,18 +262,13 @@ vp_nv12_sdl_des_node::handle_frame_meta(std::shared_ptr<vp_objects::vp_frame_met
         return vp_des_node::handle_frame_meta(meta);
     }
 
-    // NV12 的 Y 面起始地址。
-    const uint8_t* y_plane = frame.ptr<uint8_t>(0);
-    // NV12 的 UV 面起始地址。
-    const uint8_t* uv_plane = frame.ptr<uint8_t>(frame_height);
-
     // 直接按 NV12 两平面更新纹理，减少 lock/unlock 额外开销。
     const int update_ret = SDL_UpdateNVTexture(sdl_texture,
                                                nullptr,
                                                y_plane,
-                                               frame_width,
+                                               pitch,
                                                uv_plane,
-                                               frame_width);
+                                               pitch);
     if (update_ret != 0) {
         VP_WARN(vp_utils::string_format("[%s] SDL_UpdateNVTexture failed: %s", node_name.c_str(), SDL_GetError()));
         return vp_des_node::handle_frame_meta(meta);
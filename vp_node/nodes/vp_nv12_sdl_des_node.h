@@ -47,14 +47,6 @@ private:
     int texture_width = 0;
     // 当前纹理高度。
     int texture_height = 0;
-    // 显示节点输入队列上限，超出后丢弃新帧，避免显示端背压。
-    size_t max_in_queue_size = 4;
-    // 累计丢帧计数。
-    uint64_t dropped_frames = 0;
-    // 上次打印丢帧计数快照。
-    uint64_t dropped_frames_last_log = 0;
-    // 上次打印丢帧日志时间点。
-    std::chrono::steady_clock::time_point dropped_log_tp;
 
 private:
     /**
@@ -86,13 +78,6 @@ private:
     void release_sdl();
 
 protected:
-    /**
-     * @brief 接收上游元数据并在拥塞时执行丢帧保护。
-     *
-     * @param meta 上游传入的元数据。
-     */
-    virtual void meta_flow(std::shared_ptr<vp_objects::vp_meta> meta) override;
-
     /**
      * @brief 处理视频帧元数据并进行 NV12 直显。
      *
@@ -5,10 +5,11 @@
 namespace vp_nodes {
 
 /**
- * @brief 将 `vp_frame_meta.frame` 从 NV12 转换为 BGR 的中间节点。
+ * @brief 将 `vp_frame_meta` 的 NV12 图像转换为 BGR 的中间节点。
  *
- * 该节点用于在“硬解码输出 NV12”与“下游算法节点默认消费 BGR”之间做格式适配，
- * 仅改写 `meta->frame`，不改变目标框、控制信息等业务字段。
+ * 需要 BGR 的节点本身会通过 vp_frame_meta::ensure_bgr() 按需转换，该节点只用于显式固定转换位置
+ * （例如把转换开销放在独立线程上）。BGR 缓存在 meta 中，通过 `meta->bgr_frame()` 读取，
+ * `meta->frame` 保持原生 NV12 不变，也不改变目标框、控制信息等业务字段。
  */
 class vp_nv12_to_bgr_node : public vp_node {
 protected:
@@ -4,6 +4,7 @@
 
 #include "vp_rk_rtsp_src_node.h"
 #include "vp_utils/vp_utils.h"
+#include "vp_utils/vp_frame_buffer_pool.h"
 
 #include "im2d.h"
 #include "RgaUtils.h"
@@ -25,13 +26,16 @@ namespace vp_nodes {
             VP_INFO(vp_utils::string_format("[%s] Init Demuxer or Decoder failed!", node_name.c_str()));
             exit(0);
         }
+        // live stream can not wait for slow nodes, drop the oldest frame instead of blocking the receiving thread.
+        this->set_out_queue_policy(vp_queue_policy::DROP_OLDEST, 16);
         this->initialized();
     }
     
     vp_rk_rtsp_src_node::~vp_rk_rtsp_src_node() {
         deinitialized();
         // m_demux.reset();
-        // m_decoder.reset();
+        // stop the decoder's frame thread before members it calls back into go away
+        m_decoder.reset();
     }
     
     // define how to read video from rtsp stream, create frame meta etc.
@@ -52,7 +56,6 @@ namespace vp_nodes {
         }
         // send dead flag for dispatch_thread
         this->out_queue.push(nullptr);
-        this->out_queue_semaphore.signal();    
     }
 
     // return stream url
@@ -91,29 +94,28 @@ namespace vp_nodes {
                 ctx->step = 0;
                 // cv::Mat frame(height*3/2, width, CV_8UC1, data);
 
-                void *img_buf = nullptr;
-                img_buf = malloc(width * height * 3);
-                memset(img_buf, 0x00, width * height * 3);
+                // recycled buffer from pool, RGA overwrites every pixel so no memset needed.
+                // the meta owns it directly, so no clone as well.
+                cv::Mat frame = vp_utils::vp_frame_buffer_pool::host().alloc(height, width, CV_8UC3);
                 rga_buffer_t src;
                 rga_buffer_t dst;
                 
                 src = wrapbuffer_virtualaddr((void*)data, width, height, RK_FORMAT_YCbCr_420_SP, width_stride, height_stride);
-                dst = wrapbuffer_virtualaddr((void*)img_buf, width, height, RK_FORMAT_BGR_888);
+                dst = wrapbuffer_virtualaddr((void*)frame.data, width, height, RK_FORMAT_BGR_888);
                 IM_STATUS STATUS = imcvtcolor(src, dst, RK_FORMAT_YCbCr_420_SP, RK_FORMAT_BGR_888);
                 if (STATUS != IM_STATUS_SUCCESS){
                     VP_ERROR(vp_utils::string_format("[%s] Convert RGB failed!", ctx->node_name.c_str()));
-                    if (img_buf) free(img_buf); 
                     return;
                 }
-                cv::Mat frame(height, width, CV_8UC3, img_buf);
                 
                 cv::Mat resize_frame;
                 ctx->frame_index++;
                 if (ctx->resize_ratio != 1.0) {
-                    cv::resize(frame, resize_frame, cv::Size(), ctx->resize_ratio, ctx->resize_ratio);
+                    resize_frame = vp_utils::vp_frame_buffer_pool::host().alloc(cvRound(height * ctx->resize_ratio), cvRound(width * ctx->resize_ratio), CV_8UC3);
+                    cv::resize(frame, resize_frame, resize_frame.size());
                 }
                 else {
-                    resize_frame = frame.clone(); // clone!;
+                    resize_frame = frame;
                 }
 
                 auto out_meta = 
@@ -121,14 +123,9 @@ namespace vp_nodes {
                 if (out_meta != nullptr) {
                     ctx->out_queue.push(out_meta);
                     // handled hooker activated if need
-                    if (ctx->meta_handled_hooker) {
-                        ctx->meta_handled_hooker(ctx->node_name, ctx->out_queue.size(), out_meta);
-                    }
-                    // important! notify consumer of out_queue in case it is waiting.
-                    ctx->out_queue_semaphore.signal();
+                    ctx->invoke_meta_handled_hooker(ctx->node_name, ctx->out_queue.size(), out_meta);
                     VP_DEBUG(vp_utils::string_format("[%s] after handling meta, out_queue.size()==>%d", ctx->node_name.c_str(), ctx->out_queue.size()));
                 }
-                if (img_buf) free(img_buf);
                 auto end = std::chrono::steady_clock::now();
                 int dur = std::chrono::duration<double, std::milli>(end - start).count();
                 // VP_INFO(vp_utils::string_format("[%s] Frame index: [%d], Callback [%d] ms", ctx->node_name.c_str(), ctx->frame_index, dur));
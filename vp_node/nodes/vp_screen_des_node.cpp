@@ -54,10 +54,10 @@ namespace vp_nodes {
             
             cv::Mat resize_frame;
             if (this->display_w_h.width != 0 && this->display_w_h.height != 0) {                 
-                cv::resize((osd && !meta->osd_frame.empty()) ? meta->osd_frame : meta->frame, resize_frame, cv::Size(display_w_h.width, display_w_h.height));
+                cv::resize((osd && !meta->osd_frame.empty()) ? meta->osd_frame : meta->bgr_frame(), resize_frame, cv::Size(display_w_h.width, display_w_h.height));
             }
             else {
-                resize_frame = (osd && !meta->osd_frame.empty()) ? meta->osd_frame : meta->frame;
+                resize_frame = (osd && !meta->osd_frame.empty()) ? meta->osd_frame : meta->bgr_frame();
             }
 
             if (use_opencv_window) {
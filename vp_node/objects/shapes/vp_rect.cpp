@@ -22,7 +22,7 @@ namespace vp_objects {
 
     }
     
-    vp_point vp_rect::center() {
+    vp_point vp_rect::center() const {
         return vp_point(x + width / 2, y + height / 2);
     }
 
@@ -34,7 +34,7 @@ namespace vp_objects {
         return true;
     }
 
-    vp_point vp_rect::track_point() {
+    vp_point vp_rect::track_point() const {
         // by default the center point of bottom is tracking point.
         return {x + width / 2, y + height};
     }
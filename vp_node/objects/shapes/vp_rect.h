@@ -22,11 +22,11 @@ namespace vp_objects {
         int height;
 
         // get center point of the rect
-        vp_point center();
+        vp_point center() const;
 
         // get track point of the rect
         // track point is used to locate the target(represented by the rect)
-        vp_point track_point();
+        vp_point track_point() const;
 
         // calculate the iou with another rect
         float iou_with(const vp_rect & rect);
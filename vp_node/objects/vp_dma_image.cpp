@@ -0,0 +1,74 @@
+#include "vp_dma_image.h"
+
+#include <cstring>
+
+namespace vp_objects {
+
+vp_dma_image::vp_dma_image(int fd,
+                           void* vir_addr,
+                           size_t size,
+                           int width,
+                           int height,
+                           int hor_stride,
+                           int ver_stride,
+                           vp_dma_format format,
+                           std::function<void()> releaser)
+    : releaser(std::move(releaser)),
+      fd(fd),
+      vir_addr(vir_addr),
+      size(size),
+      width(width),
+      height(height),
+      hor_stride(hor_stride),
+      ver_stride(ver_stride),
+      format(format) {
+}
+
+vp_dma_image::~vp_dma_image() {
+    if (releaser) {
+        releaser();
+    }
+}
+
+bool vp_dma_image::has_compact_view() const {
+    if (vir_addr == nullptr) {
+        return false;
+    }
+    if (format == vp_dma_format::NV12) {
+        // UV 平面紧跟在有效行之后才能用单个 Mat 描述。
+        return ver_stride == height;
+    }
+    return true;
+}
+
+cv::Mat vp_dma_image::to_mat() const {
+    if (vir_addr == nullptr || width <= 0 || height <= 0) {
+        return cv::Mat();
+    }
+
+    auto* base = static_cast<uint8_t*>(vir_addr);
+    if (format != vp_dma_format::NV12) {
+        // 打包 RGB/BGR 行步长（字节）。
+        const size_t step = static_cast<size_t>(hor_stride) * 3U;
+        return cv::Mat(height, width, CV_8UC3, base, step);
+    }
+
+    // NV12 行步长（字节）。
+    const size_t step = static_cast<size_t>(hor_stride);
+    if (has_compact_view()) {
+        return cv::Mat(height * 3 / 2, width, CV_8UC1, base, step);
+    }
+
+    // UV 平面前有对齐填充行，拷贝出紧凑 NV12。
+    cv::Mat compact(height * 3 / 2, width, CV_8UC1);
+    // UV 平面起始地址。
+    const uint8_t* uv_plane = base + step * static_cast<size_t>(ver_stride);
+    for (int row = 0; row < height; ++row) {
+        std::memcpy(compact.ptr<uint8_t>(row), base + step * static_cast<size_t>(row), static_cast<size_t>(width));
+    }
+    for (int row = 0; row < height / 2; ++row) {
+        std::memcpy(compact.ptr<uint8_t>(height + row), uv_plane + step * static_cast<size_t>(row), static_cast<size_t>(width));
+    }
+    return compact;
+}
+}  // namespace vp_objects
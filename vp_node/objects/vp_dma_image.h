@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include <opencv2/core/core.hpp>
+
+namespace vp_objects {
+/**
+ * @brief DMA-buf 图像的像素格式。
+ */
+enum class vp_dma_format {
+    NV12,    // YUV420SP，Y 平面后紧跟交错 UV 平面（UV 平面起始于 hor_stride * ver_stride）。
+    RGB888,  // 打包 RGB，每像素 3 字节。
+    BGR888   // 打包 BGR，每像素 3 字节。
+};
+
+/**
+ * @brief DMA-buf 承载的图像（如 MPP 解码输出、RGA 输出）。
+ *
+ * 只记录 fd、虚拟地址与 stride 信息，不拷贝像素；底层缓冲由构造时传入的 releaser 在析构时归还
+ * （例如 mpp_buffer_put、dma_buf_free 或放回缓冲池）。对象不可拷贝，通过 shared_ptr 在 meta 间共享，
+ * 最后一个持有者释放时缓冲才被归还。
+ */
+class vp_dma_image {
+private:
+    // 析构时调用的释放函数。
+    std::function<void()> releaser;
+
+public:
+    /**
+     * @brief 构造 DMA-buf 图像描述。
+     *
+     * @param fd DMA-buf 文件描述符。
+     * @param vir_addr CPU 可访问的虚拟地址（可为空，表示仅设备可访问）。
+     * @param size 缓冲总字节数。
+     * @param width 有效宽度。
+     * @param height 有效高度。
+     * @param hor_stride 水平 stride（像素）。
+     * @param ver_stride 垂直 stride（行）。
+     * @param format 像素格式。
+     * @param releaser 析构时调用的释放函数。
+     */
+    vp_dma_image(int fd,
+                 void* vir_addr,
+                 size_t size,
+                 int width,
+                 int height,
+                 int hor_stride,
+                 int ver_stride,
+                 vp_dma_format format,
+                 std::function<void()> releaser = nullptr);
+
+    /**
+     * @brief 析构并归还底层缓冲。
+     */
+    ~vp_dma_image();
+
+    vp_dma_image(const vp_dma_image&) = delete;
+    vp_dma_image& operator=(const vp_dma_image&) = delete;
+
+    // DMA-buf 文件描述符。
+    const int fd;
+    // CPU 虚拟地址。
+    void* const vir_addr;
+    // 缓冲总字节数。
+    const size_t size;
+    // 有效宽度。
+    const int width;
+    // 有效高度。
+    const int height;
+    // 水平 stride（像素）。
+    const int hor_stride;
+    // 垂直 stride（行）。
+    const int ver_stride;
+    // 像素格式。
+    const vp_dma_format format;
+
+    /**
+     * @brief 判断 CPU 视图是否可直接作为紧凑 NV12 Mat 使用（UV 平面紧跟有效行之后）。
+     *
+     * @return true 可零拷贝包装为 cv::Mat；false 需要拷贝。
+     */
+    bool has_compact_view() const;
+
+    /**
+     * @brief 生成 CPU 视图。
+     *
+     * NV12 返回 (height*3/2) x width 的 CV_8UC1，RGB/BGR 返回 height x width 的 CV_8UC3，行步长为 stride。
+     * 仅在 has_compact_view() 为 true 时不拷贝，否则逐行拷贝出紧凑图像。
+     *
+     * @return cv::Mat CPU 图像，失败返回空 Mat。
+     */
+    cv::Mat to_mat() const;
+};
+}  // namespace vp_objects
@@ -3,6 +3,7 @@
 #include <vector>
 #include <memory>
 #include "shapes/vp_rect.h"
+#include "vp_track_history.h"
 
 
 namespace vp_objects {
@@ -45,7 +46,8 @@ namespace vp_objects {
         int track_id = -1;
         // cache of track rects in the previous frames, filled by track node if it exists. 
         // we can draw / analyse depend on these track rects later.
-        std::vector<vp_objects::vp_rect> tracks;
+        // it is shared with the track node and other clones, not copied.
+        vp_objects::vp_track_history tracks;
         
         // clone myself
         std::shared_ptr<vp_frame_face_target> clone();
@@ -1,6 +1,7 @@
 #include <iterator>
 
 #include "vp_frame_meta.h"
+#include "vp_utils/vp_color_convert.h"
 
 namespace vp_objects {
         
@@ -13,6 +14,20 @@ namespace vp_objects {
         frame(frame) {
             assert(!frame.empty());
     }
+
+    vp_frame_meta::vp_frame_meta(std::shared_ptr<vp_dma_image> dma_frame, int frame_index, int channel_index, int original_width, int original_height, int fps): 
+        vp_meta(vp_meta_type::FRAME, channel_index), 
+        frame_index(frame_index), 
+        original_width(original_width),
+        original_height(original_height),
+        fps(fps),
+        dma_frame(dma_frame) {
+            assert(dma_frame != nullptr);
+            // wrap without copy if layout allows, or readers take dma_frame.
+            if (dma_frame->has_compact_view()) {
+                frame = dma_frame->to_mat();
+            }
+    }
     
     // copy constructor of vp_frame_meta would NOT be called at most time.
     // only when it flow through vp_split_node with vp_split_node::split_with_deep_copy==true.
@@ -23,12 +38,18 @@ namespace vp_objects {
         original_width(meta.original_width),
         original_height(meta.original_height),
         fps(meta.fps),
+        dma_frame(meta.dma_frame),
+        yolo26_input_dma(meta.yolo26_input_dma),
         yolo26_input_rgb_data(meta.yolo26_input_rgb_data),
         yolo26_input_ready(meta.yolo26_input_ready),
         yolo26_input_width(meta.yolo26_input_width),
         yolo26_input_height(meta.yolo26_input_height) {
             // deep copy frame data
             this->frame = meta.frame.clone();
+            {
+                std::lock_guard<std::mutex> guard(meta.frame_lock);
+                this->bgr_cache = meta.bgr_cache.clone();
+            }
             this->osd_frame = meta.osd_frame.clone();
             this->mask = meta.mask.clone();
 
@@ -63,6 +84,54 @@ namespace vp_objects {
         return std::make_shared<vp_frame_meta>(*this);
     }
 
+    bool vp_frame_meta::ensure_bgr() {
+        if (!frame.empty() && frame.type() == CV_8UC3) {
+            return true;
+        }
+        // held during conversion, so branches sharing the meta convert only once
+        std::lock_guard<std::mutex> guard(frame_lock);
+        if (!bgr_cache.empty()) {
+            return true;
+        }
+
+        cv::Mat bgr;
+        auto ok = false;
+        if (dma_frame != nullptr && dma_frame->format == vp_dma_format::NV12) {
+            // convert from the hardware buffer directly, padded strides are fine here
+            ok = vp_utils::nv12_to_bgr(dma_frame->fd, dma_frame->vir_addr, dma_frame->size, dma_frame->width, dma_frame->height, 
+                                        dma_frame->hor_stride, dma_frame->ver_stride, bgr);
+        }
+        else if (!frame.empty() && frame.type() == CV_8UC1) {
+            ok = vp_utils::nv12_to_bgr(frame, bgr);
+        }
+        if (!ok) {
+            return false;
+        }
+        bgr_cache = bgr;
+        return true;
+    }
+
+    cv::Mat vp_frame_meta::bgr_frame() const {
+        if (!frame.empty() && frame.type() == CV_8UC3) {
+            return frame;
+        }
+        std::lock_guard<std::mutex> guard(frame_lock);
+        return bgr_cache;
+    }
+
+    void vp_frame_meta::replace_frame(cv::Mat frame) {
+        std::lock_guard<std::mutex> guard(frame_lock);
+        this->frame = frame;
+        bgr_cache.release();
+    }
+
+    bool vp_frame_meta::frame_is_nv12() const {
+        if (frame.empty()) {
+            return dma_frame != nullptr && dma_frame->format == vp_dma_format::NV12;
+        }
+        return frame.type() == CV_8UC1;
+    }
+
     std::vector<std::shared_ptr<vp_frame_target>> vp_frame_meta::get_targets_by_ids(const std::vector<int>& ids) {
         std::vector<std::shared_ptr<vp_objects::vp_frame_target>> results;
         for(auto& t: targets) {
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <vector>
+#include <mutex>
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/videoio.hpp>
 
 #include "vp_meta.h"
+#include "vp_dma_image.h"
 #include "vp_frame_target.h"
 #include "vp_frame_pose_target.h"
 #include "vp_frame_face_target.h"
@@ -32,9 +34,14 @@ namespace vp_objects {
     // frame meta, which contains frame-related data. it is kind of important meta in pipeline.
     class vp_frame_meta: public vp_meta {
     private:
-        /* data */
+        // protect bgr_cache, metas may be shared by several branches which convert at the same time.
+        mutable std::mutex frame_lock;
+        // BGR image converted from native NV12 by ensure_bgr(), written once and read via bgr_frame() only.
+        cv::Mat bgr_cache;
     public:
         vp_frame_meta(cv::Mat frame, int frame_index = -1, int channel_index = -1, int original_width = 0, int original_height = 0, int fps = 0);
+        // zero-copy constructor for hardware decoded frames, frame is a view of dma_frame if possible, otherwise it stays empty (padded strides).
+        vp_frame_meta(std::shared_ptr<vp_dma_image> dma_frame, int frame_index = -1, int channel_index = -1, int original_width = 0, int original_height = 0, int fps = 0);
         ~vp_frame_meta();
 
         // define copy constructor since we need deep copy operation.
@@ -52,9 +59,18 @@ namespace vp_objects {
         int original_height;
 
         // image data the meta holds, filled by src nodes.
+        // it is BGR (CV_8UC3) for most sources, or NV12 (CV_8UC1, rows == height * 3 / 2) for hardware decoded sources.
+        // it is never converted in place, nodes reading BGR use bgr_frame() (see vp_node::frame_needs_bgr).
         // deep copy needed here for this member.
         cv::Mat frame;
 
+        // DMA-buf 承载的原始 NV12 帧（如 MPP 解码输出），与 frame 描述同一幅图像。
+        // 替换 frame 内容的节点（如颜色转换）需要同时 reset 该成员，避免下游读到过期数据。
+        // 浅拷贝共享，图像本身不可修改。
+        std::shared_ptr<vp_dma_image> dma_frame;
+
+        // YOLO26 预处理后的 RGB 输入（DMA-buf，NHWC），可直接作为 RKNN 输入内存，优先于 yolo26_input_rgb_data。
+        std::shared_ptr<vp_dma_image> yolo26_input_dma;
         // YOLO26 预处理后的 RGB 输入字节缓冲（NHWC）。
         std::vector<uint8_t> yolo26_input_rgb_data;
         // YOLO26 预处理结果是否可用。
@@ -89,6 +105,20 @@ namespace vp_objects {
         // ba results created/appened by ba nodes.
         std::vector<std::shared_ptr<vp_objects::vp_ba_result>> ba_results;
         
+        // make sure BGR image is available via bgr_frame(), convert from native NV12 (dma_frame or frame) on the first call and cache the result.
+        // later calls (from any node) are free. return false if conversion failed.
+        bool ensure_bgr();
+
+        // BGR image of the frame, frame itself if it is BGR already, or the one cached by ensure_bgr(). empty if not converted yet.
+        cv::Mat bgr_frame() const;
+
+        // replace image data for nodes converting the whole frame (such as vp_bgr_to_nv12_node), the cached BGR is dropped with it.
+        // only for the node handling meta at the moment, like other members.
+        void replace_frame(cv::Mat frame);
+
+        // frame is (or, if empty, dma_frame holds) NV12 rather than BGR.
+        bool frame_is_nv12() const;
+
         // get target ptrs by target ids in current frame, ONLY supports vp_frame_target
         std::vector<std::shared_ptr<vp_frame_target>> get_targets_by_ids(const std::vector<int>& ids);
 
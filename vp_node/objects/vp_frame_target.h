@@ -7,6 +7,7 @@
 
 #include "shapes/vp_rect.h"
 #include "vp_sub_target.h"
+#include "vp_track_history.h"
 
 /*
 * ##################################################
@@ -54,7 +55,8 @@ namespace vp_objects {
         int track_id = -1;
         // cache of track rects in the previous frames, filled by track node if it exists. 
         // we can draw / analyse depend on these track rects later.
-        std::vector<vp_objects::vp_rect> tracks;
+        // it is shared with the track node and other clones, not copied.
+        vp_objects::vp_track_history tracks;
 
         // mask of the target, used for Instance Segmentation like mask rcnn network (ignore for other situations).
         cv::Mat mask;
@@ -0,0 +1,45 @@
+#include <algorithm>
+
+#include "vp_track_history.h"
+
+namespace vp_objects {
+
+    std::vector<vp_rect> vp_track_history::to_vector() const {
+        return std::vector<vp_rect>(begin(), end());
+    }
+
+    vp_track_history_buffer::vp_track_history_buffer(int capacity):
+                                                    capacity(std::max(capacity, 1)) {
+    }
+
+    vp_track_history_buffer::~vp_track_history_buffer() {
+    }
+
+    void vp_track_history_buffer::push(const vp_rect& rect) {
+        if (block == nullptr) {
+            block = std::shared_ptr<vp_rect[]>(new vp_rect[capacity * 2]);
+        }
+        else if (used == capacity * 2) {
+            // block is full, keep the latest capacity - 1 rects in a new one.
+            // the old block may still be read through views, so it is left untouched.
+            std::shared_ptr<vp_rect[]> next(new vp_rect[capacity * 2]);
+            std::copy(block.get() + used - (capacity - 1), block.get() + used, next.get());
+            block = next;
+            used = capacity - 1;
+        }
+        block[used++] = rect;
+        frames++;
+    }
+
+    vp_track_history vp_track_history_buffer::view() const {
+        vp_track_history history;
+        if (block == nullptr) {
+            return history;
+        }
+        history.count = std::min(used, capacity);
+        history.first = block.get() + used - history.count;
+        history.frames = frames;
+        history.block = block;
+        return history;
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "shapes/vp_rect.h"
+
+namespace vp_objects {
+    // rects of a target in the previous frames (oldest first, current frame last), filled by track node.
+    // it is an immutable view on rects owned by the track node, copying it (or cloning the target holding it)
+    // shares the rects instead of copying them.
+    class vp_track_history {
+    private:
+        // keeps the rects alive while the view exists
+        std::shared_ptr<const vp_rect[]> block;
+        const vp_rect* first = nullptr;
+        size_t count = 0;
+        int frames = 0;
+
+        friend class vp_track_history_buffer;
+    public:
+        vp_track_history() = default;
+
+        // number of rects in view, bounded by capacity of the track node's history
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const vp_rect& operator[](size_t n) const { return first[n]; }
+        const vp_rect& front() const { return first[0]; }
+        const vp_rect& back() const { return first[count - 1]; }
+        const vp_rect* begin() const { return first; }
+        const vp_rect* end() const { return first + count; }
+
+        // frames tracked since the track showed up, not bounded by capacity (size() <= tracked_frames())
+        int tracked_frames() const { return frames; }
+
+        // copy of rects in view
+        std::vector<vp_rect> to_vector() const;
+    };
+
+    // bounded history of one track, written by track node only.
+    // rects are appended to a block of 2 x capacity and never overwritten, when the block is full the latest rects
+    // move to a new block. views handed out before keep the old block alive, so readers in other threads never see
+    // a rect change under them, and appending is O(1) amortized (one allocation per capacity frames) without locks.
+    class vp_track_history_buffer {
+    private:
+        std::shared_ptr<vp_rect[]> block;
+        int capacity;
+        // rects written into block
+        int used = 0;
+        // rects pushed in total
+        int frames = 0;
+    public:
+        vp_track_history_buffer(int capacity);
+        ~vp_track_history_buffer();
+
+        // append rect of the current frame, the oldest one falls out of view if capacity reached
+        void push(const vp_rect& rect);
+
+        // view on the latest (at most capacity) rects
+        vp_track_history view() const;
+
+        // rects pushed in total
+        int tracked_frames() const { return frames; }
+    };
+}
@@ -12,22 +12,22 @@ namespace vp_utils {
                                         layer(layer) {
         assert(original_node != nullptr);
         // register meta hookers for all nodes
-        original_node->set_meta_arriving_hooker([this](std::string node_name, int queue_size, std::shared_ptr<vp_objects::vp_meta> meta) {
+        original_node->set_meta_arriving_hooker([this](const std::string& node_name, int queue_size, const std::shared_ptr<vp_objects::vp_meta>& meta) {
                 this->meta_arriving_hooker_storage.meta = meta;
                 this->meta_arriving_hooker_storage.queue_size = queue_size;
                 this->meta_arriving_hooker_storage.called_count_since_epoch_start++;
             });
-        original_node->set_meta_handling_hooker([this](std::string node_name, int queue_size, std::shared_ptr<vp_objects::vp_meta> meta) {
+        original_node->set_meta_handling_hooker([this](const std::string& node_name, int queue_size, const std::shared_ptr<vp_objects::vp_meta>& meta) {
                 this->meta_handling_hooker_storage.meta = meta;
                 this->meta_handling_hooker_storage.queue_size = queue_size;
                 this->meta_handling_hooker_storage.called_count_since_epoch_start++;
             });
-        original_node->set_meta_handled_hooker([this](std::string node_name, int queue_size, std::shared_ptr<vp_objects::vp_meta> meta) {
+        original_node->set_meta_handled_hooker([this](const std::string& node_name, int queue_size, const std::shared_ptr<vp_objects::vp_meta>& meta) {
                 this->meta_handled_hooker_storage.meta = meta;
                 this->meta_handled_hooker_storage.queue_size = queue_size;
                 this->meta_handled_hooker_storage.called_count_since_epoch_start++;
             });
-        original_node->set_meta_leaving_hooker([this](std::string node_name, int queue_size, std::shared_ptr<vp_objects::vp_meta> meta) {
+        original_node->set_meta_leaving_hooker([this](const std::string& node_name, int queue_size, const std::shared_ptr<vp_objects::vp_meta>& meta) {
                 this->meta_leaving_hooker_storage.meta = meta;
                 this->meta_leaving_hooker_storage.queue_size = queue_size;
                 this->meta_leaving_hooker_storage.called_count_since_epoch_start++;
@@ -42,7 +42,7 @@ namespace vp_utils {
         }
         if (original_node->node_type() == vp_nodes::vp_node_type::DES) {
             auto des_node = std::dynamic_pointer_cast<vp_nodes::vp_des_node>(original_node);
-            des_node->set_stream_status_hooker([this](std::string node_name, vp_nodes::vp_stream_status stream_status){
+            des_node->set_stream_status_hooker([this](const std::string& node_name, const vp_nodes::vp_stream_status& stream_status){
                 this->stream_status_hooker_storage = stream_status;
             });
         }
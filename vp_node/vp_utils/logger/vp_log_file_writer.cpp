@@ -18,14 +18,21 @@ namespace vp_utils {
         this->log_file_name_template = log_file_name_template;
         
         // open log file first time
-        auto f = create_valid_log_file_name();
-        log_writer.open(f, std::ofstream::out | std::ofstream::app);
+        open_log_file();
 
         inited = true;
     }
 
+    void vp_log_file_writer::open_log_file() {
+        auto f = create_valid_log_file_name();
+        // buffer must be set before open
+        write_buffer.resize(64 * 1024);
+        log_writer.rdbuf()->pubsetbuf(write_buffer.data(), write_buffer.size());
+        log_writer.open(f, std::ofstream::out | std::ofstream::app);
+    }
+
 
-    void vp_log_file_writer::write(std::string log) {
+    void vp_log_file_writer::write(const std::string& log) {
         if (!inited) {
             throw "vp_log_file_writer not initialized!";
         }
@@ -36,11 +43,17 @@ namespace vp_utils {
                 log_writer.close();
             }
 
-            auto f = create_valid_log_file_name();
-            log_writer.open(f, std::ofstream::out | std::ofstream::app);
+            open_log_file();
         }
         
-        log_writer << log << std::endl;
+        // no std::endl, caller flushes periodically
+        log_writer << log << '\n';
+    }
+
+    void vp_log_file_writer::flush() {
+        if (log_writer.is_open()) {
+            log_writer.flush();
+        }
     }
 
     std::string vp_log_file_writer::create_valid_log_file_name() {
@@ -66,7 +79,7 @@ namespace vp_utils {
         return time_parts[2];
     }
 
-    vp_log_file_writer& vp_log_file_writer::operator<<(std::string log) {
+    vp_log_file_writer& vp_log_file_writer::operator<<(const std::string& log) {
         write(log);
         return *this;
     }
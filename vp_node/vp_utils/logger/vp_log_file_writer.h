@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <fstream>
 #include <chrono>
 #include <experimental/filesystem>
@@ -23,8 +24,12 @@ namespace vp_utils {
 
         // file handle
         std::ofstream log_writer;
+        // buffer of log_writer, lines are written out on flush() or when it is full
+        std::vector<char> write_buffer;
         // get valid log file name including path, name and extension
         std::string create_valid_log_file_name();
+        // open log file with write_buffer
+        void open_log_file();
 
         // current log day (1 ~ 31)
         int log_day = 0;
@@ -37,13 +42,16 @@ namespace vp_utils {
         vp_log_file_writer();
         ~vp_log_file_writer();
         
-        // write log
-        void write(std::string log);
+        // write log, buffered
+        void write(const std::string& log);
+
+        // write buffered logs to file
+        void flush();
 
         // initialize writer
         void init(std::string log_dir, std::string log_file_name_template);
 
         // for << operator
-        vp_log_file_writer& operator<<(std::string log);
+        vp_log_file_writer& operator<<(const std::string& log);
     };
 }
\ No newline at end of file
@@ -1,12 +1,16 @@
-
 #include "vp_logger.h"
 
 namespace vp_utils {
-        
+
+    namespace {
+        // writing thread logs about the cache itself, it must never wait for the cache
+        thread_local bool in_log_writer = false;
+    }
+
     vp_logger::vp_logger(/* args */)
     {
     }
-    
+
     vp_logger::~vp_logger() {
         die();
         if (log_writer_th.joinable()) {
@@ -15,34 +19,36 @@ namespace vp_utils {
     }
 
     void vp_logger::die() {
-        alive = false;
-        std::lock_guard<std::mutex> guard(log_cache_mutex);
-        log_cache.push("die");
-        log_cache_semaphore.signal();
+        alive.store(false);
+        // writing thread drains what is left before it exits
+        wake_writer();
     }
 
     void vp_logger::init() {
-        inited = true;
+        // initialize cache
+        log_cache.reset(new vp_utils::vp_ring_queue<vp_log_record>(log_cache_capacity));
 
         // initialize file writer
         file_writer.init(log_dir, log_file_name_template);
 
         // run thread
-        auto t = std::thread(&vp_logger::log_write_run, this); 
+        auto t = std::thread(&vp_logger::log_write_run, this);
         log_writer_th = std::move(t);
+
+        inited.store(true);
     }
 
-    void vp_logger::log(vp_log_level level, const std::string& message, const char* code_file, int code_line) {
+    void vp_logger::log(vp_log_level level, std::string message, const char* code_file, int code_line) {
         // make sure logger is initialized
-        if (!inited) {
+        if (!inited.load(std::memory_order_acquire)) {
             throw "vp_logger is not initialized yet!";
         }
-        
+
         // level filter
-        if (level > log_level) {
+        if (!is_enabled(level)) {
             return;
         }
-        
+
         // keywords filter for debug level
         if (level == vp_log_level::DEBUG && keywords_for_debug_log.size() != 0) {
             bool filterd = true;
@@ -56,88 +62,144 @@ namespace vp_utils {
                 return;
             }
         }
-        
-        /* create log */
+
+        /* create log, turned into text by writing thread */
+        vp_log_record record;
+        record.level = level;
+        record.time = NOW;
+        record.thread_id = std::this_thread::get_id();
+        record.code_file = code_file;
+        record.code_line = code_line;
+        record.message = std::move(message);
+
+        /* write to cache, no lock */
+        while (!log_cache->try_push(record)) {
+            // cache is full, drop debug/info but never errors/warnings, they wait for writing thread
+            if (level > vp_log_level::WARN || !alive.load() || in_log_writer) {
+                log_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            wake_writer();
+            std::this_thread::yield();
+        }
+        // pairs with the check in log_write_run(), either writer sees the record or we see writer sleeping
+        log_cache_size.fetch_add(1);
+        if (log_writer_sleeping.load()) {
+            wake_writer();
+        }
+    }
+
+    void vp_logger::wake_writer() {
+        std::lock_guard<std::mutex> guard(log_wake_mutex);
+        log_wake_cond.notify_one();
+    }
+
+    std::string vp_logger::format_record(const vp_log_record& record) {
         std::string new_log = "";
         // 100% true for log time
         if (include_time) {
-            new_log += vp_utils::time_format(NOW, log_time_templete);
+            auto time = std::chrono::time_point_cast<std::chrono::milliseconds>(record.time);
+            if (cached_log_time_text.empty() || time != cached_log_time) {
+                cached_log_time = time;
+                cached_log_time_text = vp_utils::time_format(record.time, log_time_templete);
+            }
+            new_log += cached_log_time_text;
         }
 
         // log level
         if (include_level) {
-            new_log += "[" + log_level_names.at(level) + "]";
+            new_log += "[" + log_level_names.at(record.level) + "]";
         }
 
         // thread id
         if (include_thread_id) {
-            auto id = std::this_thread::get_id();
-            std::stringstream ss;
-            ss << std::hex << id;  // to hex
-            auto thread_id = ss.str(); 
+            auto& thread_id = cached_thread_ids[record.thread_id];
+            if (thread_id.empty()) {
+                std::stringstream ss;
+                ss << std::hex << record.thread_id;  // to hex
+                thread_id = ss.str();
+            }
             new_log += "[" + thread_id + "]";
         }
-        
+
         // code location
         if (include_code_location) {
-            new_log += "[" + std::string(code_file) + ":" + std::to_string(code_line) + "]";
+            new_log += "[" + std::string(record.code_file) + ":" + std::to_string(record.code_line) + "]";
         }
 
-        new_log += " " + message;
-
-        /* write to cache */
-        // min lock range
-        std::lock_guard<std::mutex> guard(log_cache_mutex);
-        log_cache.push(new_log);
-        // notify
-        log_cache_semaphore.signal();
+        new_log += " " + record.message;
+        return new_log;
     }
 
     void vp_logger::log_write_run() {
         bool log_thres_warned = false;
+        bool unflushed = false;
+        auto last_flush = std::chrono::steady_clock::now();
+        vp_log_record record;
+        in_log_writer = true;
         /* below code runs in single thread */
-        while (inited && alive) {
-            // wait for data
-            log_cache_semaphore.wait();
-            auto log = log_cache.front();
-            log_cache.pop();
-
-            if (log == "die") {
-                continue;
-            }
-            
-            /* watch the log cache size */
-            auto log_cache_size = 0;
-            {
-                // min lock range
-                std::lock_guard<std::mutex> guard(log_cache_mutex);
-                log_cache_size = log_cache.size();
-            }
-            if (!log_thres_warned && log_cache_size > log_cache_warn_threshold) {
-                VP_WARN(vp_utils::string_format("[logger] log cache size is exceeding threshold! cache size is: [%d], threshold is: [%d]", log_cache_size, log_cache_warn_threshold));
-                log_thres_warned = true;  // warn 1 time
+        while (true) {
+            // records pushed before die() are still written
+            auto stopping = !alive.load();
+            auto flush_now = false;
+
+            auto dropped = log_dropped.exchange(0);
+            if (dropped > 0) {
+                VP_WARN(vp_utils::string_format("[logger] log cache is full, [%d] logs dropped! capacity is: [%d]", dropped, static_cast<int>(log_cache->capacity())));
             }
-            if (log_cache_size <= log_cache_warn_threshold) {
-                log_thres_warned = false;
+
+            while (log_cache->try_pop(record)) {
+                /* watch the log cache size */
+                auto size = log_cache_size.fetch_sub(1) - 1;
+                if (!log_thres_warned && size > log_cache_warn_threshold) {
+                    VP_WARN(vp_utils::string_format("[logger] log cache size is exceeding threshold! cache size is: [%d], threshold is: [%d]", size, log_cache_warn_threshold));
+                    log_thres_warned = true;  // warn 1 time
+                }
+                if (size <= log_cache_warn_threshold) {
+                    log_thres_warned = false;
+                }
+
+                auto log = format_record(record);
+                // errors go out at once, the process may be about to die
+                flush_now = flush_now || record.level == vp_log_level::ERROR;
+
+                /* write to devices */
+                if (log_to_console) {
+                    write_to_console(log);
+                }
+
+                if (log_to_file) {
+                    write_to_file(log);
+                }
+
+                if (log_to_kafka) {
+                    write_to_kafka(log);
+                }
+                unflushed = true;
             }
-            
-            /* write to devices */
-            if (log_to_console) {
-                write_to_console(log);
+
+            auto now = std::chrono::steady_clock::now();
+            if (unflushed && (flush_now || stopping || now - last_flush >= std::chrono::milliseconds(log_flush_interval))) {
+                flush_devices();
+                unflushed = false;
+                last_flush = now;
             }
-            
-            if (log_to_file) {
-                write_to_file(log);
+            if (stopping) {
+                break;
             }
 
-            if (log_to_kafka) {
-                write_to_kafka(log);
-            }
+            // wait for data, wake up anyway for the next flush
+            std::unique_lock<std::mutex> lock(log_wake_mutex);
+            log_writer_sleeping.store(true);
+            log_wake_cond.wait_for(lock, std::chrono::milliseconds(log_flush_interval), [this] {
+                return !alive.load() || log_cache_size.load() > 0 || log_dropped.load() > 0;
+            });
+            log_writer_sleeping.store(false);
         }
     }
 
     void vp_logger::write_to_console(const std::string& log) {
-        std::cout << log << std::endl;
+        std::cout << log << '\n';
     }
 
     void vp_logger::write_to_file(const std::string& log) {
@@ -148,4 +210,13 @@ namespace vp_utils {
     void vp_logger::write_to_kafka(const std::string& log) {
         // TO-DO
     }
-}
\ No newline at end of file
+
+    void vp_logger::flush_devices() {
+        if (log_to_console) {
+            std::cout.flush();
+        }
+        if (log_to_file) {
+            file_writer.flush();
+        }
+    }
+}
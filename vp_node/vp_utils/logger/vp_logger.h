@@ -2,13 +2,16 @@
 
 #include <string>
 #include <thread>
-#include <queue>
 #include <mutex>
+#include <atomic>
+#include <memory>
+#include <condition_variable>
 #include <chrono>
 #include <assert.h>
 #include <map>
+#include <unordered_map>
 
-#include "vp_utils/vp_semaphore.h"
+#include "vp_utils/vp_ring_queue.h"
 #include "vp_utils/vp_utils.h"
 #include "vp_log_file_writer.h"
 
@@ -21,30 +24,56 @@ namespace vp_utils {
         DEBUG = 4
     };
 
+    // one log before formatting, time/level/thread/location are turned into text by the writing thread.
+    struct vp_log_record {
+        vp_log_level level = vp_log_level::INFO;
+        std::chrono::system_clock::time_point time;
+        std::thread::id thread_id;
+        const char* code_file = nullptr;
+        int code_line = 0;
+        std::string message;
+    };
+
     // a lightweight logger for VideoPipe, architecture: N producer * 1 consumer.
     // 1. support 3 types of devices (console, file, kafka)
-    // 2. multithread safe
-    // 3. use Macros directly
+    // 2. multithread safe, producers push records into a bounded lock-free ring (debug/info are dropped and counted if it is full, errors/warnings wait)
+    // 3. use Macros directly, level is checked before the message argument is evaluated
+    // 4. devices are written in batches and flushed every log_flush_interval ms (at once for errors)
     class vp_logger
     {
     private:
-        std::queue<std::string> log_cache;
-        vp_utils::vp_semaphore log_cache_semaphore;
-        std::mutex log_cache_mutex;
+        std::unique_ptr<vp_utils::vp_ring_queue<vp_log_record>> log_cache;
+        // records in log_cache, not yet taken by writing thread
+        std::atomic<int> log_cache_size {0};
+        // records dropped since ring was full, reported by writing thread
+        std::atomic<int> log_dropped {0};
         std::thread log_writer_th;
 
+        // writing thread sleeps here when ring is empty
+        std::mutex log_wake_mutex;
+        std::condition_variable log_wake_cond;
+        std::atomic<bool> log_writer_sleeping {false};
+        void wake_writer();
+
         // initialized or not
-        bool inited = false;
+        std::atomic<bool> inited {false};
 
-        bool alive = true;
+        std::atomic<bool> alive {true};
         void die();
 
+        // used by writing thread only, time part is formatted again only when millisecond changes
+        std::chrono::system_clock::time_point cached_log_time;
+        std::string cached_log_time_text;
+        std::unordered_map<std::thread::id, std::string> cached_thread_ids;
+        std::string format_record(const vp_log_record& record);
+
         vp_logger(/* args */);
 
         // write to devices
         void write_to_console(const std::string& log);
         void write_to_file(const std::string& log);
         void write_to_kafka(const std::string& log);
+        void flush_devices();
 
         // writing log func
         void log_write_run();
@@ -69,7 +98,7 @@ namespace vp_utils {
         ~vp_logger();
 
         // CONFIG
-        vp_log_level log_level = vp_log_level::DEBUG; // filter
+        std::atomic<vp_log_level> log_level {vp_log_level::DEBUG}; // filter
         std::string log_dir = "./log";                // folder saving log file
         const std::string log_file_name_template = "<year>-<mon>-<day>.txt";
         // const std::string log_time_templete = "[<year>-<mon>-<day> <hour>:<min>:<sec>.<mili>]";
@@ -83,6 +112,8 @@ namespace vp_utils {
 
         // watch
         int log_cache_warn_threshold = 100;           // warning if cache size greater than threshold
+        int log_cache_capacity = 8192;                // max records in cache, set before init()
+        int log_flush_interval = 100;                 // flush devices every N ms
         
         // where
         bool log_to_console = true;                   // to console
@@ -96,8 +127,13 @@ namespace vp_utils {
         bool include_thread_id = true;                // 'thread id' part in log content
         // END of CONFIG
 
+        // level filter, checked by log Macros before building message
+        bool is_enabled(vp_log_level level) const {
+            return level <= log_level.load(std::memory_order_relaxed);
+        }
+
         // better Never call directly
-        void log(vp_log_level level, const std::string& message, const char* code_file, int code_line);
+        void log(vp_log_level level, std::string message, const char* code_file, int code_line);
 
         // init for vp_logger, ready to go
         void init();
@@ -107,22 +143,25 @@ namespace vp_utils {
     #define VP_SET_LOG_LEVEL(_log_level) vp_utils::vp_logger::get_logger().log_level = _log_level
     #define VP_SET_LOG_DIR(_log_dir) vp_utils::vp_logger::get_logger().log_dir = _log_dir
     #define VP_SET_LOG_TO_CONSOLE(_log_to_console) vp_utils::vp_logger::get_logger().log_to_console = _log_to_console
-    #define VP_SET_LOG_TO_FILE(_log_to_file) vp_utils::vp_logger::get_logger().log_to_console = _log_to_file
+    #define VP_SET_LOG_TO_FILE(_log_to_file) vp_utils::vp_logger::get_logger().log_to_file = _log_to_file
     #define VP_SET_LOG_TO_KAFKA(_log_to_kafka) vp_utils::vp_logger::get_logger().log_to_kafka = _log_to_kafka
     #define VP_SET_LOG_INCLUDE_LEVEL(_include_level) vp_utils::vp_logger::get_logger().include_level = _include_level
     #define VP_SET_LOG_INCLUDE_CODE_LOCATION(_include_code_location) vp_utils::vp_logger::get_logger().include_code_location = _include_code_location
     #define VP_SET_LOG_INCLUDE_THREAD_ID(_include_thread_id) vp_utils::vp_logger::get_logger().include_thread_id = _include_thread_id
     #define VP_SET_LOG_CACHE_WARN_THRES(_log_cache_warn_threshold) vp_utils::vp_logger::get_logger().log_cache_warn_threshold = _log_cache_warn_threshold
     #define VP_SET_LOG_KEYWORDS_FOR_DEBUG(_keywords_for_debug_log) vp_utils::vp_logger::get_logger().keywords_for_debug_log = _keywords_for_debug_log
+    #define VP_SET_LOG_CACHE_CAPACITY(_log_cache_capacity) vp_utils::vp_logger::get_logger().log_cache_capacity = _log_cache_capacity
+    #define VP_SET_LOG_FLUSH_INTERVAL(_log_flush_interval) vp_utils::vp_logger::get_logger().log_flush_interval = _log_flush_interval
     
     // log Macros
-    // use vp_utils::string_format to format log content first if need
+    // use vp_utils::string_format to format log content first if need, it is evaluated only if the level is enabled.
     // example: 
     // VP_ERROR(vp_utils::string_format("message is %s at %d", s, d));
-    #define VP_ERROR(message) vp_utils::vp_logger::get_logger().log(vp_utils::vp_log_level::ERROR, message, __FILE__, __LINE__)
-    #define VP_WARN(message) vp_utils::vp_logger::get_logger().log(vp_utils::vp_log_level::WARN, message, __FILE__, __LINE__)
-    #define VP_INFO(message) vp_utils::vp_logger::get_logger().log(vp_utils::vp_log_level::INFO, message, __FILE__, __LINE__)
-    #define VP_DEBUG(message) vp_utils::vp_logger::get_logger().log(vp_utils::vp_log_level::DEBUG, message, __FILE__, __LINE__)
+    #define VP_LOG(_level, message) (vp_utils::vp_logger::get_logger().is_enabled(_level) ? vp_utils::vp_logger::get_logger().log(_level, message, __FILE__, __LINE__) : (void)0)
+    #define VP_ERROR(message) VP_LOG(vp_utils::vp_log_level::ERROR, message)
+    #define VP_WARN(message) VP_LOG(vp_utils::vp_log_level::WARN, message)
+    #define VP_INFO(message) VP_LOG(vp_utils::vp_log_level::INFO, message)
+    #define VP_DEBUG(message) VP_LOG(vp_utils::vp_log_level::DEBUG, message)
 
     // init Macros
     #define VP_LOGGER_INIT() vp_utils::vp_logger::get_logger().init()
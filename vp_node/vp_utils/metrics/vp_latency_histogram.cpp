@@ -0,0 +1,85 @@
+#include <cmath>
+
+#include "vp_latency_histogram.h"
+
+namespace vp_utils {
+
+    vp_latency_histogram::vp_latency_histogram() {
+        for (auto& b: buckets) {
+            b.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    int vp_latency_histogram::bucket_of(uint64_t value_us) {
+        if (value_us > max_value) {
+            value_us = max_value;
+        }
+        if (value_us < linear_limit) {
+            return static_cast<int>(value_us);
+        }
+        // position of highest bit, >= sub_bucket_bits + 1 here
+        auto msb = 63 - __builtin_clzll(value_us);
+        auto shift = msb - sub_bucket_bits;
+        // top sub_bucket_bits + 1 bits, in [sub_buckets, 2 * sub_buckets)
+        auto mantissa = static_cast<int>(value_us >> shift);
+        return static_cast<int>(linear_limit) + (shift - 1) * sub_buckets + (mantissa - sub_buckets);
+    }
+
+    uint64_t vp_latency_histogram::upper_bound_of(int bucket) {
+        if (bucket < static_cast<int>(linear_limit)) {
+            return static_cast<uint64_t>(bucket);
+        }
+        auto shift = (bucket - static_cast<int>(linear_limit)) / sub_buckets + 1;
+        auto mantissa = static_cast<uint64_t>((bucket - static_cast<int>(linear_limit)) % sub_buckets + sub_buckets);
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    void vp_latency_histogram::record(uint64_t value_us) {
+        buckets[bucket_of(value_us)].fetch_add(1, std::memory_order_relaxed);
+        total_count.fetch_add(1, std::memory_order_relaxed);
+        total_sum.fetch_add(value_us, std::memory_order_relaxed);
+        auto current = max_recorded.load(std::memory_order_relaxed);
+        while (value_us > current && !max_recorded.compare_exchange_weak(current, value_us, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t vp_latency_histogram::count() const {
+        return total_count.load(std::memory_order_relaxed);
+    }
+
+    uint64_t vp_latency_histogram::sum() const {
+        return total_sum.load(std::memory_order_relaxed);
+    }
+
+    uint64_t vp_latency_histogram::max() const {
+        return max_recorded.load(std::memory_order_relaxed);
+    }
+
+    void vp_latency_histogram::snapshot(std::vector<uint64_t>& counts) const {
+        counts.resize(bucket_count);
+        for (int i = 0; i < bucket_count; i++) {
+            counts[i] = buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t vp_latency_histogram::quantile_of(const std::vector<uint64_t>& counts, double q) {
+        uint64_t total = 0;
+        for (auto c: counts) {
+            total += c;
+        }
+        if (total == 0) {
+            return 0;
+        }
+        // rank of the value, 1-based
+        auto rank = static_cast<uint64_t>(std::ceil(q * total));
+        rank = rank == 0 ? 1 : rank;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return upper_bound_of(static_cast<int>(i));
+            }
+        }
+        return upper_bound_of(static_cast<int>(counts.size()) - 1);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace vp_utils {
+    // latency histogram with bounded relative error (HDR style log-linear buckets), recording is lock-free from any thread.
+    // values are microseconds, every power of 2 range is split into 8 linear sub buckets, so a quantile read from it
+    // is the upper bound of its bucket and at most 12.5% above the real value. values beyond max_value are clamped.
+    //
+    // counts are cumulative since created, take snapshot() periodically and diff them to get quantiles of a time window.
+    class vp_latency_histogram {
+    public:
+        static constexpr int sub_bucket_bits = 3;
+        static constexpr int sub_buckets = 1 << sub_bucket_bits;
+        // values below it get their own bucket
+        static constexpr uint64_t linear_limit = 2 * sub_buckets;
+        // about 19 hours
+        static constexpr int max_value_bits = 36;
+        static constexpr uint64_t max_value = (uint64_t(1) << max_value_bits) - 1;
+        static constexpr int bucket_count = linear_limit + (max_value_bits - sub_bucket_bits - 1) * sub_buckets;
+
+        vp_latency_histogram();
+
+        vp_latency_histogram(const vp_latency_histogram&) = delete;
+        vp_latency_histogram& operator=(const vp_latency_histogram&) = delete;
+
+        void record(uint64_t value_us);
+
+        uint64_t count() const;
+        uint64_t sum() const;
+        uint64_t max() const;
+
+        // copy of bucket counts
+        void snapshot(std::vector<uint64_t>& counts) const;
+
+        // value (upper bound of bucket) at quantile q in [0, 1] of bucket counts, 0 if no value recorded
+        static uint64_t quantile_of(const std::vector<uint64_t>& counts, double q);
+        static int bucket_of(uint64_t value_us);
+        // largest value falling into bucket
+        static uint64_t upper_bound_of(int bucket);
+
+    private:
+        std::array<std::atomic<uint64_t>, bucket_count> buckets;
+        std::atomic<uint64_t> total_count {0};
+        std::atomic<uint64_t> total_sum {0};
+        std::atomic<uint64_t> max_recorded {0};
+    };
+}
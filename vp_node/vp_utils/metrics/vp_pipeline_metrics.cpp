@@ -0,0 +1,338 @@
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+#include "httplib.h"
+
+#include "vp_pipeline_metrics.h"
+#include "vp_utils/logger/vp_logger.h"
+
+namespace vp_utils {
+
+    const std::array<double, vp_pipeline_metrics::quantile_count> vp_pipeline_metrics::quantiles = {0.5, 0.9, 0.99, 0.999};
+
+    namespace {
+        const char* stage_names[] = {"queue", "handle", "dispatch", "e2e"};
+        const char* port_names[] = {"arriving", "handling", "handled", "leaving"};
+
+        // metas lost between ports (dropped by queues) leave entries behind, forget the oldest of a channel beyond this
+        constexpr size_t max_pending_metas = 2 * vp_nodes::vp_meta_queue::max_capacity;
+
+        // label value in Prometheus text format
+        std::string escape_label(const std::string& value) {
+            std::string escaped;
+            for (auto c: value) {
+                if (c == '\\' || c == '"') {
+                    escaped += '\\';
+                    escaped += c;
+                }
+                else if (c == '\n') {
+                    escaped += "\\n";
+                }
+                else {
+                    escaped += c;
+                }
+            }
+            return escaped;
+        }
+    }
+
+    vp_pipeline_metrics::vp_pipeline_metrics(std::vector<std::shared_ptr<vp_nodes::vp_node>> src_nodes_in_pipe, int window_seconds):
+                                            window_seconds(window_seconds > 0 ? window_seconds : 10) {
+        // walk the pipe from src nodes, nodes with multi previous nodes are visited once
+        std::set<vp_nodes::vp_node*> visited;
+        auto layer = src_nodes_in_pipe;
+        while (!layer.empty()) {
+            std::vector<std::shared_ptr<vp_nodes::vp_node>> next_layer;
+            for (auto& node: layer) {
+                if (node == nullptr || !visited.insert(node.get()).second) {
+                    continue;
+                }
+                auto metrics = std::make_shared<node_metrics>();
+                metrics->node = node;
+                for (auto& c: metrics->port_counts) {
+                    c.store(0);
+                }
+                all_node_metrics.push_back(metrics);
+
+                auto next = node->next_nodes();
+                next_layer.insert(next_layer.end(), next.begin(), next.end());
+            }
+            layer = next_layer;
+        }
+
+        window_start = std::chrono::steady_clock::now();
+        for (auto& metrics: all_node_metrics) {
+            for (int s = 0; s < STAGE_COUNT; s++) {
+                metrics->stages[s].snapshot(metrics->window_start_buckets[s]);
+            }
+            attach(metrics);
+        }
+        window_th = std::thread(&vp_pipeline_metrics::window_run, this);
+    }
+
+    vp_pipeline_metrics::~vp_pipeline_metrics() {
+        // set_xxx_hooker waits for hookers being called, no callback after it
+        for (auto& metrics: all_node_metrics) {
+            detach(metrics);
+        }
+        {
+            std::lock_guard<std::mutex> guard(alive_lock);
+            alive = false;
+            alive_cond.notify_all();
+        }
+        if (window_th.joinable()) {
+            window_th.join();
+        }
+        if (server != nullptr) {
+            server->stop();
+        }
+        if (server_th.joinable()) {
+            server_th.join();
+        }
+    }
+
+    void vp_pipeline_metrics::attach(std::shared_ptr<node_metrics> metrics) {
+        // hookers run on node threads, metrics outlive them since hookers are removed in destructor
+        auto m = metrics.get();
+        metrics->node->set_meta_arriving_hooker([this, m](const std::string& node_name, int queue_size, const std::shared_ptr<vp_objects::vp_meta>& meta) {
+            on_port(*m, ARRIVING, meta);
+        });
+        metrics->node->set_meta_handling_hooker([this, m](const std::string& node_name, int queue_size, const std::shared_ptr<vp_objects::vp_meta>& meta) {
+            on_port(*m, HANDLING, meta);
+        });
+        metrics->node->set_meta_handled_hooker([this, m](const std::string& node_name, int queue_size, const std::shared_ptr<vp_objects::vp_meta>& meta) {
+            on_port(*m, HANDLED, meta);
+        });
+        metrics->node->set_meta_leaving_hooker([this, m](const std::string& node_name, int queue_size, const std::shared_ptr<vp_objects::vp_meta>& meta) {
+            on_port(*m, LEAVING, meta);
+        });
+    }
+
+    void vp_pipeline_metrics::detach(std::shared_ptr<node_metrics> metrics) {
+        metrics->node->set_meta_arriving_hooker({});
+        metrics->node->set_meta_handling_hooker({});
+        metrics->node->set_meta_handled_hooker({});
+        metrics->node->set_meta_leaving_hooker({});
+    }
+
+    void vp_pipeline_metrics::on_port(node_metrics& metrics, port p, const std::shared_ptr<vp_objects::vp_meta>& meta) {
+        if (meta == nullptr || meta->meta_type != vp_objects::vp_meta_type::FRAME) {
+            return;
+        }
+        metrics.port_counts[p].fetch_add(1, std::memory_order_relaxed);
+        auto now = std::chrono::steady_clock::now();
+        if (p == HANDLED) {
+            auto e2e = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - meta->create_time).count();
+            metrics.stages[E2E].record(e2e > 0 ? static_cast<uint64_t>(e2e) : 0);
+        }
+
+        // stage which ends at this port, and the one which starts at it
+        // arriving starts QUEUE, handling ends QUEUE and starts HANDLE, handled ends HANDLE and starts DISPATCH, leaving ends DISPATCH.
+        auto ending = static_cast<int>(p) - 1;
+        auto starting = p == LEAVING ? -1 : static_cast<int>(p);
+        // des nodes never dispatch
+        if (p == HANDLED && metrics.node->node_type() == vp_nodes::vp_node_type::DES) {
+            starting = -1;
+        }
+
+        auto channel_index = meta->channel_index;
+        auto frame_index = std::static_pointer_cast<vp_objects::vp_frame_meta>(meta)->frame_index;
+        std::lock_guard<std::mutex> guard(metrics.pending_lock);
+        if (ending >= 0) {
+            auto& pending = metrics.pending[ending][channel_index];
+            auto i = pending.find(frame_index);
+            if (i != pending.end()) {
+                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(now - i->second).count();
+                metrics.stages[ending].record(duration > 0 ? static_cast<uint64_t>(duration) : 0);
+                pending.erase(i);
+            }
+        }
+        if (starting >= 0) {
+            auto& pending = metrics.pending[starting][channel_index];
+            // frame index went back (source restarted), entries far ahead of it are left from before and can not end any more
+            pending.erase(pending.upper_bound(frame_index + static_cast<int>(max_pending_metas)), pending.end());
+            pending[frame_index] = now;
+            // frames of a channel pass ports in order, the oldest ones were lost
+            while (pending.size() > max_pending_metas) {
+                pending.erase(pending.begin());
+            }
+        }
+    }
+
+    void vp_pipeline_metrics::roll_window() {
+        std::lock_guard<std::mutex> guard(window_lock);
+        auto now = std::chrono::steady_clock::now();
+        auto seconds = std::chrono::duration_cast<std::chrono::milliseconds>(now - window_start).count() / 1000.0;
+        window_start = now;
+
+        std::vector<uint64_t> buckets;
+        for (auto& metrics: all_node_metrics) {
+            for (int s = 0; s < STAGE_COUNT; s++) {
+                metrics->stages[s].snapshot(buckets);
+                auto& start = metrics->window_start_buckets[s];
+                std::vector<uint64_t> window(buckets.size());
+                for (size_t i = 0; i < buckets.size(); i++) {
+                    window[i] = buckets[i] - start[i];
+                }
+                for (int q = 0; q < quantile_count; q++) {
+                    metrics->window_quantiles[s][q] = vp_latency_histogram::quantile_of(window, quantiles[q]) / 1000000.0;
+                }
+                start.swap(buckets);
+            }
+            for (int p = 0; p < PORT_COUNT; p++) {
+                auto count = metrics->port_counts[p].load(std::memory_order_relaxed);
+                metrics->window_fps[p] = seconds > 0 ? (count - metrics->window_start_counts[p]) / seconds : 0.0;
+                metrics->window_start_counts[p] = count;
+            }
+        }
+    }
+
+    void vp_pipeline_metrics::window_run() {
+        std::unique_lock<std::mutex> lock(alive_lock);
+        while (alive) {
+            alive_cond.wait_for(lock, std::chrono::seconds(window_seconds), [this] { return !alive; });
+            if (!alive) {
+                break;
+            }
+            lock.unlock();
+            roll_window();
+            dump();
+            lock.lock();
+        }
+    }
+
+    void vp_pipeline_metrics::dump() {
+        std::string path;
+        {
+            std::lock_guard<std::mutex> guard(alive_lock);
+            path = dump_path;
+        }
+        if (path.empty()) {
+            return;
+        }
+        // write aside and rename, so readers see old or new content only
+        auto tmp_path = path + ".tmp";
+        {
+            std::ofstream f(tmp_path, std::ofstream::out | std::ofstream::trunc);
+            if (!f.is_open()) {
+                VP_WARN(vp_utils::string_format("[metrics] open dump file failed: `%s`", tmp_path.c_str()));
+                return;
+            }
+            f << render();
+        }
+        if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+            VP_WARN(vp_utils::string_format("[metrics] replace dump file failed: `%s`", path.c_str()));
+        }
+    }
+
+    void vp_pipeline_metrics::dump_to(std::string path) {
+        std::lock_guard<std::mutex> guard(alive_lock);
+        dump_path = path;
+    }
+
+    bool vp_pipeline_metrics::serve(std::string host, int port) {
+        if (server != nullptr) {
+            return true;
+        }
+        server.reset(new httplib::Server());
+        server->Get("/metrics", [this](const httplib::Request&, httplib::Response& res) {
+            res.set_content(render(), "text/plain; version=0.0.4");
+        });
+        if (!server->bind_to_port(host, port)) {
+            VP_ERROR(vp_utils::string_format("[metrics] bind %s:%d failed", host.c_str(), port));
+            server.reset();
+            return false;
+        }
+        server_th = std::thread([this] { server->listen_after_bind(); });
+        VP_INFO(vp_utils::string_format("[metrics] serving http://%s:%d/metrics", host.c_str(), port));
+        return true;
+    }
+
+    std::string vp_pipeline_metrics::render() {
+        std::ostringstream out;
+        std::lock_guard<std::mutex> guard(window_lock);
+
+        out << "# HELP vp_node_metas_total Frame metas passed through a port of node.\n";
+        out << "# TYPE vp_node_metas_total counter\n";
+        for (auto& metrics: all_node_metrics) {
+            auto node = escape_label(metrics->node->node_name);
+            for (int p = 0; p < PORT_COUNT; p++) {
+                out << "vp_node_metas_total{node=\"" << node << "\",port=\"" << port_names[p] << "\"} "
+                    << metrics->port_counts[p].load(std::memory_order_relaxed) << "\n";
+            }
+        }
+
+        out << "# HELP vp_node_fps Frame metas per second through a port of node in the last window.\n";
+        out << "# TYPE vp_node_fps gauge\n";
+        for (auto& metrics: all_node_metrics) {
+            auto node = escape_label(metrics->node->node_name);
+            for (int p = 0; p < PORT_COUNT; p++) {
+                out << "vp_node_fps{node=\"" << node << "\",port=\"" << port_names[p] << "\"} " << metrics->window_fps[p] << "\n";
+            }
+        }
+
+        out << "# HELP vp_node_queue_size Metas waiting in queue of node.\n";
+        out << "# TYPE vp_node_queue_size gauge\n";
+        for (auto& metrics: all_node_metrics) {
+            auto node = escape_label(metrics->node->node_name);
+            out << "vp_node_queue_size{node=\"" << node << "\",queue=\"in\"} " << metrics->node->get_in_queue_size() << "\n";
+            out << "vp_node_queue_size{node=\"" << node << "\",queue=\"out\"} " << metrics->node->get_out_queue_size() << "\n";
+        }
+
+        out << "# HELP vp_node_dropped_total Frame metas dropped by queue of node.\n";
+        out << "# TYPE vp_node_dropped_total counter\n";
+        for (auto& metrics: all_node_metrics) {
+            auto node = escape_label(metrics->node->node_name);
+            out << "vp_node_dropped_total{node=\"" << node << "\",queue=\"in\"} " << metrics->node->get_in_queue_dropped() << "\n";
+            out << "vp_node_dropped_total{node=\"" << node << "\",queue=\"out\"} " << metrics->node->get_out_queue_dropped() << "\n";
+        }
+
+        out << "# HELP vp_node_latency_seconds Latency of stages inside node, quantiles over the last window.\n";
+        out << "# TYPE vp_node_latency_seconds summary\n";
+        for (auto& metrics: all_node_metrics) {
+            auto node = escape_label(metrics->node->node_name);
+            for (int s = 0; s < STAGE_COUNT; s++) {
+                auto labels = "node=\"" + node + "\",stage=\"" + stage_names[s] + "\"";
+                auto& histogram = metrics->stages[s];
+                for (int q = 0; q < quantile_count; q++) {
+                    out << "vp_node_latency_seconds{" << labels << ",quantile=\"" << quantiles[q] << "\"} " << metrics->window_quantiles[s][q] << "\n";
+                }
+                out << "vp_node_latency_seconds_sum{" << labels << "} " << histogram.sum() / 1000000.0 << "\n";
+                out << "vp_node_latency_seconds_count{" << labels << "} " << histogram.count() << "\n";
+            }
+        }
+
+        out << "# HELP vp_node_latency_max_seconds Max latency of stages inside node since started.\n";
+        out << "# TYPE vp_node_latency_max_seconds gauge\n";
+        for (auto& metrics: all_node_metrics) {
+            auto node = escape_label(metrics->node->node_name);
+            for (int s = 0; s < STAGE_COUNT; s++) {
+                out << "vp_node_latency_max_seconds{node=\"" << node << "\",stage=\"" << stage_names[s] << "\"} "
+                    << metrics->stages[s].max() / 1000000.0 << "\n";
+            }
+        }
+        return out.str();
+    }
+
+    std::string vp_pipeline_metrics::summary() {
+        std::string out = vp_utils::string_format("%-24s %10s %8s %21s %21s %21s\n", "node", "handled", "dropped",
+                                                  "queue p50/p99(ms)", "handle p50/p99(ms)", "e2e p50/p99(ms)");
+        std::vector<uint64_t> buckets;
+        for (auto& metrics: all_node_metrics) {
+            auto& node = metrics->node;
+            out += vp_utils::string_format("%-24s %10llu %8llu", node->node_name.c_str(),
+                                           static_cast<unsigned long long>(metrics->port_counts[HANDLED].load(std::memory_order_relaxed)),
+                                           static_cast<unsigned long long>(node->get_in_queue_dropped() + node->get_out_queue_dropped()));
+            for (auto s: {QUEUE, HANDLE, E2E}) {
+                metrics->stages[s].snapshot(buckets);
+                out += vp_utils::string_format(" %10.2f/%10.2f",
+                                               vp_latency_histogram::quantile_of(buckets, 0.5) / 1000.0,
+                                               vp_latency_histogram::quantile_of(buckets, 0.99) / 1000.0);
+            }
+            out += "\n";
+        }
+        return out;
+    }
+}
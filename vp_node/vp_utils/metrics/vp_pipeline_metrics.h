@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "nodes/base/vp_node.h"
+#include "vp_latency_histogram.h"
+
+namespace httplib {
+    class Server;
+}
+
+namespace vp_utils {
+    // per-node metrics of a pipeline, collected by meta hookers at the 4 ports of every node (see vp_nodes::vp_meta_hookable):
+    // 1. frame metas passed each port (counter) and fps of each port in the last window
+    // 2. latency histograms of stages: queue (arriving -> handling), handle (handling -> handled), dispatch (handled -> leaving)
+    //    and e2e (create_time of meta -> handled, the latency of stream when it leaves the node)
+    // 3. size and dropped frame metas of in/out queues
+    //
+    // quantiles (p50/p90/p99/p999) are computed over the last window (window_seconds), counts and sums are cumulative.
+    // metrics are exposed in Prometheus text format by render(), by a local http endpoint (serve) and by a file (dump_to).
+    //
+    // note: hookers of nodes hold one callback each, do not use it with vp_analysis_board on the same pipeline at the same time.
+    class vp_pipeline_metrics final
+    {
+    private:
+        enum stage {
+            QUEUE = 0,
+            HANDLE,
+            DISPATCH,
+            E2E,
+            STAGE_COUNT
+        };
+        enum port {
+            ARRIVING = 0,
+            HANDLING,
+            HANDLED,
+            LEAVING,
+            PORT_COUNT
+        };
+        static constexpr int quantile_count = 4;
+        static const std::array<double, quantile_count> quantiles;
+
+        using steady_time = std::chrono::steady_clock::time_point;
+
+        struct node_metrics {
+            std::shared_ptr<vp_nodes::vp_node> node;
+            std::array<std::atomic<uint64_t>, PORT_COUNT> port_counts;
+            std::array<vp_latency_histogram, STAGE_COUNT> stages;
+
+            // time when meta passed the previous port, indexed by the stage it is in and keyed by channel_index then frame_index
+            // (not by address, a freed meta's address is soon reused by a new one).
+            std::mutex pending_lock;
+            std::array<std::unordered_map<int, std::map<int, steady_time>>, E2E> pending;
+
+            /* last window, guarded by window_lock of vp_pipeline_metrics */
+            std::array<std::vector<uint64_t>, STAGE_COUNT> window_start_buckets;
+            std::array<uint64_t, PORT_COUNT> window_start_counts {};
+            std::array<std::array<double, quantile_count>, STAGE_COUNT> window_quantiles {};
+            std::array<double, PORT_COUNT> window_fps {};
+        };
+
+        std::vector<std::shared_ptr<node_metrics>> all_node_metrics;
+        int window_seconds;
+
+        std::mutex window_lock;
+        steady_time window_start;
+
+        // window thread, rolls windows and dumps file
+        std::thread window_th;
+        std::mutex alive_lock;
+        std::condition_variable alive_cond;
+        bool alive = true;
+        std::string dump_path;
+
+        // http endpoint
+        std::unique_ptr<httplib::Server> server;
+        std::thread server_th;
+
+        void attach(std::shared_ptr<node_metrics> metrics);
+        void detach(std::shared_ptr<node_metrics> metrics);
+        // meta passed port of node
+        void on_port(node_metrics& metrics, port p, const std::shared_ptr<vp_objects::vp_meta>& meta);
+        void roll_window();
+        void window_run();
+        void dump();
+    public:
+        vp_pipeline_metrics(std::vector<std::shared_ptr<vp_nodes::vp_node>> src_nodes_in_pipe, int window_seconds = 10);
+        ~vp_pipeline_metrics();
+
+        vp_pipeline_metrics(const vp_pipeline_metrics&) = delete;
+        vp_pipeline_metrics& operator=(const vp_pipeline_metrics&) = delete;
+
+        // serve `GET /metrics` on host:port in a background thread, return false if port can not be bound.
+        bool serve(std::string host = "0.0.0.0", int port = 9464);
+        // write metrics to file at the end of every window (replaced as a whole, readers never see partial content).
+        void dump_to(std::string path);
+        // metrics in Prometheus text exposition format
+        std::string render();
+        // human readable table, one row per node: metas handled, dropped, and queue/handle/e2e quantiles since created
+        // (not windowed), for reports at the end of a run such as vp_bench.
+        std::string summary();
+    };
+}
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#include "vp_tracer.h"
+#include "vp_utils/logger/vp_logger.h"
+
+namespace vp_utils {
+
+    namespace {
+        // name given by set_thread_name(...), kept even if no buffer exists yet
+        thread_local std::string current_thread_name;
+
+        void write_json_string(std::ostream& out, const std::string& s) {
+            out << '"';
+            for (auto c: s) {
+                switch (c) {
+                    case '"': out << "\\\""; break;
+                    case '\\': out << "\\\\"; break;
+                    case '\n': out << "\\n"; break;
+                    case '\t': out << "\\t"; break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            char buf[8];
+                            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                            out << buf;
+                        }
+                        else {
+                            out << c;
+                        }
+                }
+            }
+            out << '"';
+        }
+
+        // microseconds with fraction, the unit of Chrome Trace Event format
+        void write_us(std::ostream& out, int64_t ns) {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%.3f", ns / 1000.0);
+            out << buf;
+        }
+    }
+
+    vp_tracer::vp_tracer() {
+        // id 0 for spans whose name is not interned
+        intern("unknown");
+    }
+
+    std::shared_ptr<vp_tracer::thread_buffer>& vp_tracer::current_buffer() {
+        thread_local std::shared_ptr<thread_buffer> buffer;
+        return buffer;
+    }
+
+    vp_tracer::thread_buffer* vp_tracer::local_buffer() {
+        auto& buffer = current_buffer();
+        auto s = session.load(std::memory_order_acquire);
+        if (buffer != nullptr && buffer->session.load(std::memory_order_relaxed) == s) {
+            return buffer.get();
+        }
+
+        // first span of thread or of a new session, dump(...) skips buffers of other sessions so they are safe to reset
+        auto capacity = events_per_thread.load(std::memory_order_relaxed);
+        if (buffer == nullptr) {
+            auto fresh = std::make_shared<thread_buffer>();
+            std::lock_guard<std::mutex> guard(registry_lock);
+            fresh->tid = next_tid++;
+            fresh->thread_name = current_thread_name.empty() ? "thread " + std::to_string(fresh->tid) : current_thread_name;
+            buffers.push_back(fresh);
+            buffer = fresh;
+        }
+        if (buffer->capacity != capacity) {
+            buffer->events.reset(new vp_trace_event[capacity]);
+            buffer->capacity = capacity;
+        }
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->session.store(s, std::memory_order_release);
+        return buffer.get();
+    }
+
+    void vp_tracer::start(int events_per_thread) {
+        std::lock_guard<std::mutex> guard(registry_lock);
+        // forget threads which have exited
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(), [](const std::shared_ptr<thread_buffer>& b) { return b.use_count() == 1; }), buffers.end());
+        this->events_per_thread.store(std::max(1, events_per_thread), std::memory_order_relaxed);
+        origin_ns = now_ns();
+        session.fetch_add(1, std::memory_order_release);
+        enabled.store(true);
+        VP_INFO(vp_utils::string_format("[tracer] start session %d, %d spans per thread at most", session.load(), this->events_per_thread.load()));
+    }
+
+    void vp_tracer::stop() {
+        enabled.store(false);
+    }
+
+    uint32_t vp_tracer::intern(const std::string& name) {
+        std::lock_guard<std::mutex> guard(registry_lock);
+        auto it = name_ids.find(name);
+        if (it != name_ids.end()) {
+            return it->second;
+        }
+        auto id = static_cast<uint32_t>(names.size());
+        names.push_back(name);
+        name_ids[name] = id;
+        return id;
+    }
+
+    void vp_tracer::record(const vp_trace_event& event) {
+        if (!is_enabled()) {
+            return;
+        }
+        auto buffer = local_buffer();
+        auto index = buffer->count.load(std::memory_order_relaxed);
+        if (index >= buffer->capacity) {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffer->events[index] = event;
+        // publish to dump(...)
+        buffer->count.store(index + 1, std::memory_order_release);
+    }
+
+    void vp_tracer::set_thread_name(const std::string& name) {
+        current_thread_name = name;
+        auto& buffer = current_buffer();
+        if (buffer != nullptr) {
+            auto& tracer = get_tracer();
+            std::lock_guard<std::mutex> guard(tracer.registry_lock);
+            buffer->thread_name = name;
+        }
+    }
+
+    uint64_t vp_tracer::dropped() {
+        std::lock_guard<std::mutex> guard(registry_lock);
+        auto s = session.load();
+        uint64_t total = 0;
+        for (auto& b: buffers) {
+            if (b->session.load(std::memory_order_acquire) == s) {
+                total += b->dropped.load(std::memory_order_relaxed);
+            }
+        }
+        return total;
+    }
+
+    bool vp_tracer::dump(const std::string& path) {
+        std::lock_guard<std::mutex> guard(registry_lock);
+        auto s = session.load();
+        uint64_t total_dropped = 0;
+        uint64_t total_spans = 0;
+
+        // write aside and rename, so readers never see partial content
+        auto tmp_path = path + ".tmp";
+        {
+            std::ofstream f(tmp_path, std::ofstream::out | std::ofstream::trunc);
+            if (!f.is_open()) {
+                VP_WARN(vp_utils::string_format("[tracer] open trace file failed: `%s`", tmp_path.c_str()));
+                return false;
+            }
+            f << "{\"traceEvents\":[\n";
+            f << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"VideoPipe\"}}";
+            for (auto& b: buffers) {
+                if (s == 0 || b->session.load(std::memory_order_acquire) != s) {
+                    continue;
+                }
+                // spans before count never change in the session
+                auto count = b->count.load(std::memory_order_acquire);
+                total_dropped += b->dropped.load(std::memory_order_relaxed);
+                total_spans += count;
+
+                f << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid << ",\"args\":{\"name\":";
+                write_json_string(f, b->thread_name);
+                f << "}}";
+                for (int i = 0; i < count; i++) {
+                    auto& e = b->events[i];
+                    auto name_id = e.name < names.size() ? e.name : 0;
+                    f << ",\n{\"name\":";
+                    write_json_string(f, names[name_id]);
+                    f << ",\"cat\":\"" << (e.category != nullptr ? e.category : "span") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->tid << ",\"ts\":";
+                    write_us(f, e.begin_ns - origin_ns);
+                    f << ",\"dur\":";
+                    write_us(f, e.end_ns - e.begin_ns);
+                    if (e.flow && e.frame_index >= 0) {
+                        // chain of spans sharing the id, in order of time
+                        auto id = (static_cast<uint64_t>(static_cast<uint32_t>(e.channel)) << 32) | static_cast<uint32_t>(e.frame_index);
+                        f << ",\"bind_id\":\"0x" << std::hex << id << std::dec << "\",\"flow_in\":true,\"flow_out\":true";
+                    }
+                    f << ",\"args\":{\"channel\":" << e.channel << ",\"frame_index\":" << e.frame_index << "}}";
+                }
+            }
+            f << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_spans\":" << total_dropped << "}}\n";
+            if (!f.good()) {
+                VP_WARN(vp_utils::string_format("[tracer] write trace file failed: `%s`", tmp_path.c_str()));
+                return false;
+            }
+        }
+        if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+            VP_WARN(vp_utils::string_format("[tracer] replace trace file failed: `%s`", path.c_str()));
+            return false;
+        }
+        if (total_dropped > 0) {
+            VP_WARN(vp_utils::string_format("[tracer] %llu spans dropped since buffers were full, start with larger events_per_thread",
+                                            static_cast<unsigned long long>(total_dropped)));
+        }
+        VP_INFO(vp_utils::string_format("[tracer] %llu spans written to `%s`", static_cast<unsigned long long>(total_spans), path.c_str()));
+        return true;
+    }
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vp_utils {
+    // one span on a thread, names are interned ids and categories are string literals
+    struct vp_trace_event {
+        int64_t begin_ns = 0;
+        int64_t end_ns = 0;
+        const char* category = nullptr;
+        uint32_t name = 0;
+        int channel = -1;
+        int frame_index = -1;
+        // link spans of the same frame (channel + frame_index) across nodes and threads
+        bool flow = false;
+    };
+
+    // opt-in timeline of how frame metas flow through the pipeline, viewed in Perfetto (https://ui.perfetto.dev) or chrome://tracing.
+    // 1. spans (node, stage, thread, begin/end, channel, frame_index) are appended to a buffer owned by the recording thread,
+    //    no lock and no allocation after the first span of a thread. a full buffer drops new spans and counts them.
+    // 2. spans of the same frame are connected by flow arrows, so the gaps between them (queue waits, stalls) are visible.
+    // 3. dump(...) writes everything recorded since start(...) in Chrome Trace Event JSON, it can run while recording.
+    // disabled by default, a disabled tracer costs one relaxed load per span.
+    class vp_tracer
+    {
+    private:
+        struct thread_buffer {
+            int tid = 0;
+            // guarded by registry_lock
+            std::string thread_name;
+            std::unique_ptr<vp_trace_event[]> events;
+            int capacity = 0;
+            // written by owner thread only, spans before count are complete
+            std::atomic<int> count {0};
+            std::atomic<uint64_t> dropped {0};
+            // session the buffer belongs to, owner resets the buffer when a new session starts
+            std::atomic<int> session {0};
+        };
+
+        std::atomic<bool> enabled {false};
+        // bumped by start(), 0 means never started
+        std::atomic<int> session {0};
+        std::atomic<int> events_per_thread {0};
+        int64_t origin_ns = 0;
+
+        // buffers of all threads ever recorded (kept after threads exit), names and dumping
+        std::mutex registry_lock;
+        std::vector<std::shared_ptr<thread_buffer>> buffers;
+        std::deque<std::string> names;
+        std::unordered_map<std::string, uint32_t> name_ids;
+
+        int next_tid = 1;
+
+        // buffer of current thread, shared with registry so it can be dumped after the thread exits
+        static std::shared_ptr<thread_buffer>& current_buffer();
+        // buffer of current thread for current session, nullptr if it can not be created
+        thread_buffer* local_buffer();
+
+        vp_tracer();
+    public:
+        // non-copable
+        vp_tracer(const vp_tracer&) = delete;
+        vp_tracer& operator=(const vp_tracer&) = delete;
+
+        // singleton
+        static vp_tracer& get_tracer() {
+            static vp_tracer tracer;
+            return tracer;
+        }
+
+        // start a new session (spans of the previous one are discarded), each thread keeps at most events_per_thread spans.
+        // note: do not call it while dump(...) is running.
+        void start(int events_per_thread = 16384);
+        // stop recording, spans recorded so far can still be dumped.
+        void stop();
+
+        bool is_enabled() const {
+            return enabled.load(std::memory_order_relaxed);
+        }
+
+        // id of name used by record(...), same name gets same id. call it once (such as in constructor), not per span.
+        uint32_t intern(const std::string& name);
+
+        // append a span to buffer of current thread, ignored if disabled.
+        void record(const vp_trace_event& event);
+
+        // name of current thread in timeline, call it at the beginning of thread (works before start(...) too).
+        static void set_thread_name(const std::string& name);
+
+        // write spans of current session to file in Chrome Trace Event JSON, return false if file can not be written.
+        bool dump(const std::string& path);
+
+        // spans dropped in current session since buffers were full
+        uint64_t dropped();
+
+        static int64_t now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    };
+
+    // span covering its own scope, recorded when destroyed.
+    // example:
+    // {
+    //     vp_utils::vp_trace_scope trace(trace_name, "infer");
+    //     trace.bind_frame(frame_meta->channel_index, frame_meta->frame_index);
+    //     ...
+    // }
+    class vp_trace_scope
+    {
+    private:
+        vp_trace_event event;
+        bool active;
+    public:
+        vp_trace_scope(uint32_t name, const char* category): active(vp_tracer::get_tracer().is_enabled()) {
+            if (active) {
+                event.name = name;
+                event.category = category;
+                event.begin_ns = vp_tracer::now_ns();
+            }
+        }
+        ~vp_trace_scope() {
+            if (active) {
+                event.end_ns = vp_tracer::now_ns();
+                vp_tracer::get_tracer().record(event);
+            }
+        }
+
+        vp_trace_scope(const vp_trace_scope&) = delete;
+        vp_trace_scope& operator=(const vp_trace_scope&) = delete;
+
+        // recording or not, skip collecting span arguments if false
+        bool is_active() const {
+            return active;
+        }
+
+        // frame the span works on, connected to other spans of the frame by flow arrows if flow is true
+        void bind_frame(int channel, int frame_index, bool flow = true) {
+            event.channel = channel;
+            event.frame_index = frame_index;
+            event.flow = flow;
+        }
+    };
+
+    // control Macros
+    #define VP_TRACE_START(_events_per_thread) vp_utils::vp_tracer::get_tracer().start(_events_per_thread)
+    #define VP_TRACE_STOP() vp_utils::vp_tracer::get_tracer().stop()
+    #define VP_TRACE_DUMP(_path) vp_utils::vp_tracer::get_tracer().dump(_path)
+}
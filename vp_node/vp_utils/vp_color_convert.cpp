@@ -0,0 +1,231 @@
+#include <cstdint>
+#include <opencv2/imgproc.hpp>
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "vp_color_convert.h"
+#include "vp_frame_buffer_pool.h"
+
+#include "im2d.h"
+#include "RgaUtils.h"
+#include "im2d_common.h"
+
+namespace vp_utils {
+
+    namespace {
+        void prepare_dst(cv::Mat& dst, int rows, int cols, int type) {
+            if (dst.rows != rows || dst.cols != cols || dst.type() != type || !dst.isContinuous()) {
+                dst = vp_frame_buffer_pool::host().alloc(rows, cols, type);
+            }
+        }
+
+        bool rga_nv12_to_bgr(rga_buffer_t src, cv::Mat& bgr) {
+            auto dst = wrapbuffer_virtualaddr(bgr.data, bgr.cols, bgr.rows, RK_FORMAT_BGR_888);
+            return imcvtcolor(src, dst, RK_FORMAT_YCbCr_420_SP, RK_FORMAT_BGR_888) == IM_STATUS_SUCCESS;
+        }
+
+        // BT.601 limited range integer coefficients (8 bit fraction)
+        inline uint8_t rgb_to_y(int r, int g, int b) {
+            return static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        }
+        inline uint8_t rgb_to_u(int r, int g, int b) {
+            return static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        }
+        inline uint8_t rgb_to_v(int r, int g, int b) {
+            return static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+
+#if defined(__ARM_NEON)
+        // Y of 16 deinterleaved BGR pixels
+        inline uint8x16_t neon_luma(const uint8x16x3_t& bgr) {
+            const uint8x8_t k_r = vdup_n_u8(66);
+            const uint8x8_t k_g = vdup_n_u8(129);
+            const uint8x8_t k_b = vdup_n_u8(25);
+            // max 220 * 255, fits in u16
+            uint16x8_t lo = vmull_u8(vget_low_u8(bgr.val[2]), k_r);
+            lo = vmlal_u8(lo, vget_low_u8(bgr.val[1]), k_g);
+            lo = vmlal_u8(lo, vget_low_u8(bgr.val[0]), k_b);
+            uint16x8_t hi = vmull_u8(vget_high_u8(bgr.val[2]), k_r);
+            hi = vmlal_u8(hi, vget_high_u8(bgr.val[1]), k_g);
+            hi = vmlal_u8(hi, vget_high_u8(bgr.val[0]), k_b);
+            // (x + 128) >> 8, then + 16
+            return vaddq_u8(vcombine_u8(vrshrn_n_u16(lo, 8), vrshrn_n_u16(hi, 8)), vdupq_n_u8(16));
+        }
+
+        // 8 chroma samples from 2x2 averaged channels (0..255 in s16), (x + 128) >> 8 + 128
+        inline uint8x8_t neon_chroma(int16x8_t a, int16_t ka, int16x8_t b, int16_t kb, int16x8_t c, int16_t kc) {
+            int16x8_t acc = vmulq_n_s16(a, ka);
+            acc = vmlaq_n_s16(acc, b, kb);
+            acc = vmlaq_n_s16(acc, c, kc);
+            acc = vshrq_n_s16(vaddq_s16(acc, vdupq_n_s16(128)), 8);
+            return vqmovun_s16(vaddq_s16(acc, vdupq_n_s16(128)));
+        }
+#endif
+
+        // convert two BGR rows into two Y rows and one interleaved UV row, width must be even.
+        void bgr_rows_to_nv12(const uint8_t* bgr0, const uint8_t* bgr1, uint8_t* y0, uint8_t* y1, uint8_t* uv, int width) {
+            int x = 0;
+#if defined(__ARM_NEON)
+            for (; x + 16 <= width; x += 16) {
+                const uint8x16x3_t p0 = vld3q_u8(bgr0 + x * 3);
+                const uint8x16x3_t p1 = vld3q_u8(bgr1 + x * 3);
+                vst1q_u8(y0 + x, neon_luma(p0));
+                vst1q_u8(y1 + x, neon_luma(p1));
+
+                // horizontal pair sums of both rows, then rounded average of the 2x2 block
+                const int16x8_t b = vreinterpretq_s16_u16(vrshrq_n_u16(vaddq_u16(vpaddlq_u8(p0.val[0]), vpaddlq_u8(p1.val[0])), 2));
+                const int16x8_t g = vreinterpretq_s16_u16(vrshrq_n_u16(vaddq_u16(vpaddlq_u8(p0.val[1]), vpaddlq_u8(p1.val[1])), 2));
+                const int16x8_t r = vreinterpretq_s16_u16(vrshrq_n_u16(vaddq_u16(vpaddlq_u8(p0.val[2]), vpaddlq_u8(p1.val[2])), 2));
+                uint8x8x2_t chroma;
+                chroma.val[0] = neon_chroma(r, -38, g, -74, b, 112);
+                chroma.val[1] = neon_chroma(r, 112, g, -94, b, -18);
+                vst2_u8(uv + x, chroma);
+            }
+#endif
+            for (; x < width; x += 2) {
+                const uint8_t* a = bgr0 + x * 3;
+                const uint8_t* c = bgr1 + x * 3;
+                y0[x] = rgb_to_y(a[2], a[1], a[0]);
+                y0[x + 1] = rgb_to_y(a[5], a[4], a[3]);
+                y1[x] = rgb_to_y(c[2], c[1], c[0]);
+                y1[x + 1] = rgb_to_y(c[5], c[4], c[3]);
+                const int b = (a[0] + a[3] + c[0] + c[3] + 2) >> 2;
+                const int g = (a[1] + a[4] + c[1] + c[4] + 2) >> 2;
+                const int r = (a[2] + a[5] + c[2] + c[5] + 2) >> 2;
+                uv[x] = rgb_to_u(r, g, b);
+                uv[x + 1] = rgb_to_v(r, g, b);
+            }
+        }
+    }
+
+    bool nv12_to_bgr(const cv::Mat& nv12, cv::Mat& bgr) {
+        if (nv12.empty() || nv12.type() != CV_8UC1 || nv12.rows % 3 != 0) {
+            return false;
+        }
+        auto height = nv12.rows * 2 / 3;
+        auto width = nv12.cols;
+        if (width <= 1 || height <= 1) {
+            return false;
+        }
+        return nv12_to_bgr(-1, nv12.data, nv12.step[0] * nv12.rows, width, height, static_cast<int>(nv12.step[0]), height, bgr);
+    }
+
+    bool nv12_to_bgr(int fd, void* data, size_t size, int width, int height, int hor_stride, int ver_stride, cv::Mat& bgr) {
+        if (width <= 1 || height <= 1 || hor_stride < width || ver_stride < height || (fd < 0 && data == nullptr)) {
+            return false;
+        }
+        prepare_dst(bgr, height, width, CV_8UC3);
+
+        // hardware path
+        if (fd >= 0) {
+            auto handle = importbuffer_fd(fd, static_cast<int>(size));
+            if (handle != 0) {
+                auto src = wrapbuffer_handle(handle, width, height, RK_FORMAT_YCbCr_420_SP, hor_stride, ver_stride);
+                auto ok = rga_nv12_to_bgr(src, bgr);
+                releasebuffer_handle(handle);
+                if (ok) {
+                    return true;
+                }
+            }
+        }
+        if (data == nullptr) {
+            return false;
+        }
+        auto src = wrapbuffer_virtualaddr(data, width, height, RK_FORMAT_YCbCr_420_SP, hor_stride, ver_stride);
+        if (rga_nv12_to_bgr(src, bgr)) {
+            return true;
+        }
+
+        // software fallback
+        auto base = static_cast<uchar*>(data);
+        cv::Mat y(height, width, CV_8UC1, base, hor_stride);
+        cv::Mat uv(height / 2, width / 2, CV_8UC2, base + static_cast<size_t>(hor_stride) * ver_stride, hor_stride);
+        cv::cvtColorTwoPlane(y, uv, bgr, cv::COLOR_YUV2BGR_NV12);
+        return !bgr.empty();
+    }
+
+    bool bgr_to_nv12(const cv::Mat& bgr, cv::Mat& nv12, bool try_rga) {
+        if (bgr.empty() || bgr.type() != CV_8UC3) {
+            return false;
+        }
+        auto width = bgr.cols & ~1;
+        auto height = bgr.rows & ~1;
+        if (width <= 1 || height <= 1) {
+            return false;
+        }
+        prepare_dst(nv12, height * 3 / 2, width, CV_8UC1);
+
+        // hardware path, the even crop is expressed by width/height within the original strides
+        if (try_rga && bgr.step[0] % 3 == 0) {
+            auto src = wrapbuffer_virtualaddr(bgr.data, width, height, RK_FORMAT_BGR_888, static_cast<int>(bgr.step[0] / 3), bgr.rows);
+            auto dst = wrapbuffer_virtualaddr(nv12.data, width, height, RK_FORMAT_YCbCr_420_SP);
+            if (imcvtcolor(src, dst, RK_FORMAT_BGR_888, RK_FORMAT_YCbCr_420_SP) == IM_STATUS_SUCCESS) {
+                return true;
+            }
+        }
+
+        // software path, one pass over the image, no intermediate I420
+        for (int row = 0; row < height; row += 2) {
+            bgr_rows_to_nv12(bgr.ptr<uint8_t>(row), bgr.ptr<uint8_t>(row + 1),
+                             nv12.ptr<uint8_t>(row), nv12.ptr<uint8_t>(row + 1), nv12.ptr<uint8_t>(height + row / 2), width);
+        }
+        return true;
+    }
+
+    bool nv12_to_grey(int fd, void* data, size_t size, int width, int height, int hor_stride, int ver_stride, 
+                      int dst_width, int dst_height, cv::Mat& grey) {
+        if (width <= 1 || height <= 1 || hor_stride < width || ver_stride < height || dst_width <= 0 || dst_height <= 0 
+            || (fd < 0 && data == nullptr)) {
+            return false;
+        }
+        prepare_dst(grey, dst_height, dst_width, CV_8UC1);
+        auto dst = wrapbuffer_virtualaddr(grey.data, dst_width, dst_height, RK_FORMAT_YCbCr_400);
+
+        // hardware path
+        if (fd >= 0) {
+            auto handle = importbuffer_fd(fd, static_cast<int>(size));
+            if (handle != 0) {
+                auto src = wrapbuffer_handle(handle, width, height, RK_FORMAT_YCbCr_400, hor_stride, ver_stride);
+                auto ok = imresize(src, dst) == IM_STATUS_SUCCESS;
+                releasebuffer_handle(handle);
+                if (ok) {
+                    return true;
+                }
+            }
+        }
+        if (data == nullptr) {
+            return false;
+        }
+        auto src = wrapbuffer_virtualaddr(data, width, height, RK_FORMAT_YCbCr_400, hor_stride, ver_stride);
+        if (imresize(src, dst) == IM_STATUS_SUCCESS) {
+            return true;
+        }
+
+        // software fallback
+        cv::Mat y(height, width, CV_8UC1, data, hor_stride);
+        cv::resize(y, grey, grey.size(), 0, 0, cv::INTER_AREA);
+        return true;
+    }
+
+    bool frame_to_grey(const cv::Mat& frame, int dst_width, int dst_height, cv::Mat& grey) {
+        if (frame.empty() || dst_width <= 0 || dst_height <= 0) {
+            return false;
+        }
+        if (frame.type() == CV_8UC1 && frame.rows % 3 == 0) {
+            // Y plane of NV12 is grey already
+            auto height = frame.rows * 2 / 3;
+            return nv12_to_grey(-1, frame.data, frame.step[0] * frame.rows, frame.cols, height, static_cast<int>(frame.step[0]), height, 
+                                dst_width, dst_height, grey);
+        }
+        if (frame.type() != CV_8UC3) {
+            return false;
+        }
+        // shrink first, then convert fewer pixels
+        prepare_dst(grey, dst_height, dst_width, CV_8UC1);
+        cv::Mat small;
+        cv::resize(frame, small, grey.size(), 0, 0, cv::INTER_AREA);
+        cv::cvtColor(small, grey, cv::COLOR_BGR2GRAY);
+        return true;
+    }
+}
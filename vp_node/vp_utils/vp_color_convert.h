@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <opencv2/core/core.hpp>
+
+namespace vp_utils {
+    // colour conversion helpers for frame images.
+    // output Mats are allocated from vp_frame_buffer_pool::host() unless dst already has the right size/type.
+    // RGA is tried first and cv::cvtColor is the fallback, results are identical in layout either way.
+
+    // convert compact NV12 (CV_8UC1, rows == height * 3 / 2) to BGR (CV_8UC3).
+    bool nv12_to_bgr(const cv::Mat& nv12, cv::Mat& bgr);
+
+    // convert strided NV12 to BGR, the UV plane starts at data + hor_stride * ver_stride.
+    // fd is the dma-buf of data (-1 if not available), RGA imports it directly instead of going through virtual address.
+    bool nv12_to_bgr(int fd, void* data, size_t size, int width, int height, int hor_stride, int ver_stride, cv::Mat& bgr);
+
+    // convert BGR (CV_8UC3) to compact NV12 (CV_8UC1, rows == height * 3 / 2), odd width/height are cropped to even.
+    // the software path is a fused single pass (NEON on arm, scalar elsewhere) writing Y and interleaved UV directly,
+    // BT.601 limited range with 2x2 averaged chroma like cv::COLOR_BGR2YUV_I420.
+    // try_rga asks RGA first, it saves CPU but costs a synchronous job per frame, so it is opt-in here.
+    bool bgr_to_nv12(const cv::Mat& bgr, cv::Mat& nv12, bool try_rga = false);
+
+    // downscale the Y plane of strided NV12 (same arguments as nv12_to_bgr) to grey (CV_8UC1, dst_width x dst_height).
+    // RGA resizes the Y plane alone (read as YCbCr_400), cv::resize with INTER_AREA is the fallback.
+    bool nv12_to_grey(int fd, void* data, size_t size, int width, int height, int hor_stride, int ver_stride, 
+                      int dst_width, int dst_height, cv::Mat& grey);
+
+    // grey (CV_8UC1, dst_width x dst_height) of BGR (CV_8UC3) or compact NV12 (CV_8UC1, rows == height * 3 / 2).
+    bool frame_to_grey(const cv::Mat& frame, int dst_width, int dst_height, cv::Mat& grey);
+}
@@ -0,0 +1,184 @@
+#include <cstdlib>
+
+#include "vp_frame_buffer_pool.h"
+#include "allocator/dma/dma_alloc.h"
+
+namespace vp_utils {
+
+    namespace {
+        constexpr size_t page_size = 4096;
+
+        size_t round_to_page(size_t size) {
+            return (size + page_size - 1) / page_size * page_size;
+        }
+    }
+
+    vp_frame_buffer_pool::vp_frame_buffer_pool(vp_buffer_backend backend, size_t max_cached_bytes):
+                                                backend(backend),
+                                                max_cached_bytes(max_cached_bytes) {
+    }
+
+    vp_frame_buffer_pool::~vp_frame_buffer_pool() {
+        std::lock_guard<std::mutex> guard(pool_lock);
+        for (auto& i: idle_blocks) {
+            for (auto b: i.second) {
+                free_block(b);
+            }
+        }
+        idle_blocks.clear();
+        idle_bytes = 0;
+    }
+
+    vp_frame_buffer_pool& vp_frame_buffer_pool::host() {
+        // leaked on purpose, Mats allocated by pool may be released during static destruction
+        static auto pool = new vp_frame_buffer_pool(vp_buffer_backend::HOST);
+        return *pool;
+    }
+
+    vp_frame_buffer_pool& vp_frame_buffer_pool::dma() {
+        static auto pool = new vp_frame_buffer_pool(vp_buffer_backend::DMA_HEAP);
+        return *pool;
+    }
+
+    vp_frame_buffer_pool::block* vp_frame_buffer_pool::acquire(size_t size) const {
+        auto class_size = round_to_page(size);
+        {
+            std::lock_guard<std::mutex> guard(pool_lock);
+            auto it = idle_blocks.find(class_size);
+            if (it != idle_blocks.end() && !it->second.empty()) {
+                auto b = it->second.back();
+                it->second.pop_back();
+                idle_bytes -= b->size;
+                hit_count++;
+                return b;
+            }
+        }
+
+        // allocate outside of lock, it may take a while for big buffers
+        miss_count++;
+        auto b = new block();
+        b->size = class_size;
+        if (backend == vp_buffer_backend::DMA_HEAP && !dma_unavailable.load()) {
+            if (dma_buf_alloc(DMA_HEAP_PATH, class_size, &b->fd, &b->data) < 0) {
+                b->fd = -1;
+                b->data = nullptr;
+                dma_unavailable.store(true);
+            }
+        }
+        if (b->data == nullptr) {
+            b->data = std::aligned_alloc(page_size, class_size);
+        }
+        if (b->data == nullptr) {
+            delete b;
+            CV_Error(cv::Error::StsNoMem, "vp_frame_buffer_pool: failed to allocate frame buffer");
+        }
+        return b;
+    }
+
+    void vp_frame_buffer_pool::recycle(block* b) const {
+        {
+            std::lock_guard<std::mutex> guard(pool_lock);
+            if (idle_bytes + b->size <= max_cached_bytes) {
+                idle_blocks[b->size].push_back(b);
+                idle_bytes += b->size;
+                return;
+            }
+        }
+        free_block(b);
+    }
+
+    void vp_frame_buffer_pool::free_block(block* b) const {
+        if (b->fd >= 0) {
+            dma_buf_free(b->size, &b->fd, b->data);
+        }
+        else {
+            std::free(b->data);
+        }
+        delete b;
+    }
+
+    cv::Mat vp_frame_buffer_pool::alloc(int rows, int cols, int type) const {
+        cv::Mat mat;
+        mat.allocator = const_cast<vp_frame_buffer_pool*>(this);
+        mat.create(rows, cols, type);
+        return mat;
+    }
+
+    cv::Mat vp_frame_buffer_pool::clone(const cv::Mat& src) const {
+        if (src.empty()) {
+            return cv::Mat();
+        }
+        auto dst = alloc(src.rows, src.cols, src.type());
+        src.copyTo(dst);
+        return dst;
+    }
+
+    int vp_frame_buffer_pool::get_fd(const cv::Mat& mat) {
+        if (mat.u == nullptr || mat.u->handle == nullptr
+            || dynamic_cast<const vp_frame_buffer_pool*>(mat.u->currAllocator) == nullptr) {
+            return -1;
+        }
+        return static_cast<block*>(mat.u->handle)->fd;
+    }
+
+    size_t vp_frame_buffer_pool::cached_bytes() const {
+        std::lock_guard<std::mutex> guard(pool_lock);
+        return idle_bytes;
+    }
+
+    uint64_t vp_frame_buffer_pool::hits() const {
+        return hit_count.load();
+    }
+
+    uint64_t vp_frame_buffer_pool::misses() const {
+        return miss_count.load();
+    }
+
+    // same layout rules as cv::StdMatAllocator, only the memory source differs.
+    cv::UMatData* vp_frame_buffer_pool::allocate(int dims, const int* sizes, int type, void* data0, size_t* step, cv::AccessFlag /*flags*/, cv::UMatUsageFlags /*usage_flags*/) const {
+        size_t total = CV_ELEM_SIZE(type);
+        for (int i = dims - 1; i >= 0; i--) {
+            if (step) {
+                if (data0 && step[i] != CV_AUTOSTEP) {
+                    CV_Assert(total <= step[i]);
+                    total = step[i];
+                }
+                else {
+                    step[i] = total;
+                }
+            }
+            total *= sizes[i];
+        }
+
+        auto u = new cv::UMatData(this);
+        u->size = total;
+        if (data0) {
+            u->data = u->origdata = static_cast<uchar*>(data0);
+            u->flags |= cv::UMatData::USER_ALLOCATED;
+            return u;
+        }
+
+        auto b = acquire(total);
+        u->data = u->origdata = static_cast<uchar*>(b->data);
+        u->handle = b;
+        return u;
+    }
+
+    bool vp_frame_buffer_pool::allocate(cv::UMatData* data, cv::AccessFlag /*access_flags*/, cv::UMatUsageFlags /*usage_flags*/) const {
+        return data != nullptr;
+    }
+
+    void vp_frame_buffer_pool::deallocate(cv::UMatData* data) const {
+        if (data == nullptr) {
+            return;
+        }
+        CV_Assert(data->urefcount == 0);
+        CV_Assert(data->refcount == 0);
+        if (!(data->flags & cv::UMatData::USER_ALLOCATED) && data->handle != nullptr) {
+            recycle(static_cast<block*>(data->handle));
+            data->handle = nullptr;
+        }
+        data->origdata = nullptr;
+        delete data;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+namespace vp_utils {
+    // where pooled frame buffers come from.
+    enum class vp_buffer_backend {
+        HOST,      // page-aligned host memory
+        DMA_HEAP   // dma_heap buffers (include/allocator/dma), exported as dma-buf fd for RGA/RKNN/MPP. falls back to HOST if dma_heap is not available
+    };
+
+    // size-class pool for frame-sized image buffers (frame/osd_frame/NV12 payloads in vp_frame_meta).
+    // it is a cv::MatAllocator, buffers are handed out as ordinary cv::Mat and go back to the pool automatically
+    // when the last cv::Mat referencing them is released, that is when the last vp_frame_meta holding the image is destroyed.
+    // so sources do not hit the system allocator with multi-megabyte requests (and page faults on fresh pages) for every frame.
+    //
+    // size classes are byte sizes rounded up to page size, frames of the same resolution/type always share one class.
+    // cached (idle) bytes are capped by max_cached_bytes, buffers beyond the cap are freed instead of cached.
+    //
+    // note: the pool must outlive all Mats it allocated, use the process-wide instances returned by host()/dma().
+    // note: cv::Mat::clone()/copyTo() on a pooled Mat allocate from default allocator, use clone() of pool instead.
+    class vp_frame_buffer_pool: public cv::MatAllocator {
+    private:
+        // a pooled buffer
+        struct block {
+            void* data = nullptr;
+            size_t size = 0;
+            int fd = -1;  // dma-buf fd, -1 for host memory
+        };
+
+        vp_buffer_backend backend;
+        size_t max_cached_bytes;
+
+        // idle buffers by size class
+        mutable std::mutex pool_lock;
+        mutable std::unordered_map<size_t, std::vector<block*>> idle_blocks;
+        mutable size_t idle_bytes = 0;
+        // set once dma_heap allocation fails, later allocations use host memory directly
+        mutable std::atomic<bool> dma_unavailable {false};
+
+        // statistics
+        mutable std::atomic<uint64_t> hit_count {0};
+        mutable std::atomic<uint64_t> miss_count {0};
+
+        block* acquire(size_t size) const;
+        void recycle(block* b) const;
+        void free_block(block* b) const;
+    public:
+        vp_frame_buffer_pool(vp_buffer_backend backend = vp_buffer_backend::HOST, size_t max_cached_bytes = 256 * 1024 * 1024);
+        ~vp_frame_buffer_pool();
+
+        vp_frame_buffer_pool(const vp_frame_buffer_pool&) = delete;
+        vp_frame_buffer_pool& operator=(const vp_frame_buffer_pool&) = delete;
+
+        // process-wide pool backed by host memory, never destroyed.
+        static vp_frame_buffer_pool& host();
+        // process-wide pool backed by dma_heap, never destroyed.
+        static vp_frame_buffer_pool& dma();
+
+        // allocate a continuous Mat from pool, content is NOT initialized.
+        cv::Mat alloc(int rows, int cols, int type) const;
+        // deep copy src into a pooled Mat.
+        cv::Mat clone(const cv::Mat& src) const;
+
+        // dma-buf fd of the buffer behind mat, -1 if mat is not allocated by a DMA_HEAP pool (or falls back to host memory).
+        static int get_fd(const cv::Mat& mat);
+
+        // idle bytes cached in pool
+        size_t cached_bytes() const;
+        // allocations served from idle buffers / from system allocator
+        uint64_t hits() const;
+        uint64_t misses() const;
+
+        // cv::MatAllocator
+        cv::UMatData* allocate(int dims, const int* sizes, int type, void* data0, size_t* step, cv::AccessFlag flags, cv::UMatUsageFlags usage_flags) const override;
+        bool allocate(cv::UMatData* data, cv::AccessFlag access_flags, cv::UMatUsageFlags usage_flags) const override;
+        void deallocate(cv::UMatData* data) const override;
+    };
+}
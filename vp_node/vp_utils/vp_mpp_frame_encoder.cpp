@@ -0,0 +1,271 @@
+#include <cstring>
+
+#include "rockchip/mpp_buffer.h"
+
+#include "vp_mpp_frame_encoder.h"
+#include "vp_color_convert.h"
+#include "vp_utils.h"
+#include "logger/vp_logger.h"
+
+namespace vp_utils {
+
+    namespace {
+        // used when fps of stream is unknown
+        constexpr int default_fps = 25;
+
+        int align_up(int value, int align) {
+            return (value + align - 1) & ~(align - 1);
+        }
+
+        // Annex-B stream contains IDR (H.264) or BLA/IDR/CRA (H.265, nal type 16~21)
+        bool is_key_packet(const uint8_t* data, int size, bool h265) {
+            for (int i = 0; i + 3 < size; ++i) {
+                if (data[i] != 0 || data[i + 1] != 0 || data[i + 2] != 1) {
+                    continue;
+                }
+                auto nal = data[i + 3];
+                if (h265) {
+                    auto type = (nal >> 1) & 0x3f;
+                    if (type >= 16 && type <= 21) {
+                        return true;
+                    }
+                }
+                else if ((nal & 0x1f) == 5) {
+                    return true;
+                }
+                i += 3;
+            }
+            return false;
+        }
+    }
+
+    vp_mpp_frame_encoder::vp_mpp_frame_encoder(bool h265, int bitrate, bool use_rga, std::string tag):
+                                                h265(h265), bitrate(bitrate), use_rga(use_rga), tag(tag) {
+        memset(&params, 0, sizeof(params));
+    }
+
+    vp_mpp_frame_encoder::~vp_mpp_frame_encoder() {
+        encoder.reset();
+    }
+
+    bool vp_mpp_frame_encoder::init(int width, int height, int hor_stride, int ver_stride, int fps) {
+        enc_fps = fps > 0 ? fps : default_fps;
+
+        memset(&params, 0, sizeof(params));
+        params.width = width;
+        params.height = height;
+        params.hor_stride = hor_stride;
+        params.ver_stride = ver_stride;
+        params.fmt = MPP_FMT_YUV420SP;
+        params.type = h265 ? MPP_VIDEO_CodingHEVC : MPP_VIDEO_CodingAVC;
+        params.fps_in_num = enc_fps;
+        params.fps_in_den = 1;
+        params.fps_out_num = enc_fps;
+        params.fps_out_den = 1;
+        params.rc_mode = MPP_ENC_RC_MODE_CBR;
+        params.bps = bitrate * 1000;
+        // IDR every 2 seconds, muxing can only start at an IDR (new file, reconnect, pre-record ring head)
+        params.gop_len = enc_fps * 2;
+
+        encoder.reset(new MppEncoder());
+        if (encoder->Init(params, this) != 0) {
+            VP_ERROR(string_format("[%s] MppEncoder init failed %dx%d stride=%dx%d", tag.c_str(), width, height, hor_stride, ver_stride));
+            encoder.reset();
+            return false;
+        }
+        encoder->SetCallback(&vp_mpp_frame_encoder::on_encoded);
+
+        // SPS/PPS/VPS are far smaller than 4KB
+        std::vector<char> buffer(4096);
+        auto header_size = encoder->GetHeader(buffer.data(), static_cast<int>(buffer.size()));
+        if (header_size <= 0) {
+            VP_ERROR(string_format("[%s] MppEncoder get header failed", tag.c_str()));
+            encoder.reset();
+            return false;
+        }
+        stream_header.assign(buffer.begin(), buffer.begin() + header_size);
+
+        VP_INFO(string_format("[%s] encoder ready %dx%d stride=%dx%d fps=%d codec=%s",
+                                tag.c_str(), width, height, hor_stride, ver_stride, enc_fps, h265 ? "h265" : "h264"));
+        return true;
+    }
+
+    MppBuffer vp_mpp_frame_encoder::copy_to_input(const uint8_t* y_plane, const uint8_t* uv_plane, size_t pitch) {
+        // single buffer reused for every frame, Encode() is synchronous
+        auto buffer = static_cast<MppBuffer>(encoder->GetInputFrameBuffer());
+        if (!buffer) {
+            return nullptr;
+        }
+        auto dst = static_cast<uint8_t*>(encoder->GetInputFrameBufferAddr(buffer));
+        if (!dst) {
+            return nullptr;
+        }
+
+        size_t dst_pitch = params.hor_stride;
+        auto dst_uv = dst + dst_pitch * params.ver_stride;
+        for (RK_U32 row = 0; row < params.height; ++row) {
+            memcpy(dst + dst_pitch * row, y_plane + pitch * row, params.width);
+        }
+        for (RK_U32 row = 0; row < params.height / 2; ++row) {
+            memcpy(dst_uv + dst_pitch * row, uv_plane + pitch * row, params.width);
+        }
+        return buffer;
+    }
+
+    void vp_mpp_frame_encoder::on_encoded(void* userdata, const char* data, int size) {
+        auto self = static_cast<vp_mpp_frame_encoder*>(userdata);
+        if (size <= 0) {
+            return;
+        }
+        // called more than once per frame in split (low latency) mode, append to the same packet
+        int offset = 0;
+        if (self->encoded == nullptr) {
+            self->encoded = alloc_av_packet();
+            if (self->encoded == nullptr || av_new_packet(self->encoded.get(), size) < 0) {
+                self->encoded.reset();
+                return;
+            }
+        }
+        else {
+            offset = self->encoded->size;
+            if (av_grow_packet(self->encoded.get(), size) < 0) {
+                return;
+            }
+        }
+        memcpy(self->encoded->data + offset, data, size);
+    }
+
+    av_packet vp_mpp_frame_encoder::encode(const std::shared_ptr<vp_objects::vp_frame_meta>& meta, bool osd) {
+        if (init_failed) {
+            return nullptr;
+        }
+
+        // decoder buffer which can be imported without copy, only when encoding the original frame
+        std::shared_ptr<vp_objects::vp_dma_image> dma;
+        // compact NV12
+        cv::Mat nv12;
+        if (osd && !meta->osd_frame.empty()) {
+            if (meta->osd_frame.type() == CV_8UC1) {
+                nv12 = meta->osd_frame;
+            }
+            else if (!bgr_to_nv12(meta->osd_frame, nv12, use_rga)) {
+                VP_WARN(string_format("[%s] convert osd frame to NV12 failed, frame_index=%d", tag.c_str(), meta->frame_index));
+                return nullptr;
+            }
+        }
+        else if (meta->dma_frame != nullptr && meta->dma_frame->format == vp_objects::vp_dma_format::NV12 && meta->dma_frame->vir_addr != nullptr) {
+            dma = meta->dma_frame;
+        }
+        else if (!meta->frame.empty() && meta->frame.type() == CV_8UC1) {
+            nv12 = meta->frame;
+        }
+        else if (!meta->frame.empty() && meta->frame.type() == CV_8UC3) {
+            if (!bgr_to_nv12(meta->frame, nv12, use_rga)) {
+                VP_WARN(string_format("[%s] convert frame to NV12 failed, frame_index=%d", tag.c_str(), meta->frame_index));
+                return nullptr;
+            }
+        }
+        else {
+            return nullptr;
+        }
+
+        auto frame_width = dma ? dma->width : nv12.cols;
+        auto frame_height = dma ? dma->height : nv12.rows * 2 / 3;
+        if (!encoder) {
+            // keep strides of decoder buffer if the first frame comes from it, so later frames of the same source import directly
+            auto ok = dma ? init(frame_width, frame_height, dma->hor_stride, dma->ver_stride, meta->fps)
+                          : init(frame_width, frame_height, align_up(frame_width, 16), align_up(frame_height, 16), meta->fps);
+            if (!ok) {
+                init_failed = true;
+                return nullptr;
+            }
+        }
+        if (frame_width != width() || frame_height != height()) {
+            if (!size_warned) {
+                VP_WARN(string_format("[%s] frame size %dx%d differs from encoder %dx%d, dropped", tag.c_str(), frame_width, frame_height, width(), height()));
+                size_warned = true;
+            }
+            return nullptr;
+        }
+
+        MppBuffer input = nullptr;
+        // imported buffer needs to be put after encoding
+        bool imported = false;
+        if (dma && dma->fd >= 0 &&
+            dma->hor_stride == static_cast<int>(params.hor_stride) &&
+            dma->ver_stride == static_cast<int>(params.ver_stride)) {
+            input = static_cast<MppBuffer>(encoder->ImportBuffer(0, dma->size, dma->fd, MPP_BUFFER_TYPE_EXT_DMA));
+            imported = input != nullptr;
+        }
+        if (!input) {
+            if (dma) {
+                auto y_plane = static_cast<const uint8_t*>(dma->vir_addr);
+                auto pitch = static_cast<size_t>(dma->hor_stride);
+                input = copy_to_input(y_plane, y_plane + pitch * static_cast<size_t>(dma->ver_stride), pitch);
+            }
+            else {
+                input = copy_to_input(nv12.ptr<uint8_t>(0), nv12.ptr<uint8_t>(frame_height), nv12.step[0]);
+            }
+        }
+        if (!input) {
+            VP_WARN(string_format("[%s] no encoder input buffer, frame_index=%d", tag.c_str(), meta->frame_index));
+            return nullptr;
+        }
+
+        if (key_requested) {
+            encoder->RequestIDR();
+            key_requested = false;
+        }
+        // synchronous, dma keeps the decoder buffer alive until it returns
+        auto ret = encoder->Encode(input, nullptr, 0);
+        if (imported) {
+            mpp_buffer_put(input);
+        }
+        auto packet = std::move(encoded);
+        if (ret < 0 || packet == nullptr) {
+            if (ret < 0) {
+                VP_WARN(string_format("[%s] encode failed, frame_index=%d", tag.c_str(), meta->frame_index));
+            }
+            return nullptr;
+        }
+
+        packet->pts = packet->dts = next_pts++;
+        packet->duration = 1;
+        if (is_key_packet(packet->data, packet->size, h265)) {
+            packet->flags |= AV_PKT_FLAG_KEY;
+        }
+        return packet;
+    }
+
+    void vp_mpp_frame_encoder::request_key_frame() {
+        key_requested = true;
+    }
+
+    bool vp_mpp_frame_encoder::ready() const {
+        return encoder != nullptr;
+    }
+
+    bool vp_mpp_frame_encoder::failed() const {
+        return init_failed;
+    }
+
+    int vp_mpp_frame_encoder::width() const {
+        return static_cast<int>(params.width);
+    }
+
+    int vp_mpp_frame_encoder::height() const {
+        return static_cast<int>(params.height);
+    }
+
+    int vp_mpp_frame_encoder::fps() const {
+        return enc_fps;
+    }
+
+    AVCodecID vp_mpp_frame_encoder::codec_id() const {
+        return h265 ? AV_CODEC_ID_HEVC : AV_CODEC_ID_H264;
+    }
+
+    const std::vector<uint8_t>& vp_mpp_frame_encoder::header() const {
+        return stream_header;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "objects/vp_frame_meta.h"
+
+#include "SafeAVFormat.h"
+#include "mpp_encoder.h"
+
+namespace vp_utils {
+    // MPP hardware H.264/H.265 encoder fed by vp_frame_meta, one instance per video stream.
+    // input is picked from the frame meta in this order: osd_frame (if asked), decoder dma-buf NV12 (imported without copy
+    // when strides match), compact NV12 frame, BGR frame (converted to NV12).
+    // the encoder is created by the first frame, later frames with a different size are dropped (warned once).
+    //
+    // every encoded frame comes out as one Annex-B packet with pts counted in 1/fps and AV_PKT_FLAG_KEY set on IDR/IRAP,
+    // header() holds SPS/PPS[/VPS] for muxer extradata, so packets can be muxed (or cached and muxed later) without re-encoding.
+    // not thread safe, call from one thread (the node's handle thread).
+    class vp_mpp_frame_encoder {
+    private:
+        bool h265;
+        // kbps
+        int bitrate;
+        bool use_rga;
+        // used as log prefix
+        std::string tag;
+
+        std::unique_ptr<MppEncoder> encoder;
+        MppEncoderParams params;
+        int enc_fps = 0;
+        std::vector<uint8_t> stream_header;
+        // output of frame being encoded, filled by on_encoded()
+        av_packet encoded;
+        int64_t next_pts = 0;
+        // do not retry (and log) every frame once creating encoder failed
+        bool init_failed = false;
+        bool size_warned = false;
+        bool key_requested = false;
+
+        bool init(int width, int height, int hor_stride, int ver_stride, int fps);
+        // copy NV12 planes into encoder's own input buffer, laid out by encoder strides
+        MppBuffer copy_to_input(const uint8_t* y_plane, const uint8_t* uv_plane, size_t pitch);
+        static void on_encoded(void* userdata, const char* data, int size);
+    public:
+        vp_mpp_frame_encoder(bool h265, int bitrate, bool use_rga = false, std::string tag = "mpp_encoder");
+        ~vp_mpp_frame_encoder();
+
+        vp_mpp_frame_encoder(const vp_mpp_frame_encoder&) = delete;
+        vp_mpp_frame_encoder& operator=(const vp_mpp_frame_encoder&) = delete;
+
+        // encode one frame, osd means prefer osd_frame if it exists.
+        // return nullptr if frame has no usable image, is dropped, or encoding failed.
+        av_packet encode(const std::shared_ptr<vp_objects::vp_frame_meta>& meta, bool osd);
+        // ask for an IDR on the next encoded frame (applied once the encoder exists)
+        void request_key_frame();
+
+        // encoder created, below values are valid
+        bool ready() const;
+        // creating encoder failed, encode() always returns nullptr
+        bool failed() const;
+        int width() const;
+        int height() const;
+        int fps() const;
+        AVCodecID codec_id() const;
+        const std::vector<uint8_t>& header() const;
+    };
+}
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vp_utils {
+    // how vp_ordered_executor picks a worker for a new job.
+    enum class vp_dispatch_policy {
+        ROUND_ROBIN,    // worker 0, 1, ..., n-1, 0, ...
+        LEAST_LOADED    // worker with fewest pending jobs, ties broken round robin
+    };
+
+    // run jobs on a fixed set of workers and hand results back strictly in submit order.
+    // each worker owns one resource (for example one rknn_context pinned to one NPU core), a job receives the index of
+    // the worker running it so it can pick that resource, jobs on the same worker never run concurrently.
+    // results are passed to on_result from a dedicated thread, one by one, in the same order as submit(...) calls,
+    // no matter which worker finishes first.
+    //
+    // submit(...) blocks when max_in_flight jobs are submitted but not yet passed to on_result,
+    // which bounds memory and latency when workers are slower than the producer.
+    // producers which must not block (pool tasks, see vp_nodes::vp_node_pool_scope) check in_flight() < capacity() before
+    // submitting and wait for the space listener instead.
+    template<typename R>
+    class vp_ordered_executor {
+    public:
+        using job = std::function<R(int)>;
+        using result_handler = std::function<void(R&)>;
+
+    private:
+        struct slot {
+            bool done = false;
+            R result;
+        };
+        struct task {
+            job func;
+            std::shared_ptr<slot> target;
+        };
+
+        result_handler on_result;
+        // called after a result has left, see set_space_listener(...)
+        std::function<void()> on_space;
+        vp_dispatch_policy policy;
+        int max_in_flight;
+
+        std::mutex lock;
+        // slots in submit order, front is the next one to emit
+        std::deque<std::shared_ptr<slot>> order;
+        // pending tasks of each worker
+        std::vector<std::deque<task>> tasks;
+        std::vector<std::unique_ptr<std::condition_variable>> task_conds;
+        // signaled when a slot is done or order changes
+        std::condition_variable emit_cond;
+        // signaled when a slot leaves order or emitting finishes
+        std::condition_variable space_cond;
+        int next_worker = 0;
+        bool emitting = false;
+        bool stopping = false;
+
+        std::vector<std::thread> worker_threads;
+        std::thread emit_thread;
+
+        int pick_worker() {
+            auto n = static_cast<int>(tasks.size());
+            auto picked = next_worker;
+            if (policy == vp_dispatch_policy::LEAST_LOADED) {
+                for (int i = 0; i < n; i++) {
+                    auto w = (next_worker + i) % n;
+                    if (tasks[w].size() < tasks[picked].size()) {
+                        picked = w;
+                    }
+                }
+            }
+            next_worker = (picked + 1) % n;
+            return picked;
+        }
+
+        void enqueue(std::shared_ptr<slot> s, job* func) {
+            std::unique_lock<std::mutex> guard(lock);
+            space_cond.wait(guard, [this] { return stopping || static_cast<int>(order.size()) + (emitting ? 1 : 0) < max_in_flight; });
+            if (stopping) {
+                return;
+            }
+            order.push_back(s);
+            if (func != nullptr) {
+                auto w = pick_worker();
+                tasks[w].push_back(task {std::move(*func), s});
+                task_conds[w]->notify_one();
+            }
+            else {
+                emit_cond.notify_one();
+            }
+        }
+
+        void work_run(int index) {
+            auto& my_tasks = tasks[index];
+            auto& my_cond = *task_conds[index];
+            while (true) {
+                task t;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    my_cond.wait(guard, [&] { return stopping || !my_tasks.empty(); });
+                    if (my_tasks.empty()) {
+                        return;  // stopping and nothing left
+                    }
+                    t = std::move(my_tasks.front());
+                    my_tasks.pop_front();
+                }
+
+                auto r = t.func(index);
+
+                std::lock_guard<std::mutex> guard(lock);
+                t.target->result = std::move(r);
+                t.target->done = true;
+                emit_cond.notify_one();
+            }
+        }
+
+        void emit_run() {
+            while (true) {
+                std::shared_ptr<slot> s;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    emit_cond.wait(guard, [this] { return (!order.empty() && order.front()->done) || (stopping && order.empty()); });
+                    if (order.empty()) {
+                        return;  // stopping and everything emitted
+                    }
+                    s = order.front();
+                    order.pop_front();
+                    emitting = true;
+                }
+
+                on_result(s->result);
+
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    emitting = false;
+                    space_cond.notify_all();
+                }
+                if (on_space) {
+                    on_space();
+                }
+            }
+        }
+
+    public:
+        // workers: number of workers (resources), at least 1.
+        // max_in_flight: jobs allowed between submit and on_result, 0 means 2 per worker.
+        vp_ordered_executor(int workers, result_handler on_result, vp_dispatch_policy policy = vp_dispatch_policy::ROUND_ROBIN, int max_in_flight = 0):
+                            on_result(std::move(on_result)), policy(policy) {
+            workers = workers < 1 ? 1 : workers;
+            this->max_in_flight = max_in_flight > 0 ? max_in_flight : workers * 2;
+            tasks.resize(workers);
+            for (int i = 0; i < workers; i++) {
+                task_conds.push_back(std::unique_ptr<std::condition_variable>(new std::condition_variable()));
+            }
+            for (int i = 0; i < workers; i++) {
+                worker_threads.emplace_back(&vp_ordered_executor::work_run, this, i);
+            }
+            emit_thread = std::thread(&vp_ordered_executor::emit_run, this);
+        }
+
+        // pending jobs are finished and emitted before return.
+        ~vp_ordered_executor() {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stopping = true;
+                for (auto& c: task_conds) {
+                    c->notify_all();
+                }
+                space_cond.notify_all();
+            }
+            for (auto& t: worker_threads) {
+                t.join();
+            }
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                emit_cond.notify_all();
+            }
+            emit_thread.join();
+        }
+
+        vp_ordered_executor(const vp_ordered_executor&) = delete;
+        vp_ordered_executor& operator=(const vp_ordered_executor&) = delete;
+
+        // queue a job on one of workers.
+        void submit(job func) {
+            enqueue(std::make_shared<slot>(), &func);
+        }
+
+        // queue a result which is already available, it is emitted after all results submitted before it.
+        void submit_ready(R result) {
+            auto s = std::make_shared<slot>();
+            s->result = std::move(result);
+            s->done = true;
+            enqueue(s, nullptr);
+        }
+
+        // block until every result submitted so far has been passed to on_result.
+        void wait_idle() {
+            std::unique_lock<std::mutex> guard(lock);
+            space_cond.wait(guard, [this] { return order.empty() && !emitting; });
+        }
+
+        int workers() const {
+            return static_cast<int>(tasks.size());
+        }
+
+        // jobs allowed between submit and on_result, submit(...) blocks beyond it.
+        int capacity() const {
+            return max_in_flight;
+        }
+
+        // called on the completion thread each time a result has been passed to on_result and its slot is free again,
+        // so a producer which stopped on in_flight() >= capacity() knows when to go on. set it before the first submit.
+        void set_space_listener(std::function<void()> on_space) {
+            this->on_space = std::move(on_space);
+        }
+
+        // jobs submitted but not yet passed to on_result.
+        int in_flight() {
+            std::lock_guard<std::mutex> guard(lock);
+            return static_cast<int>(order.size()) + (emitting ? 1 : 0);
+        }
+    };
+}
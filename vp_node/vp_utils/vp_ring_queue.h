@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace vp_utils {
+    // bounded lock-free ring queue, safe for multiple producers and multiple consumers (Dmitry Vyukov's algorithm).
+    // each cell carries a sequence number which tells producers/consumers whether the cell is ready for them,
+    // so push/pop are a single CAS on the hot path and never allocate after construction.
+    // physical capacity is rounded up to the next power of two.
+    // note: try_push/try_pop never block, refer to vp_nodes::vp_meta_queue for blocking/backpressure semantics.
+    template<typename T>
+    class vp_ring_queue
+    {
+    public:
+        explicit vp_ring_queue(size_t capacity) {
+            size_t size = 2;
+            while (size < capacity) {
+                size <<= 1;
+            }
+            mask_ = size - 1;
+            cells_.reset(new cell[size]);
+            for (size_t i = 0; i < size; i++) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            enqueue_pos_.store(0, std::memory_order_relaxed);
+            dequeue_pos_.store(0, std::memory_order_relaxed);
+        }
+
+        vp_ring_queue(const vp_ring_queue&) = delete;
+        vp_ring_queue& operator=(const vp_ring_queue&) = delete;
+
+        // return false if queue is full, value is untouched in that case.
+        bool try_push(T& value) {
+            cell* c;
+            size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            for (;;) {
+                c = &cells_[pos & mask_];
+                size_t seq = c->sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if (diff == 0) {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;
+                }
+                else {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            c->data = std::move(value);
+            c->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // return false if queue is empty.
+        bool try_pop(T& value) {
+            size_t position;
+            return try_pop(value, position);
+        }
+
+        // same as above, position is the index of value in push order (0 for the first value ever pushed).
+        bool try_pop(T& value, size_t& position) {
+            cell* c;
+            size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            for (;;) {
+                c = &cells_[pos & mask_];
+                size_t seq = c->sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+                if (diff == 0) {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (diff < 0) {
+                    return false;
+                }
+                else {
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            value = std::move(c->data);
+            c->data = T();  // release resource held by the cell as soon as possible
+            c->sequence.store(pos + mask_ + 1, std::memory_order_release);
+            position = pos;
+            return true;
+        }
+
+        // number of values taken by consumers so far, values at positions below it are gone (or being moved out).
+        size_t popped() const {
+            return dequeue_pos_.load(std::memory_order_acquire);
+        }
+
+        // physical capacity
+        size_t capacity() const {
+            return mask_ + 1;
+        }
+
+    private:
+        struct cell {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+
+        // avoid false sharing between producers and consumers
+        static constexpr size_t cache_line_size = 64;
+
+        std::unique_ptr<cell[]> cells_;
+        size_t mask_;
+        alignas(cache_line_size) std::atomic<size_t> enqueue_pos_;
+        alignas(cache_line_size) std::atomic<size_t> dequeue_pos_;
+    };
+}
@@ -26,6 +26,16 @@ namespace vp_utils {
             --count_;
         }
 
+        // non-blocking wait, return false if count is zero.
+        bool try_wait() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (count_ == 0) {
+                return false;
+            }
+            --count_;
+            return true;
+        }
+
     private:
         std::mutex mutex_;
         std::condition_variable cv_;
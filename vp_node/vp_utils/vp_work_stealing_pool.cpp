@@ -0,0 +1,167 @@
+#include <fstream>
+#include <algorithm>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#include "vp_work_stealing_pool.h"
+#include "logger/vp_logger.h"
+#include "trace/vp_tracer.h"
+
+namespace vp_utils {
+
+    namespace {
+        // worker running on current thread, used to keep follow-up tasks local
+        thread_local vp_work_stealing_pool* current_pool = nullptr;
+        thread_local int current_worker = -1;
+    }
+
+    std::vector<int> vp_cpus_of(vp_cpu_cluster cluster) {
+        auto total = static_cast<int>(sysconf(_SC_NPROCESSORS_CONF));
+        std::vector<int> all;
+        std::vector<int> capacity;
+        for (int cpu = 0; cpu < total; cpu++) {
+            all.push_back(cpu);
+            std::ifstream f("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpu_capacity");
+            int c = 0;
+            capacity.push_back((f >> c) ? c : 0);
+        }
+        if (cluster == vp_cpu_cluster::ALL || all.empty()) {
+            return all;
+        }
+
+        auto min_capacity = *std::min_element(capacity.begin(), capacity.end());
+        auto max_capacity = *std::max_element(capacity.begin(), capacity.end());
+        if (min_capacity == max_capacity) {
+            return all;
+        }
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < total; cpu++) {
+            auto little = capacity[cpu] == min_capacity;
+            if (little == (cluster == vp_cpu_cluster::LITTLE)) {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    vp_work_stealing_pool::vp_work_stealing_pool(std::string name, int threads, std::vector<int> cpus):
+                                                pool_name(name), cpu_ids(cpus) {
+        if (threads <= 0) {
+            threads = !cpu_ids.empty() ? static_cast<int>(cpu_ids.size()) : std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (int i = 0; i < threads; i++) {
+            queues.emplace_back(new worker_queue());
+        }
+        for (int i = 0; i < threads; i++) {
+            worker_threads.emplace_back(&vp_work_stealing_pool::run, this, i);
+        }
+    }
+
+    vp_work_stealing_pool::~vp_work_stealing_pool() {
+        stopping.store(true);
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            sleep_cond.notify_all();
+        }
+        for (auto& t: worker_threads) {
+            if (t.joinable()) {
+                t.join();
+            }
+        }
+    }
+
+    const std::string& vp_work_stealing_pool::name() const {
+        return pool_name;
+    }
+
+    int vp_work_stealing_pool::workers() const {
+        return static_cast<int>(queues.size());
+    }
+
+    const std::vector<int>& vp_work_stealing_pool::cpus() const {
+        return cpu_ids;
+    }
+
+    uint64_t vp_work_stealing_pool::steals() const {
+        return steal_count.load(std::memory_order_relaxed);
+    }
+
+    void vp_work_stealing_pool::submit(task t) {
+        // keep follow-up work on the submitting worker, spread the rest
+        auto index = current_pool == this ? current_worker : static_cast<int>(next_queue++ % queues.size());
+        {
+            std::lock_guard<std::mutex> guard(queues[index]->lock);
+            queues[index]->tasks.push_back(std::move(t));
+        }
+        // pairs with the check in run(), either the sleeper sees queued > 0 or we see the sleeper
+        queued.fetch_add(1);
+        if (sleepers.load() > 0) {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            sleep_cond.notify_one();
+        }
+    }
+
+    bool vp_work_stealing_pool::take(int index, task& t) {
+        // own deque, newest first
+        {
+            auto& q = *queues[index];
+            std::lock_guard<std::mutex> guard(q.lock);
+            if (!q.tasks.empty()) {
+                t = std::move(q.tasks.back());
+                q.tasks.pop_back();
+                queued.fetch_sub(1);
+                return true;
+            }
+        }
+        // steal the oldest task of others
+        auto n = static_cast<int>(queues.size());
+        for (int i = 1; i < n; i++) {
+            auto& q = *queues[(index + i) % n];
+            std::unique_lock<std::mutex> guard(q.lock, std::try_to_lock);
+            if (guard.owns_lock() && !q.tasks.empty()) {
+                t = std::move(q.tasks.front());
+                q.tasks.pop_front();
+                queued.fetch_sub(1);
+                steal_count.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void vp_work_stealing_pool::run(int index) {
+        current_pool = this;
+        current_worker = index;
+        vp_tracer::set_thread_name(pool_name + " worker " + std::to_string(index));
+        if (!cpu_ids.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu_ids[index % cpu_ids.size()], &set);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+                VP_WARN(string_format("[%s] pin worker %d to cpu %d failed", pool_name.c_str(), index, cpu_ids[index % cpu_ids.size()]));
+            }
+        }
+
+        task t;
+        while (!stopping.load()) {
+            if (take(index, t)) {
+                t();
+                t = nullptr;
+                continue;
+            }
+            // try_lock in take() may skip busy deques, look once more before sleeping
+            if (queued.load() > 0) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> guard(sleep_lock);
+            sleepers.fetch_add(1);
+            sleep_cond.wait(guard, [this] { return stopping.load() || queued.load() > 0; });
+            sleepers.fetch_sub(1);
+        }
+        current_pool = nullptr;
+        current_worker = -1;
+    }
+}
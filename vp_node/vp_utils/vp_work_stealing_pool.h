@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vp_utils {
+    // cpu cluster of big.LITTLE socs such as RK3588 (cpu0-3 Cortex-A55, cpu4-7 Cortex-A76).
+    enum class vp_cpu_cluster {
+        ALL,     // every online cpu
+        BIG,     // cpus with capacity above the smallest one
+        LITTLE   // cpus with the smallest capacity
+    };
+
+    // cpu ids of cluster, decided by /sys/devices/system/cpu/cpuN/cpu_capacity.
+    // on homogeneous machines (or if capacity is not exposed) all clusters are the whole cpu set.
+    std::vector<int> vp_cpus_of(vp_cpu_cluster cluster);
+
+    // fixed size thread pool with one task deque per worker and work stealing between workers.
+    // tasks submitted from a worker go to the back of its own deque and are taken back LIFO (cache friendly follow-up work),
+    // idle workers steal the oldest task from the front of other deques, tasks from outside threads are spread over workers.
+    // workers can be pinned to a set of cpus, worker i runs on cpus[i % cpus.size()], so one pool per cluster keeps
+    // heavy stages on big cores and light ones on little cores.
+    //
+    // tasks must not block for long (they hold a worker), see vp_node_pool_scope for how pipeline nodes run on it.
+    // the pool must outlive everything submitting to it, tasks left in deques when it is destroyed are discarded.
+    class vp_work_stealing_pool {
+    public:
+        using task = std::function<void()>;
+
+        // threads <= 0 means one worker per cpu in cpus (or per hardware thread if cpus is empty).
+        vp_work_stealing_pool(std::string name, int threads, std::vector<int> cpus = {});
+        ~vp_work_stealing_pool();
+
+        vp_work_stealing_pool(const vp_work_stealing_pool&) = delete;
+        vp_work_stealing_pool& operator=(const vp_work_stealing_pool&) = delete;
+
+        void submit(task t);
+
+        const std::string& name() const;
+        int workers() const;
+        const std::vector<int>& cpus() const;
+        // tasks taken from other workers since created
+        uint64_t steals() const;
+
+    private:
+        struct worker_queue {
+            std::mutex lock;
+            std::deque<task> tasks;
+        };
+
+        std::string pool_name;
+        std::vector<int> cpu_ids;
+        std::vector<std::unique_ptr<worker_queue>> queues;
+        std::vector<std::thread> worker_threads;
+
+        // tasks in deques, not yet taken
+        std::atomic<int> queued {0};
+        // workers going to sleep or sleeping
+        std::atomic<int> sleepers {0};
+        std::atomic<bool> stopping {false};
+        std::atomic<unsigned> next_queue {0};
+        std::atomic<uint64_t> steal_count {0};
+        std::mutex sleep_lock;
+        std::condition_variable sleep_cond;
+
+        void run(int index);
+        bool take(int index, task& t);
+    };
+}